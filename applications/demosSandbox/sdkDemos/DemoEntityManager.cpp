@@ -83,6 +83,13 @@
 //#define DEFAULT_SCENE	47		// soft bodies	
 //#define DEFAULT_SCENE	48		// joe's joint test
 //#define DEFAULT_SCENE	49		// Misho's Hinge Test
+//#define DEFAULT_SCENE	50		// rag doll pile
+//#define DEFAULT_SCENE	51		// stiff island stacks
+//#define DEFAULT_SCENE	52		// deterministic stacks
+//#define DEFAULT_SCENE	53		// compound contact reduction
+//#define DEFAULT_SCENE	54		// large cloth patch
+//#define DEFAULT_SCENE	55		// voronoi cook benchmark
+//#define DEFAULT_SCENE	56		// convex hull benchmark
 
 /// demos forward declaration 
 void Friction (DemoEntityManager* const scene);
@@ -95,8 +102,14 @@ void PrimitiveCollision (DemoEntityManager* const scene);
 void KinematicBodies (DemoEntityManager* const scene);
 void ObjectPlacement (DemoEntityManager* const scene);
 void ClothPatch(DemoEntityManager* const scene);
+void LargeClothPatch(DemoEntityManager* const scene);
 void SoftBodies (DemoEntityManager* const scene);
 void BasicBoxStacks (DemoEntityManager* const scene);
+void StiffIslandStacks (DemoEntityManager* const scene);
+void DeterministicStacks (DemoEntityManager* const scene);
+void ConvexHullContactsBenchmark (DemoEntityManager* const scene);
+void PlayerControllersBenchmark (DemoEntityManager* const scene);
+void AnimationBlendingBenchmarkScene (DemoEntityManager* const scene);
 void SimpleMeshLevelCollision (DemoEntityManager* const scene);
 void OptimizedMeshLevelCollision (DemoEntityManager* const scene);
 void UniformScaledCollision (DemoEntityManager* const scene);
@@ -107,12 +120,15 @@ void ContinuousCollision1 (DemoEntityManager* const scene);
 void PuckSlide (DemoEntityManager* const scene);
 void SceneCollision (DemoEntityManager* const scene);
 void CompoundCollision(DemoEntityManager* const scene);
+void CompoundContactReduction(DemoEntityManager* const scene);
 void AlchimedesBuoyancy(DemoEntityManager* const scene);
 void SimpleConvexApproximation(DemoEntityManager* const scene);
 void SimpleBooleanOperations(DemoEntityManager* const scene);
 void SimpleConvexFracturing (DemoEntityManager* const scene);
+void VoronoiCookBenchmarkScene (DemoEntityManager* const scene);
 void StructuredConvexFracturing (DemoEntityManager* const scene);
 void UsingNewtonMeshTool (DemoEntityManager* const scene);
+void ConvexHullBenchmarkScene (DemoEntityManager* const scene);
 void MultiRayCast (DemoEntityManager* const scene);
 void BasicCar (DemoEntityManager* const scene);
 void SingleBodyCar(DemoEntityManager* const scene);
@@ -128,6 +144,7 @@ void UserHeightFieldCollision (DemoEntityManager* const scene);
 void PassiveRagdoll (DemoEntityManager* const scene);
 void KinematicRagdoll (DemoEntityManager* const scene);
 void DynamicRagdoll (DemoEntityManager* const scene);
+void RagdollPile (DemoEntityManager* const scene);
 void ServoJoints (DemoEntityManager* const scene);
 void ArticulatedJoints (DemoEntityManager* const scene);
 void StandardJoints (DemoEntityManager* const scene);
@@ -190,6 +207,16 @@ DemoEntityManager::SDKDemos DemoEntityManager::m_demosSelection[] =
 	{"Simple soft Body", "show simple soft body", SoftBodies},
 	{"Joes joint test", "", JoesJointTest},
 	{"Misho's Hinge Test", "", MishosHingeTest },
+	{"Rag doll pile", "stress test the skeleton solver with many identical rag dolls", RagdollPile},
+	{"Stiff island stacks", "extra solver sub steps only for islands with large mass ratios", StiffIslandStacks},
+	{"Deterministic stacks", "deterministic mode checked every step against a single thread replay", DeterministicStacks},
+	{"Compound contact reduction", "solver rows of compound against terrain contacts with and without manifold reduction", CompoundContactReduction},
+	{"Large cloth patch", "mass spring solver cost of a 100k particles cloth", LargeClothPatch},
+	{"Voronoi cook benchmark", "voronoi decomposition cook time on one thread and on the world worker threads", VoronoiCookBenchmarkScene},
+	{"Convex hull benchmark", "incremental and quick hull build times for different point counts and distributions", ConvexHullBenchmarkScene},
+	{"Convex hull contacts benchmark", "narrow phase time of a pile of convex hulls with many vertices", ConvexHullContactsBenchmark},
+	{"Player controllers benchmark", "ten thousand player controllers walking on a height field", PlayerControllersBenchmark},
+	{"Animation blending benchmark", "per skeleton cost of sampling, blending and layering flat poses against list poses", AnimationBlendingBenchmarkScene},
 };
 
 
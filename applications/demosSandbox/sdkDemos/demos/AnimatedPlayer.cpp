@@ -18,6 +18,7 @@
 #include "DemoEntityManager.h"
 #include "DebugDisplay.h"
 #include "HeightFieldPrimitive.h"
+#include "dHighResolutionTimer.h"
 
 
 #if 0
@@ -554,6 +555,49 @@ for (int i = 0; i < 10; i ++) {
 //#define PLAYER_JUMP_SPEED				5.8f
 #define PLAYER_THIRD_PERSON_VIEW_DIST	8.0f
 
+static dAnimationKeyframesSequence* LoadAnimationSequence(NewtonWorld* const world, const char* const animName)
+{
+	dScene scene(world);
+	char pathName[2048];
+	dGetWorkingFileName(animName, pathName);
+	scene.Deserialize(pathName);
+
+	dAnimationKeyframesSequence* animdata = NULL;
+	dScene::dTreeNode* const animTakeNode = scene.FindChildByType(scene.GetRootNode(), dAnimationTake::GetRttiType());
+	if (animTakeNode) {
+		animdata = new dAnimationKeyframesSequence();
+		dAnimationTake* const animTake = (dAnimationTake*)scene.GetInfoFromNode(animTakeNode);
+		animdata->SetPeriod(animTake->GetPeriod());
+
+		int compressedCount = 0;
+		dList<dAnimimationKeyFramesTrack>& tracks = animdata->GetTracks();
+		for (void* link = scene.GetFirstChildLink(animTakeNode); link; link = scene.GetNextChildLink(animTakeNode, link)) {
+			dScene::dTreeNode* const node = scene.GetNodeFromLink(link);
+			dAnimationTrack* const srcTrack = (dAnimationTrack*)scene.GetInfoFromNode(node);
+
+			if (srcTrack->IsType(dAnimationTrack::GetRttiType())) {
+				dAnimimationKeyFramesTrack* const dstTrack = &tracks.Append()->GetInfo();
+				dstTrack->SetName(srcTrack->GetName());
+				srcTrack->GetKeyFrames(*dstTrack);
+
+				const dAnimationCompressedTrack* const compressedTrack = srcTrack->GetCompressedTrack();
+				if (compressedTrack) {
+					animdata->GetCompressedTracks().Append(*compressedTrack);
+					compressedCount++;
+				}
+			}
+		}
+
+		// the compressed tracks saved with the scene are used as they are, unless some track was saved without one
+		if (compressedCount != tracks.GetCount()) {
+			animdata->GetCompressedTracks().RemoveAll();
+		}
+
+		// bake the tracks into flat poses, so that sampling does not search keys
+		animdata->BuildFrames(30.0f);
+	}
+	return animdata;
+}
 
 class AnimatedPlayerControllerManager: public dCustomPlayerControllerManager
 {
@@ -617,77 +661,9 @@ class AnimatedPlayerControllerManager: public dCustomPlayerControllerManager
 	{
 		dTree<dAnimationKeyframesSequence*, dString>::dTreeNode* cachedAnimNode = m_animCache.Find(animName);
 		if (!cachedAnimNode) {
-			dScene scene(GetWorld());
-			char pathName[2048];
-			dGetWorkingFileName(animName, pathName);
-			scene.Deserialize(pathName);
-
-			dScene::dTreeNode* const animTakeNode = scene.FindChildByType(scene.GetRootNode(), dAnimationTake::GetRttiType());
-			if (animTakeNode) {
-				//dTree<dAnimimationKeyFramesTrack*, dString> map;
-				//const dAnimPose& basePose = controller->GetBasePose();
-				//dAnimTakeData* const animdata = new dAnimTakeData(basePose.GetCount());
-				dAnimationKeyframesSequence* const animdata = new dAnimationKeyframesSequence();
-				dAnimationTake* const animTake = (dAnimationTake*)scene.GetInfoFromNode(animTakeNode);
-				animdata->SetPeriod(animTake->GetPeriod());
-
+			dAnimationKeyframesSequence* const animdata = LoadAnimationSequence(GetWorld(), animName);
+			if (animdata) {
 				cachedAnimNode = m_animCache.Insert(animdata, animName);
-
-				//dList<dAnimimationKeyFramesTrack>& tracks = animdata->GetTracks();
-				//dList<dAnimimationKeyFramesTrack>::dListNode* ptr = tracks.GetFirst();
-				//dList<dAnimimationKeyFramesTrack>::dListNode* ptr = tracks.Append();
-				//for (dAnimPose::dListNode* ptrNode = basePose.GetFirst(); ptrNode; ptrNode = ptrNode->GetNext()) {
-				//	DemoEntity* const entity = (DemoEntity*)ptrNode->GetInfo().m_userData;
-				//	map.Insert(&ptr->GetInfo(), entity->GetName());
-				//	ptr = ptr->GetNext();
-				//}
-
-				dList<dAnimimationKeyFramesTrack>& tracks = animdata->GetTracks();
-				for (void* link = scene.GetFirstChildLink(animTakeNode); link; link = scene.GetNextChildLink(animTakeNode, link)) {
-					dScene::dTreeNode* const node = scene.GetNodeFromLink(link);
-					dAnimationTrack* const srcTrack = (dAnimationTrack*)scene.GetInfoFromNode(node);
-
-					if (srcTrack->IsType(dAnimationTrack::GetRttiType())) {
-						//dTree<dAnimimationKeyFramesTrack*, dString>::dTreeNode* const ptrNode = map.Find(srcTrack->GetName());
-						//dAssert(ptrNode);
-						//dAnimTakeData::dAnimTakeTrack* const dstTrack = ptrNode->GetInfo();
-						dAnimimationKeyFramesTrack* const dstTrack = &tracks.Append()->GetInfo();
-						dstTrack->SetName(srcTrack->GetName());
-
-						const dList<dAnimationTrack::dCurveValue>& rotations = srcTrack->GetRotations();
-						dstTrack->m_rotation.Resize(rotations.GetCount());
-						int index = 0;
-						for (dList<dAnimationTrack::dCurveValue>::dListNode* node = rotations.GetFirst(); node; node = node->GetNext()) {
-							dAnimationTrack::dCurveValue keyFrame(node->GetInfo());
-
-							dMatrix matrix(dPitchMatrix(keyFrame.m_x) * dYawMatrix(keyFrame.m_y) * dRollMatrix(keyFrame.m_z));
-							dQuaternion rot(matrix);
-							dstTrack->m_rotation[index].m_rotation = rot;
-							dstTrack->m_rotation[index].m_time = keyFrame.m_time;
-							index++;
-						}
-
-						for (int i = 0; i < rotations.GetCount() - 1; i++) {
-							dFloat dot = dstTrack->m_rotation[i].m_rotation.DotProduct(dstTrack->m_rotation[i + 1].m_rotation);
-							if (dot < 0.0f) {
-								dstTrack->m_rotation[i + 1].m_rotation.m_x *= -1.0f;
-								dstTrack->m_rotation[i + 1].m_rotation.m_y *= -1.0f;
-								dstTrack->m_rotation[i + 1].m_rotation.m_z *= -1.0f;
-								dstTrack->m_rotation[i + 1].m_rotation.m_w *= -1.0f;
-							}
-						}
-
-						const dList<dAnimationTrack::dCurveValue>& positions = srcTrack->GetPositions();
-						dstTrack->m_position.Resize(positions.GetCount());
-						index = 0;
-						for (dList<dAnimationTrack::dCurveValue>::dListNode* node = positions.GetFirst(); node; node = node->GetNext()) {
-							dAnimationTrack::dCurveValue keyFrame(node->GetInfo());
-							dstTrack->m_position[index].m_posit = dVector(keyFrame.m_x, keyFrame.m_y, keyFrame.m_z, dFloat(1.0f));
-							dstTrack->m_position[index].m_time = keyFrame.m_time;
-							index++;
-						}
-					}
-				}
 			}
 		}
 		dAssert(cachedAnimNode);
@@ -996,3 +972,262 @@ void AnimatedPlayerController(DemoEntityManager* const scene)
 	scene->SetCameraMatrix(rot, origin);
 }
 
+
+// evaluates a crowd of skeletons, each one sampling the idle and the walk sequences, 
+// blending them and adding a lean layer on top, with the flat poses and with 
+// the per bone list pose and slerp that the model pose blenders use.
+class AnimationBlendingBenchmark: public dCustomListener
+{
+	public:
+	AnimationBlendingBenchmark(DemoEntityManager* const scene)
+		:dCustomListener(scene->GetNewton(), "Animation blending benchmark")
+		,m_bonesCount(0)
+		,m_frames(0)
+		,m_keysMemory(0)
+		,m_compressedMemory(0)
+		,m_framesMemory(0)
+		,m_error(0.0f)
+		,m_compressedPositError(0.0f)
+		,m_compressedRotationError(0.0f)
+		,m_compressed(false)
+	{
+		for (int i = 0; i < m_testsCount; i++) {
+			m_time[i] = 0.0f;
+		}
+
+		dAnimationKeyframesSequence* const idle = LoadAnimationSequence(scene->GetNewton(), "whiteman_idle.ngd");
+		dAnimationKeyframesSequence* const walk = LoadAnimationSequence(scene->GetNewton(), "whiteman_walk.ngd");
+		if (idle && walk && (idle->GetTracks().GetCount() == walk->GetTracks().GetCount())) {
+			m_bonesCount = walk->GetTracks().GetCount();
+			m_frames = walk->GetFramesCount();
+
+			m_compressed = idle->Compress() && walk->Compress();
+			m_keysMemory = idle->GetKeysMemorySize() + walk->GetKeysMemorySize();
+			m_compressedMemory = idle->GetCompressedMemorySize() + walk->GetCompressedMemorySize();
+			m_framesMemory = idle->GetFramesMemorySize() + walk->GetFramesMemorySize();
+			if (m_compressed) {
+				MeasureCompressionError(idle);
+				MeasureCompressionError(walk);
+			}
+
+			dAnimationPose flatPose(m_bonesCount);
+			for (int i = 0; i < m_testsCount; i++) {
+				m_time[i] = EvaluateCrowd(i, idle, walk, flatPose);
+			}
+
+			dModelKeyFramePose listPose;
+			EvaluateCrowd(idle, walk, listPose);
+			dModelKeyFramePose::dListNode* node = listPose.GetFirst();
+			for (int i = 0; i < m_bonesCount; i++) {
+				dVector posit;
+				dVector scale;
+				dQuaternion rotation;
+				flatPose.GetBone(i, posit, rotation, scale);
+				m_error = dMax(m_error, dFloat(1.0f) - dAbs(rotation.DotProduct(node->GetInfo().m_rotation)));
+				node = node->GetNext();
+			}
+		}
+
+		if (idle) {
+			idle->Release();
+		}
+		if (walk) {
+			walk->Release();
+		}
+		scene->Set2DDisplayRenderFunction(RenderHelpMenu, NULL, this);
+	}
+
+	static dFloat GetTime(int skeleton, int frame, dFloat period)
+	{
+		return dMod(dFloat(skeleton) * 0.137f + dFloat(frame) * (1.0f / 60.0f), period);
+	}
+
+	void MeasureCompressionError(dAnimationKeyframesSequence* const sequence)
+	{
+		dAnimationPose keysPose(m_bonesCount);
+		dAnimationPose compressedPose(m_bonesCount);
+		for (int i = 0; i <= 200; i++) {
+			const dFloat t = sequence->GetPeriod() * dFloat(i) / 200.0f;
+			keysPose.SetIdentity();
+			compressedPose.SetIdentity();
+			sequence->CalculatePoseFromKeys(keysPose, t);
+			sequence->CalculatePoseFromCompressedTracks(compressedPose, t);
+			for (int j = 0; j < m_bonesCount; j++) {
+				dVector posit0;
+				dVector posit1;
+				dVector scale;
+				dQuaternion rotation0;
+				dQuaternion rotation1;
+				keysPose.GetBone(j, posit0, rotation0, scale);
+				compressedPose.GetBone(j, posit1, rotation1, scale);
+				// the angle comes from the chord, acos of a dot product close to one is too coarse
+				rotation1.Scale(dSign(rotation0.DotProduct(rotation1)));
+				const dVector step(posit1 - posit0);
+				const dQuaternion chord(rotation1.m_w - rotation0.m_w, rotation1.m_x - rotation0.m_x, rotation1.m_y - rotation0.m_y, rotation1.m_z - rotation0.m_z);
+				const dFloat chordLength = dSqrt(chord.DotProduct(chord));
+				m_compressedPositError = dMax(m_compressedPositError, dFloat(dSqrt(step.DotProduct3(step))));
+				m_compressedRotationError = dMax(m_compressedRotationError, dFloat(4.0f) * dAsin(dMin(chordLength * dFloat(0.5f), dFloat(1.0f))));
+			}
+		}
+	}
+
+	// returns the average cost of one skeleton in microseconds
+	dFloat EvaluateCrowd(int test, dAnimationKeyframesSequence* const idle, dAnimationKeyframesSequence* const walk, dAnimationPose& output) const
+	{
+		dAnimationPose idlePose(m_bonesCount);
+		dAnimationPose walkPose(m_bonesCount);
+		dAnimationPose leanPose(m_bonesCount);
+		dAnimationPose additive(m_bonesCount);
+
+		walk->CalculatePose(walkPose, 0.0f);
+		walk->CalculatePose(leanPose, walk->GetPeriod() * 0.25f);
+		additive.MakeAdditive(leanPose, walkPose);
+
+		unsigned64 startTime = dGetTimeInMicrosenconds();
+		for (int frame = 0; frame < m_framesCount; frame++) {
+			for (int i = 0; i < m_skeletonsCount; i++) {
+				const dFloat idleTime = GetTime(i, frame, idle->GetPeriod());
+				const dFloat walkTime = GetTime(i, frame, walk->GetPeriod());
+				const dFloat param = dFloat(i) / m_skeletonsCount;
+				if (test == 1) {
+					idle->CalculatePoseFromKeys(idlePose, idleTime);
+					walk->CalculatePoseFromKeys(walkPose, walkTime);
+				} else if (test == 3) {
+					idle->CalculatePoseFromCompressedTracks(idlePose, idleTime);
+					walk->CalculatePoseFromCompressedTracks(walkPose, walkTime);
+				} else {
+					idle->CalculatePose(idlePose, idleTime);
+					walk->CalculatePose(walkPose, walkTime);
+				}
+				if (test == 2) {
+					output.BlendSlerp(idlePose, walkPose, param);
+				} else {
+					output.Blend(idlePose, walkPose, param);
+				}
+				output.AddLayer(additive, 0.5f);
+			}
+		}
+		return dFloat(dGetTimeInMicrosenconds() - startTime) / (m_framesCount * m_skeletonsCount);
+	}
+
+	static void SampleSequence(dAnimationKeyframesSequence* const sequence, dModelKeyFramePose& output, dFloat t)
+	{
+		dModelKeyFramePose::dListNode* node = output.GetFirst();
+		for (dList<dAnimimationKeyFramesTrack>::dListNode* trackNode = sequence->GetTracks().GetFirst(); trackNode; trackNode = trackNode->GetNext()) {
+			dModelKeyFrame& keyFrame = node->GetInfo();
+			trackNode->GetInfo().InterpolatePosition(t, keyFrame.m_posit);
+			trackNode->GetInfo().InterpolateRotation(t, keyFrame.m_rotation);
+			node = node->GetNext();
+		}
+	}
+
+	// the same work done one bone at a time on list poses, the way dModelAnimTreePoseBlender does it
+	void EvaluateCrowd(dAnimationKeyframesSequence* const idle, dAnimationKeyframesSequence* const walk, dModelKeyFramePose& output)
+	{
+		dModelKeyFramePose idlePose;
+		dModelKeyFramePose walkPose;
+		dModelKeyFramePose additive;
+		for (int i = 0; i < m_bonesCount; i++) {
+			dModelKeyFrame keyFrame;
+			keyFrame.m_posit = dVector(0.0f, 0.0f, 0.0f, 1.0f);
+			keyFrame.m_effector = NULL;
+			output.Append(keyFrame);
+			idlePose.Append(keyFrame);
+			walkPose.Append(keyFrame);
+			additive.Append(keyFrame);
+		}
+
+		dModelKeyFramePose leanPose(walkPose);
+		SampleSequence(walk, walkPose, 0.0f);
+		SampleSequence(walk, leanPose, walk->GetPeriod() * 0.25f);
+		for (dModelKeyFramePose::dListNode* node = additive.GetFirst(), *node0 = walkPose.GetFirst(), *node1 = leanPose.GetFirst(); node; node = node->GetNext(), node0 = node0->GetNext(), node1 = node1->GetNext()) {
+			dModelKeyFrame& delta = node->GetInfo();
+			delta.m_posit = node1->GetInfo().m_posit - node0->GetInfo().m_posit;
+			delta.m_rotation = node0->GetInfo().m_rotation.Inverse() * node1->GetInfo().m_rotation;
+			delta.m_rotation.Scale(dSign(delta.m_rotation.m_w));
+		}
+
+		const dQuaternion identity;
+		unsigned64 startTime = dGetTimeInMicrosenconds();
+		for (int frame = 0; frame < m_framesCount; frame++) {
+			for (int i = 0; i < m_skeletonsCount; i++) {
+				const dFloat param = dFloat(i) / m_skeletonsCount;
+				SampleSequence(idle, idlePose, GetTime(i, frame, idle->GetPeriod()));
+				SampleSequence(walk, walkPose, GetTime(i, frame, walk->GetPeriod()));
+				dModelKeyFramePose::dListNode* node0 = walkPose.GetFirst();
+				dModelKeyFramePose::dListNode* deltaNode = additive.GetFirst();
+				dModelKeyFramePose::dListNode* dstNode = output.GetFirst();
+				for (dModelKeyFramePose::dListNode* node = idlePose.GetFirst(); node; node = node->GetNext()) {
+					dModelKeyFrame& dst = dstNode->GetInfo();
+					const dModelKeyFrame& src0 = node->GetInfo();
+					const dModelKeyFrame& src1 = node0->GetInfo();
+					const dModelKeyFrame& delta = deltaNode->GetInfo();
+
+					dQuaternion srcRotation(src1.m_rotation);
+					srcRotation.Scale(dSign(src0.m_rotation.DotProduct(src1.m_rotation)));
+					dst.m_rotation = src0.m_rotation.Slerp(srcRotation, param);
+					dst.m_rotation = dst.m_rotation * identity.Slerp(delta.m_rotation, 0.5f);
+					dst.m_posit = src0.m_posit.Scale(1.0f - param) + src1.m_posit.Scale(param) + delta.m_posit.Scale(0.5f);
+					dst.m_posit.m_w = 1.0f;
+
+					node0 = node0->GetNext();
+					dstNode = dstNode->GetNext();
+					deltaNode = deltaNode->GetNext();
+				}
+			}
+		}
+		m_time[m_testsCount] = dFloat(dGetTimeInMicrosenconds() - startTime) / (m_framesCount * m_skeletonsCount);
+	}
+
+	static void RenderHelpMenu(DemoEntityManager* const scene, void* const context)
+	{
+		AnimationBlendingBenchmark* const me = (AnimationBlendingBenchmark*)context;
+		dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+		if (!me->m_bonesCount) {
+			scene->Print(color, "could not load the idle and walk sequences");
+			return;
+		}
+		scene->Print(color, "%d skeletons of %d bones, sample two sequences, blend and add a layer", m_skeletonsCount, me->m_bonesCount);
+		scene->Print(color, "flat poses, %d baked frames, nlerp:  %7.2f us per skeleton", me->m_frames, me->m_time[0]);
+		scene->Print(color, "flat poses, key search, nlerp:       %7.2f us per skeleton", me->m_time[1]);
+		scene->Print(color, "flat poses, %d baked frames, slerp:  %7.2f us per skeleton", me->m_frames, me->m_time[2]);
+		scene->Print(color, "flat poses, compressed tracks, nlerp: %7.2f us per skeleton", me->m_time[3]);
+		scene->Print(color, "list poses, key search, slerp:       %7.2f us per skeleton", me->m_time[4]);
+		scene->Print(color, "flat slerp vs list slerp max rotation error: %g", me->m_error);
+		if (!me->m_compressed) {
+			scene->Print(color, "the sequences can not be compressed within the tolerances, compressed tracks sample nothing");
+		}
+		scene->Print(color, "memory, keys: %d bytes, compressed: %d bytes, baked frames: %d bytes", me->m_keysMemory, me->m_compressedMemory, me->m_framesMemory);
+		scene->Print(color, "compressed vs keys max error, position: %g, rotation: %g radians", me->m_compressedPositError, me->m_compressedRotationError);
+	}
+
+	static const int m_testsCount = 4;
+	static const int m_framesCount = 20;
+	static const int m_skeletonsCount = 500;
+	int m_bonesCount;
+	int m_frames;
+	int m_keysMemory;
+	int m_compressedMemory;
+	int m_framesMemory;
+	dFloat m_error;
+	dFloat m_compressedPositError;
+	dFloat m_compressedRotationError;
+	dFloat m_time[m_testsCount + 1];
+	bool m_compressed;
+};
+
+void AnimationBlendingBenchmarkScene(DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+
+	// load the scene from a ngd file format
+	CreateLevelMesh(scene, "flatPlane.ngd", false);
+
+	new AnimationBlendingBenchmark(scene);
+
+	// place camera into position
+	dQuaternion rot;
+	dVector origin(-15.0f, 5.0f, 0.0f, 0.0f);
+	scene->SetCameraMatrix(rot, origin);
+}
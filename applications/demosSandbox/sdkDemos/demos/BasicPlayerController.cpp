@@ -391,3 +391,96 @@ void BasicPlayerController (DemoEntityManager* const scene)
 	scene->SetCameraMatrix(rot, origin);
 }
 
+
+class PlayerControllersBenchmarkManager: public dCustomPlayerControllerManager
+{
+	public:
+	PlayerControllersBenchmarkManager (DemoEntityManager* const scene)
+		:dCustomPlayerControllerManager (scene->GetNewton())
+		,m_controllerCount(0)
+	{
+		scene->Set2DDisplayRenderFunction (RenderHelpMenu, NULL, this);
+	}
+
+	static void RenderHelpMenu(DemoEntityManager* const scene, void* const context)
+	{
+		PlayerControllersBenchmarkManager* const me = (PlayerControllersBenchmarkManager*)context;
+
+		NewtonWorldStepStats stats[64];
+		const int count = NewtonWorldGetStepStats(me->GetWorld(), stats, 64);
+		dFloat stepTime = 0.0f;
+		for (int i = 0; i < count; i++) {
+			stepTime += stats[i].m_totalTime;
+		}
+		const dFloat scale = 1.0f / dMax(count, 1);
+
+		dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+		scene->Print(color, "player controllers: %d, average of the last %d steps", me->m_controllerCount, count);
+		scene->Print(color, "step: %.3f ms", stepTime * scale * 1.0e-3f);
+	}
+
+	void CreatePlayers (DemoEntityManager* const scene, int count)
+	{
+		dMatrix localAxis(dGetIdentityMatrix());
+		localAxis[0] = dVector (0.0, 1.0f, 0.0f, 0.0f);
+		localAxis[1] = dVector (1.0, 0.0f, 0.0f, 0.0f);
+		localAxis[2] = localAxis[0].CrossProduct(localAxis[1]);
+
+		DemoMesh* geometry = NULL;
+		const int side = int (dSqrt (dFloat (count)));
+		const dFloat spacing = 2.5f;
+		for (int i = 0; i < count; i ++) {
+			dMatrix location (dGetIdentityMatrix());
+			location.m_posit.m_x = (i % side - side / 2) * spacing;
+			location.m_posit.m_z = (i / side - side / 2) * spacing;
+			location.m_posit = FindFloor (scene->GetNewton(), location.m_posit + dVector (0.0f, 100.0f, 0.0f, 0.0f), 200.0f);
+			location.m_posit.m_y += 0.5f;
+			location.m_posit.m_w = 1.0f;
+
+			dCustomPlayerController* const controller = CreateController(location, localAxis, PLAYER_MASS, 0.4f, 1.8f, 0.6f);
+			controller->SetHeadingAngle (dFloat (i % 17) * 0.35f - 3.0f);
+
+			NewtonBody* const body = controller->GetBody();
+			if (!geometry) {
+				geometry = new DemoMesh("player", scene->GetShaderCache(), NewtonBodyGetCollision(body), "smilli.tga", "smilli.tga", "smilli.tga");
+			}
+
+			DemoEntity* const playerEntity = new DemoEntity(location, NULL);
+			scene->Append(playerEntity);
+			playerEntity->SetMesh(geometry, dGetIdentityMatrix());
+			NewtonBodySetUserData(body, playerEntity);
+			NewtonBodySetTransformCallback(body, DemoEntity::TransformCallback);
+			controller->SetUserData(playerEntity);
+		}
+		if (geometry) {
+			geometry->Release();
+		}
+		m_controllerCount = count;
+	}
+
+	virtual void ApplyMove (dCustomPlayerController* const controller, dFloat timestep)
+	{
+		dFloat g = 2.0f * DEMO_GRAVITY;
+		dVector gravity(controller->GetFrame().RotateVector(dVector(g, 0.0f, 0.0f, 0.0f)));
+		controller->SetImpulse(controller->GetImpulse() + gravity.Scale (controller->GetMass() * timestep));
+		controller->SetForwardSpeed(PLAYER_WALK_SPEED * 0.5f);
+	}
+
+	int m_controllerCount;
+};
+
+void PlayerControllersBenchmark (DemoEntityManager* const scene)
+{
+	// load the sky box
+	scene->CreateSkyBox();
+
+	CreateHeightFieldTerrain(scene, HEIGHTFIELD_DEFAULT_SIZE, HEIGHTFIELD_DEFAULT_CELLSIZE, 1.5f, 0.2f, 200.0f, -50.0f);
+
+	// ten thousand players walking on a height field
+	PlayerControllersBenchmarkManager* const playerManager = new PlayerControllersBenchmarkManager (scene);
+	playerManager->CreatePlayers (scene, 10000);
+
+	dVector origin (-140.0f, 40.0f, 0.0f, 0.0f);
+	dQuaternion rot (dVector (0.0f, 0.0f, 1.0f, 0.0f), -20.0f * dDegreeToRad);
+	scene->SetCameraMatrix(rot, origin);
+}
@@ -358,3 +358,40 @@ void PassiveRagdoll (DemoEntityManager* const scene)
 	dQuaternion rot;
 	scene->SetCameraMatrix(rot, origin);
 }
+
+// stress test for the skeleton solver, many copies of the same rag doll dropped in a tight pile 
+// so that they end up in one large island, identical skeletons are solved together, one per simd lane.
+void RagdollPile (DemoEntityManager* const scene)
+{
+	// load the sky box
+	scene->CreateSkyBox();
+
+	CreateLevelMesh (scene, "flatPlane.ngd", true);
+
+	// load a skeleton mesh 
+	dPointer<DemoEntity> ragDollModel (DemoEntity::LoadNGD_mesh("whiteman.ngd", scene->GetNewton(), scene->GetShaderCache()));
+
+	//  create a skeletal transform controller for controlling rag doll
+	PassiveRagdollManager* const manager = new PassiveRagdollManager (scene);
+
+	NewtonWorld* const world = scene->GetNewton();
+	dMatrix matrix (dGetIdentityMatrix());
+	dVector origin (FindFloor (world, dVector (0.0f, 50.0f, 0.0f, 1.0f), 2.0f * 50.0f));
+
+	const int count = 4;
+	const int layers = 8;
+	for (int y = 0; y < layers; y ++) {
+		dMatrix layerMatrix (dYawMatrix((y & 1) ? dFloat (0.5f * dPi) : dFloat (0.0f)));
+		for (int x = 0; x < count; x ++) {
+			for (int z = 0; z < count; z ++) {
+				layerMatrix.m_posit = origin + dVector ((x - count / 2) * 0.75f, 2.0f + y * 2.5f, (z - count / 2) * 0.75f, 0.0f);
+				manager->CreateRagDoll(layerMatrix, &(*ragDollModel));
+			}
+		}
+	}
+
+	origin.m_x -= 10.0f;
+	origin.m_y += 4.0f;
+	dQuaternion rot;
+	scene->SetCameraMatrix(rot, origin);
+}
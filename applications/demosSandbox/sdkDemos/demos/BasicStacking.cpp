@@ -17,6 +17,7 @@
 #include "DemoCamera.h"
 #include "DemoMesh.h"
 #include "PhysicsUtils.h"
+#include "dCustomListener.h"
 
 // Dave: my old code in lua script
 static void BuildTower(DemoEntityManager* const scene, dFloat spacing, dFloat separspace, dFloat mass, const dVector& origin, dFloat dpt, dFloat hgt, dFloat wdt, dFloat towercount, dFloat towerHigh, dFloat towerboxcount)
@@ -414,3 +415,261 @@ high = 10;
 }
 
 
+
+static void HeavyOnLightStack(DemoEntityManager* const scene, dFloat mass, dFloat massRatio, const dVector& origin, const dVector& size, int count)
+{
+	// a stack where every box is heavier than the one below, very hard for an iterative solver
+	NewtonWorld* const world = scene->GetNewton();
+
+	dVector blockBoxSize(size.Scale(2.0f));
+	dMatrix baseMatrix(dGetIdentityMatrix());
+	baseMatrix.m_posit.m_x = origin.m_x;
+	baseMatrix.m_posit.m_z = origin.m_z;
+
+	dFloat startElevation = 100.0f;
+	dVector floor(FindFloor(world, dVector(baseMatrix.m_posit.m_x, startElevation, baseMatrix.m_posit.m_z, 0.0f), 2.0f * startElevation));
+	baseMatrix.m_posit.m_y = floor.m_y + blockBoxSize.m_y * 0.5f;
+
+	int defaultMaterialID = NewtonMaterialGetDefaultGroupID(world);
+	NewtonCollision* const collision = CreateConvexCollision(world, dGetIdentityMatrix(), blockBoxSize, _BOX_PRIMITIVE, defaultMaterialID);
+	DemoMesh* const geometry = new DemoMesh("box", scene->GetShaderCache(), collision, "wood_1.tga", "wood_1.tga", "wood_1.tga");
+
+	const dFloat scale = dPow (massRatio, 1.0f / dMax (count - 1, 1));
+	for (int i = 0; i < count; i++) {
+		CreateSimpleSolid(scene, geometry, mass, baseMatrix, collision, defaultMaterialID);
+		baseMatrix.m_posit.m_y += blockBoxSize.m_y;
+		mass *= scale;
+	}
+
+	geometry->Release();
+	NewtonDestroyCollision(collision);
+}
+
+// a field of ordinary pyramids with a few stiff heavy on light stacks,
+// only the islands with a large mass ratio get the extra solver sub steps.
+void StiffIslandStacks (DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+
+	CreateLevelMesh (scene, "flatPlane.ngd", 0);
+
+	NewtonWorld* const world = scene->GetNewton();
+	NewtonSetStiffIslandSubsteps (world, 50.0f, 4);
+
+	const int high = 8;
+	for (int i = 0; i < 4; i ++) {
+		for (int j = 0; j < 4; j ++) {
+			BuildPyramid (scene, 10.0f, dVector(i * 10.0f, 0.0f, j * 10.0f, 0.0f), dVector (0.5f, 0.25f, 0.8f, 0.0f), high, _BOX_PRIMITIVE);
+		}
+	}
+
+	for (int i = 0; i < 4; i ++) {
+		HeavyOnLightStack (scene, 1.0f, 200.0f, dVector(-10.0f, 0.0f, i * 10.0f, 0.0f), dVector (0.5f, 0.25f, 0.5f, 0.0f), 6);
+	}
+
+	// place camera into position
+	dQuaternion rot;
+	dVector origin(-40.0f, 10.0f, 15.0f, 0.0f);
+	scene->SetCameraMatrix(rot, origin);
+}
+
+
+// steps a single threaded copy of the scene next to the demo world and compares the state hash
+// of both worlds after every sub step, with deterministic mode on changing the thread count
+// from the options menu must never make them diverge.
+class DeterministicReplayListener: public dCustomListener
+{
+	public:
+	DeterministicReplayListener(DemoEntityManager* const scene)
+		:dCustomListener(scene->GetNewton(), "Deterministic replay")
+		,m_shadowWorld(NewtonCreate())
+		,m_steps(0)
+		,m_firstMismatch(-1)
+	{
+		NewtonSetThreadsCount(m_shadowWorld, 1);
+		NewtonSetDeterministicMode(m_shadowWorld, 1);
+		NewtonSetDeterministicMode(scene->GetNewton(), 1);
+		scene->Set2DDisplayRenderFunction(RenderHelpMenu, NULL, this);
+	}
+
+	~DeterministicReplayListener()
+	{
+		NewtonDestroy(m_shadowWorld);
+	}
+
+	NewtonWorld* GetShadowWorld() const
+	{
+		return m_shadowWorld;
+	}
+
+	private:
+	virtual void PostUpdate(dFloat timestep)
+	{
+		// this is called once for each sub step of the demo world,
+		// so the shadow world is stepped with a single sub step.
+		NewtonWorld* const world = GetWorld();
+		NewtonSetSolverIterations(m_shadowWorld, NewtonGetSolverIterations(world));
+		NewtonSetParallelSolverOnLargeIsland(m_shadowWorld, NewtonGetParallelSolverOnLargeIsland(world));
+		NewtonSelectBroadphaseAlgorithm(m_shadowWorld, NewtonGetBroadphaseAlgorithm(world));
+		NewtonUpdate(m_shadowWorld, timestep);
+
+		if ((m_firstMismatch < 0) && (NewtonWorldGetStateHash(world) != NewtonWorldGetStateHash(m_shadowWorld))) {
+			m_firstMismatch = m_steps;
+		}
+		m_steps ++;
+	}
+
+	static void RenderHelpMenu(DemoEntityManager* const scene, void* const context)
+	{
+		DeterministicReplayListener* const me = (DeterministicReplayListener*)context;
+		dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+		scene->Print(color, "threads: %d, steps: %d", NewtonGetThreadsCount(me->GetWorld()), me->m_steps);
+		if (me->m_firstMismatch < 0) {
+			scene->Print(color, "state hash matches the single thread replay");
+		} else {
+			scene->Print(dVector(1.0f, 0.0f, 0.0f, 0.0f), "state hash diverged at step %d", me->m_firstMismatch);
+		}
+	}
+
+	NewtonWorld* m_shadowWorld;
+	int m_steps;
+	int m_firstMismatch;
+};
+
+static void AddReplayBox(DemoEntityManager* const scene, NewtonWorld* const shadowWorld, DemoMesh* const geometry, dFloat mass, const dMatrix& matrix, const dVector& size)
+{
+	// same body in both worlds, created in the same order so that the unique ids match
+	NewtonWorld* const world = scene->GetNewton();
+	NewtonCollision* const collision = CreateConvexCollision(world, dGetIdentityMatrix(), size, _BOX_PRIMITIVE, 0);
+	CreateSimpleSolid(scene, geometry, mass, matrix, collision, NewtonMaterialGetDefaultGroupID(world));
+	NewtonDestroyCollision(collision);
+
+	NewtonCollision* const shadowCollision = CreateConvexCollision(shadowWorld, dGetIdentityMatrix(), size, _BOX_PRIMITIVE, 0);
+	NewtonBody* const shadowBody = CreateSimpleBody(shadowWorld, NULL, mass, matrix, shadowCollision, NewtonMaterialGetDefaultGroupID(shadowWorld));
+	NewtonBodySetTransformCallback(shadowBody, NULL);
+	NewtonBodySetDestructorCallback(shadowBody, NULL);
+	NewtonDestroyCollision(shadowCollision);
+}
+
+// a few box pyramids simulated in deterministic mode and checked against a single thread replay
+void DeterministicStacks (DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+
+	NewtonWorld* const world = scene->GetNewton();
+	DeterministicReplayListener* const replay = new DeterministicReplayListener(scene);
+	NewtonWorld* const shadowWorld = replay->GetShadowWorld();
+
+	dMatrix matrix(dGetIdentityMatrix());
+	dVector floorSize(200.0f, 1.0f, 200.0f, 0.0f);
+	NewtonCollision* const floorShape = CreateConvexCollision(world, dGetIdentityMatrix(), floorSize, _BOX_PRIMITIVE, 0);
+	DemoMesh* const floorMesh = new DemoMesh("floor", scene->GetShaderCache(), floorShape, "wood_4.tga", "wood_4.tga", "wood_4.tga");
+	NewtonDestroyCollision(floorShape);
+	matrix.m_posit.m_y = -0.5f;
+	AddReplayBox(scene, shadowWorld, floorMesh, 0.0f, matrix, floorSize);
+	floorMesh->Release();
+
+	const int high = 12;
+	dVector size(1.0f, 0.5f, 1.6f, 0.0f);
+	NewtonCollision* const boxShape = CreateConvexCollision(world, dGetIdentityMatrix(), size, _BOX_PRIMITIVE, 0);
+	DemoMesh* const boxMesh = new DemoMesh("box", scene->GetShaderCache(), boxShape, "wood_1.tga", "wood_1.tga", "wood_1.tga");
+	NewtonDestroyCollision(boxShape);
+	for (int i = 0; i < 3; i ++) {
+		for (int j = 0; j < 3; j ++) {
+			for (int k = 0; k < high; k ++) {
+				for (int n = 0; n < high - k; n ++) {
+					matrix.m_posit = dVector(i * 20.0f + (n - (high - k) * 0.5f) * size.m_x * 1.01f, (k + 0.5f) * size.m_y, j * 10.0f, 1.0f);
+					AddReplayBox(scene, shadowWorld, boxMesh, 10.0f, matrix, size);
+				}
+			}
+		}
+	}
+	boxMesh->Release();
+
+	// place camera into position
+	dQuaternion rot;
+	dVector origin(-40.0f, 10.0f, 15.0f, 0.0f);
+	scene->SetCameraMatrix(rot, origin);
+}
+
+
+// shows the narrow phase time of a pile of convex hulls, the support vertex search dominates for hulls with many points
+class ConvexHullContactStats: public dCustomListener
+{
+	public:
+	ConvexHullContactStats(DemoEntityManager* const scene, int vertexCount)
+		:dCustomListener(scene->GetNewton(), "Convex hull contact stats")
+		,m_vertexCount(vertexCount)
+	{
+		scene->Set2DDisplayRenderFunction(RenderHelpMenu, NULL, this);
+	}
+
+	static void RenderHelpMenu(DemoEntityManager* const scene, void* const context)
+	{
+		ConvexHullContactStats* const me = (ConvexHullContactStats*)context;
+
+		NewtonWorldStepStats stats[64];
+		const int count = NewtonWorldGetStepStats(me->GetWorld(), stats, 64);
+		dFloat contacts = 0.0f;
+		dFloat contactTime = 0.0f;
+		dFloat stepTime = 0.0f;
+		for (int i = 0; i < count; i++) {
+			contacts += stats[i].m_contactCount;
+			contactTime += stats[i].m_contactsTime;
+			stepTime += stats[i].m_totalTime;
+		}
+		const dFloat scale = 1.0f / dMax(count, 1);
+
+		dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+		scene->Print(color, "hulls with %d vertices, average of the last %d steps", me->m_vertexCount, count);
+		scene->Print(color, "contact points: %d", int(contacts * scale));
+		scene->Print(color, "narrow phase: %.3f ms  step: %.3f ms", contactTime * scale * 1.0e-3f, stepTime * scale * 1.0e-3f);
+	}
+
+	int m_vertexCount;
+};
+
+void ConvexHullContactsBenchmark (DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+
+	// load the scene from a ngd file format
+	CreateLevelMesh(scene, "flatPlane.ngd", false);
+
+	NewtonWorld* const world = scene->GetNewton();
+
+	// an ellipsoid sampled with a few hundred points, all of them end up on the hull
+	const int vertexCount = 256;
+	dVector* const cloud = new dVector[vertexCount];
+	dSetRandSeed(1234);
+	for (int i = 0; i < vertexCount; i++) {
+		dVector p(dGaussianRandom(1.0f), dGaussianRandom(1.0f), dGaussianRandom(1.0f), 0.0f);
+		p = p.Scale(1.0f / dSqrt(p.DotProduct3(p) + 1.0e-6f));
+		cloud[i] = dVector(p.m_x * 0.5f, p.m_y * 0.4f, p.m_z * 0.3f, 0.0f);
+	}
+	NewtonCollision* const hull = NewtonCreateConvexHull(world, vertexCount, &cloud[0].m_x, sizeof (dVector), 0.0f, 0, NULL);
+	delete[] cloud;
+
+	DemoMesh* const mesh = new DemoMesh("hull", scene->GetShaderCache(), hull, "smilli.tga", "smilli.tga", "smilli.tga");
+	dMatrix matrix(dGetIdentityMatrix());
+	for (int i = 0; i < 8; i++) {
+		for (int j = 0; j < 8; j++) {
+			for (int k = 0; k < 6; k++) {
+				matrix.m_posit = dVector(i * 0.8f - 3.2f + k * 0.05f, 0.5f + k * 0.75f, j * 0.8f - 3.2f, 1.0f);
+				CreateSimpleSolid(scene, mesh, 1.0f, matrix, hull, 0);
+			}
+		}
+	}
+	mesh->Release();
+	NewtonDestroyCollision(hull);
+
+	new ConvexHullContactStats(scene, vertexCount);
+
+	// place camera into position
+	dQuaternion rot;
+	dVector origin(-15.0f, 5.0f, 0.0f, 0.0f);
+	scene->SetCameraMatrix(rot, origin);
+}
@@ -461,3 +461,101 @@ void CompoundCollision (DemoEntityManager* const scene)
 }
 
 
+// shows the solver rows and step time with and without the manifold reduction of the default material
+class dContactReductionStats: public dCustomListener
+{
+	public:
+	dContactReductionStats(DemoEntityManager* const scene)
+		:dCustomListener(scene->GetNewton(), "Contact reduction stats")
+		,m_reduction(true)
+		,m_applied(false)
+	{
+		Apply();
+		scene->Set2DDisplayRenderFunction(RenderHelpMenu, NULL, this);
+	}
+
+	void Apply()
+	{
+		NewtonWorld* const world = GetWorld();
+		int defaultMaterialID = NewtonMaterialGetDefaultGroupID(world);
+		NewtonMaterialSetContactReduction(world, defaultMaterialID, defaultMaterialID, m_reduction ? 4 : 0, m_reduction ? 8 : 16);
+		m_applied = m_reduction;
+	}
+
+	static void RenderHelpMenu(DemoEntityManager* const scene, void* const context)
+	{
+		dContactReductionStats* const me = (dContactReductionStats*)context;
+
+		NewtonWorldStepStats stats[64];
+		const int count = NewtonWorldGetStepStats(me->GetWorld(), stats, 64);
+		dFloat rows = 0.0f;
+		dFloat contacts = 0.0f;
+		dFloat solverTime = 0.0f;
+		dFloat stepTime = 0.0f;
+		for (int i = 0; i < count; i++) {
+			rows += stats[i].m_rowCount;
+			contacts += stats[i].m_contactCount;
+			solverTime += stats[i].m_solverTime;
+			stepTime += stats[i].m_totalTime;
+		}
+		const dFloat scale = 1.0f / dMax(count, 1);
+
+		dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+		scene->Print(color, "average of the last %d steps", count);
+		scene->Print(color, "contact points: %d  solver rows: %d", int(contacts * scale), int(rows * scale));
+		scene->Print(color, "solver: %.3f ms  step: %.3f ms", solverTime * scale * 1.0e-3f, stepTime * scale * 1.0e-3f);
+		ImGui::Checkbox("4 point manifolds, 8 points per pair", &me->m_reduction);
+		if (me->m_reduction != me->m_applied) {
+			me->Apply();
+		}
+	}
+
+	bool m_reduction;
+	bool m_applied;
+};
+
+// a field of box compounds resting on a height field, most rows come from compound against terrain contacts
+void CompoundContactReduction (DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+	CreateHeightFieldTerrain(scene, HEIGHTFIELD_DEFAULT_SIZE, HEIGHTFIELD_DEFAULT_CELLSIZE, 1.5f, 0.2f, 200.0f, -50.0f);
+
+	NewtonWorld* const world = scene->GetNewton();
+	NewtonCollision* const compound = NewtonCreateCompoundCollision(world, 0);
+	NewtonCompoundCollisionBeginAddRemove(compound);
+	for (int i = 0; i < 6; i++) {
+		dMatrix matrix(dGetIdentityMatrix());
+		matrix.m_posit = dVector((i % 3) * 0.6f - 0.6f, (i & 1) * 0.2f, (i / 3) * 0.6f - 0.3f, 1.0f);
+		NewtonCollision* const box = NewtonCreateBox(world, 0.5f, 0.5f, 0.5f, 0, &matrix[0][0]);
+		NewtonCompoundCollisionAddSubCollision(compound, box);
+		NewtonDestroyCollision(box);
+	}
+	NewtonCompoundCollisionEndAddRemove(compound);
+	DemoMesh* const visualMesh = new DemoMesh("compound", scene->GetShaderCache(), compound, "wood_1.tga", "wood_1.tga", "wood_1.tga");
+
+	dVector origin(100.0f, 0.0f, 100.0f, 0.0f);
+	const int count = 12;
+	for (int ix = 0; ix < count; ix++) {
+		for (int iz = 0; iz < count; iz++) {
+			dMatrix matrix(dGetIdentityMatrix());
+			dFloat x = origin.m_x + ix * 2.5f;
+			dFloat z = origin.m_z + iz * 2.5f;
+			matrix.m_posit = FindFloor(world, dVector(x, 1000.0f, z, 0.0f), 2000.0f);
+			for (int iy = 0; iy < 3; iy++) {
+				matrix.m_posit.m_y += 1.0f;
+				CreateSimpleSolid(scene, visualMesh, 10.0f, matrix, compound, 0);
+			}
+		}
+	}
+	visualMesh->Release();
+	NewtonDestroyCollision(compound);
+
+	new dContactReductionStats(scene);
+
+	dMatrix camMatrix(dRollMatrix(-20.0f * dDegreeToRad) * dYawMatrix(-45.0f * dDegreeToRad));
+	dQuaternion rot(camMatrix);
+	origin = FindFloor(world, dVector(origin.m_x - 10.0f, 1000.0f, origin.m_z - 10.0f, 0.0f), 2000.0f);
+	origin.m_y += 10.0f;
+	scene->SetCameraMatrix(rot, origin);
+}
@@ -78,7 +78,7 @@ static void CreateConvexAproximation (const char* const name, DemoEntityManager*
 
 	// create a convex approximation form the original mesh, 32 convex max and no more than 100 vertex convex hulls
 //	NewtonMesh* const convexApproximation = NewtonMeshApproximateConvexDecomposition (mesh, 0.01f, 0.2f, 32, 100, ReportProgress, scene);
-	NewtonMesh* const convexApproximation = NewtonMeshApproximateConvexDecomposition (mesh, 0.01f, 0.2f, 256, 100, ReportProgress, scene);
+	NewtonMesh* const convexApproximation = NewtonMeshApproximateConvexDecompositionParallel (world, mesh, 0.01f, 0.2f, 256, 100, ReportProgress, scene);
 //	NewtonMesh* const convexApproximation = NewtonMeshApproximateConvexDecomposition (mesh, 0.00001f, 0.0f, 256, 100, ReportProgress, scene);
 
 	// create a compound collision by creation a convex hull of each segment of the source mesh 
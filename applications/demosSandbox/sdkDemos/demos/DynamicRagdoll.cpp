@@ -325,15 +325,17 @@ class dDynamicRagdollManager: public dAnimationModelManager
 		// do nothing for now
 	}
 
-	virtual void OnUpdateTransform(const dAnimationJoint* const bone, const dMatrix& localMatrix) const
+	virtual void OnUpdateTransforms(const dAnimationJointRoot* const model, const dMatrix* const localMatrices) const
 	{
-		// calculate the local transform for this player body
-		NewtonBody* const body = bone->GetBody();
-		DemoEntity* const ent = (DemoEntity*)NewtonBodyGetUserData(body);
-		DemoEntityManager* const scene = (DemoEntityManager*)NewtonWorldGetUserData(NewtonBodyGetWorld(body));
-
-		dQuaternion rot(localMatrix);
-		ent->SetMatrix(*scene, rot, localMatrix.m_posit);
+		// copy the local transforms of all the bones to their entities
+		DemoEntityManager* const scene = (DemoEntityManager*)NewtonWorldGetUserData(GetWorld());
+		for (int i = 0; i < model->GetBonesCount(); i++) {
+			const dMatrix& localMatrix = localMatrices[i];
+			DemoEntity* const ent = (DemoEntity*)NewtonBodyGetUserData(model->GetBone(i)->GetBody());
+
+			dQuaternion rot(localMatrix);
+			ent->SetMatrix(*scene, rot, localMatrix.m_posit);
+		}
 	}
 
 	void OnPreUpdate(dAnimationJointRoot* const model, dFloat timestep)
@@ -16,6 +16,7 @@
 #include "DemoEntityManager.h"
 #include "DemoCamera.h"
 #include "PhysicsUtils.h"
+#include "dHighResolutionTimer.h"
 
 #define INITIAL_DELAY							1000
 #define NUMBER_OF_INTERNAL_PARTS				10
@@ -503,3 +504,76 @@ void SimpleConvexFracturing(DemoEntityManager* const scene)
 
 
 
+
+// cooks voronoi decompositions of a growing number of cells, once on a single thread 
+// world and once on the scene world worker threads, and shows the times side by side
+class VoronoiCookBenchmark: public dCustomListener
+{
+	public:
+	VoronoiCookBenchmark(DemoEntityManager* const scene)
+		:dCustomListener(scene->GetNewton(), "Voronoi cook benchmark")
+		,m_threads(NewtonGetThreadsCount(scene->GetNewton()))
+	{
+		NewtonWorld* const singleThreadWorld = NewtonCreate();
+		for (int i = 0; i < int (sizeof (m_cellCount) / sizeof (m_cellCount[0])); i++) {
+			m_cellCount[i] = 250 << i;
+			int serialPoints;
+			int parallelPoints;
+			m_serialTime[i] = Cook(singleThreadWorld, m_cellCount[i], serialPoints);
+			m_parallelTime[i] = Cook(scene->GetNewton(), m_cellCount[i], parallelPoints);
+			m_match[i] = (serialPoints == parallelPoints);
+		}
+		NewtonDestroy(singleThreadWorld);
+		scene->Set2DDisplayRenderFunction(RenderHelpMenu, NULL, this);
+	}
+
+	static dFloat Cook(NewtonWorld* const world, int cellCount, int& pointCount)
+	{
+		dVector* const points = new dVector[cellCount];
+		dSetRandSeed(1234);
+		for (int i = 0; i < cellCount; i++) {
+			points[i] = dVector(dGaussianRandom(4.0f), dGaussianRandom(4.0f), dGaussianRandom(4.0f), 0.0f);
+		}
+
+		dMatrix textureMatrix(dGetIdentityMatrix());
+		unsigned64 startTime = dGetTimeInMicrosenconds();
+		NewtonMesh* const mesh = NewtonMeshCreateVoronoiConvexDecomposition(world, cellCount, &points[0].m_x, sizeof (dVector), 0, &textureMatrix[0][0]);
+		dFloat time = dFloat (dGetTimeInMicrosenconds() - startTime) * 1.0e-3f;
+		pointCount = NewtonMeshGetPointCount(mesh);
+		NewtonMeshDestroy(mesh);
+		delete[] points;
+		return time;
+	}
+
+	static void RenderHelpMenu(DemoEntityManager* const scene, void* const context)
+	{
+		VoronoiCookBenchmark* const me = (VoronoiCookBenchmark*)context;
+		dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+		scene->Print(color, "voronoi cook time, 1 thread vs %d threads", me->m_threads);
+		for (int i = 0; i < int (sizeof (me->m_cellCount) / sizeof (me->m_cellCount[0])); i++) {
+			scene->Print(color, "%5d cells: %8.1f ms  %8.1f ms  %s", me->m_cellCount[i], me->m_serialTime[i], me->m_parallelTime[i], me->m_match[i] ? "same output" : "output mismatch");
+		}
+	}
+
+	int m_threads;
+	int m_cellCount[4];
+	dFloat m_serialTime[4];
+	dFloat m_parallelTime[4];
+	bool m_match[4];
+};
+
+void VoronoiCookBenchmarkScene(DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+
+	// load the scene from a ngd file format
+	CreateLevelMesh(scene, "flatPlane.ngd", false);
+
+	new VoronoiCookBenchmark(scene);
+
+	// place camera into position
+	dQuaternion rot;
+	dVector origin(-15.0f, 5.0f, 0.0f, 0.0f);
+	scene->SetCameraMatrix(rot, origin);
+}
@@ -777,3 +777,54 @@ void ClothPatch(DemoEntityManager* const scene)
 	dVector origin(location.m_x - 10.0f, 2.0f, location.m_z, 0.0f);
 	scene->SetCameraMatrix(rot, origin);
 }
+
+static void LargeClothStats(DemoEntityManager* const scene, void* const context)
+{
+	NewtonBody* const clothBody = (NewtonBody*)context;
+	NewtonCollision* const clothCollision = NewtonBodyGetCollision(clothBody);
+
+	NewtonWorldStepStats stats[64];
+	const int count = NewtonWorldGetStepStats(scene->GetNewton(), stats, 64);
+	dFloat solverTime = 0.0f;
+	dFloat stepTime = 0.0f;
+	for (int i = 0; i < count; i++) {
+		solverTime += stats[i].m_solverTime;
+		stepTime += stats[i].m_totalTime;
+	}
+	const dFloat scale = 1.0f / dMax(count, 1);
+
+	dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+	scene->Print(color, "average of the last %d steps", count);
+	scene->Print(color, "solver: %.3f ms  step: %.3f ms", solverTime * scale * 1.0e-3f, stepTime * scale * 1.0e-3f);
+
+	bool implicit = NewtonMassSpringDamperSystemGetImplicitIntegration(clothCollision) ? true : false;
+	if (ImGui::Checkbox("implicit integration", &implicit)) {
+		NewtonMassSpringDamperSystemSetImplicitIntegration(clothCollision, implicit ? 1 : 0);
+	}
+
+	bool selfCollision = NewtonDeformableMeshGetSelfCollision(clothCollision) ? true : false;
+	if (ImGui::Checkbox("self collision", &selfCollision)) {
+		NewtonDeformableMeshSetSelfCollision(clothCollision, selfCollision ? 1 : 0);
+	}
+}
+
+// a 316 x 316 cloth, about 100k particles, to measure the cost of the mass spring solver
+void LargeClothPatch(DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+
+	// load the scene from a ngd file format
+	CreateLevelMesh(scene, "flatPlane.ngd", 1);
+
+	dVector location(0.0f, 5.0f, 0.0f, 0.0f);
+
+	SimpleSoftBodyEntity* const entity = new SimpleSoftBodyEntity(scene, location);
+	entity->BuildClothPatch(scene, 316, 316);
+
+	scene->Set2DDisplayRenderFunction(LargeClothStats, NULL, entity->m_body);
+
+	dQuaternion rot;
+	dVector origin(location.m_x - 20.0f, 8.0f, location.m_z, 0.0f);
+	scene->SetCameraMatrix(rot, origin);
+}
@@ -359,6 +359,9 @@ static void AddStructuredFractured (DemoEntityManager* const scene, const dVecto
 	// set the force and torque call back function
 	NewtonBodySetForceAndTorqueCallback (rigidBody, PhysicsApplyGravityForce);
 
+	// lay out the chunks in a flat pool so that breaking does not allocate
+	NewtonFracturedCompoundSetPrecooked (NewtonBodyGetCollision(rigidBody), 1);
+
 	// create the entity and visual mesh and attach to the body as user data
 	CreateVisualEntity (scene, rigidBody);
 
@@ -16,6 +16,7 @@
 #include "DemoEntityManager.h"
 #include "DemoCamera.h"
 #include "PhysicsUtils.h"
+#include "dHighResolutionTimer.h"
 
 
 // the vertex array, vertices's has for values, x, y, z, w
@@ -358,3 +359,101 @@ void UsingNewtonMeshTool (DemoEntityManager* const scene)
 
 //	ExportScene (scene->GetNewton(), "test1.ngd");
 }
+
+
+// builds convex hulls of point clouds of different sizes and distributions, 
+// with the incremental builder and with the quick hull builder running on the world worker threads
+class ConvexHullBenchmark: public dCustomListener
+{
+	public:
+	ConvexHullBenchmark(DemoEntityManager* const scene)
+		:dCustomListener(scene->GetNewton(), "Convex hull benchmark")
+		,m_threads(NewtonGetThreadsCount(scene->GetNewton()))
+	{
+		for (int i = 0; i < m_distributionCount; i++) {
+			for (int j = 0; j < m_sizeCount; j++) {
+				const int count = 1000 * (1 << (2 * j));
+				dVector* const points = new dVector[count];
+				MakeCloud(i, count, points);
+
+				m_count[j] = count;
+				m_serialTime[i][j] = -1.0f;
+				m_serialFaces[i][j] = -1;
+				// the incremental builder is too slow on large clouds with all the points on the hull
+				if ((i != 1) || (count <= 4000)) {
+					unsigned64 startTime = dGetTimeInMicrosenconds();
+					NewtonMesh* const mesh = NewtonMeshCreateConvexHull(scene->GetNewton(), count, &points[0].m_x, sizeof (dVector), 0.0f);
+					m_serialTime[i][j] = dFloat(dGetTimeInMicrosenconds() - startTime) * 1.0e-3f;
+					m_serialFaces[i][j] = NewtonMeshGetTotalFaceCount(mesh);
+					NewtonMeshDestroy(mesh);
+				}
+
+				unsigned64 startTime = dGetTimeInMicrosenconds();
+				NewtonMesh* const mesh = NewtonMeshCreateConvexHullParallel(scene->GetNewton(), count, &points[0].m_x, sizeof (dVector), 0.0f);
+				m_quickTime[i][j] = dFloat(dGetTimeInMicrosenconds() - startTime) * 1.0e-3f;
+				m_quickFaces[i][j] = NewtonMeshGetTotalFaceCount(mesh);
+				NewtonMeshDestroy(mesh);
+				delete[] points;
+			}
+		}
+		scene->Set2DDisplayRenderFunction(RenderHelpMenu, NULL, this);
+	}
+
+	static void MakeCloud(int distribution, int count, dVector* const points)
+	{
+		dSetRandSeed(1234);
+		for (int i = 0; i < count; i++) {
+			dVector p(dGaussianRandom(1.0f), dGaussianRandom(1.0f), dGaussianRandom(1.0f), 0.0f);
+			if (distribution == 0) {
+				// solid box, few points on the hull
+				p = dVector(dFloat(dRand()), dFloat(dRand()), dFloat(dRand()), 0.0f).Scale(2.0f / dFloat(dRAND_MAX)) - dVector(1.0f, 1.0f, 1.0f, 0.0f);
+			} else if (distribution == 1) {
+				// scanned sphere surface, all points on the hull
+				p = p.Scale(1.0f / dSqrt(p.DotProduct3(p) + 1.0e-6f));
+			}
+			points[i] = p;
+		}
+	}
+
+	static void RenderHelpMenu(DemoEntityManager* const scene, void* const context)
+	{
+		ConvexHullBenchmark* const me = (ConvexHullBenchmark*)context;
+		const char* const names[] = {"box", "sphere", "gaussian"};
+		dVector color(1.0f, 1.0f, 0.0f, 0.0f);
+		scene->Print(color, "convex hull build time, incremental vs quick hull on %d threads", me->m_threads);
+		for (int i = 0; i < m_distributionCount; i++) {
+			for (int j = 0; j < m_sizeCount; j++) {
+				if (me->m_serialFaces[i][j] >= 0) {
+					scene->Print(color, "%-8s %6d points: %8.1f ms  %8.1f ms  %6d faces %s", names[i], me->m_count[j], me->m_serialTime[i][j], me->m_quickTime[i][j], me->m_quickFaces[i][j], (me->m_serialFaces[i][j] == me->m_quickFaces[i][j]) ? "" : "face count mismatch");
+				} else {
+					scene->Print(color, "%-8s %6d points:   skipped   %8.1f ms  %6d faces", names[i], me->m_count[j], me->m_quickTime[i][j], me->m_quickFaces[i][j]);
+				}
+			}
+		}
+	}
+
+	static const int m_sizeCount = 4;
+	static const int m_distributionCount = 3;
+	int m_threads;
+	int m_count[m_sizeCount];
+	int m_serialFaces[m_distributionCount][m_sizeCount];
+	int m_quickFaces[m_distributionCount][m_sizeCount];
+	dFloat m_serialTime[m_distributionCount][m_sizeCount];
+	dFloat m_quickTime[m_distributionCount][m_sizeCount];
+};
+
+void ConvexHullBenchmarkScene(DemoEntityManager* const scene)
+{
+	// load the skybox
+	scene->CreateSkyBox();
+
+	// load the scene from a ngd file format
+	CreateLevelMesh(scene, "flatPlane.ngd", false);
+
+	new ConvexHullBenchmark(scene);
+
+	// place camera into position
+	dQuaternion rot;
+	dVector origin(-15.0f, 5.0f, 0.0f, 0.0f);
+	scene->SetCameraMatrix(rot, origin);
+}
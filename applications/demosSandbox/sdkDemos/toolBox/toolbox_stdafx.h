@@ -207,6 +207,7 @@ typedef long long unsigned64;
 #include <dAnimationRagdollJoint.h>
 #include <dAnimationRagDollEffector.h>
 
+#include <dAnimationPose.h>
 #include <dAnimationKeyframesSequence.h>
 
 /*
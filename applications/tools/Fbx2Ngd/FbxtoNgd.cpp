@@ -1086,6 +1086,7 @@ int main(int argc, char** argv)
 {
 	bool importMesh = true;
 	bool importAnimations = true;
+	bool compressAnimations = false;
 	const char* name = NULL;
 	for (int i = 1; i < argc; i ++) {
 		if (argv[i][0] == '-') {
@@ -1095,6 +1096,8 @@ int main(int argc, char** argv)
 			} else if (argv[i][1] == 'a') {
 				importMesh = false;
 				importAnimations = true;
+			} else if (argv[i][1] == 'c') {
+				compressAnimations = true;
 			}
 		} else {
 			name = argv[i];
@@ -1106,6 +1109,7 @@ int main(int argc, char** argv)
 		printf("[fbx_file_name] = fbx file name\n");
 		printf("-m = export mesh only\n");
 		printf("-a = export animation only\n");
+		printf("-c = save compressed animation tracks\n");
 	}
 
 	FbxScene* fbxScene = NULL;
@@ -1134,6 +1138,16 @@ int main(int argc, char** argv)
 		char* ptr = strstr(name, ".fbx");
 		ptr[0] = 0;
 		strcat(name, ".ngd");
+
+		if (compressAnimations) {
+			// a track that can not be compressed within the tolerances is saved as curves
+			for (dScene::dTreeNode* node = ngdScene->GetFirstNode(); node; node = ngdScene->GetNextNode(node)) {
+				dNodeInfo* const info = ngdScene->GetInfoFromNode(node);
+				if (info->IsType(dAnimationTrack::GetRttiType())) {
+					((dAnimationTrack*)info)->Compress();
+				}
+			}
+		}
 		ngdScene->Serialize(name);
 	}
 
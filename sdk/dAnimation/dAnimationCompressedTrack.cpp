@@ -0,0 +1,792 @@
+/* Copyright (c) <2003-2019> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#include "dAnimationStdAfx.h"
+#include "dAnimationKeyframesSequence.h"
+#include "dAnimationCompressedTrack.h"
+
+#define D_COMPRESSED_MAX_BITS			24
+#define D_COMPRESSED_ROTATION_MIN_BITS	6
+#define D_COMPRESSED_ROTATION_MAX_BITS	16
+#define D_COMPRESSED_ROTATION_RANGE		dFloat(0.707106781f)
+#define D_COMPRESSED_MAX_GRID_REFINE	4
+#define D_COMPRESSED_CHANNEL_WORDS		13
+#define D_COMPRESSED_HEADER_WORDS		(2 + 3 * D_COMPRESSED_CHANNEL_WORDS)
+
+static int dBitsCount(unsigned value)
+{
+	int bits = 0;
+	for (; value; value >>= 1) {
+		bits++;
+	}
+	return bits;
+}
+
+// the stream always has one word past the last key, so a read can fetch two words.
+// a field of no bits, like the frame of a single key, may sit past the last key and is not read.
+inline static unsigned dReadBits(const unsigned* const stream, int bitOffset, int bits)
+{
+	dAssert(bits <= D_COMPRESSED_MAX_BITS);
+	if (!bits) {
+		return 0;
+	}
+	const int word = bitOffset >> 5;
+	const unsigned dLong value = ((unsigned dLong)stream[word + 1] << 32) | (unsigned dLong)stream[word];
+	return unsigned(value >> (bitOffset & 31)) & ((1u << bits) - 1);
+}
+
+// the serialized track stores floats as their 32 bit pattern, so that it loads the same in float and double builds
+static int dFloatToWord(dFloat value)
+{
+	union {
+		float m_float;
+		int m_word;
+	} cast;
+	cast.m_float = float(value);
+	return cast.m_word;
+}
+
+static dFloat dWordToFloat(int word)
+{
+	union {
+		float m_float;
+		int m_word;
+	} cast;
+	cast.m_word = word;
+	return dFloat(cast.m_float);
+}
+
+// also false for nan
+static bool dIsValidFloat(dFloat value)
+{
+	return dAbs(value) < dFloat(1.0e20f);
+}
+
+// quaternions are kept in dVector while compressing, w goes in the w component.
+// dVector arithmetic leaves w untouched, so these do all four components by hand.
+static dFloat dDotProduct4(const dVector& q0, const dVector& q1)
+{
+	return q0.m_x * q1.m_x + q0.m_y * q1.m_y + q0.m_z * q1.m_z + q0.m_w * q1.m_w;
+}
+
+static dVector dNlerp(const dVector& q0, const dVector& q1, dFloat param)
+{
+	dVector q;
+	const dFloat s0 = dFloat(1.0f) - param;
+	const dFloat s1 = (dDotProduct4(q0, q1) >= dFloat(0.0f)) ? param : -param;
+	for (int i = 0; i < 4; i++) {
+		q[i] = q0[i] * s0 + q1[i] * s1;
+	}
+	const dFloat invMag = dFloat(1.0f) / dSqrt(dDotProduct4(q, q));
+	for (int i = 0; i < 4; i++) {
+		q[i] *= invMag;
+	}
+	return q;
+}
+
+// angle of the rotation between two unit quaternions, from the chord length
+// since the acos of a dot product close to one loses most of its precision
+static dFloat dRotationError(const dVector& q0, const dVector& q1)
+{
+	dFloat chord2 = dFloat(0.0f);
+	const dFloat sign = (dDotProduct4(q0, q1) >= dFloat(0.0f)) ? dFloat(1.0f) : dFloat(-1.0f);
+	for (int i = 0; i < 4; i++) {
+		const dFloat diff = q0[i] - q1[i] * sign;
+		chord2 += diff * diff;
+	}
+	return dFloat(4.0f) * dAsin(dMin(dFloat(dSqrt(chord2)) * dFloat(0.5f), dFloat(1.0f)));
+}
+
+// smallest three: drop the largest component, which is rebuilt from the unit length
+static void dEncodeRotation(const dVector& rotation, int bits, unsigned* const code)
+{
+	int index = 0;
+	for (int i = 1; i < 4; i++) {
+		if (dAbs(rotation[i]) > dAbs(rotation[index])) {
+			index = i;
+		}
+	}
+	const dFloat sign = (rotation[index] < dFloat(0.0f)) ? dFloat(-1.0f) : dFloat(1.0f);
+	const int maxValue = (1 << bits) - 1;
+	const dFloat scale = dFloat(maxValue) / (dFloat(2.0f) * D_COMPRESSED_ROTATION_RANGE);
+
+	code[0] = unsigned(index);
+	for (int i = 0, j = 0; i < 4; i++) {
+		if (i != index) {
+			const int value = int(dFloor((rotation[i] * sign + D_COMPRESSED_ROTATION_RANGE) * scale + dFloat(0.5f)));
+			code[j + 1] = unsigned(dClamp(value, 0, maxValue));
+			j++;
+		}
+	}
+}
+
+static dFloat dRotationStep(int bits)
+{
+	return dFloat(2.0f) * D_COMPRESSED_ROTATION_RANGE / dFloat((1 << bits) - 1);
+}
+
+static dVector dDecodeRotation(const unsigned* const code, dFloat step)
+{
+	const int index = int(code[0]);
+
+	dVector q(dFloat(0.0f));
+	dFloat mag2 = dFloat(0.0f);
+	for (int i = 0, j = 0; i < 4; i++) {
+		if (i != index) {
+			q[i] = dFloat(code[j + 1]) * step - D_COMPRESSED_ROTATION_RANGE;
+			mag2 += q[i] * q[i];
+			j++;
+		}
+	}
+	q[index] = dSqrt(dMax(dFloat(1.0f) - mag2, dFloat(0.0f)));
+	return q;
+}
+
+// one channel of a track on its way to the compressed stream. the source curve is sampled
+// at every frame of the grid that covers its keys, and every curve fit is checked against
+// both those samples and the source keys, which are usually not on the grid.
+class dCompressedChannelFit
+{
+	public:
+	dCompressedChannelFit(const dAnimimationKeyFramesTrack& track, int channel, dFloat tolerance)
+		:m_frames()
+		,m_values()
+		,m_keyTimes()
+		,m_keyValues()
+		,m_track(track)
+		,m_tolerance(tolerance)
+		,m_channel(channel)
+		,m_count(0)
+		,m_keysCount(0)
+	{
+		m_keysCount = (channel == 0) ? track.m_position.GetSize() : ((channel == 1) ? track.m_rotation.GetSize() : track.m_scale.GetSize());
+		if (m_keysCount) {
+			m_keyTimes.Resize(m_keysCount);
+			m_keyValues.Resize(m_keysCount);
+			for (int i = 0; i < m_keysCount; i++) {
+				const dFloat time = (channel == 0) ? track.m_position[i].m_time : ((channel == 1) ? track.m_rotation[i].m_time : track.m_scale[i].m_time);
+				m_keyTimes[i] = time;
+				m_keyValues[i] = Evaluate(time);
+			}
+		}
+	}
+
+	// greedy curve fit, every kept key is extended as far as everything it skips can be rebuilt
+	// by interpolating the two ends within the tolerance. returns false if a source key between
+	// two consecutive frames of the grid can not be rebuilt, the grid is too coarse for the curve,
+	// or if the keys do not fit the time field.
+	bool Fit(dFloat framesPerSecond)
+	{
+		m_count = 0;
+		if (!m_keysCount) {
+			return true;
+		}
+
+		// the grid frames outside the keys hold the end values, the same as the sampling does
+		const dFloat time0 = m_keyTimes[0];
+		const dFloat time1 = m_keyTimes[m_keysCount - 1];
+		const int frame0 = int(dFloor(time0 * framesPerSecond));
+		const int frame1 = dMax(int(-dFloor(-time1 * framesPerSecond)), frame0);
+		if ((frame0 < 0) || (frame1 >= (1 << D_COMPRESSED_MAX_BITS))) {
+			// the stream only holds positive frames that fit the time field
+			return false;
+		}
+		m_count = frame1 - frame0 + 1;
+		m_frames.Resize(m_count);
+		m_values.Resize(m_count);
+		for (int i = 0; i < m_count; i++) {
+			m_frames[i] = frame0 + i;
+			m_values[i] = Evaluate(dClamp(dFloat(frame0 + i) / framesPerSecond, time0, time1));
+		}
+		if (m_count == 1) {
+			return true;
+		}
+
+		int source = 0;
+		int fitCount = 1;
+		int i0 = 0;
+		while (i0 < (m_count - 1)) {
+			for (; (source < m_keysCount) && ((m_keyTimes[source] * framesPerSecond) <= dFloat(m_frames[i0])); source++);
+			if (!FitSpan(m_values[i0], m_values[i0 + 1], i0, i0 + 1, source, framesPerSecond)) {
+				return false;
+			}
+			int i1 = i0 + 1;
+			for (; (i1 < (m_count - 1)) && FitSpan(m_values[i0], m_values[i1 + 1], i0, i1 + 1, source, framesPerSecond); i1++);
+
+			// compacting in place is safe, a key is only written over keys already behind i0
+			m_frames[fitCount] = m_frames[i1];
+			m_values[fitCount] = m_values[i1];
+			fitCount++;
+			i0 = i1;
+		}
+		m_count = fitCount;
+
+		// a channel that does not move collapses to a single key
+		if ((m_count == 2) && CollapseToFirst()) {
+			m_count = 1;
+		}
+		return true;
+	}
+
+	dArray<int> m_frames;
+	dArray<dVector> m_values;
+	dArray<dFloat> m_keyTimes;
+	dArray<dVector> m_keyValues;
+	const dAnimimationKeyFramesTrack& m_track;
+	dFloat m_tolerance;
+	int m_channel;
+	int m_count;
+	int m_keysCount;
+
+	private:
+	// the source curve as the keys path samples it, rotations as unit quaternions in a dVector with w in the w component
+	dVector Evaluate(dFloat t) const
+	{
+		dVector value(dFloat(0.0f), dFloat(0.0f), dFloat(0.0f), dFloat(1.0f));
+		if (m_channel == 0) {
+			m_track.InterpolatePosition(t, value);
+		} else if (m_channel == 1) {
+			dQuaternion rotation;
+			m_track.InterpolateRotation(t, rotation);
+			const dFloat invMag = dFloat(1.0f) / dSqrt(rotation.DotProduct(rotation));
+			value = dVector(rotation.m_x * invMag, rotation.m_y * invMag, rotation.m_z * invMag, rotation.m_w * invMag);
+		} else {
+			m_track.InterpolateScale(t, value);
+		}
+		return value;
+	}
+
+	bool FitValue(const dVector& value, const dVector& value0, const dVector& value1, dFloat param) const
+	{
+		if (m_channel == 1) {
+			return dRotationError(value, dNlerp(value0, value1, param)) <= m_tolerance;
+		}
+		const dVector err(value - value0 - (value1 - value0).Scale(param));
+		return err.DotProduct3(err) <= (m_tolerance * m_tolerance);
+	}
+
+	// the grid samples strictly inside the span, and the source keys from index source on that fall before its end
+	bool FitSpan(const dVector& value0, const dVector& value1, int i0, int i1, int source, dFloat framesPerSecond) const
+	{
+		const dFloat frame0 = dFloat(m_frames[i0]);
+		const dFloat frame1 = dFloat(m_frames[i1]);
+		const dFloat den = dFloat(1.0f) / (frame1 - frame0);
+		for (int k = i0 + 1; k < i1; k++) {
+			if (!FitValue(m_values[k], value0, value1, (dFloat(m_frames[k]) - frame0) * den)) {
+				return false;
+			}
+		}
+		for (int k = source; (k < m_keysCount) && ((m_keyTimes[k] * framesPerSecond) < frame1); k++) {
+			if (!FitValue(m_keyValues[k], value0, value1, (m_keyTimes[k] * framesPerSecond - frame0) * den)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool CollapseToFirst() const
+	{
+		if (!FitValue(m_values[1], m_values[0], m_values[0], dFloat(0.0f))) {
+			return false;
+		}
+		for (int k = 0; k < m_keysCount; k++) {
+			if (!FitValue(m_keyValues[k], m_values[0], m_values[0], dFloat(0.0f))) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+dAnimationCompressedTrack::dChannel::dChannel()
+	:m_offset(0)
+	,m_keyBits(0)
+	,m_timeBits(0)
+	,m_keysCount(0)
+{
+	for (int i = 0; i < 3; i++) {
+		m_base[i] = dFloat(0.0f);
+		m_step[i] = dFloat(0.0f);
+		m_bits[i] = 0;
+	}
+}
+
+dAnimationCompressedTrack::dAnimationCompressedTrack()
+	:m_stream()
+	,m_position()
+	,m_rotation()
+	,m_scale()
+	,m_framesPerSecond(dFloat(60.0f))
+	,m_wordsCount(0)
+{
+}
+
+dAnimationCompressedTrack::dAnimationCompressedTrack(const dAnimationCompressedTrack& src)
+	:m_stream()
+	,m_position()
+	,m_rotation()
+	,m_scale()
+	,m_framesPerSecond(dFloat(60.0f))
+	,m_wordsCount(0)
+{
+	*this = src;
+}
+
+dAnimationCompressedTrack::~dAnimationCompressedTrack()
+{
+}
+
+dAnimationCompressedTrack& dAnimationCompressedTrack::operator= (const dAnimationCompressedTrack& src)
+{
+	if (this != &src) {
+		m_position = src.m_position;
+		m_rotation = src.m_rotation;
+		m_scale = src.m_scale;
+		m_framesPerSecond = src.m_framesPerSecond;
+		m_wordsCount = src.m_wordsCount;
+		if (m_wordsCount) {
+			m_stream.Resize(m_wordsCount);
+			memcpy(&m_stream[0], &src.m_stream[0], m_wordsCount * sizeof(unsigned));
+		}
+	}
+	return *this;
+}
+
+void dAnimationCompressedTrack::RemoveAll()
+{
+	m_position = dChannel();
+	m_rotation = dChannel();
+	m_scale = dChannel();
+	m_wordsCount = 0;
+}
+
+int dAnimationCompressedTrack::GetKeysCount() const
+{
+	return m_position.m_keysCount + m_rotation.m_keysCount + m_scale.m_keysCount;
+}
+
+int dAnimationCompressedTrack::GetMemorySize() const
+{
+	return sizeof(dAnimationCompressedTrack) + m_wordsCount * sizeof(unsigned);
+}
+
+void dAnimationCompressedTrack::WriteBits(int bitOffset, unsigned value, int bits)
+{
+	dAssert(value < (1u << bits));
+	if (!bits) {
+		return;
+	}
+	const int word = bitOffset >> 5;
+	dAssert((word + 1) < m_wordsCount);
+	const unsigned dLong bitValue = (unsigned dLong)value << (bitOffset & 31);
+	m_stream[word] |= unsigned(bitValue);
+	m_stream[word + 1] |= unsigned(bitValue >> 32);
+}
+
+bool dAnimationCompressedTrack::Compress(const dAnimimationKeyFramesTrack& track, dFloat framesPerSecond, dFloat positionTolerance, dFloat rotationTolerance, dFloat scaleTolerance)
+{
+	dAssert(framesPerSecond > dFloat(0.0f));
+	RemoveAll();
+
+	// half of the error budget goes to the curve fit, the other half to the quantization.
+	// source keys that fall between the frames of the grid can put a corner in the curve
+	// that no fit over the grid rebuilds, the grid is made finer until it does.
+	dCompressedChannelFit position(track, 0, positionTolerance * dFloat(0.5f));
+	dCompressedChannelFit rotation(track, 1, rotationTolerance * dFloat(0.5f));
+	dCompressedChannelFit scale(track, 2, scaleTolerance * dFloat(0.5f));
+	for (int i = 0; !(position.Fit(framesPerSecond) && rotation.Fit(framesPerSecond) && scale.Fit(framesPerSecond)); i++) {
+		if (i == D_COMPRESSED_MAX_GRID_REFINE) {
+			return false;
+		}
+		framesPerSecond *= dFloat(2.0f);
+	}
+	m_framesPerSecond = framesPerSecond;
+
+	int counts[3];
+	dArray<int>* const frames[] = {&position.m_frames, &rotation.m_frames, &scale.m_frames};
+	dArray<dVector>* const values[] = {&position.m_values, &rotation.m_values, &scale.m_values};
+	counts[0] = position.m_count;
+	counts[1] = rotation.m_count;
+	counts[2] = scale.m_count;
+
+	dChannel* const channels[] = {&m_position, &m_rotation, &m_scale};
+	const dFloat tolerances[] = {positionTolerance * dFloat(0.5f), rotationTolerance * dFloat(0.5f), scaleTolerance * dFloat(0.5f)};
+
+	int bitsCount = 0;
+	for (int i = 0; i < 3; i++) {
+		dChannel& channel = *channels[i];
+		channel = dChannel();
+		channel.m_keysCount = counts[i];
+		if (!counts[i]) {
+			continue;
+		}
+
+		channel.m_timeBits = (counts[i] > 1) ? dBitsCount(unsigned((*frames[i])[counts[i] - 1])) : 0;
+		if (i == 1) {
+			// pick the fewest bits that keep every key within the tolerance
+			int bits = D_COMPRESSED_ROTATION_MIN_BITS;
+			for (; bits <= D_COMPRESSED_ROTATION_MAX_BITS; bits++) {
+				dFloat maxError = dFloat(0.0f);
+				for (int j = 0; j < counts[i]; j++) {
+					unsigned code[4];
+					dEncodeRotation((*values[i])[j], bits, code);
+					maxError = dMax(maxError, dRotationError((*values[i])[j], dDecodeRotation(code, dRotationStep(bits))));
+				}
+				if (maxError <= tolerances[i]) {
+					break;
+				}
+			}
+			if (bits > D_COMPRESSED_ROTATION_MAX_BITS) {
+				RemoveAll();
+				return false;
+			}
+			channel.m_bits[0] = bits;
+			channel.m_step[0] = dRotationStep(bits);
+			channel.m_keyBits = channel.m_timeBits + 2 + 3 * bits;
+		} else {
+			// each axis gets its own range, an axis that does not move takes no bits
+			const dFloat step = tolerances[i] / dSqrt(dFloat(3.0f));
+			channel.m_keyBits = channel.m_timeBits;
+			for (int k = 0; k < 3; k++) {
+				dFloat minValue = (*values[i])[0][k];
+				dFloat maxValue = (*values[i])[0][k];
+				for (int j = 1; j < counts[i]; j++) {
+					minValue = dMin(minValue, (*values[i])[j][k]);
+					maxValue = dMax(maxValue, (*values[i])[j][k]);
+				}
+				const dFloat extent = maxValue - minValue;
+				if (extent <= step) {
+					channel.m_base[k] = (maxValue + minValue) * dFloat(0.5f);
+				} else {
+					const dFloat stepsCount = -dFloor(-extent / step);
+					if (stepsCount > dFloat((1 << D_COMPRESSED_MAX_BITS) - 1)) {
+						// the range is too large for the tolerance
+						RemoveAll();
+						return false;
+					}
+					const int bits = dBitsCount(unsigned(stepsCount));
+					channel.m_bits[k] = bits;
+					channel.m_base[k] = minValue;
+					channel.m_step[k] = extent / dFloat((1 << bits) - 1);
+				}
+				channel.m_keyBits += channel.m_bits[k];
+			}
+		}
+		channel.m_offset = bitsCount;
+		bitsCount += channel.m_keyBits * counts[i];
+	}
+
+	// one extra word so that reads can always fetch two words
+	m_wordsCount = ((bitsCount + 31) >> 5) + 1;
+	m_stream.Resize(m_wordsCount);
+	for (int i = 0; i < m_wordsCount; i++) {
+		m_stream[i] = 0;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		const dChannel& channel = *channels[i];
+		for (int j = 0; j < channel.m_keysCount; j++) {
+			int offset = channel.m_offset + j * channel.m_keyBits;
+			WriteBits(offset, unsigned((*frames[i])[j]), channel.m_timeBits);
+			offset += channel.m_timeBits;
+			if (i == 1) {
+				unsigned code[4];
+				dEncodeRotation((*values[i])[j], channel.m_bits[0], code);
+				WriteBits(offset, code[0], 2);
+				offset += 2;
+				for (int k = 1; k < 4; k++) {
+					WriteBits(offset, code[k], channel.m_bits[0]);
+					offset += channel.m_bits[0];
+				}
+			} else {
+				for (int k = 0; k < 3; k++) {
+					if (channel.m_bits[k]) {
+						const int maxValue = (1 << channel.m_bits[k]) - 1;
+						const int value = int(dFloor(((*values[i])[j][k] - channel.m_base[k]) / channel.m_step[k] + dFloat(0.5f)));
+						WriteBits(offset, unsigned(dClamp(value, 0, maxValue)), channel.m_bits[k]);
+						offset += channel.m_bits[k];
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+int dAnimationCompressedTrack::FindKey(const unsigned* const stream, const dChannel& channel, dFloat frame, dFloat& param) const
+{
+	dAssert(channel.m_keysCount >= 2);
+	int i0 = 0;
+	int i1 = channel.m_keysCount - 1;
+	dFloat frame0 = dFloat(dReadBits(stream, channel.m_offset, channel.m_timeBits));
+	dFloat frame1 = dFloat(dReadBits(stream, channel.m_offset + i1 * channel.m_keyBits, channel.m_timeBits));
+	if (frame <= frame0) {
+		param = dFloat(0.0f);
+		return 0;
+	} else if (frame >= frame1) {
+		param = dFloat(1.0f);
+		return i1 - 1;
+	}
+
+	while ((i1 - i0) > 1) {
+		const int mid = (i1 + i0) >> 1;
+		const dFloat midFrame = dFloat(dReadBits(stream, channel.m_offset + mid * channel.m_keyBits, channel.m_timeBits));
+		if (midFrame <= frame) {
+			i0 = mid;
+			frame0 = midFrame;
+		} else {
+			i1 = mid;
+			frame1 = midFrame;
+		}
+	}
+	param = (frame - frame0) / (frame1 - frame0);
+	return i0;
+}
+
+dVector dAnimationCompressedTrack::DecodeVector(const unsigned* const stream, const dChannel& channel, int key) const
+{
+	dVector value(channel.m_base[0], channel.m_base[1], channel.m_base[2], dFloat(1.0f));
+	int offset = channel.m_offset + key * channel.m_keyBits + channel.m_timeBits;
+	for (int i = 0; i < 3; i++) {
+		if (channel.m_bits[i]) {
+			value[i] += dFloat(dReadBits(stream, offset, channel.m_bits[i])) * channel.m_step[i];
+			offset += channel.m_bits[i];
+		}
+	}
+	return value;
+}
+
+dVector dAnimationCompressedTrack::DecodeRotation(const unsigned* const stream, const dChannel& channel, int key) const
+{
+	unsigned code[4];
+	const int bits = channel.m_bits[0];
+	int offset = channel.m_offset + key * channel.m_keyBits + channel.m_timeBits;
+	code[0] = dReadBits(stream, offset, 2);
+	offset += 2;
+	for (int i = 1; i < 4; i++) {
+		code[i] = dReadBits(stream, offset, bits);
+		offset += bits;
+	}
+	return dDecodeRotation(code, channel.m_step[0]);
+}
+
+dVector dAnimationCompressedTrack::SampleVector(const unsigned* const stream, const dChannel& channel, dFloat frame) const
+{
+	if (channel.m_keysCount == 1) {
+		return DecodeVector(stream, channel, 0);
+	}
+	dFloat param;
+	const int key = FindKey(stream, channel, frame, param);
+	const dVector p0(DecodeVector(stream, channel, key));
+	const dVector p1(DecodeVector(stream, channel, key + 1));
+	return p0 + (p1 - p0).Scale(param);
+}
+
+dQuaternion dAnimationCompressedTrack::SampleRotation(const unsigned* const stream, const dChannel& channel, dFloat frame) const
+{
+	dVector q;
+	if (channel.m_keysCount == 1) {
+		q = DecodeRotation(stream, channel, 0);
+	} else {
+		dFloat param;
+		const int key = FindKey(stream, channel, frame, param);
+		q = dNlerp(DecodeRotation(stream, channel, key), DecodeRotation(stream, channel, key + 1), param);
+	}
+	return dQuaternion(q.m_w, q.m_x, q.m_y, q.m_z);
+}
+
+void dAnimationCompressedTrack::Sample(dFloat t, dVector& posit, dQuaternion& rotation, dVector& scale) const
+{
+	if (!m_wordsCount) {
+		return;
+	}
+	const unsigned* const stream = &m_stream[0];
+	const dFloat frame = t * m_framesPerSecond;
+	if (m_position.m_keysCount) {
+		posit = SampleVector(stream, m_position, frame);
+	}
+	if (m_rotation.m_keysCount) {
+		rotation = SampleRotation(stream, m_rotation, frame);
+	}
+	if (m_scale.m_keysCount) {
+		scale = SampleVector(stream, m_scale, frame);
+	}
+}
+
+void dAnimationCompressedTrack::Decompress(dAnimimationKeyFramesTrack& track) const
+{
+	dAssert(!track.m_position.GetSize() && !track.m_rotation.GetSize() && !track.m_scale.GetSize());
+	if (!m_wordsCount) {
+		return;
+	}
+
+	const unsigned* const stream = &m_stream[0];
+	const dFloat timestep = dFloat(1.0f) / m_framesPerSecond;
+	if (m_position.m_keysCount) {
+		track.m_position.Resize(m_position.m_keysCount);
+		for (int i = 0; i < m_position.m_keysCount; i++) {
+			track.m_position[i].m_time = dFloat(dReadBits(stream, m_position.m_offset + i * m_position.m_keyBits, m_position.m_timeBits)) * timestep;
+			track.m_position[i].m_posit = DecodeVector(stream, m_position, i);
+		}
+	}
+
+	if (m_rotation.m_keysCount) {
+		track.m_rotation.Resize(m_rotation.m_keysCount);
+		for (int i = 0; i < m_rotation.m_keysCount; i++) {
+			dVector q(DecodeRotation(stream, m_rotation, i));
+			if (i) {
+				// consecutive keys in the same hemisphere, the keys path slerps between them
+				const dQuaternion& q0 = track.m_rotation[i - 1].m_rotation;
+				if (dDotProduct4(q, dVector(q0.m_x, q0.m_y, q0.m_z, q0.m_w)) < dFloat(0.0f)) {
+					for (int k = 0; k < 4; k++) {
+						q[k] = -q[k];
+					}
+				}
+			}
+			track.m_rotation[i].m_time = dFloat(dReadBits(stream, m_rotation.m_offset + i * m_rotation.m_keyBits, m_rotation.m_timeBits)) * timestep;
+			track.m_rotation[i].m_rotation = dQuaternion(q.m_w, q.m_x, q.m_y, q.m_z);
+		}
+	}
+
+	if (m_scale.m_keysCount) {
+		track.m_scale.Resize(m_scale.m_keysCount);
+		for (int i = 0; i < m_scale.m_keysCount; i++) {
+			track.m_scale[i].m_time = dFloat(dReadBits(stream, m_scale.m_offset + i * m_scale.m_keyBits, m_scale.m_timeBits)) * timestep;
+			track.m_scale[i].m_scale = DecodeVector(stream, m_scale, i);
+		}
+	}
+}
+
+int dAnimationCompressedTrack::GetSerializedSize() const
+{
+	return D_COMPRESSED_HEADER_WORDS + m_wordsCount;
+}
+
+void dAnimationCompressedTrack::Serialize(int* const buffer) const
+{
+	buffer[0] = dFloatToWord(m_framesPerSecond);
+	buffer[1] = m_wordsCount;
+
+	int* ptr = &buffer[2];
+	const dChannel* const channels[] = {&m_position, &m_rotation, &m_scale};
+	for (int i = 0; i < 3; i++) {
+		const dChannel& channel = *channels[i];
+		ptr[0] = channel.m_keysCount;
+		ptr[1] = channel.m_offset;
+		ptr[2] = channel.m_keyBits;
+		ptr[3] = channel.m_timeBits;
+		for (int k = 0; k < 3; k++) {
+			ptr[4 + k] = channel.m_bits[k];
+			ptr[7 + k] = dFloatToWord(channel.m_base[k]);
+			ptr[10 + k] = dFloatToWord(channel.m_step[k]);
+		}
+		ptr += D_COMPRESSED_CHANNEL_WORDS;
+	}
+
+	for (int i = 0; i < m_wordsCount; i++) {
+		ptr[i] = int(m_stream[i]);
+	}
+}
+
+bool dAnimationCompressedTrack::Deserialize(const int* const buffer, int count)
+{
+	RemoveAll();
+	if (count < D_COMPRESSED_HEADER_WORDS) {
+		return false;
+	}
+	const dFloat framesPerSecond = dWordToFloat(buffer[0]);
+	const int wordsCount = buffer[1];
+	if (!dIsValidFloat(framesPerSecond) || (framesPerSecond <= dFloat(0.0f)) || (wordsCount < 1) || (wordsCount != (count - D_COMPRESSED_HEADER_WORDS))) {
+		return false;
+	}
+
+	const int* ptr = &buffer[2];
+	dChannel* const channels[] = {&m_position, &m_rotation, &m_scale};
+	for (int i = 0; i < 3; i++) {
+		dChannel& channel = *channels[i];
+		channel.m_keysCount = ptr[0];
+		channel.m_offset = ptr[1];
+		channel.m_keyBits = ptr[2];
+		channel.m_timeBits = ptr[3];
+		for (int k = 0; k < 3; k++) {
+			channel.m_bits[k] = ptr[4 + k];
+			channel.m_base[k] = dWordToFloat(ptr[7 + k]);
+			channel.m_step[k] = dWordToFloat(ptr[10 + k]);
+		}
+		ptr += D_COMPRESSED_CHANNEL_WORDS;
+	}
+
+	m_stream.Resize(wordsCount);
+	for (int i = 0; i < wordsCount; i++) {
+		m_stream[i] = unsigned(ptr[i]);
+	}
+	m_framesPerSecond = framesPerSecond;
+	m_wordsCount = wordsCount;
+
+	if (!CheckChannel(m_position, false) || !CheckChannel(m_rotation, true) || !CheckChannel(m_scale, false)) {
+		RemoveAll();
+		return false;
+	}
+	if (m_rotation.m_keysCount) {
+		// not trusted from the buffer, it follows from the bits
+		m_rotation.m_step[0] = dRotationStep(m_rotation.m_bits[0]);
+	}
+	return true;
+}
+
+bool dAnimationCompressedTrack::CheckChannel(const dChannel& channel, bool isRotation) const
+{
+	if (!channel.m_keysCount) {
+		return true;
+	}
+	if ((channel.m_keysCount < 0) || (channel.m_offset < 0) || (channel.m_timeBits < 0) || (channel.m_timeBits > D_COMPRESSED_MAX_BITS)) {
+		return false;
+	}
+	if ((channel.m_keysCount > 1) && !channel.m_timeBits) {
+		return false;
+	}
+
+	int keyBits = channel.m_timeBits;
+	if (isRotation) {
+		if ((channel.m_bits[0] < D_COMPRESSED_ROTATION_MIN_BITS) || (channel.m_bits[0] > D_COMPRESSED_ROTATION_MAX_BITS)) {
+			return false;
+		}
+		keyBits += 2 + 3 * channel.m_bits[0];
+	} else {
+		for (int k = 0; k < 3; k++) {
+			if ((channel.m_bits[k] < 0) || (channel.m_bits[k] > D_COMPRESSED_MAX_BITS) || !dIsValidFloat(channel.m_base[k]) || !dIsValidFloat(channel.m_step[k])) {
+				return false;
+			}
+			keyBits += channel.m_bits[k];
+		}
+	}
+	if (keyBits != channel.m_keyBits) {
+		return false;
+	}
+
+	// the reads fetch two words, the last word of the stream is only ever the second one
+	const dLong endBit = (dLong)channel.m_offset + (dLong)channel.m_keyBits * channel.m_keysCount;
+	if (endBit > ((dLong)(m_wordsCount - 1) << 5)) {
+		return false;
+	}
+
+	// the key search needs the frames to go up
+	const unsigned* const stream = &m_stream[0];
+	unsigned frame0 = dReadBits(stream, channel.m_offset, channel.m_timeBits);
+	for (int i = 1; i < channel.m_keysCount; i++) {
+		const unsigned frame1 = dReadBits(stream, channel.m_offset + i * channel.m_keyBits, channel.m_timeBits);
+		if (frame1 <= frame0) {
+			return false;
+		}
+		frame0 = frame1;
+	}
+	return true;
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) <2003-2019> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#ifndef __D_ANIMATION_COMPRESSED_TRACK_H__
+#define __D_ANIMATION_COMPRESSED_TRACK_H__
+
+#include "dAnimationStdAfx.h"
+
+class dAnimimationKeyFramesTrack;
+
+// key frame track compressed for storage and random access sampling.
+// the source curve is sampled on a frame grid, the samples that can be reconstructed by
+// interpolating their neighbors within the tolerance, at the grid and at the source key times,
+// are removed, and the remaining keys are quantized, rotations with the smallest three encoding. every channel packs its keys at a fix
+// number of bits, so any key can be decoded without decoding the ones before it.
+class dAnimationCompressedTrack
+{
+	public:
+	class dChannel
+	{
+		public:
+		dChannel();
+
+		dFloat m_base[3];
+		dFloat m_step[3];
+		int m_bits[3];
+		int m_offset;
+		int m_keyBits;
+		int m_timeBits;
+		int m_keysCount;
+	};
+
+	dAnimationCompressedTrack();
+	dAnimationCompressedTrack(const dAnimationCompressedTrack& src);
+	~dAnimationCompressedTrack();
+
+	dAnimationCompressedTrack& operator= (const dAnimationCompressedTrack& src);
+
+	// tolerances are the maximum distance for position and scale, and the maximum angle in radians for rotations.
+	// the grid is refined past framesPerSecond where source keys between its frames need it. returns false
+	// and leaves the track empty if a channel can not meet its tolerance at the finest grid or the maximum number of bits.
+	bool Compress(const dAnimimationKeyFramesTrack& track, dFloat framesPerSecond, dFloat positionTolerance, dFloat rotationTolerance, dFloat scaleTolerance);
+
+	// expands the stored keys back to a key frames track, one key per stored frame of each channel
+	void Decompress(dAnimimationKeyFramesTrack& track) const;
+
+	// channels without keys leave their output unchanged
+	void Sample(dFloat t, dVector& posit, dQuaternion& rotation, dVector& scale) const;
+
+	// the track as a flat array of words, so that it can be saved with the rest of a scene.
+	// Deserialize checks that every key can be read back, it returns false and leaves the track empty if not.
+	int GetSerializedSize() const;
+	void Serialize(int* const buffer) const;
+	bool Deserialize(const int* const buffer, int count);
+
+	void RemoveAll();
+	int GetKeysCount() const;
+	int GetMemorySize() const;
+
+	private:
+	bool CheckChannel(const dChannel& channel, bool isRotation) const;
+	void WriteBits(int bitOffset, unsigned value, int bits);
+
+	int FindKey(const unsigned* const stream, const dChannel& channel, dFloat frame, dFloat& param) const;
+	dVector DecodeVector(const unsigned* const stream, const dChannel& channel, int key) const;
+	dVector DecodeRotation(const unsigned* const stream, const dChannel& channel, int key) const;
+	dVector SampleVector(const unsigned* const stream, const dChannel& channel, dFloat frame) const;
+	dQuaternion SampleRotation(const unsigned* const stream, const dChannel& channel, dFloat frame) const;
+
+	dArray<unsigned> m_stream;
+	dChannel m_position;
+	dChannel m_rotation;
+	dChannel m_scale;
+	dFloat m_framesPerSecond;
+	int m_wordsCount;
+};
+
+#endif
+
@@ -19,6 +19,13 @@ dAnimationJointRoot::dAnimationJointRoot(NewtonBody* const body, const dMatrix&
 	,m_staticBody()
 	,m_solver()
 	,m_loopJoints()
+	,m_bones()
+	,m_bodies()
+	,m_parentIndex()
+	,m_bindMatrices()
+	,m_localMatrices()
+	,m_inverseMatrices()
+	,m_bonesCount(0)
 	,m_manager(NULL)
 	,m_managerNode(NULL)
 	,m_calculateLocalTransform(true)
@@ -41,36 +48,52 @@ void dAnimationJointRoot::Finalize()
 {
 	CopyRigidBodyMassToStates();
 	m_solver.Finalize(this);
+	FlattenHierarchy();
 }
 
-void dAnimationJointRoot::UpdateTransforms(dFloat timestep) const
+void dAnimationJointRoot::FlattenHierarchy()
 {
-	if (m_calculateLocalTransform) {
-		dMatrix parentMatrixPool[128];
-		const dAnimationJoint* stackPool[128];
-
-		int stack = 1;
-		stackPool[0] = this;
-		parentMatrixPool[0] = dGetIdentityMatrix();
+	// breadth first, the bone array is its own queue, so parents come first and a rig of any depth fits
+	m_bones[0] = this;
+	m_parentIndex[0] = -1;
+	m_bonesCount = 1;
+	for (int i = 0; i < m_bonesCount; i++) {
+		const dAnimationJoint* const bone = m_bones[i];
+		m_bodies[i] = bone->GetBody();
+		m_bindMatrices[i] = bone->GetBindMatrix();
+		m_localMatrices[i] = dGetIdentityMatrix();
+		m_inverseMatrices[i] = dGetIdentityMatrix();
 
-		while (stack) {
-			dMatrix matrix;
-			stack--;
+		const dAnimationJointChildren& boneChildren = bone->GetChildren();
+		for (dAnimationJointChildren::dListNode* ptrNode = boneChildren.GetFirst(); ptrNode; ptrNode = ptrNode->GetNext()) {
+			m_bones[m_bonesCount] = ptrNode->GetInfo();
+			m_parentIndex[m_bonesCount] = i;
+			m_bonesCount++;
+		}
+	}
+}
 
-			dMatrix parentMatrix(parentMatrixPool[stack]);
-			const dAnimationJoint* const bone = stackPool[stack];
+void dAnimationJointRoot::UpdateTransforms(dFloat timestep)
+{
+	if (m_calculateLocalTransform) {
+		if (!m_bonesCount) {
+			FlattenHierarchy();
+		}
 
-			NewtonBodyGetMatrix(bone->GetBody(), &matrix[0][0]);
-			m_manager->OnUpdateTransform(bone, matrix * parentMatrix * bone->GetBindMatrix());
+		const int* const parentIndex = &m_parentIndex[0];
+		NewtonBody* const* const bodies = &m_bodies[0];
+		const dMatrix* const bindMatrices = &m_bindMatrices[0];
+		dMatrix* const localMatrices = &m_localMatrices[0];
+		dMatrix* const inverseMatrices = &m_inverseMatrices[0];
 
-			parentMatrix = matrix.Inverse();
-			const dAnimationJointChildren& boneChildren = bone->GetChildren();
-			for (dAnimationJointChildren::dListNode* ptrNode = boneChildren.GetFirst(); ptrNode; ptrNode = ptrNode->GetNext()) {
-				parentMatrixPool[stack] = parentMatrix;
-				stackPool[stack] = ptrNode->GetInfo();
-				stack++;
-			}
+		// parents come first, so every bone finds the inverse matrix of its parent already calculated
+		for (int i = 0; i < m_bonesCount; i++) {
+			dMatrix matrix;
+			NewtonBodyGetMatrix(bodies[i], &matrix[0][0]);
+			const int parent = parentIndex[i];
+			localMatrices[i] = (parent >= 0) ? matrix * inverseMatrices[parent] * bindMatrices[i] : matrix * bindMatrices[i];
+			inverseMatrices[i] = matrix.Inverse();
 		}
+		m_manager->OnUpdateTransforms(this, localMatrices);
 	}
 }
-
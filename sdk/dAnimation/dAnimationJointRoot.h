@@ -42,15 +42,30 @@ class dAnimationJointRoot: public dAnimationJoint
 
 	void Finalize();
 
+	// the hierarchy flattened by Finalize, parents always come before their children
+	int GetBonesCount() const;
+	dAnimationJoint* GetBone(int index) const;
+	int GetParentIndex(int index) const;
+	const dMatrix* GetLocalMatrices() const;
+
 	protected:
 	virtual void PreUpdate(dFloat timestep) {};
 	virtual void PostUpdate(dFloat timestep) {};
-	void UpdateTransforms(dFloat timestep) const;
+	void UpdateTransforms(dFloat timestep);
+	void FlattenHierarchy();
 
 	dAnimationBody m_staticBody;
 	dAnimationJointSolver m_solver;
 	dAnimationLoopJointList m_loopJoints;
 
+	dArray<dAnimationJoint*> m_bones;
+	dArray<NewtonBody*> m_bodies;
+	dArray<int> m_parentIndex;
+	dArray<dMatrix> m_bindMatrices;
+	dArray<dMatrix> m_localMatrices;
+	dArray<dMatrix> m_inverseMatrices;
+	int m_bonesCount;
+
 	dAnimationModelManager* m_manager;
 	dList<dAnimationJointRoot*>::dListNode* m_managerNode;
 	bool m_calculateLocalTransform;
@@ -73,6 +88,28 @@ inline dAnimationBody* dAnimationJointRoot::GetStaticWorld()
 	return &m_staticBody;
 }
 
+inline int dAnimationJointRoot::GetBonesCount() const
+{
+	return m_bonesCount;
+}
+
+inline dAnimationJoint* dAnimationJointRoot::GetBone(int index) const
+{
+	dAssert(index < m_bonesCount);
+	return m_bones[index];
+}
+
+inline int dAnimationJointRoot::GetParentIndex(int index) const
+{
+	dAssert(index < m_bonesCount);
+	return m_parentIndex[index];
+}
+
+inline const dMatrix* dAnimationJointRoot::GetLocalMatrices() const
+{
+	return m_bonesCount ? &m_localMatrices[0] : NULL;
+}
+
 inline void dAnimationJointRoot::SetCalculateLocalTransforms(bool val) 
 { 
 	m_calculateLocalTransform = val; 
@@ -59,6 +59,7 @@ dAnimationJointSolver::dAnimationJointSolver()
 	m_pairs = NULL;
 	m_rootNode = NULL;
 	m_nodesOrder = NULL;
+	m_parentIndex = NULL;
 	m_loopJoints = NULL;
 	m_deltaForce = NULL;
 	m_leftHandSide = NULL;
@@ -81,6 +82,9 @@ dAnimationJointSolver::~dAnimationJointSolver()
 	if (m_nodesOrder) {
 		delete[] m_nodesOrder; 
 	}
+	if (m_parentIndex) {
+		delete[] m_parentIndex;
+	}
 }
 
 int dAnimationJointSolver::CalculateNodeCount () const
@@ -130,16 +134,26 @@ void dAnimationJointSolver::Finalize(dAnimationJointRoot* const rootNode)
 	if (m_nodesOrder) {
 		delete m_nodesOrder;
 	}
+	if (m_parentIndex) {
+		delete[] m_parentIndex;
+	}
 
 	m_nodeCount = CalculateNodeCount ();
 	m_maxNodeCount = m_nodeCount * 2 + 8;
 	m_nodesOrder = new dAnimationBody*[m_maxNodeCount * sizeof (dAnimationBody*)];
+	m_parentIndex = new int[m_maxNodeCount];
 
 	int index = 0;
 	SortGraph(rootNode, index);
 	dAssert(index == m_nodeCount);
 	rootNode->GetStaticWorld()->m_index = index;
 	m_nodesOrder[index] = rootNode->GetStaticWorld();
+
+	for (int i = 0; i < m_nodeCount; i++) {
+		const dAnimationJoint* const parent = m_nodesOrder[i]->m_owner->GetParent();
+		m_parentIndex[i] = parent ? parent->m_proxyBody.GetIndex() : -1;
+		dAssert(m_parentIndex[i] > i || !parent);
+	}
 }
 
 void dAnimationJointSolver::CalculateInertiaMatrix(dAnimationJoint* const node) const
@@ -203,7 +217,7 @@ void dAnimationJointSolver::CalculateBodyDiagonal(dAnimationJoint* const child)
 		}
 	}
 	
-	const int parentIndes = child->GetParent()->GetProxyBody()->GetIndex();
+	const int parentIndes = m_parentIndex[index];
 	dSpatialMatrix& bodyMass = m_data[parentIndes].m_body.m_mass;
 	for (int i = 0; i < dof; i++) {
 		const dSpatialVector& Jacobian = copy[i];
@@ -269,7 +283,6 @@ void dAnimationJointSolver::CalculateJacobianBlock(dAnimationJoint* const node)
 
 void dAnimationJointSolver::Factorize(dAnimationJoint* const node)
 {
-	CalculateInertiaMatrix(node);
 	dAnimationContraint* const joint = node->GetProxyJoint();
 	if (joint) {
 		joint->m_ordinals = 0x050403020100ll;
@@ -302,10 +315,7 @@ void dAnimationJointSolver::Factorize(dAnimationJoint* const node)
 	const dSpatialMatrix& bodyMass = m_data[nodeIndex].m_body.m_mass;
 	dSpatialMatrix& bodyInvMass = m_data[nodeIndex].m_body.m_invMass;
 	if (body->GetInvMass() != dFloat32(0.0f)) {
-		const dAnimationJointChildren& children = node->GetChildren();
-		for (dAnimationJointChildren::dListNode* childNode = children.GetFirst(); childNode; childNode = childNode->GetNext()) {
-			CalculateBodyDiagonal(childNode->GetInfo());
-		}
+		// the children already added their diagonal to the mass of this body
 		bodyInvMass = bodyMass.Inverse(6);
 	} else {
 		bodyInvMass = dSpatialMatrix(0.0f);
@@ -319,6 +329,9 @@ void dAnimationJointSolver::Factorize(dAnimationJoint* const node)
 		}
 		CalculateJointDiagonal(node);
 		CalculateJacobianBlock(node);
+		if (m_nodesOrder[m_parentIndex[nodeIndex]]->GetInvMass() != dFloat32(0.0f)) {
+			CalculateBodyDiagonal(node);
+		}
 	}
 }
 
@@ -587,6 +600,11 @@ void dAnimationJointSolver::InitMassMatrix()
 	int auxiliaryRowCount = 0;
 
 	dAssert (m_nodesOrder);
+	// all the inertias first, so that the factorization can add each node diagonal to its parent
+	for (int i = 0; i < m_nodeCount; i++) {
+		CalculateInertiaMatrix(m_nodesOrder[i]->m_owner);
+	}
+
 	for (int i = 0; i < m_nodeCount - 1; i++) {
 		dAnimationJoint* const node = m_nodesOrder[i]->m_owner;
 		Factorize(node);
@@ -784,44 +802,31 @@ void dAnimationJointSolver::SolveForward(dVectorPair* const force, const dVector
 		force[i].m_joint = zero;
 	}
 
-	const int nodeCount = m_nodeCount - 1;
-	for (int i = startNode; i < nodeCount; i++) {
+	const int n = m_nodeCount - 1;
+	dAssert(n == m_nodesOrder[n]->GetIndex());
+	for (int i = startNode; i <= n; i++) {
+		force[i] = accel[i];
+	}
+
+	// children come before their parent, so by the time a node is reached 
+	// all of its children have already added their contribution to it.
+	for (int i = startNode; i < n; i++) {
 		dAnimationJoint* const node = m_nodesOrder[i]->m_owner;
 		dAssert(node->GetProxyJoint());
 		dAssert(i == node->GetProxyBody()->GetIndex());
 
 		dVectorPair& f = force[i];
-		const dVectorPair& a = accel[i];
-		f.m_body = a.m_body;
-		f.m_joint = a.m_joint;
-
-		const dList<dAnimationJoint*>& children = node->GetChildren();
-		for (dList<dAnimationJoint*>::dListNode* childNode = children.GetFirst(); childNode; childNode = childNode->GetNext()) {
-			dAnimationJoint* const child = childNode->GetInfo();
-			dAssert(child->m_parent->GetProxyBody()->GetIndex() == i);
-			BodyJacobianTimeMassForward(child, force[child->GetProxyBody()->GetIndex()], f);
-		}
 		JointJacobianTimeMassForward(node, f);
+		BodyJacobianTimeMassForward(node, f, force[m_parentIndex[i]]);
 	}
 
-	const int n = m_nodeCount - 1;
-	dAssert(n == m_nodesOrder[n]->GetIndex());
-	dAnimationJoint* const rootNode = m_nodesOrder[n]->m_owner;
-	force[n] = accel[n];
-	const dList<dAnimationJoint*>& children = rootNode->GetChildren();
-	for (dList<dAnimationJoint*>::dListNode* childNode = children.GetFirst(); childNode; childNode = childNode->GetNext()) {
-		dAnimationJoint* const child = childNode->GetInfo();
-		dAssert(child->m_parent->GetProxyBody()->GetIndex() == n);
-		BodyJacobianTimeMassForward(child, force[child->GetProxyBody()->GetIndex()], force[n]);
-	}
-
-	for (int i = startNode; i < nodeCount; i++) {
+	for (int i = startNode; i < n; i++) {
 		dAnimationJoint* const node = m_nodesOrder[i]->m_owner;
 		dVectorPair& f = force[i];
 		BodyDiagInvTimeSolution(node, f);
 		JointDiagInvTimeSolution(node, f);
 	}
-	BodyDiagInvTimeSolution(rootNode, force[n]);
+	BodyDiagInvTimeSolution(m_nodesOrder[n]->m_owner, force[n]);
 }
 
 void dAnimationJointSolver::SolveBackward(dVectorPair* const force, const dVectorPair* const accel) const
@@ -830,7 +835,7 @@ void dAnimationJointSolver::SolveBackward(dVectorPair* const force, const dVecto
 		dAnimationJoint* const node = m_nodesOrder[i]->m_owner;
 		dAssert(i == node->GetProxyBody()->GetIndex());
 		dVectorPair& f = force[i];
-		JointJacobianTimeSolutionBackward(node, f, force[node->m_parent->GetProxyBody()->GetIndex()]);
+		JointJacobianTimeSolutionBackward(node, f, force[m_parentIndex[i]]);
 		BodyJacobianTimeSolutionBackward(node, f);
 	}
 }
@@ -71,6 +71,8 @@ class dAnimationJointSolver: public dCustomAlloc
 	dAnimationJointRoot* m_rootNode;
 //	dAnimationJoint** m_nodesOrder;
 	dAnimationBody** m_nodesOrder;
+	// index of the parent of each node in m_nodesOrder, children always come before their parent
+	int* m_parentIndex;
 
 	// cache temporary variables
 	int* m_matrixRowsIndex;
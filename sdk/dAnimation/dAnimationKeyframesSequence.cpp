@@ -106,10 +106,63 @@ void dAnimIKBlendNodeTake::Evaluate(dAnimPose& output, dFloat timestep)
 }
 */
 
+void dAnimimationKeyFramesTrack::InterpolatePosition(dFloat t, dVector& posit) const
+{
+	const int count = m_position.GetSize();
+	if (count == 1) {
+		posit = m_position[0].m_posit;
+	} else if (count) {
+		const int base = m_position.GetIndex(t);
+		const dFloat t0 = m_position[base].m_time;
+		const dFloat t1 = m_position[base + 1].m_time;
+		const dFloat param = dClamp((t - t0) / (t1 - t0 + dFloat(1.0e-6f)), dFloat(0.0f), dFloat(1.0f));
+		const dVector& p0 = m_position[base].m_posit;
+		const dVector& p1 = m_position[base + 1].m_posit;
+		posit = p0 + (p1 - p0).Scale(param);
+	}
+}
+
+void dAnimimationKeyFramesTrack::InterpolateRotation(dFloat t, dQuaternion& rotation) const
+{
+	const int count = m_rotation.GetSize();
+	if (count == 1) {
+		rotation = m_rotation[0].m_rotation;
+	} else if (count) {
+		const int base = m_rotation.GetIndex(t);
+		const dFloat t0 = m_rotation[base].m_time;
+		const dFloat t1 = m_rotation[base + 1].m_time;
+		const dFloat param = dClamp((t - t0) / (t1 - t0 + dFloat(1.0e-6f)), dFloat(0.0f), dFloat(1.0f));
+		const dQuaternion& rot0 = m_rotation[base].m_rotation;
+		const dQuaternion& rot1 = m_rotation[base + 1].m_rotation;
+		rotation = rot0.Slerp(rot1, param);
+	}
+}
+
+void dAnimimationKeyFramesTrack::InterpolateScale(dFloat t, dVector& scale) const
+{
+	const int count = m_scale.GetSize();
+	if (count == 1) {
+		scale = m_scale[0].m_scale;
+	} else if (count) {
+		const int base = m_scale.GetIndex(t);
+		const dFloat t0 = m_scale[base].m_time;
+		const dFloat t1 = m_scale[base + 1].m_time;
+		const dFloat param = dClamp((t - t0) / (t1 - t0 + dFloat(1.0e-6f)), dFloat(0.0f), dFloat(1.0f));
+		const dVector& s0 = m_scale[base].m_scale;
+		const dVector& s1 = m_scale[base + 1].m_scale;
+		scale = s0 + (s1 - s0).Scale(param);
+	}
+}
+
 dAnimationKeyframesSequence::dAnimationKeyframesSequence()
 	:dRefCounter()
 	,m_tracks()
+	,m_compressedTracks()
+	,m_frames()
 	,m_period(1.0f)
+	,m_frameRate(0.0f)
+	,m_frameSize(0)
+	,m_framesCount(0)
 {
 //	for (int i = 0; i < tracksCount; i++) {
 //		m_tracks.Append();
@@ -120,3 +173,118 @@ dAnimationKeyframesSequence::~dAnimationKeyframesSequence()
 {
 }
 
+void dAnimationKeyframesSequence::BuildFrames(dFloat framesPerSecond)
+{
+	dAssert(framesPerSecond > dFloat(0.0f));
+	dAnimationPose pose(m_tracks.GetCount());
+
+	// a zero length clip, like a single key pose, gets two copies of its only frame
+	// and a zero frame rate, so that sampling always reads the first row.
+	const bool hasLength = m_period > dFloat(1.0e-6f);
+	const int intervals = hasLength ? dMax(int(dFloor(m_period * framesPerSecond + dFloat(0.5f))), 1) : 1;
+	m_framesCount = intervals + 1;
+	m_frameRate = hasLength ? dFloat(intervals) / m_period : dFloat(0.0f);
+	m_frameSize = pose.GetBufferSize();
+	m_frames.Resize(m_framesCount * m_frameSize);
+
+	for (int i = 0; i < m_framesCount; i++) {
+		const dFloat t = hasLength ? dMin(dFloat(i) / m_frameRate, m_period) : dFloat(0.0f);
+		pose.SetIdentity();
+		CalculatePoseFromKeys(pose, t);
+		memcpy(&m_frames[i * m_frameSize], pose.GetBuffer(), m_frameSize * sizeof(dFloat));
+	}
+}
+
+bool dAnimationKeyframesSequence::Compress(dFloat framesPerSecond, dFloat positionTolerance, dFloat rotationTolerance, dFloat scaleTolerance)
+{
+	m_compressedTracks.RemoveAll();
+	for (dList<dAnimimationKeyFramesTrack>::dListNode* node = m_tracks.GetFirst(); node; node = node->GetNext()) {
+		dAnimationCompressedTrack& track = m_compressedTracks.Append()->GetInfo();
+		if (!track.Compress(node->GetInfo(), framesPerSecond, positionTolerance, rotationTolerance, scaleTolerance)) {
+			// the sequence keeps sampling the keys
+			m_compressedTracks.RemoveAll();
+			return false;
+		}
+	}
+	return true;
+}
+
+int dAnimationKeyframesSequence::GetKeysMemorySize() const
+{
+	int size = 0;
+	for (dList<dAnimimationKeyFramesTrack>::dListNode* node = m_tracks.GetFirst(); node; node = node->GetNext()) {
+		const dAnimimationKeyFramesTrack& track = node->GetInfo();
+		size += sizeof(dAnimimationKeyFramesTrack);
+		size += track.m_position.GetSize() * sizeof(dAnimimationKeyFramesTrack::dPositionKey);
+		size += track.m_rotation.GetSize() * sizeof(dAnimimationKeyFramesTrack::dRotationKey);
+		size += track.m_scale.GetSize() * sizeof(dAnimimationKeyFramesTrack::dScaleKey);
+	}
+	return size;
+}
+
+int dAnimationKeyframesSequence::GetCompressedMemorySize() const
+{
+	int size = 0;
+	for (dList<dAnimationCompressedTrack>::dListNode* node = m_compressedTracks.GetFirst(); node; node = node->GetNext()) {
+		size += node->GetInfo().GetMemorySize();
+	}
+	return size;
+}
+
+int dAnimationKeyframesSequence::GetFramesMemorySize() const
+{
+	return m_framesCount * m_frameSize * sizeof(dFloat);
+}
+
+void dAnimationKeyframesSequence::CalculatePose(dAnimationPose& output, dFloat t) const
+{
+	if (m_framesCount) {
+		dAssert(output.GetCount() == m_tracks.GetCount());
+		dAssert(output.GetBufferSize() == m_frameSize);
+		const dFloat frame = dClamp(t, dFloat(0.0f), m_period) * m_frameRate;
+		const int index = dMin(int(frame), m_framesCount - 2);
+		const dFloat* const frame0 = &m_frames[index * m_frameSize];
+		output.Blend(frame0, frame0 + m_frameSize, frame - dFloat(index));
+	} else if (m_compressedTracks.GetCount()) {
+		CalculatePoseFromCompressedTracks(output, t);
+	} else {
+		CalculatePoseFromKeys(output, t);
+	}
+}
+
+void dAnimationKeyframesSequence::CalculatePoseFromKeys(dAnimationPose& output, dFloat t) const
+{
+	dAssert(output.GetCount() >= m_tracks.GetCount());
+	t = dClamp(t, dFloat(0.0f), m_period);
+
+	int index = 0;
+	for (dList<dAnimimationKeyFramesTrack>::dListNode* node = m_tracks.GetFirst(); node; node = node->GetNext()) {
+		dVector posit;
+		dVector scale;
+		dQuaternion rotation;
+		const dAnimimationKeyFramesTrack& track = node->GetInfo();
+		output.GetBone(index, posit, rotation, scale);
+		track.InterpolatePosition(t, posit);
+		track.InterpolateRotation(t, rotation);
+		track.InterpolateScale(t, scale);
+		output.SetBone(index, posit, rotation, scale);
+		index++;
+	}
+}
+
+void dAnimationKeyframesSequence::CalculatePoseFromCompressedTracks(dAnimationPose& output, dFloat t) const
+{
+	dAssert(output.GetCount() >= m_compressedTracks.GetCount());
+	t = dClamp(t, dFloat(0.0f), m_period);
+
+	int index = 0;
+	for (dList<dAnimationCompressedTrack>::dListNode* node = m_compressedTracks.GetFirst(); node; node = node->GetNext()) {
+		dVector posit;
+		dVector scale;
+		dQuaternion rotation;
+		output.GetBone(index, posit, rotation, scale);
+		node->GetInfo().Sample(t, posit, rotation, scale);
+		output.SetBone(index, posit, rotation, scale);
+		index++;
+	}
+}
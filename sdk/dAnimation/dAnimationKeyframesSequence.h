@@ -11,11 +11,10 @@
 
 #ifndef __D_ANIMATION_KEYFRAMES_SEQUENCE_h__
 #define __D_ANIMATION_KEYFRAMES_SEQUENCE_h__
-//#include "dAnimPose.h"
+#include "dAnimationPose.h"
+#include "dAnimationCompressedTrack.h"
 //#include "dAnimIKBlendNode.h"
 
-class dAnimPose;
-
 class dAnimimationKeyFramesTrack
 {
 	public:
@@ -33,6 +32,13 @@ class dAnimimationKeyFramesTrack
 		dFloat m_time;
 	};
 
+	class dScaleKey
+	{
+		public:
+		dVector m_scale;
+		dFloat m_time;
+	};
+
 	template<class OBJECT>
 	class dAnimTakeArray: public dArray<OBJECT>
 	{
@@ -74,6 +80,7 @@ class dAnimimationKeyFramesTrack
 	dAnimimationKeyFramesTrack()
 		:m_position()
 		,m_rotation()
+		,m_scale()
 	{
 	}
 
@@ -86,12 +93,14 @@ class dAnimimationKeyFramesTrack
 		m_name = name; 
 	}
 
-	const void InterpolatePosition(dFloat t, dVector &positOut) const;
-	const void InterpolateRotation(dFloat t, dQuaternion& rotationOut) const;
+	void InterpolatePosition(dFloat t, dVector &positOut) const;
+	void InterpolateRotation(dFloat t, dQuaternion& rotationOut) const;
+	void InterpolateScale(dFloat t, dVector &scaleOut) const;
 
 	dString m_name;
 	dAnimTakeArray<dPositionKey> m_position;
 	dAnimTakeArray<dRotationKey> m_rotation;
+	dAnimTakeArray<dScaleKey> m_scale;
 };
 
 class dAnimationKeyframesSequence: public dRefCounter
@@ -105,11 +114,38 @@ class dAnimationKeyframesSequence: public dRefCounter
 	void SetPeriod(dFloat period) { m_period = period;}
 
 	dList<dAnimimationKeyFramesTrack>& GetTracks() { return m_tracks; }
-	
-	void CalculatePose(dAnimPose& output, dFloat t) const;
+
+	// resamples all tracks at a fixed rate into a table of flat poses,
+	// after this the sequence is sampled by blending two consecutive rows
+	// instead of searching the keys of each track.
+	// must be called again if the tracks are edited.
+	void BuildFrames(dFloat framesPerSecond = dFloat(30.0f));
+	int GetFramesCount() const { return m_framesCount; }
+
+	// builds a compressed copy of every track, after this the sequence is
+	// sampled from the compressed tracks unless frames were also baked.
+	// returns false and keeps sampling the keys if a track can not be compressed within the tolerances.
+	// must be called again if the tracks are edited.
+	bool Compress(dFloat framesPerSecond = dFloat(60.0f), dFloat positionTolerance = dFloat(1.0e-4f), dFloat rotationTolerance = dFloat(1.0e-3f), dFloat scaleTolerance = dFloat(1.0e-4f));
+	dList<dAnimationCompressedTrack>& GetCompressedTracks() { return m_compressedTracks; }
+
+	// memory used by each representation of the sequence, in bytes
+	int GetKeysMemorySize() const;
+	int GetCompressedMemorySize() const;
+	int GetFramesMemorySize() const;
+
+	// track i goes to bone i of the output pose
+	void CalculatePose(dAnimationPose& output, dFloat t) const;
+	void CalculatePoseFromKeys(dAnimationPose& output, dFloat t) const;
+	void CalculatePoseFromCompressedTracks(dAnimationPose& output, dFloat t) const;
 	
 	dList<dAnimimationKeyFramesTrack> m_tracks;
+	dList<dAnimationCompressedTrack> m_compressedTracks;
+	dArray<dFloat> m_frames;
 	dFloat m_period;
+	dFloat m_frameRate;
+	int m_frameSize;
+	int m_framesCount;
 };
 
 /*
@@ -15,6 +15,8 @@
 dAnimationModelManager::dAnimationModelManager(NewtonWorld* const world, const char* const name)
 	:dCustomParallelListener(world, name)
 	,m_controllerList()
+	,m_controllerArray()
+	,m_controllerArrayCount(0)
 	,m_timestep(0.0f)
 {
 }
@@ -28,6 +30,7 @@ void dAnimationModelManager::AddModel(dAnimationJointRoot* const model)
 	dAssert(!model->m_managerNode);
 	model->m_manager = this;
 	model->m_managerNode = m_controllerList.Append(model);
+	m_controllerArrayCount = -1;
 }
 
 void dAnimationModelManager::RemoveModel(dAnimationJointRoot* const model)
@@ -38,6 +41,7 @@ void dAnimationModelManager::RemoveModel(dAnimationJointRoot* const model)
 	m_controllerList.Remove(model->m_managerNode);
 	model->m_manager = NULL;
 	model->m_managerNode = NULL;
+	m_controllerArrayCount = -1;
 }
 
 dAnimationJoint* dAnimationModelManager::GetFirstJoint(const dAnimationJointRoot* const model) const
@@ -85,47 +89,52 @@ void dAnimationModelManager::OnPreUpdate(dAnimationJointRoot* const model, dFloa
 	model->PreUpdate(timestep);
 }
 
-void dAnimationModelManager::PreUpdate(dFloat timestep, int threadID)
+void dAnimationModelManager::UpdateControllerArray()
 {
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
+	// a count of -1 means models were added or removed since the array was built
+	if (m_controllerArrayCount == -1) {
+		m_controllerArrayCount = 0;
+		for (dList<dAnimationJointRoot*>::dListNode* node = m_controllerList.GetFirst(); node; node = node->GetNext()) {
+			m_controllerArray[m_controllerArrayCount] = node->GetInfo();
+			m_controllerArrayCount ++;
+		}
+	}
+}
 
+void dAnimationModelManager::PreUpdate(dFloat timestep)
+{
+	D_TRACKTIME();
 	m_timestep = timestep;
-	dList<dAnimationJointRoot*>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
-	if (node) {
-		dAnimationJointRoot* const model = node->GetInfo();
-		//model->PreUpdate(timestep);
-		OnPreUpdate(model, timestep);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
-	}
+	UpdateControllerArray();
+	NewtonParallelFor(GetWorld(), m_controllerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, PreUpdateKernel, this, "dAnimationModelManager");
 }
 
-void dAnimationModelManager::PostUpdate(dFloat timestep, int threadID)
+void dAnimationModelManager::PostUpdate(dFloat timestep)
 {
 	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
+	m_timestep = timestep;
+	UpdateControllerArray();
+	NewtonParallelFor(GetWorld(), m_controllerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, PostUpdateKernel, this, "dAnimationModelManager");
+}
 
-	dList<dAnimationJointRoot*>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+void dAnimationModelManager::PreUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
+{
+	D_TRACKTIME();
+	dAnimationModelManager* const me = (dAnimationModelManager*)context;
+	dAnimationJointRoot** const models = &me->m_controllerArray[startIndex];
+	for (int i = 0; i < count; i++) {
+		me->OnPreUpdate(models[i], me->m_timestep);
 	}
-	if (node) {
-		dAnimationJointRoot* const model = node->GetInfo();
-		OnPostUpdate(model, timestep);
-		model->UpdateTransforms(timestep);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+}
+
+void dAnimationModelManager::PostUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
+{
+	D_TRACKTIME();
+	dAnimationModelManager* const me = (dAnimationModelManager*)context;
+	dAnimationJointRoot** const models = &me->m_controllerArray[startIndex];
+	for (int i = 0; i < count; i++) {
+		dAnimationJointRoot* const model = models[i];
+		me->OnPostUpdate(model, me->m_timestep);
+		model->UpdateTransforms(me->m_timestep);
 	}
 }
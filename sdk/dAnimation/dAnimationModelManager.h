@@ -34,7 +34,10 @@ class dAnimationModelManager: public dCustomParallelListener
 	dAnimationJoint* GetNextJoint(const dAnimationJoint* const joint) const;
 
 	//virtual void OnDebug(dCustomJoint::dDebugDisplay* const debugContext) = 0;
-	virtual void OnUpdateTransform(const dAnimationJoint* const bone, const dMatrix& localMatrix) const = 0;
+
+	// called once per model after the step, localMatrices has one entry for each bone
+	// of the model, in the order of dAnimationJointRoot::GetBone
+	virtual void OnUpdateTransforms(const dAnimationJointRoot* const model, const dMatrix* const localMatrices) const = 0;
 
 	protected:
 	virtual void OnDestroy();
@@ -42,12 +45,18 @@ class dAnimationModelManager: public dCustomParallelListener
 	virtual void OnPostUpdate(dAnimationJointRoot* const model, dFloat timestep) {}
 
 	private:
-	void PreUpdate(dFloat timestep, int threadID);
-	void PostUpdate(dFloat timestep, int threadID);
+	void PreUpdate(dFloat timestep);
+	void PostUpdate(dFloat timestep);
+	void UpdateControllerArray();
 	dAnimationJoint* GetFirstJoint(const dAnimationJoint* const joint) const;
 
+	static void PreUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
+	static void PostUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
+
 	private:
 	dList<dAnimationJointRoot*> m_controllerList;
+	dArray<dAnimationJointRoot*> m_controllerArray;
+	int m_controllerArrayCount;
 	dFloat m_timestep;
 	//unsigned m_lock;
 };
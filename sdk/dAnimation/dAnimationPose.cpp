@@ -0,0 +1,346 @@
+/* Copyright (c) <2003-2019> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#include "dAnimationStdAfx.h"
+#include "dAnimationPose.h"
+
+dAnimationPose::dAnimationPose(int bonesCount)
+	:dCustomAlloc()
+	,m_buffer(NULL)
+	,m_count(0)
+	,m_stride(0)
+{
+	Allocate(bonesCount);
+	SetIdentity();
+}
+
+dAnimationPose::dAnimationPose(const dAnimationPose& src)
+	:dCustomAlloc()
+	,m_buffer(NULL)
+	,m_count(0)
+	,m_stride(0)
+{
+	Allocate(src.m_count);
+	CopyFrom(src);
+}
+
+dAnimationPose::~dAnimationPose()
+{
+	NewtonFree(m_buffer);
+}
+
+void dAnimationPose::Allocate(int bonesCount)
+{
+	dAssert(bonesCount >= 0);
+	m_count = bonesCount;
+	m_stride = dMax((bonesCount + D_ANIMATION_POSE_BLOCK - 1) & -D_ANIMATION_POSE_BLOCK, D_ANIMATION_POSE_BLOCK);
+	m_buffer = (dFloat*)NewtonAlloc(int(GetBufferSize() * sizeof(dFloat)));
+}
+
+void dAnimationPose::SetIdentity()
+{
+	for (int i = 0; i < m_channelsCount; i++) {
+		const dFloat value = ((i == m_rotationW) || (i >= m_scaleX)) ? dFloat(1.0f) : dFloat(0.0f);
+		dFloat* const channel = GetChannel(dChannel(i));
+		for (int j = 0; j < m_stride; j++) {
+			channel[j] = value;
+		}
+	}
+}
+
+void dAnimationPose::CopyFrom(const dAnimationPose& src)
+{
+	dAssert(src.m_stride == m_stride);
+	memcpy(m_buffer, src.m_buffer, GetBufferSize() * sizeof(dFloat));
+}
+
+void dAnimationPose::SetBone(int index, const dVector& posit, const dQuaternion& rotation, const dVector& scale)
+{
+	dAssert(index >= 0);
+	dAssert(index < m_count);
+	dFloat* const buffer = &m_buffer[index];
+	buffer[m_positX * m_stride] = posit.m_x;
+	buffer[m_positY * m_stride] = posit.m_y;
+	buffer[m_positZ * m_stride] = posit.m_z;
+	buffer[m_rotationX * m_stride] = rotation.m_x;
+	buffer[m_rotationY * m_stride] = rotation.m_y;
+	buffer[m_rotationZ * m_stride] = rotation.m_z;
+	buffer[m_rotationW * m_stride] = rotation.m_w;
+	buffer[m_scaleX * m_stride] = scale.m_x;
+	buffer[m_scaleY * m_stride] = scale.m_y;
+	buffer[m_scaleZ * m_stride] = scale.m_z;
+}
+
+void dAnimationPose::GetBone(int index, dVector& posit, dQuaternion& rotation, dVector& scale) const
+{
+	dAssert(index >= 0);
+	dAssert(index < m_count);
+	const dFloat* const buffer = &m_buffer[index];
+	posit = dVector(buffer[m_positX * m_stride], buffer[m_positY * m_stride], buffer[m_positZ * m_stride], dFloat(1.0f));
+	rotation = dQuaternion(buffer[m_rotationW * m_stride], buffer[m_rotationX * m_stride], buffer[m_rotationY * m_stride], buffer[m_rotationZ * m_stride]);
+	scale = dVector(buffer[m_scaleX * m_stride], buffer[m_scaleY * m_stride], buffer[m_scaleZ * m_stride], dFloat(1.0f));
+}
+
+dMatrix dAnimationPose::GetMatrix(int index) const
+{
+	dVector posit;
+	dVector scale;
+	dQuaternion rotation;
+	GetBone(index, posit, rotation, scale);
+	dMatrix matrix(rotation, posit);
+	matrix.m_front = matrix.m_front.Scale(scale.m_x);
+	matrix.m_up = matrix.m_up.Scale(scale.m_y);
+	matrix.m_right = matrix.m_right.Scale(scale.m_z);
+	return matrix;
+}
+
+void dAnimationPose::Blend(const dAnimationPose& pose0, const dAnimationPose& pose1, dFloat param)
+{
+	dAssert(pose0.m_stride == m_stride);
+	dAssert(pose1.m_stride == m_stride);
+	Blend(pose0.m_buffer, pose1.m_buffer, param);
+}
+
+void dAnimationPose::Blend(const dFloat* const buffer0, const dFloat* const buffer1, dFloat param)
+{
+	const dFloat t1 = param;
+	const dFloat t0 = dFloat(1.0f) - param;
+	const int stride = m_stride;
+
+	// position and scale are plain linear interpolations
+	for (int i = 0; i < 3 * stride; i++) {
+		m_buffer[i] = buffer0[i] * t0 + buffer1[i] * t1;
+	}
+	for (int i = m_scaleX * stride; i < m_channelsCount * stride; i++) {
+		m_buffer[i] = buffer0[i] * t0 + buffer1[i] * t1;
+	}
+
+	const dFloat* const qx0 = &buffer0[m_rotationX * stride];
+	const dFloat* const qy0 = &buffer0[m_rotationY * stride];
+	const dFloat* const qz0 = &buffer0[m_rotationZ * stride];
+	const dFloat* const qw0 = &buffer0[m_rotationW * stride];
+	const dFloat* const qx1 = &buffer1[m_rotationX * stride];
+	const dFloat* const qy1 = &buffer1[m_rotationY * stride];
+	const dFloat* const qz1 = &buffer1[m_rotationZ * stride];
+	const dFloat* const qw1 = &buffer1[m_rotationW * stride];
+	dFloat* const qx = GetChannel(m_rotationX);
+	dFloat* const qy = GetChannel(m_rotationY);
+	dFloat* const qz = GetChannel(m_rotationZ);
+	dFloat* const qw = GetChannel(m_rotationW);
+	for (int base = 0; base < stride; base += D_ANIMATION_POSE_BLOCK) {
+		dFloat x[D_ANIMATION_POSE_BLOCK];
+		dFloat y[D_ANIMATION_POSE_BLOCK];
+		dFloat z[D_ANIMATION_POSE_BLOCK];
+		dFloat w[D_ANIMATION_POSE_BLOCK];
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			// take the shortest arc
+			const int i = base + j;
+			const dFloat dot = qx0[i] * qx1[i] + qy0[i] * qy1[i] + qz0[i] * qz1[i] + qw0[i] * qw1[i];
+			const dFloat s1 = (dot >= dFloat(0.0f)) ? t1 : -t1;
+			const dFloat a = qx0[i] * t0 + qx1[i] * s1;
+			const dFloat b = qy0[i] * t0 + qy1[i] * s1;
+			const dFloat c = qz0[i] * t0 + qz1[i] * s1;
+			const dFloat d = qw0[i] * t0 + qw1[i] * s1;
+			const dFloat invMag = dFloat(1.0f) / dSqrt(a * a + b * b + c * c + d * d);
+			x[j] = a * invMag;
+			y[j] = b * invMag;
+			z[j] = c * invMag;
+			w[j] = d * invMag;
+		}
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			qx[base + j] = x[j];
+			qy[base + j] = y[j];
+			qz[base + j] = z[j];
+			qw[base + j] = w[j];
+		}
+	}
+}
+
+void dAnimationPose::BlendSlerp(const dAnimationPose& pose0, const dAnimationPose& pose1, dFloat param)
+{
+	dAssert(pose0.m_stride == m_stride);
+	dAssert(pose1.m_stride == m_stride);
+
+	const dFloat t1 = param;
+	const dFloat t0 = dFloat(1.0f) - param;
+	const int stride = m_stride;
+
+	const dFloat* const buffer0 = pose0.m_buffer;
+	const dFloat* const buffer1 = pose1.m_buffer;
+	for (int i = 0; i < 3 * stride; i++) {
+		m_buffer[i] = buffer0[i] * t0 + buffer1[i] * t1;
+	}
+	for (int i = m_scaleX * stride; i < m_channelsCount * stride; i++) {
+		m_buffer[i] = buffer0[i] * t0 + buffer1[i] * t1;
+	}
+
+	// sin((1 - t) * a) / sin(a) and sin(t * a) / sin(a) expanded as polynomials in cos(a),
+	// after "A Fast and Accurate Algorithm for Computing SLERP" by David Eberly.
+	// the coefficients only depend on the parameter, which is the same for all bones,
+	// the error is below 2.0e-5 over the whole half sphere.
+	const int termsCount = 8;
+	const dFloat mu = dFloat(1.85298109240830f);
+	dFloat a0[termsCount];
+	dFloat a1[termsCount];
+	for (int i = 0; i < termsCount; i++) {
+		const dFloat n = dFloat(i + 1);
+		const dFloat scale = (i == (termsCount - 1)) ? mu : dFloat(1.0f);
+		const dFloat u = scale / (n * (dFloat(2.0f) * n + dFloat(1.0f)));
+		const dFloat v = scale * n / (dFloat(2.0f) * n + dFloat(1.0f));
+		a0[i] = u * t0 * t0 - v;
+		a1[i] = u * t1 * t1 - v;
+	}
+
+	const dFloat* const qx0 = pose0.GetChannel(m_rotationX);
+	const dFloat* const qy0 = pose0.GetChannel(m_rotationY);
+	const dFloat* const qz0 = pose0.GetChannel(m_rotationZ);
+	const dFloat* const qw0 = pose0.GetChannel(m_rotationW);
+	const dFloat* const qx1 = pose1.GetChannel(m_rotationX);
+	const dFloat* const qy1 = pose1.GetChannel(m_rotationY);
+	const dFloat* const qz1 = pose1.GetChannel(m_rotationZ);
+	const dFloat* const qw1 = pose1.GetChannel(m_rotationW);
+	dFloat* const qx = GetChannel(m_rotationX);
+	dFloat* const qy = GetChannel(m_rotationY);
+	dFloat* const qz = GetChannel(m_rotationZ);
+	dFloat* const qw = GetChannel(m_rotationW);
+	for (int base = 0; base < stride; base += D_ANIMATION_POSE_BLOCK) {
+		dFloat s0[D_ANIMATION_POSE_BLOCK];
+		dFloat s1[D_ANIMATION_POSE_BLOCK];
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			const int i = base + j;
+			const dFloat dot = qx0[i] * qx1[i] + qy0[i] * qy1[i] + qz0[i] * qz1[i] + qw0[i] * qw1[i];
+			const dFloat sign = (dot >= dFloat(0.0f)) ? dFloat(1.0f) : dFloat(-1.0f);
+			const dFloat xm1 = dot * sign - dFloat(1.0f);
+			dFloat c0 = dFloat(1.0f);
+			dFloat c1 = dFloat(1.0f);
+			for (int k = termsCount - 1; k >= 0; k--) {
+				c0 = dFloat(1.0f) + a0[k] * xm1 * c0;
+				c1 = dFloat(1.0f) + a1[k] * xm1 * c1;
+			}
+			s0[j] = c0 * t0;
+			s1[j] = c1 * t1 * sign;
+		}
+
+		dFloat x[D_ANIMATION_POSE_BLOCK];
+		dFloat y[D_ANIMATION_POSE_BLOCK];
+		dFloat z[D_ANIMATION_POSE_BLOCK];
+		dFloat w[D_ANIMATION_POSE_BLOCK];
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			const int i = base + j;
+			x[j] = qx0[i] * s0[j] + qx1[i] * s1[j];
+			y[j] = qy0[i] * s0[j] + qy1[i] * s1[j];
+			z[j] = qz0[i] * s0[j] + qz1[i] * s1[j];
+			w[j] = qw0[i] * s0[j] + qw1[i] * s1[j];
+		}
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			qx[base + j] = x[j];
+			qy[base + j] = y[j];
+			qz[base + j] = z[j];
+			qw[base + j] = w[j];
+		}
+	}
+}
+
+void dAnimationPose::MakeAdditive(const dAnimationPose& pose, const dAnimationPose& reference)
+{
+	dAssert(pose.m_stride == m_stride);
+	dAssert(reference.m_stride == m_stride);
+
+	const int stride = m_stride;
+	for (int i = 0; i < 3 * stride; i++) {
+		m_buffer[i] = pose.m_buffer[i] - reference.m_buffer[i];
+	}
+	for (int i = m_scaleX * stride; i < m_channelsCount * stride; i++) {
+		m_buffer[i] = pose.m_buffer[i] / reference.m_buffer[i];
+	}
+
+	// delta = conjugate(reference) * pose
+	const dFloat* const ax = reference.GetChannel(m_rotationX);
+	const dFloat* const ay = reference.GetChannel(m_rotationY);
+	const dFloat* const az = reference.GetChannel(m_rotationZ);
+	const dFloat* const aw = reference.GetChannel(m_rotationW);
+	const dFloat* const bx = pose.GetChannel(m_rotationX);
+	const dFloat* const by = pose.GetChannel(m_rotationY);
+	const dFloat* const bz = pose.GetChannel(m_rotationZ);
+	const dFloat* const bw = pose.GetChannel(m_rotationW);
+	dFloat* const qx = GetChannel(m_rotationX);
+	dFloat* const qy = GetChannel(m_rotationY);
+	dFloat* const qz = GetChannel(m_rotationZ);
+	dFloat* const qw = GetChannel(m_rotationW);
+	for (int base = 0; base < stride; base += D_ANIMATION_POSE_BLOCK) {
+		dFloat x[D_ANIMATION_POSE_BLOCK];
+		dFloat y[D_ANIMATION_POSE_BLOCK];
+		dFloat z[D_ANIMATION_POSE_BLOCK];
+		dFloat w[D_ANIMATION_POSE_BLOCK];
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			const int i = base + j;
+			w[j] = bw[i] * aw[i] + bx[i] * ax[i] + by[i] * ay[i] + bz[i] * az[i];
+			x[j] = bx[i] * aw[i] - bw[i] * ax[i] + bz[i] * ay[i] - by[i] * az[i];
+			y[j] = by[i] * aw[i] - bz[i] * ax[i] - bw[i] * ay[i] + bx[i] * az[i];
+			z[j] = bz[i] * aw[i] + by[i] * ax[i] - bx[i] * ay[i] - bw[i] * az[i];
+		}
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			qx[base + j] = x[j];
+			qy[base + j] = y[j];
+			qz[base + j] = z[j];
+			qw[base + j] = w[j];
+		}
+	}
+}
+
+void dAnimationPose::AddLayer(const dAnimationPose& additive, dFloat weight)
+{
+	dAssert(additive.m_stride == m_stride);
+
+	const int stride = m_stride;
+	for (int i = 0; i < 3 * stride; i++) {
+		m_buffer[i] += additive.m_buffer[i] * weight;
+	}
+	for (int i = m_scaleX * stride; i < m_channelsCount * stride; i++) {
+		m_buffer[i] *= dFloat(1.0f) + (additive.m_buffer[i] - dFloat(1.0f)) * weight;
+	}
+
+	// rotation = rotation * nlerp(identity, delta, weight)
+	const dFloat t0 = dFloat(1.0f) - weight;
+	const dFloat* const dx = additive.GetChannel(m_rotationX);
+	const dFloat* const dy = additive.GetChannel(m_rotationY);
+	const dFloat* const dz = additive.GetChannel(m_rotationZ);
+	const dFloat* const dw = additive.GetChannel(m_rotationW);
+	dFloat* const qx = GetChannel(m_rotationX);
+	dFloat* const qy = GetChannel(m_rotationY);
+	dFloat* const qz = GetChannel(m_rotationZ);
+	dFloat* const qw = GetChannel(m_rotationW);
+	for (int base = 0; base < stride; base += D_ANIMATION_POSE_BLOCK) {
+		dFloat x[D_ANIMATION_POSE_BLOCK];
+		dFloat y[D_ANIMATION_POSE_BLOCK];
+		dFloat z[D_ANIMATION_POSE_BLOCK];
+		dFloat w[D_ANIMATION_POSE_BLOCK];
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			const int i = base + j;
+			const dFloat s1 = (dw[i] >= dFloat(0.0f)) ? weight : -weight;
+			const dFloat bx = dx[i] * s1;
+			const dFloat by = dy[i] * s1;
+			const dFloat bz = dz[i] * s1;
+			const dFloat bw = dw[i] * s1 + t0;
+			const dFloat invMag = dFloat(1.0f) / dSqrt(bx * bx + by * by + bz * bz + bw * bw);
+			w[j] = (bw * qw[i] - bx * qx[i] - by * qy[i] - bz * qz[i]) * invMag;
+			x[j] = (bx * qw[i] + bw * qx[i] - bz * qy[i] + by * qz[i]) * invMag;
+			y[j] = (by * qw[i] + bz * qx[i] + bw * qy[i] - bx * qz[i]) * invMag;
+			z[j] = (bz * qw[i] - by * qx[i] + bx * qy[i] + bw * qz[i]) * invMag;
+		}
+		for (int j = 0; j < D_ANIMATION_POSE_BLOCK; j++) {
+			qx[base + j] = x[j];
+			qy[base + j] = y[j];
+			qz[base + j] = z[j];
+			qw[base + j] = w[j];
+		}
+	}
+}
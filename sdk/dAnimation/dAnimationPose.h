@@ -0,0 +1,89 @@
+/* Copyright (c) <2003-2019> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#ifndef __D_ANIMATION_POSE_H__
+#define __D_ANIMATION_POSE_H__
+
+#include "dAnimationStdAfx.h"
+
+// bones are processed in blocks of this many lanes,
+// the channel arrays are padded with identity bones to a multiple of it
+#define D_ANIMATION_POSE_BLOCK	8
+
+// flat pose of a skeleton, stored as structure of arrays.
+// every channel is a contiguous array of floats, one entry per bone,
+// so that sampling and blending run as straight loops over all bones
+// that the compiler turns into simd code.
+class dAnimationPose: public dCustomAlloc
+{
+	public:
+	enum dChannel
+	{
+		m_positX,
+		m_positY,
+		m_positZ,
+		m_rotationX,
+		m_rotationY,
+		m_rotationZ,
+		m_rotationW,
+		m_scaleX,
+		m_scaleY,
+		m_scaleZ,
+		m_channelsCount,
+	};
+
+	dAnimationPose(int bonesCount);
+	dAnimationPose(const dAnimationPose& src);
+	~dAnimationPose();
+
+	int GetCount() const { return m_count; }
+	int GetStride() const { return m_stride; }
+	int GetBufferSize() const { return m_stride * m_channelsCount; }
+
+	dFloat* GetBuffer() { return m_buffer; }
+	const dFloat* GetBuffer() const { return m_buffer; }
+	dFloat* GetChannel(dChannel channel) { return &m_buffer[channel * m_stride]; }
+	const dFloat* GetChannel(dChannel channel) const { return &m_buffer[channel * m_stride]; }
+
+	void SetIdentity();
+	void CopyFrom(const dAnimationPose& src);
+
+	void SetBone(int index, const dVector& posit, const dQuaternion& rotation, const dVector& scale = dVector (1.0f));
+	void GetBone(int index, dVector& posit, dQuaternion& rotation, dVector& scale) const;
+	dMatrix GetMatrix(int index) const;
+
+	// normalized linear interpolation, the fast default for blend trees
+	void Blend(const dAnimationPose& pose0, const dAnimationPose& pose1, dFloat param);
+
+	// same as Blend, with two raw buffers in the layout of this pose,
+	// used by the key frame sequences to interpolate between baked frames
+	void Blend(const dFloat* const buffer0, const dFloat* const buffer1, dFloat param);
+
+	// constant angular velocity interpolation, evaluated with a polynomial
+	// approximation of the slerp coefficients so that it vectorizes as well.
+	void BlendSlerp(const dAnimationPose& pose0, const dAnimationPose& pose1, dFloat param);
+
+	// makes this pose the difference between pose and reference,
+	// so that reference plus the additive layer gives pose back.
+	void MakeAdditive(const dAnimationPose& pose, const dAnimationPose& reference);
+	void AddLayer(const dAnimationPose& additive, dFloat weight);
+
+	private:
+	dAnimationPose& operator= (const dAnimationPose& src);
+	void Allocate(int bonesCount);
+
+	dFloat* m_buffer;
+	int m_count;
+	int m_stride;
+};
+
+#endif
+
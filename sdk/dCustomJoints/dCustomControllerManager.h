@@ -19,7 +19,7 @@
 
 #include "dCustomJointLibraryStdAfx.h"
 #include "dCustomAlloc.h"
-
+#include "dCustomListener.h"
 
 class dCustomControllerConvexCastPreFilter
 {	
@@ -187,6 +187,7 @@ class dCustomControllerManager: public dCustomControllerManagerBase, public dLis
 
 	private:
 	void DestroyAllController ();
+	void UpdateControllerArray ();
 
 	static void Destroy (const NewtonWorld* const world, void* const listenerUserData);
 	static void Debug (const NewtonWorld* const world, void* const listenerUserData, void* const debugContext);
@@ -194,8 +195,12 @@ class dCustomControllerManager: public dCustomControllerManagerBase, public dLis
 	static void PostUpdate (const NewtonWorld* const world, void* const listenerUserData, dFloat timestep);
 	static void OnBodyDestroy (const NewtonWorld* const world, void* const listener, NewtonBody* const body);
 
-	static void PreUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex);
-	static void PostUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex);
+	static void PreUpdateKernel (NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
+	static void PostUpdateKernel (NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
+
+	dArray<CONTROLLER_BASE*> m_controllerArray;
+	int m_controllerArrayCount;
+	bool m_controllerArrayDirty;
 };
 
 
@@ -203,6 +208,9 @@ template<class CONTROLLER_BASE>
 dCustomControllerManager<CONTROLLER_BASE>::dCustomControllerManager(NewtonWorld* const world, const char* const managerName)
 	:dCustomControllerManagerBase(world)
 	,dList<CONTROLLER_BASE>()
+	,m_controllerArray()
+	,m_controllerArrayCount(0)
+	,m_controllerArrayDirty(false)
 {
 	void* const listener = NewtonWorldAddListener(world, managerName, this);
 
@@ -226,22 +234,33 @@ void dCustomControllerManager<CONTROLLER_BASE>::DestroyAllController ()
 	}
 }
 
+// the list keeps the controllers in place, the array is what the worker threads split in ranges.
 template<class CONTROLLER_BASE>
-void dCustomControllerManager<CONTROLLER_BASE>::PreUpdate(dFloat timestep)
+void dCustomControllerManager<CONTROLLER_BASE>::UpdateControllerArray ()
 {
-	for (typename dCustomControllerManager<CONTROLLER_BASE>::dListNode* node = dCustomControllerManager<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
-		NewtonDispachThreadJob(m_world, PreUpdateKernel, &node->GetInfo(), __FUNCTION__);
+	if (m_controllerArrayDirty || (m_controllerArrayCount != dList<CONTROLLER_BASE>::GetCount())) {
+		int index = 0;
+		for (typename dList<CONTROLLER_BASE>::dListNode* node = dList<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
+			m_controllerArray[index] = &node->GetInfo();
+			index ++;
+		}
+		m_controllerArrayCount = index;
+		m_controllerArrayDirty = false;
 	}
-	NewtonSyncThreadJobs(m_world);
+}
+
+template<class CONTROLLER_BASE>
+void dCustomControllerManager<CONTROLLER_BASE>::PreUpdate(dFloat timestep)
+{
+	UpdateControllerArray ();
+	NewtonParallelFor(m_world, m_controllerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, PreUpdateKernel, this, __FUNCTION__);
 }
 
 template<class CONTROLLER_BASE>
 void dCustomControllerManager<CONTROLLER_BASE>::PostUpdate(dFloat timestep)
 {
-	for (typename dList<CONTROLLER_BASE>::dListNode* node = dList<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
-		NewtonDispachThreadJob(m_world, PostUpdateKernel, &node->GetInfo(), __FUNCTION__);
-	}
-	NewtonSyncThreadJobs(m_world);
+	UpdateControllerArray ();
+	NewtonParallelFor(m_world, m_controllerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, PostUpdateKernel, this, __FUNCTION__);
 }
 
 
@@ -290,17 +309,25 @@ void dCustomControllerManager<CONTROLLER_BASE>::OnBodyDestroy (const NewtonWorld
 }
 
 template<class CONTROLLER_BASE>
-void dCustomControllerManager<CONTROLLER_BASE>::PreUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex)
+void dCustomControllerManager<CONTROLLER_BASE>::PreUpdateKernel (NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
 {
-	dCustomControllerBase* const controller = (dCustomControllerBase*) context;
-	controller->PreUpdate(((dCustomControllerManager*)controller->m_manager)->GetTimeStep(), threadIndex);
+	dCustomControllerManager* const me = (dCustomControllerManager*) context;
+	CONTROLLER_BASE** const controllers = &me->m_controllerArray[startIndex];
+	for (int i = 0; i < count; i ++) {
+		dCustomControllerBase* const controller = controllers[i];
+		controller->PreUpdate(me->GetTimeStep(), threadIndex);
+	}
 }
 
 template<class CONTROLLER_BASE>
-void dCustomControllerManager<CONTROLLER_BASE>::PostUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex)
+void dCustomControllerManager<CONTROLLER_BASE>::PostUpdateKernel (NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
 {
-	class dCustomControllerBase* const controller = (dCustomControllerBase*) context;
-	controller->PostUpdate(((dCustomControllerManager*)controller->m_manager)->GetTimeStep(), threadIndex);
+	dCustomControllerManager* const me = (dCustomControllerManager*) context;
+	CONTROLLER_BASE** const controllers = &me->m_controllerArray[startIndex];
+	for (int i = 0; i < count; i ++) {
+		dCustomControllerBase* const controller = controllers[i];
+		controller->PostUpdate(me->GetTimeStep(), threadIndex);
+	}
 }
 
 template<class CONTROLLER_BASE>
@@ -308,6 +335,7 @@ CONTROLLER_BASE* dCustomControllerManager<CONTROLLER_BASE>::CreateController ()
 {
 	CONTROLLER_BASE* const controller = &dCustomControllerManager<CONTROLLER_BASE>::Append()->GetInfo();
 	controller->m_manager = this;
+	m_controllerArrayDirty = true;
 	return controller;
 }
 
@@ -317,6 +345,7 @@ void dCustomControllerManager<CONTROLLER_BASE>::DestroyController (CONTROLLER_BA
 	dAssert (dCustomControllerManager<CONTROLLER_BASE>::GetNodeFromInfo (*controller));
 	typename dCustomControllerManager<CONTROLLER_BASE>::dListNode* const node = dCustomControllerManager<CONTROLLER_BASE>::GetNodeFromInfo (*controller);
 	dCustomControllerManager<CONTROLLER_BASE>::Remove (node);
+	m_controllerArrayDirty = true;
 }
 
 
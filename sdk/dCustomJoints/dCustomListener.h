@@ -16,6 +16,8 @@
 #include "dCustomJoint.h"
 #include "dCustomAlloc.h"
 
+// items per call of a parallel update, small enough to balance thousands of light controllers
+#define D_CUSTOM_PARALLEL_GRAIN_SIZE	8
 
 class dCustomListener: public dCustomAlloc
 {
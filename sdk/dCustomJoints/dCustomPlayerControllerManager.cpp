@@ -20,7 +20,7 @@
 #define D_DESCRETE_MOTION_STEPS		4
 #define D_MAX_COLLIONSION_STEPS		8
 #define D_MAX_CONTACTS				6
-#define D_MAX_ROWS					(3 * D_MAX_CONTACTS) 
+#define D_MAX_ROWS					(3 * D_MAX_CONTACTS + 4)
 #define D_STEP_FRICTION				dFloat (2.0f)
 #define D_MAX_COLLISION_PENETRATION	dFloat (5.0e-3f)
 
@@ -28,20 +28,33 @@
 class dCustomPlayerController::dContactSolver
 {
 	public: 
-	dContactSolver(dCustomPlayerController* const controller)
+	dContactSolver(dCustomPlayerController* const controller, int threadIndex)
 		:m_controller(controller)
 		,m_contactCount(0)
+		,m_threadIndex(threadIndex)
 	{
 	}
 
 	void CalculateContacts()
 	{
 		dMatrix matrix;
+		dVector p0(0.0f);
+		dVector p1(0.0f);
 		NewtonWorld* const world = m_controller->m_manager->GetWorld();
 		NewtonCollision* const shape = NewtonBodyGetCollision(m_controller->m_kinematicBody);
 
 		NewtonBodyGetMatrix(m_controller->m_kinematicBody, &matrix[0][0]);
-		m_contactCount = NewtonWorldCollide(world, &matrix[0][0], shape, m_controller, PrefilterCallback, m_contactBuffer, D_MAX_CONTACTS, 0);
+		NewtonCollisionCalculateAABB(shape, &matrix[0][0], &p0[0], &p1[0]);
+
+		// use the bodies gathered at the beginning of the step, unless the player moved out of the gathered box
+		const dVector& boxP0 = m_controller->m_candidateBoxP0;
+		const dVector& boxP1 = m_controller->m_candidateBoxP1;
+		if ((p0.m_x >= boxP0.m_x) && (p0.m_y >= boxP0.m_y) && (p0.m_z >= boxP0.m_z) && (p1.m_x <= boxP1.m_x) && (p1.m_y <= boxP1.m_y) && (p1.m_z <= boxP1.m_z)) {
+			NewtonBody* const* const candidates = m_controller->m_candidateCount ? &m_controller->m_candidates[0] : NULL;
+			m_contactCount = NewtonWorldCollideBodies(world, candidates, m_controller->m_candidateCount, &matrix[0][0], shape, m_controller, PrefilterCallback, m_contactBuffer, D_MAX_CONTACTS, m_threadIndex);
+		} else {
+			m_contactCount = NewtonWorldCollide(world, &matrix[0][0], shape, m_controller, PrefilterCallback, m_contactBuffer, D_MAX_CONTACTS, m_threadIndex);
+		}
 	}
 
 	static unsigned PrefilterCallback(const NewtonBody* const body, const NewtonCollision* const collision, void* const userData)
@@ -56,6 +69,7 @@ class dCustomPlayerController::dContactSolver
 	NewtonWorldConvexCastReturnInfo m_contactBuffer[D_MAX_ROWS];
 	dCustomPlayerController* m_controller;
 	int m_contactCount;
+	int m_threadIndex;
 };
 
 class dCustomPlayerController::dImpulseSolver 
@@ -182,6 +196,8 @@ class dCustomPlayerController::dImpulseSolver
 dCustomPlayerControllerManager::dCustomPlayerControllerManager(NewtonWorld* const world)
 	:dCustomParallelListener(world, PLAYER_PLUGIN_NAME)
 	,m_playerList()
+	,m_playerArray()
+	,m_playerArrayCount(0)
 {
 }
 
@@ -191,25 +207,28 @@ dCustomPlayerControllerManager::~dCustomPlayerControllerManager()
 	dAssert(m_playerList.GetCount() == 0);
 }
 
-void dCustomPlayerControllerManager::PreUpdate(dFloat timestep, int threadID)
+void dCustomPlayerControllerManager::PreUpdate(dFloat timestep)
 {
 	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dCustomPlayerController>::dListNode* node = m_playerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+	m_timestep = timestep;
+	// a count of -1 means players were added since the array was built
+	if (m_playerArrayCount == -1) {
+		m_playerArrayCount = 0;
+		for (dList<dCustomPlayerController>::dListNode* node = m_playerList.GetFirst(); node; node = node->GetNext()) {
+			m_playerArray[m_playerArrayCount] = &node->GetInfo();
+			m_playerArrayCount ++;
+		}
 	}
+	NewtonParallelFor(GetWorld(), m_playerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, PreUpdateKernel, this, "dCustomPlayerControllerManager");
+}
 
-	if (node) {
-		dCustomPlayerController* const controller = &node->GetInfo();
-		controller->PreUpdate(timestep);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+void dCustomPlayerControllerManager::PreUpdateKernel (NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
+{
+	D_TRACKTIME();
+	dCustomPlayerControllerManager* const me = (dCustomPlayerControllerManager*) context;
+	dCustomPlayerController** const controllers = &me->m_playerArray[startIndex];
+	for (int i = 0; i < count; i ++) {
+		controllers[i]->PreUpdate(me->m_timestep, threadIndex);
 	}
 }
 
@@ -239,6 +258,7 @@ dCustomPlayerController* dCustomPlayerControllerManager::CreateController(const
 	NewtonDestroyCollision(bodyCapsule);
 
 	dCustomPlayerController& controller = m_playerList.Append()->GetInfo();
+	m_playerArrayCount = -1;
 
 	shapeMatrix.m_posit = dVector (0.0f, dFloat (0.0f), dFloat (0.0f), 1.0f);
 	controller.m_localFrame = shapeMatrix;
@@ -542,9 +562,12 @@ void dCustomPlayerController::ResolveCollision(dContactSolver& contactSolver, dF
 		if (localPooint.m_x < contactPatchHigh) {
 			m_isOnFloor = true;
 			dFloat friction = m_manager->ContactFriction(this, point, normal, int (contact.m_contactID), contact.m_hitBody);
-			if (friction > 0.0f) {
+			// a normal aligned with the heading has no traction basis, this happens on terrain ledges
+			dVector sideDir (frameMatrix.m_up.CrossProduct(normal));
+			const dFloat sideDirMag2 = sideDir.DotProduct3(sideDir);
+			if ((friction > 0.0f) && (sideDirMag2 > dFloat (1.0e-6f))) {
 				// add lateral traction friction
-				dVector sideDir (frameMatrix.m_up.CrossProduct(normal).Normalize());
+				sideDir = sideDir.Scale (dFloat (1.0f) / dSqrt (sideDirMag2));
 				impulseSolver.AddLinearRow(sideDir, point - com, -m_lateralSpeed, -friction, friction, normalIndex);
 				impulseSolver.m_rhs[impulseSolver.m_rowCount-1] += surfaceVeloc.DotProduct3(sideDir);
 				impulseSolver.m_contactPoint[impulseSolver.m_rowCount - 1] = otherBodyContact;
@@ -566,9 +589,38 @@ void dCustomPlayerController::ResolveCollision(dContactSolver& contactSolver, dF
 	NewtonBodySetVelocity(m_kinematicBody, &veloc[0]);
 }
 
-void dCustomPlayerController::PreUpdate(dFloat timestep)
+int dCustomPlayerController::GatherCandidate(const NewtonBody* const body, void* const userData)
+{
+	dCustomPlayerController* const me = (dCustomPlayerController*)userData;
+	if (body != me->m_kinematicBody) {
+		me->m_candidates[me->m_candidateCount] = (NewtonBody*)body;
+		me->m_candidateCount++;
+	}
+	return 1;
+}
+
+void dCustomPlayerController::GatherCandidates(dFloat timestep)
 {
-	dContactSolver contactSolver (this);
+	// one broadphase query per step, large enough to contain the step resolve and all the motion sub steps
+	dMatrix matrix;
+	dVector veloc(0.0f);
+	NewtonCollision* const shape = NewtonBodyGetCollision(m_kinematicBody);
+	NewtonBodyGetMatrix(m_kinematicBody, &matrix[0][0]);
+	NewtonBodyGetVelocity(m_kinematicBody, &veloc[0]);
+	NewtonCollisionCalculateAABB(shape, &matrix[0][0], &m_candidateBoxP0[0], &m_candidateBoxP1[0]);
+
+	const dFloat speed = dSqrt(veloc.DotProduct3(veloc)) + dAbs(m_forwardSpeed) + dAbs(m_lateralSpeed);
+	const dVector padding(speed * timestep * 2.0f + m_stepHeight + m_contactPatch);
+	m_candidateBoxP0 -= padding;
+	m_candidateBoxP1 += padding;
+
+	m_candidateCount = 0;
+	NewtonWorldForEachBodyInAABBDo(m_manager->GetWorld(), &m_candidateBoxP0[0], &m_candidateBoxP1[0], GatherCandidate, this);
+}
+
+void dCustomPlayerController::PreUpdate(dFloat timestep, int threadIndex)
+{
+	dContactSolver contactSolver (this, threadIndex);
 
 	dFloat timeLeft = timestep;
 	const dFloat timeEpsilon = timestep * (1.0f / 16.0f);
@@ -613,6 +665,9 @@ xxxx *= 1;
 	dVector veloc(GetVelocity() + m_impulse.Scale(m_invMass));
 	NewtonBodySetVelocity(m_kinematicBody, &veloc[0]);
 
+	// collect the bodies around the player once, all the contact queries below use this set
+	GatherCandidates(timestep);
+
 	// determine if player has to step over obstacles lower than step hight
 	ResolveStep(timestep, contactSolver);
 
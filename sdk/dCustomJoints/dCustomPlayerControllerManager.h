@@ -36,6 +36,9 @@ class dCustomPlayerController
 	dCustomPlayerController ()
 		:m_localFrame(dGetIdentityMatrix())
 		,m_impulse(0.0f)
+		,m_candidateBoxP0(0.0f)
+		,m_candidateBoxP1(0.0f)
+		,m_candidates()
 		,m_mass(0.0f)
 		,m_invMass(0.0f)
 		,m_headingAngle(0.0f)
@@ -46,6 +49,7 @@ class dCustomPlayerController
 		,m_userData(NULL)
 		,m_kinematicBody(NULL)
 		,m_manager(NULL)
+		,m_candidateCount(0)
 		,m_isAirbone(false)
 		,m_isOnFloor(false)
 	{
@@ -90,15 +94,20 @@ class dCustomPlayerController
 		m_deepPenetration,
 	};
 
-	void PreUpdate(dFloat timestep);
+	void PreUpdate(dFloat timestep, int threadIndex);
+	void GatherCandidates(dFloat timestep);
 	void ResolveStep(dFloat timestep, dContactSolver& contactSolver);
 	void ResolveCollision(dContactSolver& contactSolver, dFloat timestep);
 	dFloat PredictTimestep(dFloat timestep, dContactSolver& contactSolver);
 	void ResolveInterpenetrations(dContactSolver& contactSolver, dImpulseSolver& impulseSolver);
 	dCollisionState TestPredictCollision(const dContactSolver& contactSolver, const dVector& veloc) const;
+	static int GatherCandidate(const NewtonBody* const body, void* const userData);
 
 	dMatrix m_localFrame;
 	dVector m_impulse;
+	dVector m_candidateBoxP0;
+	dVector m_candidateBoxP1;
+	dArray<NewtonBody*> m_candidates;
 	dFloat m_mass;
 	dFloat m_invMass;
 	dFloat m_headingAngle;
@@ -109,6 +118,7 @@ class dCustomPlayerController
 	void* m_userData;
 	NewtonBody* m_kinematicBody;
 	dCustomPlayerControllerManager* m_manager;
+	int m_candidateCount;
 	bool m_isAirbone;
 	bool m_isOnFloor;
 
@@ -128,10 +138,14 @@ class dCustomPlayerControllerManager: public dCustomParallelListener
 
 	protected:
 	void PostUpdate(dFloat timestep) {}
-	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep, int threadID);
+	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep);
 
 	private:
+	static void PreUpdateKernel (NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
+
 	dList<dCustomPlayerController> m_playerList;
+	dArray<dCustomPlayerController*> m_playerArray;
+	int m_playerArrayCount;
 	friend class dCustomPlayerController;
 };
 
@@ -20,10 +20,9 @@
 dCustomTriggerManager::dCustomTriggerManager(NewtonWorld* const world)
 	:dCustomParallelListener(world, TRIGGER_PLUGIN_NAME)
 	,m_triggerList()
-	,m_pairCache ()
-	,m_timestep(0.0f)
-	,m_cacheCount(0)
-	,m_lock(0)
+	,m_triggerArray()
+	,m_events()
+	,m_triggerArrayCount(0)
 	,m_lru(0)
 {
 }
@@ -51,11 +50,16 @@ dCustomTriggerController* dCustomTriggerManager::CreateTrigger (const dMatrix& m
 	trigger.m_manager = this;
 	trigger.m_userData = userData;
 	trigger.m_kinematicBody = NewtonCreateKinematicBody(world, convexShape, &matrix[0][0]);
+	trigger.m_triggerId = NewtonBodyGetID(trigger.m_kinematicBody);
 
 	// set this shape do not collide with other bodies
 	NewtonCollision* const collision = NewtonBodyGetCollision (trigger.m_kinematicBody);
 	NewtonCollisionSetMode(collision, 0);
 
+	// the broad phase reports the bodies entering and leaving the trigger volume
+	NewtonBodySetTriggerVolume(trigger.m_kinematicBody, 1);
+
+	m_triggerArrayCount = 0;
 	return &trigger;
 }
 
@@ -63,19 +67,32 @@ void dCustomTriggerManager::DestroyTrigger (dCustomTriggerController* const trig
 {
 	dList<dCustomTriggerController>::dListNode* const node = m_triggerList.GetNodeFromInfo(*trigger);
 	m_triggerList.Remove(node);
+	m_triggerArrayCount = 0;
 }
 
-
 void dCustomTriggerManager::OnDestroyBody (NewtonBody* const body)
 {
+	const int id = NewtonBodyGetID(body);
 	for (dList<dCustomTriggerController>::dListNode* node = m_triggerList.GetFirst(); node; node = node->GetNext()) {
 		dCustomTriggerController& controller = node->GetInfo();
-		dCustomTriggerController::dTriggerManifest::dTreeNode* const passengerNode = controller.m_manifest.Find (body);
-		if (passengerNode) {
-			OnExit (&controller, body);
 
-			dCustomScopeLock lock (&m_lock);
-			controller.m_manifest.Remove (passengerNode);
+		int i0 = 0;
+		int i1 = controller.m_guestCount - 1;
+		while (i0 <= i1) {
+			const int mid = (i0 + i1) >> 1;
+			const int guestId = controller.m_guests[mid].m_id;
+			if (guestId == id) {
+				OnExit (&controller, body);
+				for (int i = mid + 1; i < controller.m_guestCount; i ++) {
+					controller.m_guests[i - 1] = controller.m_guests[i];
+				}
+				controller.m_guestCount --;
+				break;
+			} else if (guestId < id) {
+				i0 = mid + 1;
+			} else {
+				i1 = mid - 1;
+			}
 		}
 	}
 }
@@ -84,80 +101,124 @@ void dCustomTriggerManager::OnDebug(dCustomJoint::dDebugDisplay* const debugCont
 {
 	for (dList<dCustomTriggerController>::dListNode* node = GetControllersList().GetFirst(); node; node = node->GetNext()) {
 		const dCustomTriggerController& controller = node->GetInfo();
+		for (int i = 0; i < controller.m_guestCount; i ++) {
+			OnDebug(debugContext, &controller, controller.m_guests[i].m_body);
+		}
+	}
+}
 
-		dCustomTriggerController::dTriggerManifest::Iterator iter (controller.m_manifest);
-		for (iter.Begin(); iter; iter++) {
-			const NewtonBody* const body = iter.GetKey();
-			OnDebug(debugContext, &controller, body);
+int dCustomTriggerManager::CompareTriggers(dCustomTriggerController* const* const triggerA, dCustomTriggerController* const* const triggerB, void* const context)
+{
+	if ((*triggerA)->m_triggerId < (*triggerB)->m_triggerId) {
+		return -1;
+	} else if ((*triggerA)->m_triggerId > (*triggerB)->m_triggerId) {
+		return 1;
+	}
+	return 0;
+}
+
+void dCustomTriggerManager::UpdateManifest(dCustomTriggerController* const trigger, const NewtonTriggerEvent* const events, int eventCount)
+{
+	// merge the sorted guest list with the sorted events of this trigger, 
+	// the last event of each guest tells if it is still inside the trigger.
+	// guests in exit events can be dead bodies, so only bodies in the guest list are passed to OnExit
+	int i0 = 0;
+	int newCount = 0;
+	const int count0 = trigger->m_guestCount;
+	for (int i = 0; i < eventCount; i ++) {
+		const int guestId = events[i].m_guestId;
+		for (; (i + 1 < eventCount) && (events[i + 1].m_guestId == guestId); i ++);
+		const NewtonTriggerEvent& event = events[i];
+
+		for (; (i0 < count0) && (trigger->m_guests[i0].m_id < guestId); i0 ++) {
+			trigger->m_newGuests[newCount] = trigger->m_guests[i0];
+			newCount ++;
 		}
+
+		if ((i0 < count0) && (trigger->m_guests[i0].m_id == guestId)) {
+			if (event.m_enter) {
+				trigger->m_newGuests[newCount] = trigger->m_guests[i0];
+				newCount ++;
+			} else {
+				OnExit(trigger, trigger->m_guests[i0].m_body);
+			}
+			i0 ++;
+		} else if (event.m_enter) {
+			dCustomTriggerController::dTriggerGuest& guest = trigger->m_newGuests[newCount];
+			guest.m_body = event.m_guest;
+			guest.m_id = guestId;
+			guest.m_enterLru = m_lru;
+			newCount ++;
+			OnEnter(trigger, event.m_guest);
+		}
+	}
+	for (; i0 < count0; i0 ++) {
+		trigger->m_newGuests[newCount] = trigger->m_guests[i0];
+		newCount ++;
 	}
+
+	for (int i = 0; i < newCount; i ++) {
+		trigger->m_guests[i] = trigger->m_newGuests[i];
+	}
+	trigger->m_guestCount = newCount;
 }
 
-void dCustomTriggerManager::PreUpdate(dFloat timestep, int threadID)
+void dCustomTriggerManager::WhileInKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
 {
 	D_TRACKTIME();
-
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	for (int i = threadID; i < m_cacheCount; i += threadCount) {
-		dTriggerGuestPair& cacheEntry = m_pairCache[i];
-		if (cacheEntry.m_bodyNode->GetInfo() != m_lru) {
-			cacheEntry.m_bodyNode->GetInfo() = m_lru;
-//			dTrace(("in trigger body:%d lru:%d frame:%d\n", NewtonBodyGetID(cacheEntry.m_bodyNode->GetKey()), cacheEntry.m_bodyNode->GetInfo(), xxxxx));
-			WhileIn (cacheEntry.m_trigger, cacheEntry.m_bodyNode->GetKey());
+	dCustomTriggerManager* const me = (dCustomTriggerManager*)context;
+	dCustomTriggerController** const triggers = &me->m_triggerArray[startIndex];
+	const unsigned lru = me->m_lru;
+	for (int i = 0; i < count; i ++) {
+		const dCustomTriggerController* const trigger = triggers[i];
+		for (int j = 0; j < trigger->m_guestCount; j ++) {
+			const dCustomTriggerController::dTriggerGuest& guest = trigger->m_guests[j];
+			// bodies that just entered the trigger get their first call next step
+			if (guest.m_enterLru != lru) {
+				me->WhileIn(trigger, guest.m_body);
+			}
 		}
 	}
 }
 
 void dCustomTriggerManager::PreUpdate(dFloat timestep)
 {
-	m_lru++;
-	m_cacheCount = 0;
+	D_TRACKTIME();
+	m_lru ++;
 	m_timestep = timestep;
-
-	for (dList<dCustomTriggerController>::dListNode* triggerNode = GetControllersList().GetFirst(); triggerNode; triggerNode = triggerNode->GetNext()) {
-		dCustomTriggerController& controller = triggerNode->GetInfo();
-
-		NewtonBody* const triggerBody = controller.GetBody();
-		dCustomTriggerController::dTriggerManifest& manifest = controller.m_manifest;
-
-		for (NewtonJoint* joint = NewtonBodyGetFirstContactJoint(triggerBody); joint; joint = NewtonBodyGetNextContactJoint(triggerBody, joint)) {
-			dAssert(NewtonJointIsActive(joint));
-			NewtonBody* const body0 = NewtonJointGetBody0(joint);
-			NewtonBody* const body1 = NewtonJointGetBody1(joint);
-			NewtonBody* cargoBody = (body0 != triggerBody) ? body0 : body1;
-			dCustomTriggerController::dTriggerManifest::dTreeNode* uniqueEntryNode = manifest.Find(cargoBody);
-			if (!uniqueEntryNode) {
-				dCustomScopeLock lock(&m_lock);
-				uniqueEntryNode = manifest.Insert(m_lru, cargoBody);
-//				dTrace(("entering trigger body:%d lru:%d frame:%d\n", NewtonBodyGetID(cargoBody), m_lru, xxxxx));
-				OnEnter(&controller, cargoBody);
-			}
-			dTriggerGuestPair& cacheEntry = m_pairCache[m_cacheCount];
-			cacheEntry.m_trigger = &controller;
-			cacheEntry.m_bodyNode = uniqueEntryNode;
-			m_cacheCount++;
+	if (m_triggerArrayCount != m_triggerList.GetCount()) {
+		m_triggerArrayCount = 0;
+		for (dList<dCustomTriggerController>::dListNode* node = m_triggerList.GetFirst(); node; node = node->GetNext()) {
+			m_triggerArray[m_triggerArrayCount] = &node->GetInfo();
+			m_triggerArrayCount ++;
+		}
+		if (m_triggerArrayCount > 1) {
+			dSort(&m_triggerArray[0], m_triggerArrayCount, CompareTriggers);
 		}
 	}
 
-	dCustomParallelListener::PreUpdate(timestep);
-
-	for (dList<dCustomTriggerController>::dListNode* controllerNode = GetControllersList().GetFirst(); controllerNode; controllerNode = controllerNode->GetNext()) {
-		dCustomTriggerController* const controller = &controllerNode->GetInfo();
-		dCustomTriggerController::dTriggerManifest::Iterator iter(controller->m_manifest);
+	// the world events are sorted by trigger id and the trigger array is sorted by body id,
+	// so enter and exit events are a merge of the two lists, reported from the calling thread
+	NewtonWorld* const world = GetWorld();
+	const int eventCount = NewtonWorldGetTriggerEventCount(world);
+	if (eventCount) {
+		if (m_events.GetSize() < eventCount) {
+			m_events.Resize(eventCount);
+		}
+		NewtonWorldGetTriggerEvents(world, 0, eventCount, &m_events[0]);
 
-		for (iter.Begin(); iter;) {
-			dCustomTriggerController::dTriggerManifest::dTreeNode* const node = iter.GetNode();
-			iter++;
-			if (node->GetInfo() != m_lru) {
-				NewtonBody* const cargoBody = node->GetKey();
+		int index = 0;
+		for (int i = 0; i < eventCount;) {
+			const int triggerId = m_events[i].m_triggerId;
+			const int start = i;
+			for (i ++; (i < eventCount) && (m_events[i].m_triggerId == triggerId); i ++);
 
-//				dTrace(("exiting trigger body:%d lru:%d frame:%d\n\n", NewtonBodyGetID(cargoBody), node->GetInfo(), xxxxx));
-				OnExit(controller, cargoBody);
-				dCustomScopeLock lock(&m_lock);
-				controller->m_manifest.Remove(cargoBody);
+			for (; (index < m_triggerArrayCount) && (m_triggerArray[index]->m_triggerId < triggerId); index ++);
+			if ((index < m_triggerArrayCount) && (m_triggerArray[index]->m_triggerId == triggerId)) {
+				UpdateManifest(m_triggerArray[index], &m_events[start], i - start);
 			}
 		}
 	}
-}
\ No newline at end of file
+
+	NewtonParallelFor(world, m_triggerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, WhileInKernel, this, "dCustomTriggerManager");
+}
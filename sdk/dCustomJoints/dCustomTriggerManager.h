@@ -23,20 +23,28 @@
 #define TRIGGER_PLUGIN_NAME				"__triggerManager__"
 // a trigger is volume of space that is there to send a message 
 // to other objects when and object enter of leave the trigger region  
-// they are not visible and do not collide with bodies, but the generate contacts
+// they are not visible and do not collide with bodies, the broad phase only 
+// test them for overlap and the manager reports the changes in the overlap sets
 
 
 class dCustomTriggerManager;
 
 class dCustomTriggerController
 {
-	class dTriggerManifest: public dTree<unsigned, NewtonBody*>
+	class dTriggerGuest
 	{
+		public:
+		NewtonBody* m_body;
+		int m_id;
+		unsigned m_enterLru;
 	};
 
 	public:
 	dCustomTriggerController()
-		:m_manifest()
+		:m_guests()
+		,m_newGuests()
+		,m_guestCount(0)
+		,m_triggerId(0)
 		,m_userData(NULL)
 		,m_kinematicBody(NULL)
 		,m_manager(NULL)
@@ -54,8 +62,15 @@ class dCustomTriggerController
 	NewtonBody* GetBody() const {return m_kinematicBody; }
 	dCustomTriggerManager* GetManager() const { return m_manager; }
 
+	int GetGuestCount() const {return m_guestCount;}
+	NewtonBody* GetGuest(int index) const {return m_guests[index].m_body;}
+
 	private:
-	dTriggerManifest m_manifest;
+	// guests sorted by body id, the same order the world reports the trigger events
+	dArray<dTriggerGuest> m_guests;
+	dArray<dTriggerGuest> m_newGuests;
+	int m_guestCount;
+	int m_triggerId;
 	void* m_userData;
 	NewtonBody* m_kinematicBody;
 	dCustomTriggerManager* m_manager;
@@ -65,13 +80,6 @@ class dCustomTriggerController
 
 class dCustomTriggerManager: public dCustomParallelListener
 {
-	class dTriggerGuestPair
-	{
-		public:
-		dCustomTriggerController* m_trigger;
-		dCustomTriggerController::dTriggerManifest::dTreeNode* m_bodyNode;
-	};
-
 	public:
 	CUSTOM_JOINTS_API dCustomTriggerManager (NewtonWorld* const world);
 	CUSTOM_JOINTS_API virtual ~dCustomTriggerManager();
@@ -88,7 +96,6 @@ class dCustomTriggerManager: public dCustomParallelListener
 
 	protected:
 	CUSTOM_JOINTS_API virtual void OnDestroy();
-	CUSTOM_JOINTS_API void PreUpdate(dFloat timestep, int threadID);
 	CUSTOM_JOINTS_API virtual void OnDestroyBody (NewtonBody* const body); 
 
 	virtual void OnDebug(dCustomJoint::dDebugDisplay* const debugContext, const dCustomTriggerController* const controller, const NewtonBody* const guess) const 
@@ -104,12 +111,14 @@ class dCustomTriggerManager: public dCustomParallelListener
 
 	private:
 	CUSTOM_JOINTS_API void OnDebug(dCustomJoint::dDebugDisplay* const debugContext);
+	void UpdateManifest(dCustomTriggerController* const trigger, const NewtonTriggerEvent* const events, int eventCount);
+	static int CompareTriggers(dCustomTriggerController* const* const triggerA, dCustomTriggerController* const* const triggerB, void* const context);
+	static void WhileInKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
 
 	dList<dCustomTriggerController> m_triggerList;
-	dArray<dTriggerGuestPair> m_pairCache;
-	dFloat m_timestep;
-	int m_cacheCount;
-	unsigned m_lock;
+	dArray<dCustomTriggerController*> m_triggerArray;
+	dArray<NewtonTriggerEvent> m_events;
+	int m_triggerArrayCount;
 	unsigned m_lru;
 };
 
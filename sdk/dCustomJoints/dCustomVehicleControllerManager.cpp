@@ -1279,6 +1279,7 @@ void dCustomVehicleController::Init(NewtonBody* const body, const dMatrix& local
 	m_contactFilter = new dTireFrictionModel(this);
 
 	m_engine = NULL;
+	m_tireCandidatesCount = 0;
 	m_brakesControl = NULL;
 	m_engineControl = NULL;
 	m_steeringControl = NULL;
@@ -2380,6 +2381,76 @@ void dCustomVehicleController::PreUpdate(dFloat timestep, int threadID)
 	}
 }
 
+void dCustomVehicleController::CalculateTireSweep(const dWheelJoint* const tire, const dMatrix& tireMatrix, dMatrix& chassisMatrix, dMatrix& tireSweeptMatrix) const
+{
+	NewtonBodyGetMatrix(m_body, &chassisMatrix[0][0]);
+	const dVector tireSidePin(tireMatrix.RotateVector(tire->GetMatrix0().m_front));
+	chassisMatrix = tire->GetMatrix1() * chassisMatrix;
+	chassisMatrix.m_posit += tireSidePin.Scale(tireSidePin.DotProduct3(tireMatrix.m_posit - chassisMatrix.m_posit));
+
+	tireSweeptMatrix.m_up = chassisMatrix.m_up;
+	tireSweeptMatrix.m_right = tireSidePin.CrossProduct(chassisMatrix.m_up);
+	tireSweeptMatrix.m_right = tireSweeptMatrix.m_right.Scale(1.0f / dSqrt(tireSweeptMatrix.m_right.DotProduct3(tireSweeptMatrix.m_right)));
+	tireSweeptMatrix.m_front = tireSweeptMatrix.m_up.CrossProduct(tireSweeptMatrix.m_right);
+	tireSweeptMatrix.m_posit = chassisMatrix.m_posit + chassisMatrix.m_up.Scale(tire->m_suspensionLength);
+}
+
+int dCustomVehicleController::GatherTireCandidate(const NewtonBody* const body, void* const userData)
+{
+	dCustomVehicleController* const me = (dCustomVehicleController*)userData;
+	if (body == me->m_body) {
+		return 1;
+	}
+	for (dList<NewtonBody*>::dListNode* node = me->m_bodyList.GetFirst(); node; node = node->GetNext()) {
+		if (node->GetInfo() == body) {
+			return 1;
+		}
+	}
+	me->m_tireCandidates[me->m_tireCandidatesCount] = (NewtonBody*)body;
+	me->m_tireCandidatesCount++;
+	return 1;
+}
+
+void dCustomVehicleController::GatherTireCandidates()
+{
+	// one broadphase query with the union of all tire sweeps, the tires then cast against this set only
+	dVector minBox(1.0e10f);
+	dVector maxBox(-1.0e10f);
+	for (dList<dWheelJoint*>::dListNode* node = GetFirstTire(); node; node = GetNextTire(node)) {
+		dMatrix tireMatrix;
+		dMatrix chassisMatrix;
+		dMatrix tireSweeptMatrix;
+		dVector p0(0.0f);
+		dVector p1(0.0f);
+
+		const dWheelJoint* const tire = node->GetInfo();
+		const NewtonBody* const tireBody = tire->GetTireBody();
+		const NewtonCollision* const tireCollision = NewtonBodyGetCollision(tireBody);
+		const dFloat padding = tire->m_radio * 0.25f;
+
+		NewtonBodyGetMatrix(tireBody, &tireMatrix[0][0]);
+		CalculateTireSweep(tire, tireMatrix, chassisMatrix, tireSweeptMatrix);
+
+		NewtonCollisionCalculateAABB(tireCollision, &tireSweeptMatrix[0][0], &p0[0], &p1[0]);
+		for (int i = 0; i < 3; i++) {
+			minBox[i] = dMin(minBox[i], p0[i] - padding);
+			maxBox[i] = dMax(maxBox[i], p1[i] + padding);
+		}
+
+		tireSweeptMatrix.m_posit = chassisMatrix.m_posit;
+		NewtonCollisionCalculateAABB(tireCollision, &tireSweeptMatrix[0][0], &p0[0], &p1[0]);
+		for (int i = 0; i < 3; i++) {
+			minBox[i] = dMin(minBox[i], p0[i] - padding);
+			maxBox[i] = dMax(maxBox[i], p1[i] + padding);
+		}
+	}
+
+	m_tireCandidatesCount = 0;
+	if (m_tireList.GetCount()) {
+		NewtonWorldForEachBodyInAABBDo(NewtonBodyGetWorld(m_body), &minBox[0], &maxBox[0], GatherTireCandidate, this);
+	}
+}
+
 void dCustomVehicleController::Collide(dWheelJoint* const tire, int threadIndex)
 {
 	class CheckBadContact: public dTireFilter
@@ -2418,35 +2489,29 @@ void dCustomVehicleController::Collide(dWheelJoint* const tire, int threadIndex)
 	dAssert(tireBody == tire->GetTireBody());
 	dCustomVehicleController* const controller = tire->GetController();
 
+	dMatrix tireSweeptMatrix;
 	NewtonBodyGetMatrix(tireBody, &tireMatrix[0][0]);
-	NewtonBodyGetMatrix(vehicleBody, &chassisMatrix[0][0]);
+	CalculateTireSweep(tire, tireMatrix, chassisMatrix, tireSweeptMatrix);
 	const dVector tireSidePin(tireMatrix.RotateVector(tire->GetMatrix0().m_front));
-	chassisMatrix = tire->GetMatrix1() * chassisMatrix;
-	chassisMatrix.m_posit += tireSidePin.Scale(tireSidePin.DotProduct3(tireMatrix.m_posit - chassisMatrix.m_posit));
-
 	dVector suspensionSpan(chassisMatrix.m_up.Scale(tire->m_suspensionLength));
 
-	dMatrix tireSweeptMatrix;
-	tireSweeptMatrix.m_up = chassisMatrix.m_up;
-	tireSweeptMatrix.m_right = tireSidePin.CrossProduct(chassisMatrix.m_up);
-	tireSweeptMatrix.m_right = tireSweeptMatrix.m_right.Scale(1.0f / dSqrt(tireSweeptMatrix.m_right.DotProduct3(tireSweeptMatrix.m_right)));
-	tireSweeptMatrix.m_front = tireSweeptMatrix.m_up.CrossProduct(tireSweeptMatrix.m_right);
-	tireSweeptMatrix.m_posit = chassisMatrix.m_posit + suspensionSpan;
-
 	NewtonCollision* const tireCollision = NewtonBodyGetCollision(tireBody);
 	dTireFilter filter(tire, controller);
 
-	dFloat timeOfImpact;
+	// sweep the tire against the bodies collected for the whole chassis, not the full broadphase
+	NewtonBody* const* const candidates = m_tireCandidatesCount ? &m_tireCandidates[0] : NULL;
+
+	dFloat timeOfImpact = 1.0f;
 	tire->m_contactCount = 0;
 	const int maxContactCount = 2;
 	dAssert(sizeof(tire->m_contactInfo) / sizeof(tire->m_contactInfo[0]) > 2);
-	int count = NewtonWorldConvexCast(world, &tireSweeptMatrix[0][0], &chassisMatrix.m_posit[0], tireCollision, &timeOfImpact, &filter, dCustomControllerConvexCastPreFilter::Prefilter, tire->m_contactInfo, maxContactCount, threadIndex);
+	int count = NewtonWorldConvexCastBodies(world, candidates, m_tireCandidatesCount, &tireSweeptMatrix[0][0], &chassisMatrix.m_posit[0], tireCollision, &timeOfImpact, &filter, dCustomControllerConvexCastPreFilter::Prefilter, tire->m_contactInfo, maxContactCount, threadIndex);
 
 	if (timeOfImpact < 1.0e-2f) {
-		dFloat timeOfImpact1;
+		dFloat timeOfImpact1 = 1.0f;
 		NewtonWorldConvexCastReturnInfo contactInfo[4];
 		CheckBadContact checkfilter(tire, controller, count, tire->m_contactInfo);
-		int count1 = NewtonWorldConvexCast(world, &tireSweeptMatrix[0][0], &chassisMatrix.m_posit[0], tireCollision, &timeOfImpact1, &checkfilter, dCustomControllerConvexCastPreFilter::Prefilter, contactInfo, maxContactCount, threadIndex);
+		int count1 = NewtonWorldConvexCastBodies(world, candidates, m_tireCandidatesCount, &tireSweeptMatrix[0][0], &chassisMatrix.m_posit[0], tireCollision, &timeOfImpact1, &checkfilter, dCustomControllerConvexCastPreFilter::Prefilter, contactInfo, maxContactCount, threadIndex);
 		if (count1) {
 			count = count1;
 			timeOfImpact = timeOfImpact1;
@@ -2755,6 +2820,13 @@ void dCustomVehicleController::CalculateTireForces(dFloat timestep, int threadID
 			dDifferentialJoint* const diff = diffNode->GetInfo();
 			diff->ResetTransform();
 		}
+
+		// project integration error from previous frame
+		for (dList<dWheelJoint*>::dListNode* node = GetFirstTire(); node; node = GetNextTire(node)) {
+			dWheelJoint* const tireJoint = node->GetInfo();
+			tireJoint->ResetTransform();
+		}
+		GatherTireCandidates();
 	}
 
 	NewtonBodyGetOmega(m_body, &omega.m_x);
@@ -2770,8 +2842,6 @@ void dCustomVehicleController::CalculateTireForces(dFloat timestep, int threadID
 
 		// calculate contacts, if body is sleeping then contacts are the same as preview frame 
 		if (!isSleeping) {
-			// project integration error from previous frame
-			tireJoint->ResetTransform();
 			Collide(tireJoint, threadID);
 		}
 
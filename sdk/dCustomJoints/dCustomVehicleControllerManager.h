@@ -631,6 +631,9 @@ class dCustomVehicleController: public dCustomControllerBase
 	void CalculateSuspensionForces (dFloat timestep);
 	void CalculateTireForces (dFloat timestep, int threadID);
 	void Collide (dWheelJoint* const tire, int threadIndex);
+	void GatherTireCandidates ();
+	void CalculateTireSweep (const dWheelJoint* const tire, const dMatrix& tireMatrix, dMatrix& chassisMatrix, dMatrix& tireSweeptMatrix) const;
+	static int GatherTireCandidate (const NewtonBody* const body, void* const userData);
 	
 	dVector GetLastLateralForce(dWheelJoint* const tire) const;
 	
@@ -638,6 +641,8 @@ class dCustomVehicleController: public dCustomControllerBase
 	dList<NewtonBody*> m_bodyList;
 	dList<dWheelJoint*> m_tireList;
 	dList<dDifferentialJoint*> m_differentialList;
+	dArray<NewtonBody*> m_tireCandidates;
+	int m_tireCandidatesCount;
 
 	dEngineJoint* m_engine;
 	void* m_collisionAggregate;
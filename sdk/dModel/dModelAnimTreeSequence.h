@@ -0,0 +1,85 @@
+/* Copyright (c) <2003-2019> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+
+#ifndef __D_MODEL_ANIM_TREE_SEQUENCE_H__
+#define __D_MODEL_ANIM_TREE_SEQUENCE_H__
+
+#include "dModelAnimTree.h"
+#include <dAnimationKeyframesSequence.h>
+
+// plays a key frames sequence, the tracks go to the key frames of the pose in order.
+// the sequence compressed tracks are sampled when it has them, its keys otherwise.
+class dModelAnimTreeSequence: public dModelAnimTree
+{
+	public:
+	dModelAnimTreeSequence(dModelRootNode* const model, dAnimationKeyframesSequence* const sequence)
+		:dModelAnimTree(model)
+		,m_sequence(sequence)
+		,m_time(0.0f)
+	{
+		m_sequence->AddRef();
+	}
+
+	~dModelAnimTreeSequence()
+	{
+		m_sequence->Release();
+	}
+
+	dFloat GetTime() const
+	{
+		return m_time;
+	}
+
+	void SetTime(dFloat time)
+	{
+		m_time = dClamp(time, dFloat(0.0f), m_sequence->GetPeriod());
+	}
+
+	virtual void Evaluate(dFloat timestep)
+	{
+		const dFloat period = m_sequence->GetPeriod();
+		m_time = (period > dFloat(0.0f)) ? dMod(m_time + timestep, period) : dFloat(0.0f);
+	}
+
+	virtual void GeneratePose(dModelKeyFramePose& output)
+	{
+		dModelKeyFramePose::dListNode* node = output.GetFirst();
+		const dList<dAnimationCompressedTrack>& compressedTracks = m_sequence->GetCompressedTracks();
+		if (compressedTracks.GetCount()) {
+			dAssert(output.GetCount() == compressedTracks.GetCount());
+			for (dList<dAnimationCompressedTrack>::dListNode* trackNode = compressedTracks.GetFirst(); node && trackNode; trackNode = trackNode->GetNext()) {
+				dVector scale;
+				dModelKeyFrame& keyFrame = node->GetInfo();
+				trackNode->GetInfo().Sample(m_time, keyFrame.m_posit, keyFrame.m_rotation, scale);
+				keyFrame.m_posit.m_w = 1.0f;
+				node = node->GetNext();
+			}
+		} else {
+			const dList<dAnimimationKeyFramesTrack>& tracks = m_sequence->GetTracks();
+			dAssert(output.GetCount() == tracks.GetCount());
+			for (dList<dAnimimationKeyFramesTrack>::dListNode* trackNode = tracks.GetFirst(); node && trackNode; trackNode = trackNode->GetNext()) {
+				dModelKeyFrame& keyFrame = node->GetInfo();
+				trackNode->GetInfo().InterpolatePosition(m_time, keyFrame.m_posit);
+				trackNode->GetInfo().InterpolateRotation(m_time, keyFrame.m_rotation);
+				keyFrame.m_posit.m_w = 1.0f;
+				node = node->GetNext();
+			}
+		}
+	}
+
+	protected:
+	dAnimationKeyframesSequence* m_sequence;
+	dFloat m_time;
+};
+
+#endif
+
@@ -14,8 +14,9 @@
 
 dModelManager::dModelManager(NewtonWorld* const world, const char* const name)
 	:dCustomParallelListener(world, name)
-	//,m_controllerList()
-	//,m_timestep(0.0f)
+	,m_controllerList()
+	,m_controllerArray()
+	,m_controllerArrayCount(0)
 {
 }
 
@@ -119,6 +120,7 @@ void dModelManager::AddRoot(dModelRootNode* const root)
 {
 	dList<dPointer<dModelRootNode>>::dListNode* const node = m_controllerList.Append();
 	node->GetInfo().SetData(root);
+	m_controllerArrayCount = -1;
 }
 
 void dModelManager::UpdateLocalTranforms(dModelRootNode* const model) const
@@ -149,49 +151,54 @@ void dModelManager::UpdateLocalTranforms(dModelRootNode* const model) const
 	}
 }
 
-void dModelManager::PreUpdate(dFloat timestep, int threadID)
+void dModelManager::UpdateControllerArray()
 {
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dPointer<dModelRootNode>>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+	// a count of -1 means models were added since the array was built
+	if (m_controllerArrayCount == -1) {
+		m_controllerArrayCount = 0;
+		for (dList<dPointer<dModelRootNode>>::dListNode* node = m_controllerList.GetFirst(); node; node = node->GetNext()) {
+			m_controllerArray[m_controllerArrayCount] = node->GetInfo().GetData();
+			m_controllerArrayCount ++;
+		}
 	}
+}
 
-	if (node) {
-		dModelRootNode* const model = node->GetInfo().GetData();
-		OnPreUpdate(model, timestep);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
-	}
+void dModelManager::PreUpdate(dFloat timestep)
+{
+	D_TRACKTIME();
+	m_timestep = timestep;
+	UpdateControllerArray();
+	NewtonParallelFor(GetWorld(), m_controllerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, PreUpdateKernel, this, "dModelManager");
 }
 
-void dModelManager::PostUpdate(dFloat timestep, int threadID)
+void dModelManager::PostUpdate(dFloat timestep)
 {
 	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
+	m_timestep = timestep;
+	UpdateControllerArray();
+	NewtonParallelFor(GetWorld(), m_controllerArrayCount, D_CUSTOM_PARALLEL_GRAIN_SIZE, PostUpdateKernel, this, "dModelManager");
+}
 
-	dList<dPointer<dModelRootNode>>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+void dModelManager::PreUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
+{
+	D_TRACKTIME();
+	dModelManager* const me = (dModelManager*)context;
+	dModelRootNode** const models = &me->m_controllerArray[startIndex];
+	for (int i = 0; i < count; i++) {
+		me->OnPreUpdate(models[i], me->m_timestep);
 	}
+}
 
-	if (node) {
-		dModelRootNode* const model = node->GetInfo().GetData();
-		OnPostUpdate(model, timestep);
+void dModelManager::PostUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex)
+{
+	D_TRACKTIME();
+	dModelManager* const me = (dModelManager*)context;
+	dModelRootNode** const models = &me->m_controllerArray[startIndex];
+	for (int i = 0; i < count; i++) {
+		dModelRootNode* const model = models[i];
+		me->OnPostUpdate(model, me->m_timestep);
 		if (model->m_localTransformMode) {
-			UpdateLocalTranforms(model);
+			me->UpdateLocalTranforms(model);
 		}
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
 	}
 }
@@ -33,14 +33,20 @@ class dModelManager: public dCustomParallelListener
 	virtual void OnDebug(dModelRootNode* const model, dCustomJoint::dDebugDisplay* const debugContext) {}
 
 	protected:
-	void PreUpdate(dFloat timestep, int threadID);
-	void PostUpdate(dFloat timestep, int threadID);
+	void PreUpdate(dFloat timestep);
+	void PostUpdate(dFloat timestep);
 
 	private:
+	void UpdateControllerArray();
 	void UpdateLocalTranforms(dModelRootNode* const model) const;
 	void OnDebug(dCustomJoint::dDebugDisplay* const debugContext);
+
+	static void PreUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
+	static void PostUpdateKernel(NewtonWorld* const world, void* const context, int startIndex, int count, int threadIndex);
 	
 	dList<dPointer<dModelRootNode>> m_controllerList;
+	dArray<dModelRootNode*> m_controllerArray;
+	int m_controllerArrayCount;
 };
 
 
@@ -31,11 +31,14 @@ dNewtonBody::dNewtonBody(dBodyType type, dNewtonBody* const parent)
 	,m_body(NULL)
 	,m_child(NULL) 
 	,m_sibling(NULL) 
-	,m_parent(parent) 
+	,m_parent(NULL) 
 	,m_boneArticulation(NULL)
 	,m_userData(NULL)
 	,m_bodyType(type)
 {
+	if (parent) {
+		parent->AttachChild(this);
+	}
 }
 
 dNewtonBody::dNewtonBody (dNewton* const dWorld, dFloat mass, const dNewtonCollision* const collision, void* const userData, const dFloat* const matrix, dBodyType type, dNewtonBody* const parent)
@@ -44,11 +47,15 @@ dNewtonBody::dNewtonBody (dNewton* const dWorld, dFloat mass, const dNewtonColli
 	,m_body(NULL)
 	,m_child(NULL) 
 	,m_sibling(NULL) 
-	,m_parent(parent) 
+	,m_parent(NULL) 
 	,m_boneArticulation(NULL)
 	,m_userData(userData)
 	,m_bodyType(type)
 {
+	if (parent) {
+		parent->AttachChild(this);
+	}
+
 	NewtonWorld* const world = dWorld->GetNewton ();
 	NewtonBody* const body = NewtonCreateDynamicBody (world, collision->GetShape(), matrix);
 
@@ -60,6 +67,21 @@ dNewtonBody::dNewtonBody (dNewton* const dWorld, dFloat mass, const dNewtonColli
 
 dNewtonBody::~dNewtonBody()
 {
+	// unlink from the parent, the children become roots
+	if (m_parent) {
+		dNewtonBody** ptr = &m_parent->m_child;
+		while (*ptr != this) {
+			ptr = &(*ptr)->m_sibling;
+		}
+		*ptr = m_sibling;
+	}
+	for (dNewtonBody* child = m_child; child; ) {
+		dNewtonBody* const next = child->m_sibling;
+		child->m_parent = NULL;
+		child->m_sibling = NULL;
+		child = next;
+	}
+
 	if (m_body && NewtonBodyGetDestructorCallback(m_body)) {
 		NewtonBodySetDestructorCallback (m_body, NULL);
 		NewtonDestroyBody(m_body);
@@ -18,47 +18,97 @@
 
 dNewtonTransformManager::dNewtonTransformManager (dNewton* const world)
 	:dCustomControllerManager<dNewtonTransformController>(world->GetNewton(), "__dNewton_transformManager__")
+	,m_matrices(NULL)
+	,m_bodies(NULL)
+	,m_capacity(0)
 {
+	// the transforms are exported after the world updated the body matrices, 
+	// listeners post update run before that, so the manager uses the listener post transform callback.
+	NewtonWorld* const newton = world->GetNewton();
+	void* const listener = NewtonWorldGetListener(newton, "__dNewton_transformManager__");
+	NewtonWorldListenerSetPostTransformCallback(newton, listener, OnPostTransform);
 }
 
 dNewtonTransformManager::~dNewtonTransformManager()
 {
+	if (m_matrices) {
+		delete[] m_matrices;
+		delete[] m_bodies;
+	}
 }
 
+void dNewtonTransformManager::OnPostTransform (const NewtonWorld* const world, void* const listenerUserData, dFloat timestep)
+{
+	dNewtonTransformManager* const me = (dNewtonTransformManager*) ((dCustomListener*) listenerUserData);
+	me->UpdateTransforms();
+}
 
-void dNewtonTransformManager::PostUpdate (dFloat timestep)
+void dNewtonTransformManager::UpdateTransforms ()
 {
+	// only the bodies that moved in the last update are exported, in one contiguous range per thread
 	NewtonWorld* const world = GetWorld();
-	for (NewtonBody* body = NewtonWorldGetFirstBody(world); body; body = NewtonWorldGetNextBody(world, body)) {
-		NewtonDispachThreadJob (world, UpdateTransformKernel, body, "UpdateTransformKernel");
+	const int count = NewtonWorldGetActiveTransformCount(world);
+	if (!count) {
+		return;
+	}
+
+	if (count > m_capacity) {
+		if (m_matrices) {
+			delete[] m_matrices;
+			delete[] m_bodies;
+		}
+		m_capacity = count * 2;
+		m_matrices = new dMatrix[m_capacity];
+		m_bodies = new NewtonBody*[m_capacity];
+	}
+
+	const int threadCount = NewtonGetThreadsCount(world);
+	const int rangeSize = (count + threadCount - 1) / threadCount;
+	dTransformRange* const ranges = dAlloca (dTransformRange, threadCount);
+	for (int i = 0; i < threadCount; i ++) {
+		ranges[i].m_manager = this;
+		ranges[i].m_start = dMin (i * rangeSize, count);
+		ranges[i].m_count = dMin (rangeSize, count - ranges[i].m_start);
+		if (ranges[i].m_count) {
+			NewtonDispachThreadJob (world, UpdateTransformKernel, &ranges[i], "UpdateTransformKernel");
+		}
 	}
 	NewtonSyncThreadJobs(world);
 }
 
+void dNewtonTransformManager::ExportTransform (dNewtonBody* const body, const dMatrix& matrix, int threadIndex)
+{
+	const dNewtonBody* const parent = body->GetParent();
+	if (parent) {
+		dMatrix parentMatrix;
+		NewtonBodyGetMatrix(parent->GetNewtonBody(), &parentMatrix[0][0]);
+		const dMatrix childMatrix (matrix * parentMatrix.Inverse());
+		body->OnBodyTransform (&childMatrix[0][0], threadIndex);
+	} else {
+		body->OnBodyTransform (&matrix[0][0], threadIndex);
+	}
+}
+
 void dNewtonTransformManager::UpdateTransformKernel (NewtonWorld* const world, void* const context, int threadIndex)
 {
-	NewtonBody* const body	= (NewtonBody*) context;
-	dNewtonBody* const dBody = (dNewtonBody*) NewtonBodyGetUserData(body);
+	const dTransformRange* const range = (dTransformRange*) context;
+	dMatrix* const matrices = &range->m_manager->m_matrices[range->m_start];
+	NewtonBody** const bodies = &range->m_manager->m_bodies[range->m_start];
+	const int count = NewtonWorldGetActiveTransforms (world, range->m_start, range->m_count, bodies, &matrices[0][0][0]);
 
-	const dNewtonBody* const dParent = dBody->GetParent();
-	if (dParent) {
-		NewtonBody* const parent = dParent->GetNewtonBody();
-		if (!(NewtonBodyGetSleepState(body) & NewtonBodyGetSleepState(parent))) {
-			dMatrix parentMatrix;
-			dMatrix childMatrix;
-			NewtonBodyGetMatrix(body, &childMatrix[0][0]);
-			NewtonBodyGetMatrix(parent, &parentMatrix[0][0]);
-			childMatrix = childMatrix * parentMatrix.Inverse();
+	for (int i = 0; i < count; i ++) {
+		dNewtonBody* const dBody = (dNewtonBody*) NewtonBodyGetUserData(bodies[i]);
+		ExportTransform (dBody, matrices[i], threadIndex);
 
-			dBody->OnBodyTransform (&childMatrix[0][0], threadIndex);
-		}
-	} else {
-		
-		if (!NewtonBodyGetSleepState(body)) {
-			dMatrix matrix;
-			NewtonBodyGetMatrix(body, &matrix[0][0]);
-			dBody->OnBodyTransform (&matrix[0][0], threadIndex);
+		// a sleeping child is not in the active list, but its matrix relative to this body changed.
+		// awake children are exported by their own entry.
+		for (dNewtonBody* child = dBody->GetChild(); child; child = child->GetSibling()) {
+			NewtonBody* const childBody = child->GetNewtonBody();
+			if (NewtonBodyGetSleepState(childBody)) {
+				dMatrix childMatrix;
+				NewtonBodyGetMatrix(childBody, &childMatrix[0][0]);
+				ExportTransform (child, childMatrix, threadIndex);
+			}
 		}
 	}
 }
-
@@ -19,6 +19,7 @@
 #include "dCustomControllerManager.h"
 
 class dNewton;
+class dNewtonBody;
 
 // a Skeleton Transform controller is use to calculate local transform on contractions of rigid bodies and joint that form part of a hierarchical Skeleton
 class dNewtonTransformController: public dCustomControllerBase
@@ -30,6 +31,14 @@ class dNewtonTransformController: public dCustomControllerBase
 
 class dNewtonTransformManager: public dCustomControllerManager<dNewtonTransformController> 
 {
+	class dTransformRange
+	{
+		public:
+		dNewtonTransformManager* m_manager;
+		int m_start;
+		int m_count;
+	};
+
 	public:
 	CNEWTON_API dNewtonTransformManager (dNewton* const world);
 	CNEWTON_API virtual ~dNewtonTransformManager();
@@ -37,9 +46,16 @@ class dNewtonTransformManager: public dCustomControllerManager<dNewtonTransformC
 	private:
 	CNEWTON_API virtual void Debug () const {};
 	CNEWTON_API virtual void PreUpdate(dFloat timestep){};
-	CNEWTON_API virtual void PostUpdate (dFloat timestep);
+	CNEWTON_API virtual void PostUpdate (dFloat timestep){};
+	CNEWTON_API void UpdateTransforms ();
 
+	static void OnPostTransform (const NewtonWorld* const world, void* const listenerUserData, dFloat timestep);
+	static void ExportTransform (dNewtonBody* const body, const dMatrix& matrix, int threadIndex);
 	static void UpdateTransformKernel (NewtonWorld* const world, void* const context, int threadIndex);
+
+	dMatrix* m_matrices;
+	NewtonBody** m_bodies;
+	int m_capacity;
 };
 
 
@@ -21,6 +21,7 @@
 #include "dScene.h"
 #include "dAnimationTrack.h"
 #include <tinyxml.h>
+#include <dAnimationKeyframesSequence.h>
 
 
 D_IMPLEMENT_CLASS_NODE(dAnimationTrack);
@@ -43,6 +44,7 @@ dAnimationTrack::~dAnimationTrack(void)
 
 void dAnimationTrack::AddScale(dFloat time, dFloat x, dFloat y, dFloat z)
 {
+	m_compressedTrack.RemoveAll();
 	dCurveValue& value = m_scale.Append()->GetInfo();
 	value.m_x = x;
 	value.m_y = y;
@@ -52,6 +54,7 @@ void dAnimationTrack::AddScale(dFloat time, dFloat x, dFloat y, dFloat z)
 
 void dAnimationTrack::AddPosition(dFloat time, dFloat x, dFloat y, dFloat z)
 {
+	m_compressedTrack.RemoveAll();
 	dCurveValue& value = m_position.Append()->GetInfo();
 	value.m_x = x;
 	value.m_y = y;
@@ -61,6 +64,7 @@ void dAnimationTrack::AddPosition(dFloat time, dFloat x, dFloat y, dFloat z)
 
 void dAnimationTrack::AddRotation(dFloat time, dFloat x, dFloat y, dFloat z)
 {
+	m_compressedTrack.RemoveAll();
 	dCurveValue& value = m_rotation.Append()->GetInfo();
 	value.m_x = x;
 	value.m_y = y;
@@ -86,6 +90,7 @@ void dAnimationTrack::AddKeyframe(dFloat time, const dMatrix& matrix)
 
 void dAnimationTrack::ResampleAnimation()
 {
+	m_compressedTrack.RemoveAll();
 	dFloat period = m_scale.GetLast()->GetInfo().m_time;
 	dFloat t1 = m_position.GetLast()->GetInfo().m_time;
 	period = dMax(period, t1);
@@ -273,6 +278,7 @@ dFloat dAnimationTrack::FixAngleAlias(dFloat angleA, dFloat angleB) const
 
 void dAnimationTrack::OptimizeCurves()
 {
+	m_compressedTrack.RemoveAll();
 	if (m_scale.GetCount()) {
 		OptimizeCurve(m_scale);
 	}
@@ -293,6 +299,114 @@ void dAnimationTrack::OptimizeCurves()
 	}
 }
 
+void dAnimationTrack::GetKeyFrames(dAnimimationKeyFramesTrack& track) const
+{
+	dAssert(!track.m_position.GetSize() && !track.m_rotation.GetSize() && !track.m_scale.GetSize());
+
+	int index = 0;
+	track.m_position.Resize(m_position.GetCount());
+	for (dCurve::dListNode* node = m_position.GetFirst(); node; node = node->GetNext()) {
+		const dCurveValue& value = node->GetInfo();
+		track.m_position[index].m_posit = dVector(value.m_x, value.m_y, value.m_z, dFloat(1.0f));
+		track.m_position[index].m_time = value.m_time;
+		index++;
+	}
+
+	index = 0;
+	track.m_rotation.Resize(m_rotation.GetCount());
+	for (dCurve::dListNode* node = m_rotation.GetFirst(); node; node = node->GetNext()) {
+		const dCurveValue& value = node->GetInfo();
+		dQuaternion rotation(dPitchMatrix(value.m_x) * dYawMatrix(value.m_y) * dRollMatrix(value.m_z));
+		if (index && (rotation.DotProduct(track.m_rotation[index - 1].m_rotation) < dFloat(0.0f))) {
+			rotation.m_x *= dFloat(-1.0f);
+			rotation.m_y *= dFloat(-1.0f);
+			rotation.m_z *= dFloat(-1.0f);
+			rotation.m_w *= dFloat(-1.0f);
+		}
+		track.m_rotation[index].m_rotation = rotation;
+		track.m_rotation[index].m_time = value.m_time;
+		index++;
+	}
+
+	index = 0;
+	track.m_scale.Resize(m_scale.GetCount());
+	for (dCurve::dListNode* node = m_scale.GetFirst(); node; node = node->GetNext()) {
+		const dCurveValue& value = node->GetInfo();
+		track.m_scale[index].m_scale = dVector(value.m_x, value.m_y, value.m_z, dFloat(1.0f));
+		track.m_scale[index].m_time = value.m_time;
+		index++;
+	}
+}
+
+bool dAnimationTrack::Compress(dFloat framesPerSecond, dFloat positionTolerance, dFloat rotationTolerance, dFloat scaleTolerance)
+{
+	dAnimimationKeyFramesTrack track;
+	GetKeyFrames(track);
+	return m_compressedTrack.Compress(track, framesPerSecond, positionTolerance, rotationTolerance, scaleTolerance);
+}
+
+void dAnimationTrack::ExpandCompressedTrack()
+{
+	dAnimimationKeyFramesTrack track;
+	m_compressedTrack.Decompress(track);
+
+	m_scale.RemoveAll();
+	m_position.RemoveAll();
+	m_rotation.RemoveAll();
+
+	dFloat period = dFloat(0.0f);
+	for (int i = 0; i < track.m_position.GetSize(); i++) {
+		const dAnimimationKeyFramesTrack::dPositionKey& key = track.m_position[i];
+		dCurveValue& value = m_position.Append()->GetInfo();
+		value.m_x = key.m_posit.m_x;
+		value.m_y = key.m_posit.m_y;
+		value.m_z = key.m_posit.m_z;
+		value.m_time = key.m_time;
+		period = dMax(period, key.m_time);
+	}
+
+	for (int i = 0; i < track.m_rotation.GetSize(); i++) {
+		dVector euler0;
+		dVector euler1;
+		const dAnimimationKeyFramesTrack::dRotationKey& key = track.m_rotation[i];
+		dMatrix matrix(key.m_rotation, dVector(dFloat(0.0f), dFloat(0.0f), dFloat(0.0f), dFloat(1.0f)));
+		matrix.GetEulerAngles(euler0, euler1);
+
+		dCurveValue& value = m_rotation.Append()->GetInfo();
+		value.m_x = euler0.m_x;
+		value.m_y = euler0.m_y;
+		value.m_z = euler0.m_z;
+		value.m_time = key.m_time;
+		if (i) {
+			const dCurveValue& value0 = m_rotation.GetLast()->GetPrev()->GetInfo();
+			value.m_x = FixAngleAlias(value0.m_x, value.m_x);
+			value.m_y = FixAngleAlias(value0.m_y, value.m_y);
+			value.m_z = FixAngleAlias(value0.m_z, value.m_z);
+		}
+		period = dMax(period, key.m_time);
+	}
+
+	for (int i = 0; i < track.m_scale.GetSize(); i++) {
+		const dAnimimationKeyFramesTrack::dScaleKey& key = track.m_scale[i];
+		dCurveValue& value = m_scale.Append()->GetInfo();
+		value.m_x = key.m_scale.m_x;
+		value.m_y = key.m_scale.m_y;
+		value.m_z = key.m_scale.m_z;
+		value.m_time = key.m_time;
+		period = dMax(period, key.m_time);
+	}
+
+	// a channel that does not move is stored as one key, the curves always span the whole track
+	dCurve* const curves[] = {&m_scale, &m_position, &m_rotation};
+	for (int i = 0; i < 3; i++) {
+		if (curves[i]->GetCount() == 1) {
+			dCurveValue value(curves[i]->GetFirst()->GetInfo());
+			value.m_time = period;
+			curves[i]->Append(value);
+		}
+	}
+}
+
 void dAnimationTrack::Serialize (TiXmlElement* const rootNode) 
 {
 	SerialiseBase(dNodeInfo, rootNode);
@@ -300,6 +414,23 @@ void dAnimationTrack::Serialize (TiXmlElement* const rootNode)
 	dAssert(m_rotation.GetCount() >= 2);
 	dAssert(m_position.GetCount() >= 2);
 
+	if (m_compressedTrack.GetKeysCount()) {
+		// the compressed track is saved in place of the curves, loading rebuilds them from it
+		TiXmlElement* const compressedKeys = new TiXmlElement("compressedKeyframes");
+		rootNode->LinkEndChild(compressedKeys);
+
+		const int count = m_compressedTrack.GetSerializedSize();
+		const int bufferSizeInBytes = 12 * (count + 1);
+		char* const buffer = dAlloca(char, bufferSizeInBytes);
+		int* const words = dAlloca(int, count);
+		m_compressedTrack.Serialize(words);
+
+		dIntArrayToString(words, count, buffer, bufferSizeInBytes);
+		compressedKeys->SetAttribute("int", count);
+		compressedKeys->SetAttribute("ints", buffer);
+		return;
+	}
+
 	if (m_scale.GetCount()) {
 		TiXmlElement* const scaleKeys = new TiXmlElement("scaleKeyframes");
 		rootNode->LinkEndChild(scaleKeys);
@@ -402,6 +533,27 @@ bool dAnimationTrack::Deserialize (const dScene* const scene, TiXmlElement* cons
 {
 	DeserialiseBase(scene, dNodeInfo, rootNode);
 
+	TiXmlElement* const compressedKeyframes = (TiXmlElement*)rootNode->FirstChild("compressedKeyframes");
+	if (compressedKeyframes) {
+		int count = 0;
+		compressedKeyframes->Attribute("int", &count);
+		const char* const words = compressedKeyframes->Attribute("ints");
+
+		// every word takes at least two characters, a larger count is a corrupted file
+		if (!words || (count <= 0) || (count > int(strlen(words) / 2 + 1))) {
+			return false;
+		}
+
+		dArray<int> buffer;
+		buffer.Resize(count);
+		dStringToIntArray(words, &buffer[0], count);
+		if (!m_compressedTrack.Deserialize(&buffer[0], count)) {
+			return false;
+		}
+		ExpandCompressedTrack();
+		return true;
+	}
+
 	TiXmlElement* const scaleKeyframes = (TiXmlElement*)rootNode->FirstChild("scaleKeyframes");
 	if (scaleKeyframes) {
 
@@ -20,6 +20,9 @@
 #define _D_ANIMATION_TRACK_H_
 
 #include "dNodeInfo.h"
+#include <dAnimationCompressedTrack.h>
+
+class dAnimimationKeyFramesTrack;
 
 class dAnimationTrack: public dNodeInfo
 {
@@ -79,11 +82,20 @@ class dAnimationTrack: public dNodeInfo
 	void OptimizeCurves();
 	virtual void FreezeScale(const dMatrix& matrix);
 
+	// the curves as quaternion key frames, the way the animation library samples them
+	void GetKeyFrames(dAnimimationKeyFramesTrack& track) const;
+
+	// a compressed track is saved in place of the curves, and loading it expands it back to curves.
+	// editing the curves drops the compressed track.
+	bool Compress(dFloat framesPerSecond = dFloat(60.0f), dFloat positionTolerance = dFloat(1.0e-4f), dFloat rotationTolerance = dFloat(1.0e-3f), dFloat scaleTolerance = dFloat(1.0e-4f));
+	const dAnimationCompressedTrack* GetCompressedTrack() const;
+
 	protected:
 	void ResampleAnimation();
 	void OptimizeCurve(dList<dCurveValue>& curve);
 	dFloat FixAngleAlias(dFloat angle0, dFloat angle1) const;
 	dFloat Interpolate(dFloat x0, dFloat t0, dFloat x1, dFloat t1, dFloat t) const;
+	void ExpandCompressedTrack();
 	
 	virtual void BakeTransform(const dMatrix& matrix);
 	virtual void Serialize (TiXmlElement* const rootNode); 
@@ -92,6 +104,7 @@ class dAnimationTrack: public dNodeInfo
 	dCurve m_scale;
 	dCurve m_position;
 	dCurve m_rotation;
+	dAnimationCompressedTrack m_compressedTrack;
 };
 
 inline const dList<dAnimationTrack::dCurveValue>& dAnimationTrack::GetScales() const
@@ -109,5 +122,10 @@ inline const dList<dAnimationTrack::dCurveValue>& dAnimationTrack::GetRotations(
 	return m_rotation;
 }
 
+inline const dAnimationCompressedTrack* dAnimationTrack::GetCompressedTrack() const
+{
+	return m_compressedTrack.GetKeysCount() ? &m_compressedTrack : NULL;
+}
+
 
 #endif
\ No newline at end of file
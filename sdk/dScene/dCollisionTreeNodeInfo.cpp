@@ -21,6 +21,7 @@
 #include "dScene.h"
 #include "dDrawUtils.h"
 #include "dCollisionTreeNodeInfo.h"
+#include "dSceneBinary.h"
 #include <tinyxml.h>
 
 D_IMPLEMENT_CLASS_NODE(dCollisionTreeNodeInfo);
@@ -93,6 +94,25 @@ bool dCollisionTreeNodeInfo::Deserialize (const dScene* const scene, TiXmlElemen
 	return true;
 }
 
+void dCollisionTreeNodeInfo::SerializeBinary (dSceneBinaryWriter& writer) 
+{
+	TiXmlElement rootNode (GetClassName());
+	dCollisionNodeInfo::Serialize (&rootNode);
+	SerializeBinaryElement (writer, &rootNode);
+	SerializeMesh (m_mesh, writer);
+}
+
+bool dCollisionTreeNodeInfo::DeserializeBinary (const dScene* const scene, dSceneBinaryReader& reader) 
+{
+	TiXmlDocument document;
+	TiXmlElement* const rootNode = DeserializeBinaryElement (reader, document);
+	if (!rootNode) {
+		return false;
+	}
+	dCollisionNodeInfo::Deserialize (scene, rootNode);
+	return DeserializeMesh (m_mesh, reader);
+}
+
 
 NewtonCollision* dCollisionTreeNodeInfo::CreateNewtonCollision (NewtonWorld* const world, dScene* const scene, dScene::dTreeNode* const myNode) const
 {
@@ -41,6 +41,8 @@ class dCollisionTreeNodeInfo: public dCollisionNodeInfo
 	protected:
 	virtual void Serialize (TiXmlElement* const rootNode); 
 	virtual bool Deserialize (const dScene* const scene, TiXmlElement* const rootNode);
+	virtual void SerializeBinary (dSceneBinaryWriter& writer);
+	virtual bool DeserializeBinary (const dScene* const scene, dSceneBinaryReader& reader);
 	NewtonCollision* CreateNewtonCollision (NewtonWorld* const world, dScene* const scene, dScene::dTreeNode* const myNode) const;
 
 	NewtonMesh* m_mesh;
@@ -24,6 +24,7 @@
 #include "dSceneNodeInfo.h"
 #include "dGeometryNodeModifierInfo.h"
 #include "dGeometryNodeSkinClusterInfo.h"
+#include "dSceneBinary.h"
 #include <tinyxml.h>
 
 D_IMPLEMENT_CLASS_NODE(dGeometryNodeSkinClusterInfo);
@@ -122,3 +123,45 @@ bool dGeometryNodeSkinClusterInfo::Deserialize (const dScene* const scene, TiXml
 	return true;
 }
 
+void dGeometryNodeSkinClusterInfo::SerializeBinary (dSceneBinaryWriter& writer) 
+{
+	TiXmlElement rootNode (GetClassName());
+	dNodeInfo::Serialize (&rootNode);
+	SerializeBinaryElement (writer, &rootNode);
+
+	writer.WriteFloatArray (&m_basePoseMatrix[0][0], 16);
+	writer.WriteIntArray (&m_vertexIndex[0], m_vertexIndex.GetSize());
+	writer.WriteFloatArray (&m_vertexWeight[0], m_vertexWeight.GetSize());
+}
+
+bool dGeometryNodeSkinClusterInfo::DeserializeBinary (const dScene* const scene, dSceneBinaryReader& reader) 
+{
+	TiXmlDocument document;
+	TiXmlElement* const rootNode = DeserializeBinaryElement (reader, document);
+	if (!rootNode) {
+		return false;
+	}
+	dNodeInfo::Deserialize (scene, rootNode);
+
+	int count;
+	const dFloat* const matrix = reader.ReadFloatArray (count);
+	if (count != 16) {
+		return false;
+	}
+	memcpy (&m_basePoseMatrix[0][0], matrix, 16 * sizeof (dFloat));
+
+	int vertexCount; 
+	int weightCount; 
+	const int* const vertexIndex = reader.ReadIntArray (vertexCount);
+	const dFloat* const vertexWeight = reader.ReadFloatArray (weightCount);
+	if (reader.HasError() || (vertexCount != weightCount)) {
+		return false;
+	}
+	m_vertexIndex.Resize(vertexCount);
+	m_vertexWeight.Resize(weightCount);
+	memcpy (&m_vertexIndex[0], vertexIndex, vertexCount * sizeof (int));
+	memcpy (&m_vertexWeight[0], vertexWeight, weightCount * sizeof (dFloat));
+
+	return true;
+}
+
@@ -36,6 +36,8 @@ class dGeometryNodeSkinClusterInfo: public dNodeInfo
 
 	DSCENE_API virtual void Serialize (TiXmlElement* const rootNode);
 	DSCENE_API virtual bool Deserialize (const dScene* const scene, TiXmlElement* const rootNode);
+	DSCENE_API virtual void SerializeBinary (dSceneBinaryWriter& writer);
+	DSCENE_API virtual bool DeserializeBinary (const dScene* const scene, dSceneBinaryReader& reader);
 
 	dMatrix m_basePoseMatrix;
 	dArray<int> m_vertexIndex;
@@ -24,6 +24,7 @@
 #include "dTextureNodeInfo.h"
 #include "dMaterialNodeInfo.h"
 #include "dGeometryNodeModifierInfo.h"
+#include "dSceneBinary.h"
 #include <tinyxml.h>
 
 D_IMPLEMENT_CLASS_NODE(dMeshNodeInfo);
@@ -310,3 +311,22 @@ bool dMeshNodeInfo::Deserialize(const dScene* const scene, TiXmlElement* const r
 	DeserializeMesh(m_mesh, rootNode);
 	return true;
 }
+
+void dMeshNodeInfo::SerializeBinary(dSceneBinaryWriter& writer)
+{
+	TiXmlElement rootNode(GetClassName());
+	dGeometryNodeInfo::Serialize(&rootNode);
+	SerializeBinaryElement(writer, &rootNode);
+	SerializeMesh(m_mesh, writer);
+}
+
+bool dMeshNodeInfo::DeserializeBinary(const dScene* const scene, dSceneBinaryReader& reader)
+{
+	TiXmlDocument document;
+	TiXmlElement* const rootNode = DeserializeBinaryElement(reader, document);
+	if (!rootNode) {
+		return false;
+	}
+	dGeometryNodeInfo::Deserialize(scene, rootNode);
+	return DeserializeMesh(m_mesh, reader);
+}
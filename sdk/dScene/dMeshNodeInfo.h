@@ -57,6 +57,8 @@ class dMeshNodeInfo: public dGeometryNodeInfo
 	virtual dCRCTYPE CalculateSignature() const;
 	virtual void Serialize (TiXmlElement* const rootNode); 
 	virtual bool Deserialize (const dScene* const scene, TiXmlElement* const rootNode);
+	virtual void SerializeBinary (dSceneBinaryWriter& writer);
+	virtual bool DeserializeBinary (const dScene* const scene, dSceneBinaryReader& reader);
 
 	virtual void DrawWireFrame(dSceneRender* const render, dScene* const scene, dScene::dTreeNode* const myNode) const;
 	virtual void DrawFlatShaded(dSceneRender* const render, dScene* const scene, dScene::dTreeNode* const myNode) const;
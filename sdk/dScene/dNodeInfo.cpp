@@ -19,6 +19,7 @@
 
 #include "dSceneStdafx.h"
 #include "dNodeInfo.h"
+#include "dSceneBinary.h"
 #include <tinyxml.h>
 
 dInitRtti(dNodeInfo);
@@ -160,4 +161,32 @@ bool dNodeInfo::Deserialize (const dScene* const scene, TiXmlElement* const root
 	dVariableList::Deserialize(scene, rootNode);
 
 	return true;
-}
\ No newline at end of file
+}
+
+void dNodeInfo::SerializeBinaryElement (dSceneBinaryWriter& writer, TiXmlElement* const rootNode)
+{
+	TiXmlPrinter printer;
+	printer.SetStreamPrinting();
+	rootNode->Accept(&printer);
+	writer.WriteString(printer.CStr());
+}
+
+TiXmlElement* dNodeInfo::DeserializeBinaryElement (dSceneBinaryReader& reader, TiXmlDocument& document)
+{
+	document.Parse(reader.ReadString());
+	return document.Error() ? NULL : document.RootElement();
+}
+
+void dNodeInfo::SerializeBinary (dSceneBinaryWriter& writer)
+{
+	TiXmlElement rootNode (GetClassName());
+	Serialize (&rootNode);
+	SerializeBinaryElement (writer, &rootNode);
+}
+
+bool dNodeInfo::DeserializeBinary (const dScene* const scene, dSceneBinaryReader& reader)
+{
+	TiXmlDocument document;
+	TiXmlElement* const rootNode = DeserializeBinaryElement (reader, document);
+	return rootNode ? Deserialize (scene, rootNode) : false;
+}
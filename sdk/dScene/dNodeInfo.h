@@ -26,6 +26,9 @@
 
 class dNodeInfo;
 class dSceneRender;
+class TiXmlDocument;
+class dSceneBinaryWriter;
+class dSceneBinaryReader;
 
 
 #define D_DEFINE_CLASS_NODE_ESSENCIALS(className,baseClass,exportType)		\
@@ -109,6 +112,10 @@ class dNodeInfo: public dClassInfo, public dVariableList
 	virtual void Serialize (TiXmlElement* const rootNode); 
 	virtual bool Deserialize (const dScene* const scene, TiXmlElement* const rootNode);
 
+	// nodes without a binary layout save their xml element as text inside the chunk
+	virtual void SerializeBinary (dSceneBinaryWriter& writer);
+	virtual bool DeserializeBinary (const dScene* const scene, dSceneBinaryReader& reader);
+
 	// draw scene in wire frame mode
 	virtual void DrawWireFrame(dSceneRender* const render, dScene* const scene, dScene::dTreeNode* const myNode) const{dAssert (0);}
 	virtual void DrawFlatShaded(dSceneRender* const render, dScene* const scene, dScene::dTreeNode* const myNode) const{dAssert (0);}
@@ -121,6 +128,10 @@ class dNodeInfo: public dClassInfo, public dVariableList
 
 	dAddRtti(dClassInfo,DSCENE_API);
 
+	protected:
+	static void SerializeBinaryElement (dSceneBinaryWriter& writer, TiXmlElement* const rootNode);
+	static TiXmlElement* DeserializeBinaryElement (dSceneBinaryReader& reader, TiXmlDocument& document);
+
 	private:
 	dString m_name;
 	int m_uniqueID;
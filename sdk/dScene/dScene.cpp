@@ -41,6 +41,7 @@
 #include "dCollisionConvexHullNodeInfo.h"
 #include "dGeometryNodeSkinClusterInfo.h"
 #include "dCollisionChamferCylinderNodeInfo.h"
+#include "dSceneBinary.h"
 #include <tinyxml.h>
 
 
@@ -1596,8 +1597,50 @@ void dScene::NewtonWorldToScene (const NewtonWorld* const world, dSceneExportCal
 	}
 }
 
+bool dScene::SerializeBinary (const char* const fileName, bool compress)
+{
+	// nodes without a binary layout are saved as xml text, using standard localization
+	char* const oldloc = setlocale( LC_ALL, 0 );
+	setlocale( LC_ALL, "C" );
+
+	// need to remove unused vertices's before saving, otherwise Deserialize will not work,
+	RemoveUnusedVertex();
+
+	dSceneBinaryFile file;
+	bool state = file.Create (fileName, m_revision, compress);
+	if (state) {
+		state = dSceneGraph::SerializeBinary (file);
+		state = file.Close() && state;
+	}
+
+	// restore locale settings
+	setlocale (LC_ALL, oldloc);
+	return state;
+}
+
+bool dScene::DeserializeBinary (const char* const fileName)
+{
+	setlocale( LC_ALL, "C" );
+
+	dSceneBinaryFile file;
+	bool state = file.Open (fileName);
+	if (state) {
+		// binary files are always saved at the current revision
+		m_revision = file.GetRevision();
+		dAssert (m_revision >= 105);
+		state = dSceneGraph::DeserializeBinary (file);
+	}
+
+	setlocale( LC_ALL, "");
+	return state;
+}
+
 bool dScene::Deserialize (const char* const fileName)
 {
+	if (dSceneBinaryFile::IsBinaryFile (fileName)) {
+		return DeserializeBinary (fileName);
+	}
+
 	// apply last Configuration, using standard localization
 	//static char* oldloc = setlocale( LC_ALL, 0 );
 	setlocale( LC_ALL, "C" );
@@ -147,6 +147,11 @@ class dScene: public dSceneGraph, public dRefCounter
 	DSCENE_API virtual void Serialize (const char* const fileName);
 	DSCENE_API virtual bool Deserialize (const char* const fileName);
 
+	// chunked binary file, arrays are stored raw and nodes can be optionally compressed.
+	// Deserialize detects binary files as well, use dSceneBinaryFile directly for loading individual nodes.
+	DSCENE_API virtual bool SerializeBinary (const char* const fileName, bool compress = false);
+	DSCENE_API virtual bool DeserializeBinary (const char* const fileName);
+
 	DSCENE_API virtual dFloat RayCast (const dVector& p0, const dVector& p1, dList<dTreeNode*>& traceRoot) const;
 
 	DSCENE_API virtual void FreezeScale ();
@@ -0,0 +1,532 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        dSceneBinary.cpp
+// Purpose:
+// Author:      Julio Jerez
+// Modified by:
+// Created:     22/05/2010 08:02:08
+// RCS-ID:
+// Copyright:   Copyright (c) <2010> <Newton Game Dynamics>
+// License:
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely
+/////////////////////////////////////////////////////////////////////////////
+
+#include "dSceneStdafx.h"
+#include "dScene.h"
+#include "dNodeInfo.h"
+#include "dSceneBinary.h"
+
+#ifdef _DSCENE_USE_ZLIB
+	#include <zlib.h>
+#endif
+
+#define D_SCENE_BINARY_DOUBLE_PRECISION	(1<<0)
+
+class dSceneBinaryHeader
+{
+	public:
+	int m_magic;
+	int m_version;
+	int m_revision;
+	int m_flags;
+	int m_nodeCount;
+	int m_directoryOffset;
+	int m_directorySize;
+	int m_reserved;
+};
+
+static char* dAlignBuffer (char* const buffer)
+{
+	return (char*) ((size_t (buffer) + D_SCENE_BINARY_ALIGNMENT - 1) & ~size_t (D_SCENE_BINARY_ALIGNMENT - 1));
+}
+
+
+dSceneBinaryWriter::dSceneBinaryWriter()
+	:m_data(NULL)
+	,m_size(0)
+	,m_capacity(0)
+{
+}
+
+dSceneBinaryWriter::~dSceneBinaryWriter()
+{
+	if (m_data) {
+		delete[] m_data;
+	}
+}
+
+void dSceneBinaryWriter::Reserve (int sizeInBytes)
+{
+	if (sizeInBytes > m_capacity) {
+		int capacity = dMax (m_capacity * 2, 1024);
+		while (capacity < sizeInBytes) {
+			capacity *= 2;
+		}
+		char* const data = new char[capacity];
+		if (m_data) {
+			memcpy (data, m_data, m_size);
+			delete[] m_data;
+		}
+		m_data = data;
+		m_capacity = capacity;
+	}
+}
+
+void dSceneBinaryWriter::WriteBytes (const void* const data, int sizeInBytes)
+{
+	Reserve (m_size + sizeInBytes);
+	memcpy (&m_data[m_size], data, sizeInBytes);
+	m_size += sizeInBytes;
+}
+
+void dSceneBinaryWriter::Align (int alignment)
+{
+	int size = (m_size + alignment - 1) & -alignment;
+	Reserve (size);
+	memset (&m_data[m_size], 0, size - m_size);
+	m_size = size;
+}
+
+void dSceneBinaryWriter::WriteInt (int value)
+{
+	WriteBytes (&value, sizeof (int));
+}
+
+void dSceneBinaryWriter::WriteFloat (dFloat value)
+{
+	WriteBytes (&value, sizeof (dFloat));
+}
+
+void dSceneBinaryWriter::WriteString (const char* const string)
+{
+	int length = string ? int (strlen (string)) : 0;
+	WriteInt (length);
+	WriteBytes (string ? string : "", length + 1);
+	Align (sizeof (int));
+}
+
+void dSceneBinaryWriter::WriteIntArray (const int* const array, int count)
+{
+	WriteInt (count);
+	Align (D_SCENE_BINARY_ALIGNMENT);
+	WriteBytes (array, count * sizeof (int));
+	Align (sizeof (int));
+}
+
+void dSceneBinaryWriter::WriteFloatArray (const dFloat* const array, int count)
+{
+	WriteInt (count);
+	Align (D_SCENE_BINARY_ALIGNMENT);
+	WriteBytes (array, count * sizeof (dFloat));
+	Align (sizeof (int));
+}
+
+void dSceneBinaryWriter::WriteFloat64Array (const dFloat64* const array, int count)
+{
+	WriteInt (count);
+	Align (D_SCENE_BINARY_ALIGNMENT);
+	WriteBytes (array, count * sizeof (dFloat64));
+}
+
+
+dSceneBinaryReader::dSceneBinaryReader(const char* const data, int size)
+	:m_data(data)
+	,m_size(size)
+	,m_position(0)
+	,m_error(false)
+{
+	dAssert (!(size_t (data) & (D_SCENE_BINARY_ALIGNMENT - 1)));
+}
+
+const void* dSceneBinaryReader::ReadBytes (int sizeInBytes)
+{
+	if (m_error || (sizeInBytes < 0) || (sizeInBytes > (m_size - m_position))) {
+		m_error = true;
+		return NULL;
+	}
+	const void* const data = &m_data[m_position];
+	m_position += sizeInBytes;
+	return data;
+}
+
+void dSceneBinaryReader::Align (int alignment)
+{
+	m_position = dMin ((m_position + alignment - 1) & -alignment, m_size);
+}
+
+int dSceneBinaryReader::ReadInt ()
+{
+	const int* const value = (const int*) ReadBytes (sizeof (int));
+	return value ? *value : 0;
+}
+
+dFloat dSceneBinaryReader::ReadFloat ()
+{
+	const dFloat* const value = (const dFloat*) ReadBytes (sizeof (dFloat));
+	return value ? *value : dFloat (0.0f);
+}
+
+const char* dSceneBinaryReader::ReadString ()
+{
+	int length = ReadInt();
+	const char* const string = (length >= 0) && (length < m_size) ? (const char*) ReadBytes (length + 1) : NULL;
+	Align (sizeof (int));
+	if (!string || string[length]) {
+		m_error = true;
+		return "";
+	}
+	return string;
+}
+
+const void* dSceneBinaryReader::ReadArray (int& count, int elementSize)
+{
+	count = ReadInt();
+	Align (D_SCENE_BINARY_ALIGNMENT);
+	// the count is checked against the bytes left before it is scaled, so that it can not overflow
+	const void* const array = (count >= 0) && (count <= ((m_size - m_position) / elementSize)) ? ReadBytes (count * elementSize) : NULL;
+	if (!array) {
+		m_error = true;
+		count = 0;
+	}
+	return array;
+}
+
+const int* dSceneBinaryReader::ReadIntArray (int& count)
+{
+	const int* const array = (const int*) ReadArray (count, sizeof (int));
+	Align (sizeof (int));
+	return array;
+}
+
+const dFloat* dSceneBinaryReader::ReadFloatArray (int& count)
+{
+	const dFloat* const array = (const dFloat*) ReadArray (count, sizeof (dFloat));
+	Align (sizeof (int));
+	return array;
+}
+
+const dFloat64* dSceneBinaryReader::ReadFloat64Array (int& count)
+{
+	return (const dFloat64*) ReadArray (count, sizeof (dFloat64));
+}
+
+
+dSceneBinaryFile::dSceneBinaryFile()
+	:m_file(NULL)
+	,m_directory(NULL)
+	,m_entries(NULL)
+	,m_directoryWriter(NULL)
+	,m_nodeMap()
+	,m_revision(0)
+	,m_nodeCount(0)
+	,m_offset(0)
+	,m_compress(false)
+	,m_writeError(false)
+{
+}
+
+dSceneBinaryFile::~dSceneBinaryFile()
+{
+	Close();
+}
+
+bool dSceneBinaryFile::IsBinaryFile (const char* const fileName)
+{
+	int magic = 0;
+	FILE* const file = fopen (fileName, "rb");
+	if (file) {
+		if (fread (&magic, sizeof (int), 1, file) != 1) {
+			magic = 0;
+		}
+		fclose (file);
+	}
+	return magic == D_SCENE_BINARY_MAGIC;
+}
+
+void dSceneBinaryFile::Write (const void* const data, int sizeInBytes)
+{
+	// offsets are stored as int, a file that grows past that range can not be addressed
+	if ((sizeInBytes > (0x7fffffff - D_SCENE_BINARY_ALIGNMENT - m_offset)) || (fwrite (data, 1, size_t (sizeInBytes), m_file) != size_t (sizeInBytes))) {
+		m_writeError = true;
+	}
+	m_offset += m_writeError ? 0 : sizeInBytes;
+}
+
+void dSceneBinaryFile::WritePadding ()
+{
+	char padding[D_SCENE_BINARY_ALIGNMENT];
+	memset (padding, 0, sizeof (padding));
+	int offset = (m_offset + D_SCENE_BINARY_ALIGNMENT - 1) & -D_SCENE_BINARY_ALIGNMENT;
+	Write (padding, offset - m_offset);
+}
+
+bool dSceneBinaryFile::Create (const char* const fileName, int revision, bool compress)
+{
+	Close();
+	m_file = fopen (fileName, "wb");
+	if (!m_file) {
+		return false;
+	}
+
+	dSceneBinaryHeader header;
+	memset (&header, 0, sizeof (header));
+	if (fwrite (&header, sizeof (header), 1, m_file) != 1) {
+		fclose (m_file);
+		m_file = NULL;
+		return false;
+	}
+
+	#ifdef _DSCENE_USE_ZLIB
+		m_compress = compress;
+	#else
+		m_compress = false;
+	#endif
+	m_revision = revision;
+	m_offset = sizeof (header);
+	m_writeError = false;
+	m_directoryWriter = new dSceneBinaryWriter;
+	return true;
+}
+
+bool dSceneBinaryFile::AddNode (const dNodeInfo* const info, const dSceneBinaryWriter& chunk, const int* const parents, int parentCount, const int* const children, int childCount)
+{
+	dAssert (m_file && m_directoryWriter);
+
+	const char* data = chunk.GetData();
+	int size = chunk.GetSize();
+	char* compressedData = NULL;
+
+	#ifdef _DSCENE_USE_ZLIB
+	if (m_compress) {
+		uLongf compressedSize = compressBound (uLong (size));
+		compressedData = new char[compressedSize];
+		if ((compress2 ((Bytef*)compressedData, &compressedSize, (const Bytef*)data, uLong (size), Z_DEFAULT_COMPRESSION) == Z_OK) && (int (compressedSize) < size)) {
+			// only keep the compressed chunk when it pays off, small nodes are stored raw
+			data = compressedData;
+			size = int (compressedSize);
+		}
+	}
+	#endif
+
+	int offset = m_offset;
+	Write (data, size);
+	WritePadding();
+
+	if (compressedData) {
+		delete[] compressedData;
+	}
+
+	m_directoryWriter->WriteString (info->GetClassName());
+	m_directoryWriter->WriteString (info->GetName());
+	m_directoryWriter->WriteInt (info->GetNodeID());
+	m_directoryWriter->WriteInt (offset);
+	m_directoryWriter->WriteInt (size);
+	m_directoryWriter->WriteInt (chunk.GetSize());
+	m_directoryWriter->WriteIntArray (parents, parentCount);
+	m_directoryWriter->WriteIntArray (children, childCount);
+	m_nodeCount ++;
+	return !m_writeError;
+}
+
+bool dSceneBinaryFile::Open (const char* const fileName)
+{
+	Close();
+	m_file = fopen (fileName, "rb");
+	if (!m_file) {
+		return false;
+	}
+
+	dSceneBinaryHeader header;
+	memset (&header, 0, sizeof (header));
+	bool state = fread (&header, sizeof (header), 1, m_file) == 1;
+	state = state && (header.m_magic == D_SCENE_BINARY_MAGIC) && (header.m_version == D_SCENE_BINARY_VERSION);
+
+	int precision = (sizeof (dFloat) == sizeof (dFloat64)) ? D_SCENE_BINARY_DOUBLE_PRECISION : 0;
+	state = state && ((header.m_flags & D_SCENE_BINARY_DOUBLE_PRECISION) == precision);
+
+	// the directory must lie between the header and the end of the file
+	long fileSize = (state && !fseek (m_file, 0, SEEK_END)) ? ftell (m_file) : -1;
+	state = state && (fileSize >= long (sizeof (header))) && (header.m_nodeCount >= 0);
+	state = state && (header.m_directoryOffset >= int (sizeof (header))) && (header.m_directorySize >= 0);
+	state = state && (long (header.m_directorySize) <= (fileSize - long (header.m_directoryOffset)));
+	if (state) {
+		m_directory = new char[header.m_directorySize + D_SCENE_BINARY_ALIGNMENT];
+		char* const directory = dAlignBuffer (m_directory);
+		state = !fseek (m_file, header.m_directoryOffset, SEEK_SET);
+		state = state && (fread (directory, 1, header.m_directorySize, m_file) == size_t (header.m_directorySize));
+		// each entry takes at least its two strings and two array counts, this bounds the allocation below
+		state = state && (header.m_nodeCount <= (header.m_directorySize / int (6 * sizeof (int))));
+
+		if (state) {
+			m_revision = header.m_revision;
+			m_nodeCount = header.m_nodeCount;
+			m_entries = new dEntry[m_nodeCount];
+
+			dSceneBinaryReader reader (directory, header.m_directorySize);
+			for (int i = 0; i < m_nodeCount; i ++) {
+				dEntry& entry = m_entries[i];
+				entry.m_className = reader.ReadString();
+				entry.m_name = reader.ReadString();
+				entry.m_nodeID = reader.ReadInt();
+				entry.m_offset = reader.ReadInt();
+				entry.m_size = reader.ReadInt();
+				entry.m_rawSize = reader.ReadInt();
+				entry.m_parents = reader.ReadIntArray (entry.m_parentCount);
+				entry.m_children = reader.ReadIntArray (entry.m_childCount);
+
+				// node chunks sit between the header and the directory
+				state = state && !reader.HasError() && (entry.m_size >= 0) && (entry.m_rawSize >= 0);
+				state = state && (entry.m_offset >= int (sizeof (header))) && (entry.m_size <= (header.m_directoryOffset - entry.m_offset));
+				if (!state) {
+					break;
+				}
+				m_nodeMap.Insert (i, entry.m_nodeID);
+			}
+		}
+	}
+
+	if (!state) {
+		dTrace (("%s is not a valid binary scene\n", fileName));
+		Close();
+	}
+	return state;
+}
+
+bool dSceneBinaryFile::Close ()
+{
+	bool state = true;
+	if (m_file && m_directoryWriter) {
+		// finish a new file, write the directory and patch the header
+		WritePadding();
+		int directoryOffset = m_offset;
+		Write (m_directoryWriter->GetData(), m_directoryWriter->GetSize());
+
+		dSceneBinaryHeader header;
+		memset (&header, 0, sizeof (header));
+		header.m_magic = D_SCENE_BINARY_MAGIC;
+		header.m_version = D_SCENE_BINARY_VERSION;
+		header.m_revision = m_revision;
+		header.m_flags = (sizeof (dFloat) == sizeof (dFloat64)) ? D_SCENE_BINARY_DOUBLE_PRECISION : 0;
+		header.m_nodeCount = m_nodeCount;
+		header.m_directoryOffset = directoryOffset;
+		header.m_directorySize = m_directoryWriter->GetSize();
+
+		// the header is left zeroed if anything failed, so a partial file is never taken for a valid scene
+		state = !m_writeError && !fseek (m_file, 0, SEEK_SET) && (fwrite (&header, sizeof (header), 1, m_file) == 1);
+		state = !fclose (m_file) && state;
+		m_file = NULL;
+	}
+
+	if (m_file) {
+		fclose (m_file);
+	}
+	if (m_directoryWriter) {
+		delete m_directoryWriter;
+	}
+	if (m_entries) {
+		delete[] m_entries;
+	}
+	if (m_directory) {
+		delete[] m_directory;
+	}
+
+	m_nodeMap.RemoveAll();
+	m_file = NULL;
+	m_directory = NULL;
+	m_entries = NULL;
+	m_directoryWriter = NULL;
+	m_revision = 0;
+	m_nodeCount = 0;
+	m_offset = 0;
+	m_compress = false;
+	m_writeError = false;
+	return state;
+}
+
+int dSceneBinaryFile::FindNode (int nodeID) const
+{
+	dTree<int, int>::dTreeNode* const node = m_nodeMap.Find (nodeID);
+	return node ? node->GetInfo() : -1;
+}
+
+int dSceneBinaryFile::GetNodeID (int index) const
+{
+	dAssert ((index >= 0) && (index < m_nodeCount));
+	return m_entries[index].m_nodeID;
+}
+
+const char* dSceneBinaryFile::GetNodeName (int index) const
+{
+	dAssert ((index >= 0) && (index < m_nodeCount));
+	return m_entries[index].m_name;
+}
+
+const char* dSceneBinaryFile::GetNodeClassName (int index) const
+{
+	dAssert ((index >= 0) && (index < m_nodeCount));
+	return m_entries[index].m_className;
+}
+
+const int* dSceneBinaryFile::GetParents (int index, int& count) const
+{
+	dAssert ((index >= 0) && (index < m_nodeCount));
+	count = m_entries[index].m_parentCount;
+	return m_entries[index].m_parents;
+}
+
+const int* dSceneBinaryFile::GetChildren (int index, int& count) const
+{
+	dAssert ((index >= 0) && (index < m_nodeCount));
+	count = m_entries[index].m_childCount;
+	return m_entries[index].m_children;
+}
+
+dNodeInfo* dSceneBinaryFile::LoadNode (int index, dScene* const scene) const
+{
+	dAssert (m_file && m_entries);
+	dAssert ((index >= 0) && (index < m_nodeCount));
+	const dEntry& entry = m_entries[index];
+
+	char* const buffer = new char[entry.m_size + D_SCENE_BINARY_ALIGNMENT];
+	char* data = dAlignBuffer (buffer);
+	fseek (m_file, entry.m_offset, SEEK_SET);
+	bool state = fread (data, 1, entry.m_size, m_file) == size_t (entry.m_size);
+
+	char* rawBuffer = NULL;
+	if (state && (entry.m_size != entry.m_rawSize)) {
+		#ifdef _DSCENE_USE_ZLIB
+			rawBuffer = new char[entry.m_rawSize + D_SCENE_BINARY_ALIGNMENT];
+			char* const rawData = dAlignBuffer (rawBuffer);
+			uLongf rawSize = uLongf (entry.m_rawSize);
+			state = (uncompress ((Bytef*)rawData, &rawSize, (const Bytef*)data, uLong (entry.m_size)) == Z_OK) && (int (rawSize) == entry.m_rawSize);
+			data = rawData;
+		#else
+			dTrace (("compressed scene nodes need zlib support\n"));
+			state = false;
+		#endif
+	}
+
+	dNodeInfo* info = NULL;
+	if (state) {
+		info = dNodeInfo::CreateFromClassName (entry.m_className, scene);
+		if (info) {
+			dSceneBinaryReader reader (data, entry.m_rawSize);
+			if (!info->DeserializeBinary (scene, reader) || reader.HasError()) {
+				dTrace (("node %d of the binary scene is corrupted\n", entry.m_nodeID));
+				info->Release();
+				info = NULL;
+			}
+		}
+	}
+
+	if (rawBuffer) {
+		delete[] rawBuffer;
+	}
+	delete[] buffer;
+	return info;
+}
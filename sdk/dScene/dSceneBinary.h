@@ -0,0 +1,154 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        dSceneBinary.h
+// Purpose:
+// Author:      Julio Jerez
+// Modified by:
+// Created:     22/05/2010 08:02:08
+// RCS-ID:
+// Copyright:   Copyright (c) <2010> <Newton Game Dynamics>
+// License:
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _D_SCENE_BINARY_H_
+#define _D_SCENE_BINARY_H_
+
+class dScene;
+class dNodeInfo;
+
+#define D_SCENE_BINARY_MAGIC		0x444e4742
+#define D_SCENE_BINARY_VERSION		100
+#define D_SCENE_BINARY_ALIGNMENT	16
+
+// a binary scene file is a header, followed by one chunk per node and a directory chunk at the end.
+// the directory holds the class, name, id and edges of every node, so that the graph
+// can be inspected without reading any node, and nodes can be loaded one at a time.
+// all chunks start at aligned file offsets, and arrays are stored raw and aligned inside the
+// chunks so that they can be used in place after the chunk is read.
+
+
+// writes the content of one node chunk
+class dSceneBinaryWriter
+{
+	public:
+	DSCENE_API dSceneBinaryWriter();
+	DSCENE_API ~dSceneBinaryWriter();
+
+	DSCENE_API void WriteInt (int value);
+	DSCENE_API void WriteFloat (dFloat value);
+	DSCENE_API void WriteString (const char* const string);
+
+	DSCENE_API void WriteIntArray (const int* const array, int count);
+	DSCENE_API void WriteFloatArray (const dFloat* const array, int count);
+	DSCENE_API void WriteFloat64Array (const dFloat64* const array, int count);
+
+	DSCENE_API const char* GetData() const {return m_data;}
+	DSCENE_API int GetSize() const {return m_size;}
+
+	private:
+	void Align (int alignment);
+	void WriteBytes (const void* const data, int sizeInBytes);
+	void Reserve (int sizeInBytes);
+
+	char* m_data;
+	int m_size;
+	int m_capacity;
+};
+
+// reads the content of one node chunk, arrays are returned in place.
+// reading past the end of the chunk does not move the cursor, it returns zero values and
+// null arrays and sets the error flag, so a corrupted chunk can be rejected after it is parsed.
+class dSceneBinaryReader
+{
+	public:
+	DSCENE_API dSceneBinaryReader(const char* const data, int size);
+
+	DSCENE_API bool HasError() const {return m_error;}
+
+	DSCENE_API int ReadInt ();
+	DSCENE_API dFloat ReadFloat ();
+	DSCENE_API const char* ReadString ();
+
+	DSCENE_API const int* ReadIntArray (int& count);
+	DSCENE_API const dFloat* ReadFloatArray (int& count);
+	DSCENE_API const dFloat64* ReadFloat64Array (int& count);
+
+	private:
+	void Align (int alignment);
+	const void* ReadBytes (int sizeInBytes);
+	const void* ReadArray (int& count, int elementSize);
+
+	const char* m_data;
+	int m_size;
+	int m_position;
+	bool m_error;
+};
+
+class dSceneBinaryFile
+{
+	public:
+	DSCENE_API dSceneBinaryFile();
+	DSCENE_API ~dSceneBinaryFile();
+
+	DSCENE_API static bool IsBinaryFile (const char* const fileName);
+
+	// saving, nodes are added in any order and the directory is written on close
+	// AddNode and Close return false if any write to the file failed
+	DSCENE_API bool Create (const char* const fileName, int revision, bool compress);
+	DSCENE_API bool AddNode (const dNodeInfo* const info, const dSceneBinaryWriter& chunk, const int* const parents, int parentCount, const int* const children, int childCount);
+
+	// loading, only reads the header and the directory
+	DSCENE_API bool Open (const char* const fileName);
+	DSCENE_API bool Close ();
+
+	DSCENE_API int GetRevision() const {return m_revision;}
+	DSCENE_API int GetNodeCount() const {return m_nodeCount;}
+	DSCENE_API int FindNode (int nodeID) const;
+
+	DSCENE_API int GetNodeID (int index) const;
+	DSCENE_API const char* GetNodeName (int index) const;
+	DSCENE_API const char* GetNodeClassName (int index) const;
+	DSCENE_API const int* GetParents (int index, int& count) const;
+	DSCENE_API const int* GetChildren (int index, int& count) const;
+
+	// read, decompress and deserialize one node, the caller owns the returned reference
+	DSCENE_API dNodeInfo* LoadNode (int index, dScene* const scene) const;
+
+	private:
+	class dEntry
+	{
+		public:
+		const char* m_className;
+		const char* m_name;
+		const int* m_parents;
+		const int* m_children;
+		int m_parentCount;
+		int m_childCount;
+		int m_nodeID;
+		int m_offset;
+		int m_size;
+		int m_rawSize;
+	};
+
+	void Write (const void* const data, int sizeInBytes);
+	void WritePadding ();
+
+	FILE* m_file;
+	char* m_directory;
+	dEntry* m_entries;
+	dSceneBinaryWriter* m_directoryWriter;
+	dTree<int, int> m_nodeMap;
+	int m_revision;
+	int m_nodeCount;
+	int m_offset;
+	bool m_compress;
+	bool m_writeError;
+};
+
+#endif
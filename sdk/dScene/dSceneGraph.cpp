@@ -22,6 +22,7 @@
 #include "dNodeInfo.h"
 #include "dSceneNodeInfo.h"
 #include "dSceneGraph.h"
+#include "dSceneBinary.h"
 #include <tinyxml.h>
 
 dGraphNode::dGraphNode ()
@@ -587,5 +588,92 @@ bool dSceneGraph::Deserialize (TiXmlElement* const rootNode)
 	return true;
 }
 
+bool dSceneGraph::SerializeBinary (dSceneBinaryFile& file)
+{
+	int parents[D_GRAPH_MAX_STACK_DEPTH];
+	int children[D_GRAPH_MAX_STACK_DEPTH];
+
+	Iterator iter (*this);
+	for (iter.Begin(); iter; iter ++) {
+		dTreeNode* const node = iter.GetNode();
+		dNodeInfo* const info = node->GetInfo().GetNode();
+
+		int parentCount = 0;
+		for (dGraphNode::dLink::dListNode* edgeNode = node->GetInfo().m_parents.GetFirst(); edgeNode; edgeNode = edgeNode->GetNext()) {
+			parents[parentCount] = edgeNode->GetInfo()->GetInfo().GetNode()->GetNodeID();
+			parentCount ++;
+			dAssert (parentCount < int (sizeof (parents) / sizeof (parents[0])));
+		}
+
+		int childCount = 0;
+		for (dGraphNode::dLink::dListNode* edgeNode = node->GetInfo().m_children.GetFirst(); edgeNode; edgeNode = edgeNode->GetNext()) {
+			children[childCount] = edgeNode->GetInfo()->GetInfo().GetNode()->GetNodeID();
+			childCount ++;
+			dAssert (childCount < int (sizeof (children) / sizeof (children[0])));
+		}
+
+		dSceneBinaryWriter chunk;
+		info->SerializeBinary (chunk);
+		if (!file.AddNode (info, chunk, parents, parentCount, children, childCount)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool dSceneGraph::DeserializeBinary (const dSceneBinaryFile& file)
+{
+	Cleanup();
+
+	dScene* const world = (dScene*) this;
+
+	// nodes that fail to load are left out and reported, the rest of the graph is still linked
+	bool state = true;
+	int nodeCount = file.GetNodeCount();
+	dTreeNode** const nodes = new dTreeNode*[nodeCount];
+	for (int i = 0; i < nodeCount; i ++) {
+		nodes[i] = NULL;
+		dNodeInfo* const info = file.LoadNode (i, world);
+		if (info) {
+			nodes[i] = AddNode (info, NULL);
+			info->Release();
+		} else {
+			state = false;
+		}
+	}
+
+	for (int i = 0; i < nodeCount; i ++) {
+		dTreeNode* const myNode = nodes[i];
+		if (myNode) {
+			dGraphNode& node = myNode->GetInfo();
+
+			int parentCount;
+			const int* const parents = file.GetParents (i, parentCount);
+			for (int j = 0; j < parentCount; j ++) {
+				// a parent that failed to load, or an id that is not in the file, is dropped
+				dTreeNode* const parentNode = Find(parents[j]);
+				if (parentNode) {
+					node.m_parents.Append(parentNode);
+				}
+			}
+			if (!parentCount && !m_rootNode) {
+				m_rootNode = myNode;
+			}
+
+			int childCount;
+			const int* const children = file.GetChildren (i, childCount);
+			for (int j = 0; j < childCount; j ++) {
+				dTreeNode* const childNode = Find(children[j]);
+				if (childNode) {
+					node.m_children.Append(childNode);
+				}
+			}
+		}
+	}
+
+	delete[] nodes;
+	return state;
+}
+
 
 
@@ -22,6 +22,7 @@
 class dNodeInfo;
 class dGraphNode;
 class TiXmlElement;
+class dSceneBinaryFile;
 
 #define D_GRAPH_MAX_STACK_DEPTH	(1024 * 16)
 
@@ -50,6 +51,9 @@ class dSceneGraph: public dTree<dGraphNode, unsigned>
 	DSCENE_API virtual void Serialize (TiXmlElement* const parentNode);
 	DSCENE_API virtual bool Deserialize (TiXmlElement* const parentNode);
 
+	DSCENE_API virtual bool SerializeBinary (dSceneBinaryFile& file);
+	DSCENE_API virtual bool DeserializeBinary (const dSceneBinaryFile& file);
+
 	DSCENE_API virtual int GetLRU();
 	DSCENE_API virtual void Cleanup();
 
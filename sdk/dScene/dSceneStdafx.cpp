@@ -19,6 +19,7 @@
 
 
 #include "dSceneStdafx.h"
+#include "dSceneBinary.h"
 #include <tinyxml.h>
 
 #ifdef _DSCENE_DLL
@@ -730,3 +731,191 @@ bool DeserializeMesh (const NewtonMesh* const mesh, TiXmlElement* const rootNode
 	delete[] faceIndexCount;
 	return true;
 }
+
+// same layout as the xml mesh, with all arrays stored raw
+void SerializeMesh (const NewtonMesh* const mesh, dSceneBinaryWriter& writer)
+{
+	int pointCount = NewtonMeshGetPointCount(mesh);
+	int vertexCount = NewtonMeshGetVertexCount(mesh);
+	int pointBaseCount = NewtonMeshGetVertexBaseCount(mesh);
+	writer.WriteInt(pointBaseCount);
+
+	int bufferCount = dMax (vertexCount, pointCount);
+	dFloat* const points = new dFloat[3 * bufferCount];
+	dFloat64* const positions = new dFloat64[4 * bufferCount];
+	int* const normalIndexList = new int[bufferCount];
+	int* const uv0IndexList = new int[bufferCount];
+	int* const uv1IndexList = new int[bufferCount];
+
+	int controlPointCountStride = NewtonMeshGetVertexStrideInByte(mesh) / sizeof(dFloat64);
+	const dFloat64* const controlPoints = NewtonMeshGetVertexArray(mesh);
+	for (int i = 0; i < vertexCount; i++) {
+		positions[4 * i + 0] = controlPoints[controlPointCountStride * i + 0];
+		positions[4 * i + 1] = controlPoints[controlPointCountStride * i + 1];
+		positions[4 * i + 2] = controlPoints[controlPointCountStride * i + 2];
+		positions[4 * i + 3] = 0.0f;
+	}
+	writer.WriteFloat64Array(positions, vertexCount * 4);
+
+	int channels = 0;
+	channels |= NewtonMeshHasNormalChannel(mesh) ? 1 : 0;
+	channels |= NewtonMeshHasUV0Channel(mesh) ? 2 : 0;
+	channels |= NewtonMeshHasUV1Channel(mesh) ? 4 : 0;
+	writer.WriteInt(channels);
+
+	if (channels & 1) {
+		NewtonMeshGetNormalChannel(mesh, 3 * sizeof(dFloat), points);
+		int count = dPackVertexArray(points, 3, 3 * sizeof(dFloat), pointCount, normalIndexList);
+		writer.WriteFloatArray(points, count * 3);
+	}
+
+	if (channels & 2) {
+		memset(points, 0, 3 * sizeof(dFloat) * pointCount);
+		NewtonMeshGetUV0Channel(mesh, 3 * sizeof(dFloat), points);
+		int count = dPackVertexArray(points, 3, 3 * sizeof(dFloat), pointCount, uv0IndexList);
+		for (int i = 0; i < count; i++) {
+			points[i * 2 + 0] = points[i * 3 + 0];
+			points[i * 2 + 1] = points[i * 3 + 1];
+		}
+		writer.WriteFloatArray(points, count * 2);
+	}
+
+	if (channels & 4) {
+		memset(points, 0, 3 * sizeof(dFloat) * pointCount);
+		NewtonMeshGetUV1Channel(mesh, 3 * sizeof(dFloat), points);
+		int count = dPackVertexArray(points, 3, 3 * sizeof(dFloat), pointCount, uv1IndexList);
+		for (int i = 0; i < count; i++) {
+			points[i * 2 + 0] = points[i * 3 + 0];
+			points[i * 2 + 1] = points[i * 3 + 1];
+		}
+		writer.WriteFloatArray(points, count * 2);
+	}
+
+	dAssert (!NewtonMeshHasVertexColorChannel(mesh));
+	dAssert (!NewtonMeshHasBinormalChannel(mesh));
+
+	int faceCount = NewtonMeshGetTotalFaceCount (mesh); 
+	int indexCount = NewtonMeshGetTotalIndexCount (mesh); 
+
+	int* const faceArray = new int [faceCount];
+	void** const indexArray = new void* [indexCount];
+	int* const materialIndexArray = new int [faceCount];
+	int* const remapedIndexArray = new int [indexCount];
+
+	NewtonMeshGetFaces (mesh, faceArray, materialIndexArray, indexArray); 
+	writer.WriteIntArray(faceArray, faceCount);
+	writer.WriteIntArray(materialIndexArray, faceCount);
+
+	for (int i = 0; i < indexCount; i ++) {
+		remapedIndexArray[i] = NewtonMeshGetVertexIndexFromPoint(mesh, indexArray[i]);
+	}
+	writer.WriteIntArray(remapedIndexArray, indexCount);
+
+	const int* const channelIndexList[] = {normalIndexList, uv0IndexList, uv1IndexList};
+	for (int j = 0; j < 3; j ++) {
+		if (channels & (1 << j)) {
+			const int* const indexList = channelIndexList[j];
+			for (int i = 0; i < indexCount; i++) {
+				int index = NewtonMeshGetPointIndex(mesh, indexArray[i]);
+				remapedIndexArray[i] = indexList[index];
+			}
+			writer.WriteIntArray(remapedIndexArray, indexCount);
+		}
+	}
+
+	delete[] remapedIndexArray;
+	delete[] materialIndexArray;
+	delete[] indexArray;
+	delete[] faceArray;
+	delete[] uv1IndexList;
+	delete[] uv0IndexList;
+	delete[] normalIndexList;
+	delete[] positions;
+	delete[] points;
+}
+
+// arrays are passed to the mesh in place, without any copy
+static bool dCheckIndexList (const int* const indexList, int count, int indexCount, int elementCount)
+{
+	if (!indexList || (count != indexCount)) {
+		return false;
+	}
+	for (int i = 0; i < count; i ++) {
+		if ((indexList[i] < 0) || (indexList[i] >= elementCount)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool DeserializeMesh (const NewtonMesh* const mesh, dSceneBinaryReader& reader)
+{
+	NewtonMeshVertexFormat vertexFormat;
+	NewtonMeshClearVertexFormat(&vertexFormat);
+
+	// the arrays are used in place, so every count and index is checked before the mesh is built
+	int count;
+	int normalCount = 0;
+	int uv0Count = 0;
+	int uv1Count = 0;
+	int pointBaseCount = reader.ReadInt();
+	vertexFormat.m_vertex.m_data = (dFloat64*) reader.ReadFloat64Array(count);
+	vertexFormat.m_vertex.m_strideInBytes = 4 * sizeof (dFloat64);
+	int pointCount = count / 4;
+	// a base count of -1 means the mesh was saved without one
+	bool state = !(count % 4) && (pointBaseCount >= -1) && (pointBaseCount <= pointCount);
+
+	int channels = reader.ReadInt();
+	if (channels & 1) {
+		vertexFormat.m_normal.m_data = (dFloat*) reader.ReadFloatArray(count);
+		vertexFormat.m_normal.m_strideInBytes = 3 * sizeof (dFloat);
+		normalCount = count / 3;
+		state = state && !(count % 3);
+	}
+	if (channels & 2) {
+		vertexFormat.m_uv0.m_data = (dFloat*) reader.ReadFloatArray(count);
+		vertexFormat.m_uv0.m_strideInBytes = 2 * sizeof (dFloat);
+		uv0Count = count / 2;
+		state = state && !(count % 2);
+	}
+	if (channels & 4) {
+		vertexFormat.m_uv1.m_data = (dFloat*) reader.ReadFloatArray(count);
+		vertexFormat.m_uv1.m_strideInBytes = 2 * sizeof (dFloat);
+		uv1Count = count / 2;
+		state = state && !(count % 2);
+	}
+
+	vertexFormat.m_faceIndexCount = (int*) reader.ReadIntArray(vertexFormat.m_faceCount);
+	vertexFormat.m_faceMaterial = (int*) reader.ReadIntArray(count);
+	state = state && !reader.HasError() && (count == vertexFormat.m_faceCount);
+
+	int indexCount = 0;
+	for (int i = 0; state && (i < vertexFormat.m_faceCount); i ++) {
+		int faceIndexCount = vertexFormat.m_faceIndexCount[i];
+		state = (faceIndexCount >= 0) && (faceIndexCount <= (0x7fffffff - indexCount));
+		indexCount += faceIndexCount;
+	}
+
+	vertexFormat.m_vertex.m_indexList = (int*) reader.ReadIntArray(count);
+	state = state && dCheckIndexList (vertexFormat.m_vertex.m_indexList, count, indexCount, pointCount);
+	if (channels & 1) {
+		vertexFormat.m_normal.m_indexList = (int*) reader.ReadIntArray(count);
+		state = state && dCheckIndexList (vertexFormat.m_normal.m_indexList, count, indexCount, normalCount);
+	}
+	if (channels & 2) {
+		vertexFormat.m_uv0.m_indexList = (int*) reader.ReadIntArray(count);
+		state = state && dCheckIndexList (vertexFormat.m_uv0.m_indexList, count, indexCount, uv0Count);
+	}
+	if (channels & 4) {
+		vertexFormat.m_uv1.m_indexList = (int*) reader.ReadIntArray(count);
+		state = state && dCheckIndexList (vertexFormat.m_uv1.m_indexList, count, indexCount, uv1Count);
+	}
+
+	if (!state || reader.HasError()) {
+		return false;
+	}
+
+	NewtonMeshBuildFromVertexListIndexList (mesh, &vertexFormat);
+	NewtonMeshSetVertexBaseCount(mesh, pointBaseCount);
+	return true;
+}
@@ -116,6 +116,8 @@
 #include <Newton.h>
 
 class TiXmlElement;
+class dSceneBinaryWriter;
+class dSceneBinaryReader;
 
 
 #ifdef _DSCENE_DLL
@@ -152,6 +154,8 @@ DSCENE_API dFloat dPolygonRayCast (const dVector& line0, const dVector& line1, i
 
 void SerializeMesh (const NewtonMesh* const mesh, TiXmlElement* const rootNode);
 bool DeserializeMesh (const NewtonMesh* const mesh, TiXmlElement* const rootNode); 
+void SerializeMesh (const NewtonMesh* const mesh, dSceneBinaryWriter& writer);
+bool DeserializeMesh (const NewtonMesh* const mesh, dSceneBinaryReader& reader);
 
 // TODO: reference additional headers your program requires here
 
@@ -29,6 +29,8 @@
 
 
 #define DG_CONVEXHULL_3D_VERTEX_CLUSTER_SIZE		8
+#define DG_CONVEXHULL_3D_CONFLICT_BATCH			256
+#define DG_CONVEXHULL_3D_PARALLEL_MIN_POINTS	(DG_CONVEXHULL_3D_CONFLICT_BATCH * 4)
 
 #ifdef	DG_OLD_CONVEXHULL_3D
 class dgConvexHull3d::dgNormalMap
@@ -106,6 +108,34 @@ class dgConvexHull3DVertex: public dgBigVector
 	dgInt32 m_mark;
 };
 
+// the outside set of a face in the quick hull builder. 
+// the points are a linked list, and the furthest one is tracked while the list is built.
+class dgConvexHull3d::dgConflictFace
+{
+	public:
+	dgListNode* m_face;
+	dgFloat64 m_dist;
+	dgInt32 m_head;
+	dgInt32 m_furthest;
+};
+
+// points to be assigned to the outside sets of a group of new faces. 
+// the face planes are stored four at the time in structure of arrays form (nx, ny, nz, w), 
+// so that one point is tested against four faces with a few vector instructions.
+class dgConvexHull3d::dgConflictContext
+{
+	public:
+	const dgConvexHull3DVertex* m_points;
+	const dgInt32* m_pointIndex;
+	const dgBigVector* m_planes;
+	dgInt32* m_slot;
+	dgFloat64* m_dist;
+	dgFloat64 m_distTol;
+	dgInt32 m_pointCount;
+	dgInt32 m_faceCount;
+	dgInt32 m_atomicIndex;
+};
+
 class dgConvexHull3dAABBTreeNode
 {
 	public:
@@ -126,6 +156,7 @@ class dgConvexHull3dPointCluster: public dgConvexHull3dAABBTreeNode
 dgConvexHull3DFace::dgConvexHull3DFace()
 {
 	m_mark = 0;
+	m_conflict = -1;
 	m_twin[0] = NULL;
 	m_twin[1] = NULL;
 	m_twin[2] = NULL;
@@ -214,6 +245,7 @@ dgConvexHull3d::dgConvexHull3d(const dgConvexHull3d& source)
 		dgConvexHull3DFace& srcFace = sourceNode->GetInfo();
 
 		face.m_mark = 0;
+		face.m_conflict = -1;
 		for (dgInt32 i = 0; i < 3; i ++) {
 			face.m_index[i] = srcFace.m_index[i];
 			face.m_twin[i] = map.Find (srcFace.m_twin[i])->GetInfo();
@@ -221,7 +253,7 @@ dgConvexHull3d::dgConvexHull3d(const dgConvexHull3d& source)
 	}
 }
 
-dgConvexHull3d::dgConvexHull3d(dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount)
+dgConvexHull3d::dgConvexHull3d(dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount, dgThreadHive* const threadPool)
 	:dgList<dgConvexHull3DFace>(allocator)
 	,m_count (0)
 	,m_diag()
@@ -229,7 +261,7 @@ dgConvexHull3d::dgConvexHull3d(dgMemoryAllocator* const allocator, const dgFloat
 	,m_aabbP1 (dgBigVector (dgFloat64 (0.0), dgFloat64 (0.0), dgFloat64 (0.0), dgFloat64 (0.0)))
 	,m_points(allocator)
 {
-	BuildHull (vertexCloud, strideInBytes, count, distTol, maxVertexCount);
+	BuildHull (vertexCloud, strideInBytes, count, distTol, maxVertexCount, threadPool);
 }
 
 dgConvexHull3d::~dgConvexHull3d(void)
@@ -237,7 +269,7 @@ dgConvexHull3d::~dgConvexHull3d(void)
 }
 
 
-void dgConvexHull3d::BuildHull (const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount)
+void dgConvexHull3d::BuildHull (const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount, dgThreadHive* const threadPool)
 {
 	dgSetPrecisionDouble precision;
 
@@ -253,7 +285,11 @@ void dgConvexHull3d::BuildHull (const dgFloat64* const vertexCloud, dgInt32 stri
 
 #ifdef	DG_OLD_CONVEXHULL_3D
 	if (m_count >= 4) {
-		CalculateConvexHull3d (&treePool[0], &points[0], count, distTol, maxVertexCount);
+		if (threadPool) {
+			CalculateConvexHull3dParallel (&points[0], count, distTol, maxVertexCount, threadPool);
+		} else {
+			CalculateConvexHull3d (&treePool[0], &points[0], count, distTol, maxVertexCount);
+		}
 	}
 #else
 	if (m_count >= 3) {
@@ -261,7 +297,11 @@ void dgConvexHull3d::BuildHull (const dgFloat64* const vertexCloud, dgInt32 stri
 			CalculateConvexHull2d(&treePool[0], &points[0], count, distTol, maxVertexCount);
 		} else {
 			dgAssert(m_count == 4);
-			CalculateConvexHull3d(&treePool[0], &points[0], count, distTol, maxVertexCount);
+			if (threadPool) {
+				CalculateConvexHull3dParallel (&points[0], count, distTol, maxVertexCount, threadPool);
+			} else {
+				CalculateConvexHull3d(&treePool[0], &points[0], count, distTol, maxVertexCount);
+			}
 		}
 	}
 #endif
@@ -989,6 +1029,314 @@ void dgConvexHull3d::CalculateConvexHull3d (dgConvexHull3dAABBTreeNode* vertexTr
 }
 
 
+void dgConvexHull3d::AssignConflictPointsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgConflictContext* const data = (dgConflictContext*) context;
+	const dgBigVector* const planes = data->m_planes;
+	const dgBigVector tol (data->m_distTol);
+	const dgInt32 groupCount = (data->m_faceCount + 3) >> 2;
+	const dgInt32 pointCount = data->m_pointCount;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, DG_CONVEXHULL_3D_CONFLICT_BATCH); i < pointCount; i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, DG_CONVEXHULL_3D_CONFLICT_BATCH)) {
+		const dgInt32 batchEnd = dgMin (i + DG_CONVEXHULL_3D_CONFLICT_BATCH, pointCount);
+		for (dgInt32 j = i; j < batchEnd; j ++) {
+			const dgBigVector& p = data->m_points[data->m_pointIndex[j]];
+			const dgBigVector x (p.BroadcastX());
+			const dgBigVector y (p.BroadcastY());
+			const dgBigVector z (p.BroadcastZ());
+
+			dgInt32 slot = -1;
+			dgFloat64 dist = dgFloat64 (0.0f);
+			for (dgInt32 k = 0; k < groupCount; k ++) {
+				const dgBigVector* const group = &planes[k * 4];
+				const dgBigVector test (group[3] + group[0] * x + group[1] * y + group[2] * z);
+				const dgInt32 mask = (test > tol).GetSignMask();
+				if (mask) {
+					dgInt32 lane = 0;
+					while (!(mask & (1 << lane))) {
+						lane ++;
+					}
+					slot = k * 4 + lane;
+					dist = test[lane];
+					break;
+				}
+			}
+			data->m_slot[j] = slot;
+			data->m_dist[j] = dist;
+		}
+	}
+}
+
+void dgConvexHull3d::AssignConflictPoints (dgConflictContext& context, dgThreadHive* const threadPool) const
+{
+	context.m_atomicIndex = 0;
+	if (threadPool && (threadPool->GetThreadCount() > 1) && (context.m_pointCount >= DG_CONVEXHULL_3D_PARALLEL_MIN_POINTS)) {
+		const dgInt32 threadCount = threadPool->GetThreadCount();
+		for (dgInt32 i = 0; i < threadCount; i ++) {
+			threadPool->QueueJob(AssignConflictPointsKernel, &context, NULL, "dgConvexHull3d::AssignConflictPoints");
+		}
+		threadPool->SynchronizationBarrier();
+	} else {
+		AssignConflictPointsKernel (&context, NULL, 0);
+	}
+}
+
+// quick hull variant of CalculateConvexHull3d.
+// each face keeps the set of points in front of it, so a new vertex is the furthest point of its face, 
+// and only the points of the deleted faces are tested against the new cone of faces.
+// the point tests run on the thread pool, the changes to the hull are made by the calling thread 
+// in a fix order, so the result does not depend on the thread count.
+void dgConvexHull3d::CalculateConvexHull3dParallel (dgConvexHull3DVertex* const points, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount, dgThreadHive* const threadPool)
+{
+	distTol = dgAbs (distTol) * m_diag;
+	dgListNode* const f0Node = AddFace (0, 1, 2);
+	dgListNode* const f1Node = AddFace (0, 2, 3);
+	dgListNode* const f2Node = AddFace (2, 1, 3);
+	dgListNode* const f3Node = AddFace (1, 0, 3);
+
+	dgConvexHull3DFace* const f0 = &f0Node->GetInfo();
+	dgConvexHull3DFace* const f1 = &f1Node->GetInfo();
+	dgConvexHull3DFace* const f2 = &f2Node->GetInfo();
+	dgConvexHull3DFace* const f3 = &f3Node->GetInfo();
+
+	f0->m_twin[0] = f3Node;
+	f0->m_twin[1] = f2Node;
+	f0->m_twin[2] = f1Node;
+
+	f1->m_twin[0] = f0Node;
+	f1->m_twin[1] = f2Node;
+	f1->m_twin[2] = f3Node;
+
+	f2->m_twin[0] = f0Node;
+	f2->m_twin[1] = f3Node;
+	f2->m_twin[2] = f1Node;
+
+	f3->m_twin[0] = f0Node;
+	f3->m_twin[1] = f1Node;
+	f3->m_twin[2] = f2Node;
+
+	maxVertexCount -= 4;
+	dgInt32 currentIndex = 4;
+
+	dgStack<dgInt32> nextPointPool (count);
+	dgStack<dgInt32> pointIndexPool (count);
+	dgStack<dgInt32> slotPool (count);
+	dgStack<dgFloat64> distPool (count);
+	dgInt32* const nextPoint = &nextPointPool[0];
+	dgInt32* const pointIndex = &pointIndexPool[0];
+
+	dgArray<dgBigVector> planes (GetAllocator());
+	dgArray<dgConflictFace> conflictFaces (GetAllocator());
+	dgArray<dgInt32> conflictQueue (GetAllocator());
+	dgArray<dgListNode*> stack (GetAllocator());
+	dgArray<dgListNode*> coneList (GetAllocator());
+	dgArray<dgListNode*> deleteList (GetAllocator());
+	dgArray<dgInt32> coneConflict (GetAllocator());
+
+	dgConflictContext context;
+	context.m_points = points;
+	context.m_pointIndex = pointIndex;
+	context.m_slot = &slotPool[0];
+	context.m_dist = &distPool[0];
+	context.m_distTol = distTol;
+
+	dgInt32 pointCount = 0;
+	for (dgInt32 i = 0; i < count; i ++) {
+		if (!points[i].m_mark) {
+			pointIndex[pointCount] = i;
+			pointCount ++;
+		}
+	}
+	coneList[0] = f0Node;
+	coneList[1] = f1Node;
+	coneList[2] = f2Node;
+	coneList[3] = f3Node;
+	dgInt32 newCount = 4;
+
+	dgInt32 conflictCount = 0;
+	dgInt32 queueStart = 0;
+	dgInt32 queueEnd = 0;
+	do {
+		// assign the free points to the outside set of the new faces
+		if (pointCount) {
+			const dgInt32 groupCount = (newCount + 3) >> 2;
+			planes.ResizeIfNecessary(groupCount * 4);
+			for (dgInt32 i = 0; i < groupCount * 4; i ++) {
+				planes[i] = dgBigVector (dgFloat64 (0.0f));
+			}
+			for (dgInt32 i = 0; i < groupCount * 4; i ++) {
+				dgBigVector* const group = &planes[(i >> 2) * 4];
+				const dgInt32 lane = i & 3;
+				if (i < newCount) {
+					const dgBigPlane plane (coneList[i]->GetInfo().GetPlaneEquation (&m_points[0]));
+					group[0][lane] = plane.m_x;
+					group[1][lane] = plane.m_y;
+					group[2][lane] = plane.m_z;
+					group[3][lane] = plane.m_w;
+				} else {
+					group[3][lane] = dgFloat64 (-1.0e20f);
+				}
+				coneConflict[i] = -1;
+			}
+
+			context.m_planes = &planes[0];
+			context.m_faceCount = newCount;
+			context.m_pointCount = pointCount;
+			AssignConflictPoints (context, threadPool);
+
+			for (dgInt32 i = 0; i < pointCount; i ++) {
+				const dgInt32 slot = context.m_slot[i];
+				if (slot >= 0) {
+					if (coneConflict[slot] < 0) {
+						coneConflict[slot] = conflictCount;
+						dgConflictFace& conflict = conflictFaces[conflictCount];
+						conflict.m_face = coneList[slot];
+						conflict.m_dist = dgFloat64 (0.0f);
+						conflict.m_head = -1;
+						conflict.m_furthest = -1;
+						conflict.m_face->GetInfo().m_conflict = conflictCount;
+						conflictCount ++;
+					}
+					const dgInt32 index = pointIndex[i];
+					dgConflictFace& conflict = conflictFaces[coneConflict[slot]];
+					nextPoint[index] = conflict.m_head;
+					conflict.m_head = index;
+					if (context.m_dist[i] > conflict.m_dist) {
+						conflict.m_dist = context.m_dist[i];
+						conflict.m_furthest = index;
+					}
+				}
+			}
+
+			for (dgInt32 i = 0; i < newCount; i ++) {
+				if (coneConflict[i] >= 0) {
+					conflictQueue[queueEnd] = coneConflict[i];
+					queueEnd ++;
+				}
+			}
+		}
+
+		// find the next face with a non empty outside set
+		dgInt32 index = -1;
+		dgListNode* faceNode = NULL;
+		while ((queueStart < queueEnd) && (maxVertexCount > 0)) {
+			dgConflictFace& conflict = conflictFaces[conflictQueue[queueStart]];
+			queueStart ++;
+			if (conflict.m_face) {
+				dgConvexHull3DFace* const face = &conflict.m_face->GetInfo();
+				if (face->Evalue(&m_points[0], points[conflict.m_furthest]) > dgFloat64(0.0f)) {
+					index = conflict.m_furthest;
+					faceNode = conflict.m_face;
+					break;
+				}
+				// the furthest point is on the face plane, so are all the others
+				face->m_conflict = -1;
+				conflict.m_face = NULL;
+			}
+		}
+		if (!faceNode) {
+			break;
+		}
+
+		const dgBigVector& p = points[index];
+		stack[0] = faceNode;
+		dgInt32 stackIndex = 1;
+		dgInt32 deletedCount = 0;
+		while (stackIndex) {
+			stackIndex --;
+			dgListNode* const node1 = stack[stackIndex];
+			dgConvexHull3DFace* const face1 = &node1->GetInfo();
+			if (!face1->m_mark && (face1->Evalue(&m_points[0], p) > dgFloat64(0.0f))) {
+				deleteList[deletedCount] = node1;
+				deletedCount ++;
+				face1->m_mark = 1;
+				for (dgInt32 i = 0; i < 3; i ++) {
+					dgListNode* const twinNode = face1->m_twin[i];
+					dgAssert (twinNode);
+					if (!twinNode->GetInfo().m_mark) {
+						stack[stackIndex] = twinNode;
+						stackIndex ++;
+					}
+				}
+			}
+		}
+
+		m_points[currentIndex] = p;
+		points[index].m_mark = 1;
+
+		// build the cone of new faces from the horizon edges
+		newCount = 0;
+		for (dgInt32 i = 0; i < deletedCount; i ++) {
+			dgListNode* const node1 = deleteList[i];
+			dgConvexHull3DFace* const face1 = &node1->GetInfo();
+			for (dgInt32 j0 = 0; j0 < 3; j0 ++) {
+				dgListNode* const twinNode = face1->m_twin[j0];
+				dgConvexHull3DFace* const twinFace = &twinNode->GetInfo();
+				if (!twinFace->m_mark) {
+					dgInt32 j1 = (j0 == 2) ? 0 : j0 + 1;
+					dgListNode* const newNode = AddFace (currentIndex, face1->m_index[j0], face1->m_index[j1]);
+					dgConvexHull3DFace* const newFace = &newNode->GetInfo();
+					newFace->m_twin[1] = twinNode;
+					for (dgInt32 k = 0; k < 3; k ++) {
+						if (twinFace->m_twin[k] == node1) {
+							twinFace->m_twin[k] = newNode;
+						}
+					}
+					coneList[newCount] = newNode;
+					newCount ++;
+				}
+			}
+		}
+
+		for (dgInt32 i = 0; i < newCount - 1; i ++) {
+			dgListNode* const nodeA = coneList[i];
+			dgConvexHull3DFace* const faceA = &nodeA->GetInfo();
+			for (dgInt32 j = i + 1; j < newCount; j ++) {
+				dgListNode* const nodeB = coneList[j];
+				dgConvexHull3DFace* const faceB = &nodeB->GetInfo();
+				if (faceA->m_index[2] == faceB->m_index[1]) {
+					faceA->m_twin[2] = nodeB;
+					faceB->m_twin[0] = nodeA;
+					break;
+				}
+			}
+
+			for (dgInt32 j = i + 1; j < newCount; j ++) {
+				dgListNode* const nodeB = coneList[j];
+				dgConvexHull3DFace* const faceB = &nodeB->GetInfo();
+				if (faceA->m_index[1] == faceB->m_index[2]) {
+					faceA->m_twin[0] = nodeB;
+					faceB->m_twin[2] = nodeA;
+					break;
+				}
+			}
+		}
+
+		// the outside points of the deleted faces are the only candidates for the new faces
+		pointCount = 0;
+		for (dgInt32 i = 0; i < deletedCount; i ++) {
+			dgListNode* const node = deleteList[i];
+			const dgInt32 conflictIndex = node->GetInfo().m_conflict;
+			if (conflictIndex >= 0) {
+				dgConflictFace& conflict = conflictFaces[conflictIndex];
+				for (dgInt32 j = conflict.m_head; j >= 0; j = nextPoint[j]) {
+					if (!points[j].m_mark) {
+						pointIndex[pointCount] = j;
+						pointCount ++;
+					}
+				}
+				conflict.m_face = NULL;
+			}
+			DeleteFace (node);
+		}
+
+		maxVertexCount --;
+		currentIndex ++;
+	} while (maxVertexCount > 0);
+
+	m_count = currentIndex;
+}
+
 void dgConvexHull3d::CalculateVolumeAndSurfaceArea (dgFloat64& volume, dgFloat64& surfaceArea) const
 {
 	dgFloat64 areaAcc = dgFloat32 (0.0f);
@@ -32,6 +32,7 @@
 
 #define DG_OLD_CONVEXHULL_3D
 
+class dgThreadHive;
 class dgMemoryAllocator;
 class dgConvexHull3DVertex;
 class dgConvexHull3dAABBTreeNode;
@@ -53,6 +54,7 @@ class dgConvexHull3DFace
 	dgInt32 m_index[3]; 
 	private:
 	dgInt32 m_mark;
+	dgInt32 m_conflict;
 	dgList<dgConvexHull3DFace>::dgListNode* m_twin[3];
 	friend class dgConvexHull3d;
 };
@@ -62,10 +64,12 @@ class dgConvexHull3d: public dgList<dgConvexHull3DFace>
 #ifdef	DG_OLD_CONVEXHULL_3D
 	class dgNormalMap;
 #endif
+	class dgConflictFace;
+	class dgConflictContext;
 
 	public:
 	dgConvexHull3d(const dgConvexHull3d& source);
-	dgConvexHull3d(dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount = 0x7fffffff);
+	dgConvexHull3d(dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount = 0x7fffffff, dgThreadHive* const threadPool = NULL);
 	virtual ~dgConvexHull3d();
 
 	dgInt32 GetVertexCount() const;
@@ -79,7 +83,7 @@ class dgConvexHull3d: public dgList<dgConvexHull3DFace>
 
 	protected:
 	dgConvexHull3d(dgMemoryAllocator* const allocator);
-	void BuildHull (const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount);
+	void BuildHull (const dgFloat64* const vertexCloud, dgInt32 strideInBytes, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount, dgThreadHive* const threadPool = NULL);
 
 	virtual dgListNode* AddFace (dgInt32 i0, dgInt32 i1, dgInt32 i2);
 	virtual void DeleteFace (dgListNode* const node) ;
@@ -88,6 +92,9 @@ class dgConvexHull3d: public dgList<dgConvexHull3DFace>
 	bool CheckFlatSurface(dgConvexHull3dAABBTreeNode* vertexTree, dgConvexHull3DVertex* const points, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount);
 	void CalculateConvexHull2d (dgConvexHull3dAABBTreeNode* vertexTree, dgConvexHull3DVertex* const points, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount);
 	void CalculateConvexHull3d (dgConvexHull3dAABBTreeNode* vertexTree, dgConvexHull3DVertex* const points, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount);
+	void CalculateConvexHull3dParallel (dgConvexHull3DVertex* const points, dgInt32 count, dgFloat64 distTol, dgInt32 maxVertexCount, dgThreadHive* const threadPool);
+	void AssignConflictPoints (dgConflictContext& context, dgThreadHive* const threadPool) const;
+	static void AssignConflictPointsKernel (void* const context, void* const worldContext, dgInt32 threadID);
 	
 	dgInt32 SupportVertex (dgConvexHull3dAABBTreeNode** const tree, const dgConvexHull3DVertex* const points, const dgBigVector& dir, const bool removeEntry = true) const;
 	dgFloat64 TetrahedrumVolume (const dgBigVector& p0, const dgBigVector& p1, const dgBigVector& p2, const dgBigVector& p3) const;
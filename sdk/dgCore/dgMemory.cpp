@@ -172,6 +172,11 @@ dgInt32 dgMemoryAllocator::GetMemoryUsed() const
 	return m_memoryUsed;
 }
 
+dgInt32 dgMemoryAllocator::GetAllocationCount() const
+{
+	return m_enumerator;
+}
+
 void dgMemoryAllocator::SetAllocatorsCallback (dgMemAlloc memAlloc, dgMemFree memFree)
 {
 	m_free = memFree;
@@ -226,6 +231,9 @@ void *dgMemoryAllocator::Malloc (dgInt32 memsize)
 	dgInt32 paddedSize = size + DG_MEMORY_GRANULARITY; 
 	dgInt32 entry = paddedSize >> DG_MEMORY_GRANULARITY_BITS;	
 
+	// the enumerator doubles as a running allocation count for the step statistics
+	dgAtomicExchangeAndAdd (&m_enumerator, 1);
+
 	void* ptr;
 	if (entry >= DG_MEMORY_BIN_ENTRIES) {
 		ptr = MallocLow (size);
@@ -685,6 +693,7 @@ void dgMemoryAllocator::dgMemoryBeam::Init(dgInt32 size, dgMemoryAllocator* cons
 }
 
 dgMemoryAllocator::dgMemoryAllocator()
+	:m_allocationCount(0)
 {
 //	for (dgInt32 i = 0; i < DG_MEMORY_BEAMS_COUNT; i++) {
 //		dgInt32 size = ((dgInt32 (sizeof (dgMemoryGranularity) * (dgPow(dgFloat32(1.6f), i + 2) - dgPow(dgFloat32(1.6f), i + 1))) + sizeof(dgMemoryGranularity) - 1) & -dgInt32 (sizeof(dgMemoryGranularity))) - sizeof (dgMemoryHeader);
@@ -744,6 +753,7 @@ dgInt32 dgMemoryAllocator::GetSize (void* const ptr)
 
 void* dgMemoryAllocator::Malloc(dgInt32 size)
 {
+	dgAtomicExchangeAndAdd(&m_allocationCount, 1);
 	dgMemoryAllocatorBase& globalAllocator = dgGlobalAllocator::GetGlobalAllocator();
 	if (size > m_beams[DG_MEMORY_BEAMS_COUNT-1].m_beamSize) {
 		return globalAllocator.Malloc(size);
@@ -92,6 +92,7 @@ class dgMemoryAllocator
 	void *operator new (size_t size);
 	void operator delete (void* const ptr);
 	dgInt32 GetMemoryUsed() const;
+	dgInt32 GetAllocationCount() const;
 
 	void SetAllocatorsCallback (dgMemAlloc memAlloc, dgMemFree memFree);
 	virtual void *MallocLow (dgInt32 size, dgInt32 alignment = DG_MEMORY_GRANULARITY);
@@ -314,11 +315,13 @@ class dgMemoryAllocator: public dgMemoryAllocatorBase
 
 	void *operator new (size_t size);
 	void operator delete (void* const ptr);
+	dgInt32 GetAllocationCount() const { return m_allocationCount; }
 
 	private:
 	dgMemoryBeam* FindBeam(dgInt32 size);
 
 	dgMemoryBeam m_beams[DG_MEMORY_BEAMS_COUNT];
+	dgInt32 m_allocationCount;
 };
 
 
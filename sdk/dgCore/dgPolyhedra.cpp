@@ -2158,7 +2158,7 @@ dgFloat64 dgPolyhedra::EdgePenalty (const dgBigVector* const pool, dgEdge* const
 }
 
 
-bool dgPolyhedra::Optimize (const dgFloat64* const array, dgInt32 strideInBytes, dgReportProgress normalizedProgress, void* const reportProgressUserData, dgFloat64 tol, dgInt32 maxFaceCount)
+bool dgPolyhedra::Optimize (const dgFloat64* const array, dgInt32 strideInBytes, dgReportProgress normalizedProgress, void* const reportProgressUserData, dgFloat64 tol, dgInt32 maxFaceCount, const dgInt8* const lockedVertex)
 {
 	dgInt32 stride = dgInt32 (strideInBytes / sizeof (dgFloat64));
 
@@ -2218,6 +2218,11 @@ bool dgPolyhedra::Optimize (const dgFloat64* const array, dgInt32 strideInBytes,
 		bigHeapArray.Pop();
 		edgeHandleList.Remove (handleNodePtr);
 
+		// edges touching a locked vertex are never collapsed, this keeps the borders of partitioned meshes intact
+		if (edge && lockedVertex && (lockedVertex[edge->m_incidentVertex] || lockedVertex[edge->m_twin->m_incidentVertex])) {
+			edge = NULL;
+		}
+
 		if (edge) {
 			if (IsOkToCollapse (&vertexPool[0], edge)) {
 
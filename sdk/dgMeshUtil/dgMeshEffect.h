@@ -25,6 +25,7 @@
 #include <dgRefCounter.h>
 
 class dgWorld;
+class dgThreadHive;
 class dgMeshEffect;
 class dgCollisionInstance;
 
@@ -307,7 +308,7 @@ class dgMeshEffect: public dgPolyhedra, public dgRefCounter
 	dgMeshEffect(dgMemoryAllocator* const allocator, const char* const fileName);
 
 	// Create a convex hull Mesh form point cloud
-	dgMeshEffect (dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 count, dgInt32 strideInByte, dgFloat64 distTol);
+	dgMeshEffect (dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 count, dgInt32 strideInByte, dgFloat64 distTol, dgThreadHive* const threadPool = NULL);
 
 	// create a planar Mesh
 	dgMeshEffect(dgMemoryAllocator* const allocator, const dgMatrix& planeMatrix, dgFloat32 witdth, dgFloat32 breadth, dgInt32 material, const dgMatrix& textureMatrix0, const dgMatrix& textureMatrix1);
@@ -332,10 +333,10 @@ class dgMeshEffect: public dgPolyhedra, public dgRefCounter
 
 	dgEdge* InsertEdgeVertex (dgEdge* const edge, dgFloat64 param);
 
-	dgMeshEffect* Union (const dgMatrix& matrix, const dgMeshEffect* const clipper) const;
-	dgMeshEffect* Difference (const dgMatrix& matrix, const dgMeshEffect* const clipper) const;
-	dgMeshEffect* Intersection (const dgMatrix& matrix, const dgMeshEffect* const clipper) const;
-	void ClipMesh (const dgMatrix& matrix, const dgMeshEffect* const clipper, dgMeshEffect** const top, dgMeshEffect** const bottom) const;
+	dgMeshEffect* Union (const dgMatrix& matrix, const dgMeshEffect* const clipper, dgThreadHive* const threadPool = NULL) const;
+	dgMeshEffect* Difference (const dgMatrix& matrix, const dgMeshEffect* const clipper, dgThreadHive* const threadPool = NULL) const;
+	dgMeshEffect* Intersection (const dgMatrix& matrix, const dgMeshEffect* const clipper, dgThreadHive* const threadPool = NULL) const;
+	void ClipMesh (const dgMatrix& matrix, const dgMeshEffect* const clipper, dgMeshEffect** const top, dgMeshEffect** const bottom, dgThreadHive* const threadPool = NULL) const;
 
 	//bool PlaneClip (const dgBigPlane& plane);
 	
@@ -417,13 +418,14 @@ class dgMeshEffect: public dgPolyhedra, public dgRefCounter
 	dgCollisionInstance* CreateCollisionTree(dgWorld* const world, dgInt32 shapeID) const;
 	dgCollisionInstance* CreateConvexCollision(dgWorld* const world, dgFloat64 tolerance, dgInt32 shapeID, const dgMatrix& matrix = dgGetIdentityMatrix()) const;
 
-	dgMeshEffect* CreateSimplification (dgInt32 maxVertexCount, dgReportProgress reportProgressCallback, void* const userData) const;
-	dgMeshEffect* CreateConvexApproximation (dgFloat32 maxConcavity, dgFloat32 backFaceDistanceFactor, dgInt32 maxHullOuputCount, dgInt32 maxVertexPerHull, dgReportProgress reportProgressCallback, void* const userData) const;
+	dgMeshEffect* CreateSimplification (dgInt32 maxVertexCount, dgReportProgress reportProgressCallback, void* const userData, dgThreadHive* const threadPool = NULL) const;
+	dgMeshEffect* CreateConvexApproximation (dgFloat32 maxConcavity, dgFloat32 backFaceDistanceFactor, dgInt32 maxHullOuputCount, dgInt32 maxVertexPerHull, dgReportProgress reportProgressCallback, void* const userData, dgThreadHive* const threadPool = NULL) const;
 
 	dgMeshEffect* CreateTetrahedraIsoSurface() const;
 	void CreateTetrahedraLinearBlendSkinWeightsChannel (const dgMeshEffect* const tetrahedraMesh);
 
-	static dgMeshEffect* CreateVoronoiConvexDecomposition (dgMemoryAllocator* const allocator, dgInt32 pointCount, dgInt32 pointStrideInBytes, const dgFloat32* const pointCloud, dgInt32 materialId, const dgMatrix& textureProjectionMatrix);
+	static dgMeshEffect* CreateVoronoiConvexDecomposition (dgMemoryAllocator* const allocator, dgInt32 pointCount, dgInt32 pointStrideInBytes, const dgFloat32* const pointCloud, dgInt32 materialId, const dgMatrix& textureProjectionMatrix, dgThreadHive* const threadPool = NULL);
+	static dgMeshEffect* CreateSimplificationFromOFF (dgMemoryAllocator* const allocator, const char* const fileName, dgInt32 maxVertexCount, dgReportProgress reportProgressCallback, void* const userData, dgThreadHive* const threadPool = NULL);
 	static dgMeshEffect* CreateFromSerialization (dgMemoryAllocator* const allocator, dgDeserialize deserialization, void* const userData);
 
 	void LoadOffMesh (const char* const filename);
@@ -498,7 +500,9 @@ class dgMeshEffect: public dgPolyhedra, public dgRefCounter
 	friend class dgConvexHull3d;
 	friend class dgConvexHull4d;
 	friend class dgBooleanMeshBVH;
+	friend class dgBooleanMeshClipper;
 	friend class dgHACDClusterGraph;
+	friend class dgVoronoiCellBuilder;
 	friend class dgTriangleAnglesToUV;
 	friend class dgTetraIsoSufaceStuffing;
 	friend class dgCollisionCompoundFractured;
@@ -1371,14 +1371,14 @@ dgMeshEffect::dgMeshEffect(dgCollisionInstance* const collision)
 }
 
 // create a convex hull
-dgMeshEffect::dgMeshEffect(dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 count, dgInt32 strideInByte, dgFloat64 distTol)
+dgMeshEffect::dgMeshEffect(dgMemoryAllocator* const allocator, const dgFloat64* const vertexCloud, dgInt32 count, dgInt32 strideInByte, dgFloat64 distTol, dgThreadHive* const threadPool)
 	:dgPolyhedra(allocator)
 	,m_points(allocator)
 	,m_attrib(allocator)
 {
 	Init();
 	if (count >= 4) {
-		dgConvexHull3d convexHull(allocator, vertexCloud, strideInByte, count, distTol);
+		dgConvexHull3d convexHull(allocator, vertexCloud, strideInByte, count, distTol, 0x7fffffff, threadPool);
 		if (convexHull.GetCount()) {
 			dgStack<dgInt32> faceCountPool(convexHull.GetCount());
 			dgStack<dgInt32> vertexIndexListPool(convexHull.GetCount() * 3);
@@ -936,7 +936,110 @@ void dgMeshEffect::LoadTetraMesh (const char* const filename)
 	}
 }
 
-dgMeshEffect* dgMeshEffect::CreateVoronoiConvexDecomposition (dgMemoryAllocator* const allocator, dgInt32 pointCount, dgInt32 pointStrideInBytes, const dgFloat32* const pointCloud, dgInt32 materialId, const dgMatrix& textureProjectionMatrix)
+class dgVoronoiCellBuilder
+{
+	public:
+	typedef dgTree<dgList<dgInt32>, dgInt32>::dgTreeNode dgCellNode;
+
+	dgVoronoiCellBuilder(dgMemoryAllocator* const allocator, const dgBigVector* const voronoiPoints, dgInt32 materialId, const dgMatrix& textureProjectionMatrix)
+		:m_textureProjectionMatrix(textureProjectionMatrix)
+		,m_cells(allocator)
+		,m_cellMeshes(allocator)
+		,m_voronoiPoints(voronoiPoints)
+		,m_allocator(allocator)
+		,m_materialId(materialId)
+		,m_cellCount(0)
+		,m_atomicIndex(0)
+	{
+	}
+
+	void AddCell(dgCellNode* const cellNode)
+	{
+		m_cells[m_cellCount] = cellNode;
+		m_cellMeshes[m_cellCount] = NULL;
+		m_cellCount++;
+	}
+
+	// cells are independent, each one is built into its own slot so that the 
+	// merge order, and therefore the output mesh, does not depend on the thread count
+	void BuildCells(dgThreadHive* const threadPool)
+	{
+		m_atomicIndex = 0;
+		if (threadPool && (threadPool->GetThreadCount() > 1) && (m_cellCount > 1)) {
+			const dgInt32 threadCount = threadPool->GetThreadCount();
+			for (dgInt32 i = 0; i < threadCount; i++) {
+				threadPool->QueueJob(BuildCellsKernel, this, NULL, "dgVoronoiCellBuilder::BuildCells");
+			}
+			threadPool->SynchronizationBarrier();
+		} else {
+			BuildCellsKernel(this, NULL, 0);
+		}
+	}
+
+	void MergeCells(dgMeshEffect* const voronoiPartition)
+	{
+		dgInt32 layer = 0;
+		for (dgInt32 i = 0; i < m_cellCount; i++) {
+			dgMeshEffect* const convexMesh = m_cellMeshes[i];
+			if (convexMesh) {
+				for (dgInt32 j = 0; j < convexMesh->m_points.m_vertex.m_count; j++) {
+					convexMesh->m_points.m_layers[j] = layer;
+				}
+				voronoiPartition->MergeFaces(convexMesh);
+				delete convexMesh;
+				m_cellMeshes[i] = NULL;
+				layer++;
+			}
+		}
+	}
+
+	private:
+	static void BuildCellsKernel(void* const context, void* const, dgInt32 threadID)
+	{
+		dgVoronoiCellBuilder* const me = (dgVoronoiCellBuilder*)context;
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1); i < me->m_cellCount; i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1)) {
+			me->m_cellMeshes[i] = me->BuildCell(me->m_cells[i]);
+		}
+	}
+
+	dgMeshEffect* BuildCell(dgCellNode* const cellNode) const
+	{
+		dgBigVector pointArray[512];
+		dgInt32 indexArray[512];
+
+		dgInt32 count = 0;
+		const dgList<dgInt32>& list = cellNode->GetInfo();
+		for (dgList<dgInt32>::dgListNode* ptr = list.GetFirst(); ptr; ptr = ptr->GetNext()) {
+			dgInt32 i = ptr->GetInfo();
+			pointArray[count] = m_voronoiPoints[i];
+			count++;
+			dgAssert(count < dgInt32(sizeof (pointArray) / sizeof (pointArray[0])));
+		}
+
+		count = dgVertexListToIndexList(&pointArray[0].m_x, sizeof (dgBigVector), 3, count, &indexArray[0], dgFloat64(1.0e-3f));
+		if (count >= 4) {
+			dgMeshEffect* const convexMesh = new (m_allocator) dgMeshEffect(m_allocator, &pointArray[0].m_x, count, sizeof (dgBigVector), dgFloat64(0.0f));
+			if (convexMesh->GetCount()) {
+				convexMesh->CalculateNormals(dgFloat32(30.0f * dgDegreeToRad));
+				convexMesh->UniformBoxMapping(m_materialId, m_textureProjectionMatrix);
+				return convexMesh;
+			}
+			delete convexMesh;
+		}
+		return NULL;
+	}
+
+	dgMatrix m_textureProjectionMatrix;
+	dgArray<dgCellNode*> m_cells;
+	dgArray<dgMeshEffect*> m_cellMeshes;
+	const dgBigVector* m_voronoiPoints;
+	dgMemoryAllocator* m_allocator;
+	dgInt32 m_materialId;
+	dgInt32 m_cellCount;
+	dgInt32 m_atomicIndex;
+};
+
+dgMeshEffect* dgMeshEffect::CreateVoronoiConvexDecomposition (dgMemoryAllocator* const allocator, dgInt32 pointCount, dgInt32 pointStrideInBytes, const dgFloat32* const pointCloud, dgInt32 materialId, const dgMatrix& textureProjectionMatrix, dgThreadHive* const threadPool)
 {
 	dgStack<dgBigVector> buffer(pointCount + 16);
 	dgBigVector* const pool = &buffer[0];
@@ -1018,43 +1121,19 @@ dgMeshEffect* dgMeshEffect::CreateVoronoiConvexDecomposition (dgMemoryAllocator*
 		index ++;
 	}
 
-	const dgFloat32 normalAngleInRadians = dgFloat32 (30.0f * dgDegreeToRad);
-	dgMeshEffect* const voronoiPartition = new (allocator) dgMeshEffect (allocator);
-	voronoiPartition->BeginBuild();
-	dgInt32 layer = 0;
+	dgVoronoiCellBuilder cellBuilder (allocator, &voronoiPoints[0], materialId, textureProjectionMatrix);
 	dgTree<dgList<dgInt32>, dgInt32>::Iterator iter (delaunayNodes);
 	for (iter.Begin(); iter; iter ++) {
 		dgTree<dgList<dgInt32>, dgInt32>::dgTreeNode* const nodeNode = iter.GetNode();
-		const dgList<dgInt32>& list = nodeNode->GetInfo();
-		dgInt32 key = nodeNode->GetKey();
-
-		if (key < guardVertexKey) {
-			dgBigVector pointArray[512];
-			dgInt32 indexArray[512];
-			
-			dgInt32 count1 = 0;
-			for (dgList<dgInt32>::dgListNode* ptr = list.GetFirst(); ptr; ptr = ptr->GetNext()) {
-				dgInt32 i = ptr->GetInfo();
-				pointArray[count1] = voronoiPoints[i];
-				count1 ++;
-				dgAssert (count1 < dgInt32 (sizeof (pointArray) / sizeof (pointArray[0])));
-			}
-
-			count1 = dgVertexListToIndexList(&pointArray[0].m_x, sizeof (dgBigVector), 3, count1, &indexArray[0], dgFloat64 (1.0e-3f));	
-			if (count1 >= 4) {
-				dgMeshEffect convexMesh (allocator, &pointArray[0].m_x, count1, sizeof (dgBigVector), dgFloat64 (0.0f));
-				if (convexMesh.GetCount()) {
-					convexMesh.CalculateNormals(normalAngleInRadians);
-					convexMesh.UniformBoxMapping (materialId, textureProjectionMatrix);
-					for (dgInt32 i = 0; i < convexMesh.m_points.m_vertex.m_count; i ++) {
-						convexMesh.m_points.m_layers[i] = layer;
-					}
-					voronoiPartition->MergeFaces(&convexMesh);
-					layer ++;
-				}
-			}
+		if (nodeNode->GetKey() < guardVertexKey) {
+			cellBuilder.AddCell(nodeNode);
 		}
 	}
+	cellBuilder.BuildCells(threadPool);
+
+	dgMeshEffect* const voronoiPartition = new (allocator) dgMeshEffect (allocator);
+	voronoiPartition->BeginBuild();
+	cellBuilder.MergeCells(voronoiPartition);
 	voronoiPartition->EndBuild(dgFloat64 (1.0e-8f), false);
 	//voronoiPartition->SaveOFF("xxx0.off");
 	return voronoiPartition;
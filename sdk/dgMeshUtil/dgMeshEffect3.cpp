@@ -849,38 +849,105 @@ class dgHACDClusterGraph: public dgGraph<dgHACDCluster, dgHACDEdge>
 		return state;
 	}
 
-	dgMeshEffect* CreatePartitionMesh (dgMeshEffect& mesh, dgInt32 maxVertexPerHull)
+	class dgPartitionHullContext
+	{
+		public:
+		dgMeshEffect* m_mesh;
+		dgHACDConvacityLookAheadTree** m_clusters;
+		dgMeshEffect** m_hulls;
+		dgInt32 m_clusterCount;
+		dgInt32 m_atomicIndex;
+	};
+
+	static dgMeshEffect* CreateClusterHull (dgMeshEffect& mesh, const dgHACDConvacityLookAheadTree* const cluster)
+	{
+		dgMemoryAllocator* const allocator = mesh.GetAllocator();
+		const dgBigVector* const points = (dgBigVector*) mesh.GetVertexPool();
+
+		dgInt32 vertexCount = 0;
+		for (dgList<dgEdge*>::dgListNode* faceNode = cluster->m_faceList.GetFirst(); faceNode; faceNode = faceNode->GetNext()) {
+			dgEdge* const edge = faceNode->GetInfo();
+			dgEdge* ptr = edge;
+			do {
+				vertexCount++;
+				ptr = ptr->m_next;
+			} while (ptr != edge);
+		}
+
+		dgStack<dgBigVector> convexVertexBuffer(vertexCount + 1);
+		vertexCount = 0;
+		for (dgList<dgEdge*>::dgListNode* faceNode = cluster->m_faceList.GetFirst(); faceNode; faceNode = faceNode->GetNext()) {
+			dgEdge* const edge = faceNode->GetInfo();
+			dgEdge* ptr = edge;
+			do {
+				dgInt32 index = ptr->m_incidentVertex;
+				convexVertexBuffer[vertexCount] = points[index];
+				vertexCount++;
+				ptr = ptr->m_next;
+			} while (ptr != edge);
+		}
+
+		//dgConvexHull3d convexHull(allocator, &convexVertexBuffer[0].m_x, sizeof(dgBigVector), vertexCount, 0.0, maxVertexPerHull);
+		dgMeshEffect* const convexMesh = new (allocator) dgMeshEffect(allocator, &convexVertexBuffer[0].m_x, vertexCount, sizeof(dgBigVector), dgFloat64(0.0f));
+		if (!convexMesh->GetCount()) {
+			delete convexMesh;
+			return NULL;
+		}
+		return convexMesh;
+	}
+
+	static void CreateClusterHullsKernel (void* const context, void* const, dgInt32 threadID)
+	{
+		dgPartitionHullContext* const data = (dgPartitionHullContext*) context;
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1); i < data->m_clusterCount; i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1)) {
+			data->m_hulls[i] = CreateClusterHull (*data->m_mesh, data->m_clusters[i]);
+		}
+	}
+
+	dgMeshEffect* CreatePartitionMesh (dgMeshEffect& mesh, dgInt32 maxVertexPerHull, dgThreadHive* const threadPool)
 	{
 		dgMemoryAllocator* const allocator = mesh.GetAllocator();
 		dgMeshEffect* const convexPartionMesh = new (allocator) dgMeshEffect(allocator);
 
-		dgArray<dgBigVector> convexVertexBuffer(mesh.m_points.m_vertex, mesh.m_points.m_vertex.m_count);
-		const dgBigVector* const points = (dgBigVector*) mesh.GetVertexPool();
+		// the hulls of each cluster are independent, build them all first and merge them 
+		// in cluster order, so that the layers do not depend on the thread count
+		const dgInt32 clusterCount = m_convexProximation.GetCount();
+		dgStack<dgHACDConvacityLookAheadTree*> clusters(clusterCount + 1);
+		dgStack<dgMeshEffect*> hulls(clusterCount + 1);
 
-		dgInt32 layer = 0;
-		convexPartionMesh->BeginBuild();
+		dgInt32 index = 0;
 		for (dgList<dgHACDConvacityLookAheadTree*>::dgListNode* clusterNode = m_convexProximation.GetFirst(); clusterNode; clusterNode = clusterNode->GetNext()) {
-			dgHACDConvacityLookAheadTree* const cluster = clusterNode->GetInfo();
+			clusters[index] = clusterNode->GetInfo();
+			hulls[index] = NULL;
+			index++;
+		}
 
-			dgInt32 vertexCount = 0;
-			for (dgList<dgEdge*>::dgListNode* faceNode = cluster->m_faceList.GetFirst(); faceNode; faceNode = faceNode->GetNext()) {
-				dgEdge* const edge = faceNode->GetInfo();
-				dgEdge* ptr = edge;
-				do {
-					dgInt32 index = ptr->m_incidentVertex;
-					convexVertexBuffer[vertexCount] = points[index];
-					vertexCount++;
-					ptr = ptr->m_next;
-				} while (ptr != edge);
+		dgPartitionHullContext context;
+		context.m_mesh = &mesh;
+		context.m_clusters = &clusters[0];
+		context.m_hulls = &hulls[0];
+		context.m_clusterCount = clusterCount;
+		context.m_atomicIndex = 0;
+		if (threadPool && (threadPool->GetThreadCount() > 1) && (clusterCount > 1)) {
+			const dgInt32 threadCount = threadPool->GetThreadCount();
+			for (dgInt32 i = 0; i < threadCount; i++) {
+				threadPool->QueueJob(CreateClusterHullsKernel, &context, NULL, "dgHACDClusterGraph::CreatePartitionMesh");
 			}
+			threadPool->SynchronizationBarrier();
+		} else {
+			CreateClusterHullsKernel(&context, NULL, 0);
+		}
 
-			//dgConvexHull3d convexHull(allocator, &convexVertexBuffer[0].m_x, sizeof(dgBigVector), vertexCount, 0.0, maxVertexPerHull);
-			dgMeshEffect convexMesh(allocator, &convexVertexBuffer[0].m_x, vertexCount, sizeof(dgBigVector), dgFloat64(0.0f));
-			if (convexMesh.GetCount()) {
-				for (dgInt32 i = 0; i < convexMesh.m_points.m_vertex.m_count; i++) {
-					convexMesh.m_points.m_layers[i] = layer;
+		dgInt32 layer = 0;
+		convexPartionMesh->BeginBuild();
+		for (dgInt32 i = 0; i < clusterCount; i++) {
+			dgMeshEffect* const convexMesh = hulls[i];
+			if (convexMesh) {
+				for (dgInt32 j = 0; j < convexMesh->m_points.m_vertex.m_count; j++) {
+					convexMesh->m_points.m_layers[j] = layer;
 				}
-				convexPartionMesh->MergeFaces(&convexMesh);
+				convexPartionMesh->MergeFaces(convexMesh);
+				delete convexMesh;
 				layer++;
 			}
 		}
@@ -1308,7 +1375,7 @@ class dgHACDClusterGraph: public dgGraph<dgHACDCluster, dgHACDEdge>
     void* m_reportProgressUserData;
 };
 
-dgMeshEffect* dgMeshEffect::CreateConvexApproximation(dgFloat32 maxConcavity, dgFloat32 backFaceDistanceFactor, dgInt32 maxHullsCount, dgInt32 maxVertexPerHull, dgReportProgress reportProgressCallback, void* const progressReportUserData) const
+dgMeshEffect* dgMeshEffect::CreateConvexApproximation(dgFloat32 maxConcavity, dgFloat32 backFaceDistanceFactor, dgInt32 maxHullsCount, dgInt32 maxVertexPerHull, dgReportProgress reportProgressCallback, void* const progressReportUserData, dgThreadHive* const threadPool) const
 {
 	//	dgMeshEffect triangleMesh(*this);
 	if (maxHullsCount <= 1) {
@@ -1363,7 +1430,7 @@ dgMeshEffect* dgMeshEffect::CreateConvexApproximation(dgFloat32 maxConcavity, dg
 		// collapse the graph
 		if (graph.CollapseClusters (mesh, maxConcavity, maxHullsCount)) {
 			// Create Partition Mesh
-			partition = graph.CreatePartitionMesh (mesh, maxVertexPerHull);
+			partition = graph.CreatePartitionMesh (mesh, maxVertexPerHull, threadPool);
 		}
 	}
 
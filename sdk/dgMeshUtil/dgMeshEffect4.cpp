@@ -1524,102 +1524,700 @@ class dgHACDClusterGraph
 
 #endif
 
-dgMeshEffect* dgMeshEffect::CreateSimplification(dgInt32 maxVertexCount, dgReportProgress reportProgressCallback, void* const reportPrgressUserData) const
+#define DG_SIMPLIFY_CELL_FACE_COUNT		(1024 * 16)
+#define DG_SIMPLIFY_MAX_CELLS_PER_AXIS	32
+#define DG_SIMPLIFY_BORDER_VERTEX		-2
+#define DG_SIMPLIFY_SEAM_BUDGET			dgFloat64 (1.25f)
+#define DG_SIMPLIFY_STREAM_BATCH		4096
+
+// partitioned quadric simplifier. 
+// triangles are bucketed into a regular grid of cells by centroid, every vertex shared by 
+// two or more cells is locked, and each cell is collapsed on its own, so cells can run in 
+// parallel. cells stop a little above their share of the vertex budget, and a last serial 
+// pass over the stitched mesh runs until the budget is met, mostly on the over tessellated seams.
+// the simplifier reads the caller's vertex array, it does not keep a copy.
+// triangle records are four integers: cell, index0, index1, index2.
+class dgMeshSimplifier
 {
-	if (GetVertexCount() <= maxVertexCount) {
-		return new (GetAllocator()) dgMeshEffect(*this); 
+	public:
+	dgMeshSimplifier(dgMemoryAllocator* const allocator, const dgBigVector* const points, dgInt32 pointCount, dgInt32 faceCount, dgInt32 maxVertexCount)
+		:m_origin(dgFloat32 (0.0f))
+		,m_vertexCell(allocator)
+		,m_slabTriangles(allocator)
+		,m_cellStart(allocator)
+		,m_cellResultCount(allocator)
+		,m_cellQueue(allocator)
+		,m_output(allocator)
+		,m_vertexMap(allocator)
+		,m_points(points)
+		,m_allocator(allocator)
+		,m_pointCount(pointCount)
+		,m_faceCount(dgMax (faceCount, 1))
+		,m_maxVertexCount(dgMax (maxVertexCount, 3))
+		,m_outputCount(0)
+		,m_cellQueueCount(0)
+		,m_atomicIndex(0)
+	{
+		dgBigVector minBox (dgFloat64 (1.0e20f), dgFloat64 (1.0e20f), dgFloat64 (1.0e20f), dgFloat64 (0.0f));
+		dgBigVector maxBox (dgFloat64 (-1.0e20f), dgFloat64 (-1.0e20f), dgFloat64 (-1.0e20f), dgFloat64 (0.0f));
+		m_vertexCell.ResizeIfNecessary(pointCount);
+		for (dgInt32 i = 0; i < pointCount; i++) {
+			const dgBigVector p (points[i].m_x, points[i].m_y, points[i].m_z, dgFloat64 (0.0f));
+			m_vertexCell[i] = -1;
+			minBox = minBox.GetMin(p);
+			maxBox = maxBox.GetMax(p);
+		}
+
+		// the metrics cost cap in dgPolyhedra::Optimize is absolute, simplify in a unit size space
+		const dgBigVector size (maxBox - minBox);
+		const dgFloat64 diagonal = sqrt (size.DotProduct3(size));
+		m_origin = minBox;
+		m_invScale = (diagonal > dgFloat64 (1.0e-12f)) ? dgFloat64 (1.0f) / diagonal : dgFloat64 (1.0f);
+
+		dgInt32 cellsPerAxis = 1;
+		const dgInt32 cellCount = m_faceCount / DG_SIMPLIFY_CELL_FACE_COUNT;
+		while (((cellsPerAxis * cellsPerAxis * cellsPerAxis) < cellCount) && (cellsPerAxis < DG_SIMPLIFY_MAX_CELLS_PER_AXIS)) {
+			cellsPerAxis++;
+		}
+		m_cellsPerAxis = cellsPerAxis;
+		for (dgInt32 i = 0; i < 3; i++) {
+			const dgFloat64 den = dgMax (size[i], dgFloat64 (1.0e-12f));
+			m_cellScale[i] = dgFloat64 (cellsPerAxis) / den;
+		}
+		m_cellScale[3] = dgFloat64 (0.0f);
 	}
-dgAssert (0);
-return new (GetAllocator()) dgMeshEffect(*this); 
-/*
-	//	dgMeshEffect triangleMesh(*this);
-	if (maxHullsCount <= 1) {
-		maxHullsCount = 1;
+
+	~dgMeshSimplifier()
+	{
+		m_vertexCell.Clear();
+		m_slabTriangles.Clear();
+		m_cellStart.Clear();
+		m_cellResultCount.Clear();
+		m_cellQueue.Clear();
+		m_output.Clear();
+		m_vertexMap.Clear();
 	}
-	if (maxConcavity <= dgFloat32 (1.0e-5f)) {
-		maxConcavity = dgFloat32 (1.0e-5f);
+
+	dgInt32 GetSlabCount() const
+	{
+		return m_cellsPerAxis;
 	}
 
-	if (maxVertexPerHull < 4) {
-		maxVertexPerHull = 4;
+	dgInt32 GetSlab(dgInt32 cell) const
+	{
+		return cell / (m_cellsPerAxis * m_cellsPerAxis);
 	}
-	ClampValue(backFaceDistanceFactor, dgFloat32 (0.01f), dgFloat32 (1.0f));
 
-	if (reportProgressCallback) {
-		reportProgressCallback (0.0f);
+	const dgInt32* GetTriangles() const
+	{
+		return &m_output[0];
 	}
 
+	// assign the triangle to a cell and lock the vertices shared with other cells
+	dgInt32 MarkTriangle(dgInt32 i0, dgInt32 i1, dgInt32 i2)
+	{
+		const dgBigVector centroid ((m_points[i0] + m_points[i1] + m_points[i2]).Scale (dgFloat64 (1.0f / 3.0f)) - m_origin);
+		dgInt32 cellIndex[3];
+		for (dgInt32 i = 0; i < 3; i++) {
+			cellIndex[i] = dgClamp (dgInt32 (floor (centroid[i] * m_cellScale[i])), 0, m_cellsPerAxis - 1);
+		}
+		const dgInt32 cell = (cellIndex[0] * m_cellsPerAxis + cellIndex[1]) * m_cellsPerAxis + cellIndex[2];
+
+		const dgInt32 index[] = {i0, i1, i2};
+		for (dgInt32 i = 0; i < 3; i++) {
+			dgInt32& vertexCell = m_vertexCell[index[i]];
+			if (vertexCell == -1) {
+				vertexCell = cell;
+			} else if (vertexCell != cell) {
+				vertexCell = DG_SIMPLIFY_BORDER_VERTEX;
+			}
+		}
+		return cell;
+	}
 
-	// make a copy of the mesh
-	dgMeshEffect mesh(*this);
-	mesh.ClearAttributeArray();
+	// collapse all the cells of one slab, the results are appended to the output in cell order, 
+	// so the final mesh does not depend on the number of threads
+	void SimplifySlab(const dgInt32* const records, dgInt32 count, dgThreadHive* const threadPool)
+	{
+		const dgInt32 cellCount = m_cellsPerAxis * m_cellsPerAxis * m_cellsPerAxis;
+		m_cellStart.ResizeIfNecessary(cellCount + 1);
+		m_cellResultCount.ResizeIfNecessary(cellCount);
+		m_slabTriangles.ResizeIfNecessary(count * 3);
+		memset (&m_cellStart[0], 0, (cellCount + 1) * sizeof (dgInt32));
+		for (dgInt32 i = 0; i < count; i++) {
+			m_cellStart[records[i * 4] + 1] ++;
+		}
+		for (dgInt32 i = 0; i < cellCount; i++) {
+			m_cellStart[i + 1] += m_cellStart[i];
+		}
 
+		dgStack<dgInt32> scan (cellCount);
+		m_cellQueueCount = 0;
+		m_cellQueue.ResizeIfNecessary(cellCount);
+		for (dgInt32 i = 0; i < cellCount; i++) {
+			scan[i] = m_cellStart[i];
+			m_cellResultCount[i] = 0;
+			if (m_cellStart[i + 1] > m_cellStart[i]) {
+				m_cellQueue[m_cellQueueCount] = i;
+				m_cellQueueCount++;
+			}
+		}
+		for (dgInt32 i = 0; i < count; i++) {
+			const dgInt32* const record = &records[i * 4];
+			const dgInt32 index = scan[record[0]] * 3;
+			scan[record[0]] ++;
+			m_slabTriangles[index + 0] = record[1];
+			m_slabTriangles[index + 1] = record[2];
+			m_slabTriangles[index + 2] = record[3];
+		}
 
-	dgInt32 faceCount = mesh.GetTotalFaceCount();
-	if (faceCount  > meshSimplicationMaxFaceCount) {
-		mesh.Triangulate();
+		m_atomicIndex = 0;
+		if (threadPool && (threadPool->GetThreadCount() > 1) && (m_cellQueueCount > 1)) {
+			const dgInt32 threadCount = threadPool->GetThreadCount();
+			for (dgInt32 i = 0; i < threadCount; i++) {
+				threadPool->QueueJob(SimplifyCellsKernel, this, NULL, "dgMeshSimplifier::SimplifySlab");
+			}
+			threadPool->SynchronizationBarrier();
+		} else {
+			SimplifyCellsKernel(this, NULL, 0);
+		}
 
-		dgPolyhedra polygon(GetAllocator());
-		dgInt32 mark = mesh.IncLRU();
-		polygon.BeginFace();
-		dgPolyhedra::Iterator iter (mesh);
-		for (iter.Begin(); iter; iter ++){
-			dgEdge* const face = &(*iter);
+		for (dgInt32 i = 0; i < m_cellQueueCount; i++) {
+			const dgInt32 cell = m_cellQueue[i];
+			const dgInt32 start = m_cellStart[cell] * 3;
+			const dgInt32 indexCount = m_cellResultCount[cell] * 3;
+			m_output.ResizeIfNecessary(m_outputCount + indexCount);
+			for (dgInt32 j = 0; j < indexCount; j++) {
+				m_output[m_outputCount + j] = m_slabTriangles[start + j];
+			}
+			m_outputCount += indexCount;
+		}
+	}
 
-			if ((face->m_mark != mark) && (face->m_incidentFace > 0)) {
-				dgInt32	index[DG_MESH_EFFECT_POINT_SPLITED];
+	// stitch the cells and run the seam pass until the vertex budget is met or no edge can be collapsed, 
+	// returns the triangle count, the triangles index the caller's vertex array
+	dgInt32 Finish()
+	{
+		dgInt32 triangleCount = m_outputCount / 3;
+		dgInt32 vertexCount = CompactVertices(triangleCount);
+		while (vertexCount > m_maxVertexCount) {
+			dgStack<dgBigVector> unitPoints (vertexCount);
+			for (dgInt32 i = 0; i < vertexCount; i++) {
+				unitPoints[i] = (m_points[m_vertexMap[i]] - m_origin).Scale(m_invScale);
+			}
+			const dgInt32 targetFaceCount = dgMax (dgInt32 (dgFloat64 (triangleCount) * dgFloat64 (m_maxVertexCount) / dgFloat64 (vertexCount)), 4);
+			triangleCount = Simplify(&m_output[0], triangleCount, &unitPoints[0], NULL, targetFaceCount);
+			for (dgInt32 i = 0; i < triangleCount * 3; i++) {
+				m_output[i] = m_vertexMap[m_output[i]];
+			}
+			const dgInt32 count = CompactVertices(triangleCount);
+			if (count == vertexCount) {
+				break;
+			}
+			vertexCount = count;
+		}
+		for (dgInt32 i = 0; i < triangleCount * 3; i++) {
+			m_output[i] = m_vertexMap[m_output[i]];
+		}
+		return triangleCount;
+	}
 
-				dgEdge* ptr = face;
-				dgInt32 indexCount = 0;
-				do {
-					index[indexCount] = ptr->m_incidentVertex;
-					ptr->m_mark = mark;
-					indexCount ++;
-					ptr = ptr->m_next;
-				} while (ptr != face);
-				polygon.AddFace(indexCount, index);
+	// build a mesh with positions only, for sources that have no vertex attributes
+	dgMeshEffect* CreateMesh(dgInt32 triangleCount)
+	{
+		const dgInt32 vertexCount = CompactVertices(triangleCount);
+		dgStack<dgBigVector> points (vertexCount + 1);
+		for (dgInt32 i = 0; i < vertexCount; i++) {
+			points[i] = m_points[m_vertexMap[i]];
+		}
+
+		dgStack<dgInt32> faceIndexCount (triangleCount + 1);
+		for (dgInt32 i = 0; i < triangleCount; i++) {
+			faceIndexCount[i] = 3;
+		}
+
+		dgMeshEffect* const mesh = new (m_allocator) dgMeshEffect (m_allocator);
+		dgMeshEffect::dgMeshVertexFormat vertexFormat;
+		vertexFormat.m_faceCount = triangleCount;
+		vertexFormat.m_faceIndexCount = &faceIndexCount[0];
+		vertexFormat.m_vertex.m_data = &points[0].m_x;
+		vertexFormat.m_vertex.m_strideInBytes = sizeof (dgBigVector);
+		vertexFormat.m_vertex.m_indexList = &m_output[0];
+		mesh->BuildFromIndexList(&vertexFormat);
+		mesh->CalculateNormals(dgFloat32 (30.0f * dgDegreeToRad));
+		return mesh;
+	}
+
+	private:
+	static dgInt32 CompareIndex (const dgInt32* const indexA, const dgInt32* const indexB, void* const context)
+	{
+		return (*indexA < *indexB) ? -1 : ((*indexA > *indexB) ? 1 : 0);
+	}
+
+	// dgPolyhedra::Optimize only counts faces against the budget when it has a progress callback
+	static bool dgApi OptimizeProgress (dgFloat32 progressNormalzedPercent, void* const userData)
+	{
+		return true;
+	}
+
+	// remap the output to the referenced vertices only, m_vertexMap gets the original index of each compact vertex
+	dgInt32 CompactVertices(dgInt32 triangleCount)
+	{
+		dgInt32 vertexCount = 0;
+		for (dgInt32 i = 0; i < m_pointCount; i++) {
+			m_vertexCell[i] = -1;
+		}
+		for (dgInt32 i = 0; i < triangleCount * 3; i++) {
+			const dgInt32 index = m_output[i];
+			if (m_vertexCell[index] == -1) {
+				m_vertexCell[index] = vertexCount;
+				m_vertexMap[vertexCount] = index;
+				vertexCount++;
 			}
+			m_output[i] = m_vertexCell[index];
 		}
-		polygon.EndFace();
+		return vertexCount;
+	}
 
-		polygon.Optimize(&mesh.m_points[0].m_x, sizeof (dgFloat64), 1000.0f, meshSimplicationMaxFaceCount);
+	static void SimplifyCellsKernel (void* const context, void* const, dgInt32 threadID)
+	{
+		dgMeshSimplifier* const me = (dgMeshSimplifier*) context;
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1); i < me->m_cellQueueCount; i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1)) {
+			me->SimplifyCell(me->m_cellQueue[i]);
+		}
+	}
 
-		mesh.RemoveAll();
-		
-		mark = polygon.IncLRU();
-		mesh.BeginFace();
-		dgPolyhedra::Iterator iter1 (polygon);
-		for (iter1.Begin(); iter1; iter1 ++){
-			dgEdge* const face = &(*iter1);
+	void SimplifyCell (dgInt32 cell)
+	{
+		const dgInt32 triangleCount = m_cellStart[cell + 1] - m_cellStart[cell];
+		dgInt32* const triangles = &m_slabTriangles[m_cellStart[cell] * 3];
+
+		// map the global vertex indices to a compact local set
+		const dgInt32 indexCount = triangleCount * 3;
+		dgStack<dgInt32> vertexMap (indexCount);
+		memcpy (&vertexMap[0], triangles, indexCount * sizeof (dgInt32));
+		dgSort (&vertexMap[0], indexCount, CompareIndex);
+		dgInt32 vertexCount = 1;
+		for (dgInt32 i = 1; i < indexCount; i++) {
+			if (vertexMap[i] != vertexMap[vertexCount - 1]) {
+				vertexMap[vertexCount] = vertexMap[i];
+				vertexCount++;
+			}
+		}
+
+		dgStack<dgBigVector> points (vertexCount);
+		dgStack<dgInt8> locked (vertexCount);
+		for (dgInt32 i = 0; i < vertexCount; i++) {
+			const dgInt32 index = vertexMap[i];
+			points[i] = (m_points[index] - m_origin).Scale(m_invScale);
+			locked[i] = (m_vertexCell[index] == DG_SIMPLIFY_BORDER_VERTEX) ? 1 : 0;
+		}
+		for (dgInt32 i = 0; i < indexCount; i++) {
+			triangles[i] = dgBinarySearch (&vertexMap[0], vertexCount, triangles[i], CompareIndex);
+		}
+
+		// faces are cut in the same proportion as the vertex budget
+		const dgFloat64 budget = DG_SIMPLIFY_SEAM_BUDGET * dgFloat64 (m_maxVertexCount) / dgFloat64 (m_pointCount);
+		const dgInt32 targetFaceCount = dgMax (dgInt32 (budget * triangleCount), 1);
+		const dgInt32 count = Simplify (triangles, triangleCount, &points[0], &locked[0], targetFaceCount);
+
+		for (dgInt32 i = 0; i < count * 3; i++) {
+			triangles[i] = vertexMap[triangles[i]];
+		}
+		m_cellResultCount[cell] = count;
+	}
+
+	// collapse an indexed triangle list in place, return the new triangle count
+	dgInt32 Simplify (dgInt32* const triangles, dgInt32 triangleCount, const dgBigVector* const points, const dgInt8* const locked, dgInt32 targetFaceCount) const
+	{
+		dgPolyhedra polyhedra (m_allocator);
+		polyhedra.BeginFace();
+		for (dgInt32 i = 0; i < triangleCount; i++) {
+			const dgInt32* const index = &triangles[i * 3];
+			if ((index[0] != index[1]) && (index[1] != index[2]) && (index[2] != index[0])) {
+				polyhedra.AddFace(index[0], index[1], index[2]);
+			}
+		}
+		polyhedra.EndFace();
+
+		polyhedra.Optimize (&points[0].m_x, sizeof (dgBigVector), OptimizeProgress, NULL, dgFloat64 (1.0e-5f), targetFaceCount, locked);
+
+		dgInt32 count = 0;
+		const dgInt32 mark = polyhedra.IncLRU();
+		dgPolyhedra::Iterator iter (polyhedra);
+		for (iter.Begin(); iter; iter ++) {
+			dgEdge* const face = &(*iter);
 			if ((face->m_mark != mark) && (face->m_incidentFace > 0)) {
-				dgInt32	index[DG_MESH_EFFECT_POINT_SPLITED];
 				dgEdge* ptr = face;
-				dgInt32 indexCount = 0;
 				do {
 					ptr->m_mark = mark;
-					index[indexCount] = dgInt32 (ptr->m_incidentVertex);
-					indexCount ++;
 					ptr = ptr->m_next;
 				} while (ptr != face);
-				mesh.AddFace(indexCount, index);
+
+				// collapses keep triangles, fan any other polygon
+				for (dgEdge* edge = face->m_next->m_next; (edge != face) && (count < triangleCount); edge = edge->m_next) {
+					triangles[count * 3 + 0] = face->m_incidentVertex;
+					triangles[count * 3 + 1] = edge->m_prev->m_incidentVertex;
+					triangles[count * 3 + 2] = edge->m_incidentVertex;
+					count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	dgBigVector m_origin;
+	dgBigVector m_cellScale;
+	dgArray<dgInt32> m_vertexCell;
+	dgArray<dgInt32> m_slabTriangles;
+	dgArray<dgInt32> m_cellStart;
+	dgArray<dgInt32> m_cellResultCount;
+	dgArray<dgInt32> m_cellQueue;
+	dgArray<dgInt32> m_output;
+	dgArray<dgInt32> m_vertexMap;
+	const dgBigVector* m_points;
+	dgMemoryAllocator* m_allocator;
+	dgFloat64 m_invScale;
+	dgInt32 m_pointCount;
+	dgInt32 m_faceCount;
+	dgInt32 m_maxVertexCount;
+	dgInt32 m_outputCount;
+	dgInt32 m_cellsPerAxis;
+	dgInt32 m_cellQueueCount;
+	dgInt32 m_atomicIndex;
+};
+
+dgMeshEffect* dgMeshEffect::CreateSimplification(dgInt32 maxVertexCount, dgReportProgress reportProgressCallback, void* const reportPrgressUserData, dgThreadHive* const threadPool) const
+{
+	if (GetVertexCount() <= maxVertexCount) {
+		return new (GetAllocator()) dgMeshEffect(*this); 
+	}
+
+	// fan every face into a triangle record
+	dgArray<dgInt32> records (GetAllocator());
+	dgInt32 triangleCount = 0;
+	const dgInt32 mark = IncLRU();
+	dgPolyhedra::Iterator iter (*this);
+	for (iter.Begin(); iter; iter ++) {
+		dgEdge* const face = &(*iter);
+		if ((face->m_mark != mark) && (face->m_incidentFace > 0)) {
+			dgEdge* ptr = face;
+			do {
+				ptr->m_mark = mark;
+				ptr = ptr->m_next;
+			} while (ptr != face);
+
+			for (dgEdge* edge = face->m_next->m_next; edge != face; edge = edge->m_next) {
+				records.ResizeIfNecessary(triangleCount * 4 + 4);
+				records[triangleCount * 4 + 0] = 0;
+				records[triangleCount * 4 + 1] = face->m_incidentVertex;
+				records[triangleCount * 4 + 2] = edge->m_prev->m_incidentVertex;
+				records[triangleCount * 4 + 3] = edge->m_incidentVertex;
+				triangleCount++;
 			}
 		}
-		mesh.EndFace();
+	}
 
-		faceCount = mesh.GetTotalFaceCount();
-		mesh.ClearAttributeArray();
+	const dgBigVector* const points = &m_points.m_vertex[0];
+	const dgInt32 pointCount = m_points.m_vertex.m_count;
+	dgMeshSimplifier simplifier (GetAllocator(), points, pointCount, triangleCount, maxVertexCount);
+	for (dgInt32 i = 0; i < triangleCount; i++) {
+		dgInt32* const record = &records[i * 4];
+		record[0] = simplifier.MarkTriangle(record[1], record[2], record[3]);
 	}
 
-	// create a general connectivity graph    
-	dgHACDClusterGraph graph (mesh, backFaceDistanceFactor, reportProgressCallback);
+	bool progress = reportProgressCallback ? reportProgressCallback(dgFloat32 (0.0f), reportPrgressUserData) : true;
+	if (progress) {
+		simplifier.SimplifySlab(&records[0], triangleCount, threadPool);
+	}
+	records.Clear();
+	if (!progress) {
+		return NULL;
+	}
+	if (reportProgressCallback && !reportProgressCallback(dgFloat32 (0.5f), reportPrgressUserData)) {
+		return NULL;
+	}
+	triangleCount = simplifier.Finish();
+	const dgInt32* const triangles = simplifier.GetTriangles();
+
+	// collapses only remove vertices, so every corner of the result is an original vertex and 
+	// takes one of that vertex's attributes. the corner with the fewest choices is the anchor, it picks 
+	// by normal. the other two corners follow the anchor material and uv, so faces stay on one side of 
+	// the uv and material seams, and then pick the normal closest to the new face.
+	const dgInt32 attribCount = m_attrib.m_pointChannel.m_count;
+	dgStack<dgInt32> attribStart (pointCount + 1);
+	dgStack<dgInt32> attribList (attribCount + 1);
+	memset (&attribStart[0], 0, (pointCount + 1) * sizeof (dgInt32));
+	for (dgInt32 i = 0; i < attribCount; i++) {
+		attribStart[m_attrib.m_pointChannel[i] + 1] ++;
+	}
+	for (dgInt32 i = 0; i < pointCount; i++) {
+		attribStart[i + 1] += attribStart[i];
+	}
+	for (dgInt32 i = 0; i < attribCount; i++) {
+		const dgInt32 vertex = m_attrib.m_pointChannel[i];
+		attribList[attribStart[vertex]] = i;
+		attribStart[vertex] ++;
+	}
+	for (dgInt32 i = pointCount; i > 0; i--) {
+		attribStart[i] = attribStart[i - 1];
+	}
+	attribStart[0] = 0;
+
+	const bool hasMaterial = m_attrib.m_materialChannel.m_count ? true : false;
+	const bool hasNormal = m_attrib.m_normalChannel.m_count ? true : false;
+	const bool hasUV0 = m_attrib.m_uv0Channel.m_count ? true : false;
+	dgMeshEffect* const mesh = new (GetAllocator()) dgMeshEffect (GetAllocator());
+	mesh->BeginBuild();
+	for (dgInt32 i = 0; i < triangleCount; i++) {
+		const dgInt32* const face = &triangles[i * 3];
+		const dgBigVector& p0 = points[face[0]];
+		const dgBigVector e10 (points[face[1]] - p0);
+		const dgBigVector e20 (points[face[2]] - p0);
+		dgBigVector normal (e10.CrossProduct(e20));
+		normal = normal.Scale (dgFloat64 (1.0f) / sqrt (normal.DotProduct3(normal) + dgFloat64 (1.0e-24f)));
+
+		dgInt32 anchor = 0;
+		for (dgInt32 j = 1; j < 3; j++) {
+			if ((attribStart[face[j] + 1] - attribStart[face[j]]) < (attribStart[face[anchor] + 1] - attribStart[face[anchor]])) {
+				anchor = j;
+			}
+		}
+
+		dgInt32 faceAttrib[3];
+		for (dgInt32 j = 0; j < 3; j++) {
+			const dgInt32 corner = (anchor + j) % 3;
+			const dgInt32 vIndex = face[corner];
+			dgAssert (attribStart[vIndex + 1] > attribStart[vIndex]);
+			dgInt32 aIndex = attribList[attribStart[vIndex]];
+			dgFloat64 bestScore = dgFloat64 (-1.0e10f);
+			for (dgInt32 k = attribStart[vIndex]; k < attribStart[vIndex + 1]; k++) {
+				const dgInt32 index = attribList[k];
+				dgFloat64 score = dgFloat64 (0.0f);
+				if (j) {
+					const dgInt32 anchorIndex = faceAttrib[anchor];
+					if (hasMaterial && (m_attrib.m_materialChannel[index] == m_attrib.m_materialChannel[anchorIndex])) {
+						score += dgFloat64 (8.0f);
+					}
+					if (hasUV0) {
+						const dgFloat64 du = m_attrib.m_uv0Channel[index].m_u - m_attrib.m_uv0Channel[anchorIndex].m_u;
+						const dgFloat64 dv = m_attrib.m_uv0Channel[index].m_v - m_attrib.m_uv0Channel[anchorIndex].m_v;
+						score -= dgFloat64 (4.0f) * (du * du + dv * dv);
+					}
+				}
+				if (hasNormal) {
+					const dgTriplex& n = m_attrib.m_normalChannel[index];
+					score += normal.DotProduct3(dgBigVector (n.m_x, n.m_y, n.m_z, dgFloat64 (0.0f)));
+				}
+				if (score > bestScore) {
+					bestScore = score;
+					aIndex = index;
+				}
+			}
+			faceAttrib[corner] = aIndex;
+		}
 
-	// calculate initial edge costs
-	graph.SubmitInitialEdgeCosts (mesh);
+		mesh->BeginBuildFace();
+		for (dgInt32 j = 0; j < 3; j++) {
+			const dgInt32 vIndex = face[j];
+			const dgInt32 aIndex = faceAttrib[j];
+			mesh->AddPoint (points[vIndex].m_x, points[vIndex].m_y, points[vIndex].m_z);
+			if (m_points.m_layers.m_count) {
+				mesh->AddLayer (m_points.m_layers[vIndex]);
+			}
+			if (hasMaterial) {
+				mesh->AddMaterial (m_attrib.m_materialChannel[aIndex]);
+			}
+			if (m_attrib.m_colorChannel.m_count) {
+				mesh->AddVertexColor(m_attrib.m_colorChannel[aIndex].m_x, m_attrib.m_colorChannel[aIndex].m_y, m_attrib.m_colorChannel[aIndex].m_z, m_attrib.m_colorChannel[aIndex].m_w);
+			}
+			if (hasNormal) {
+				mesh->AddNormal(m_attrib.m_normalChannel[aIndex].m_x, m_attrib.m_normalChannel[aIndex].m_y, m_attrib.m_normalChannel[aIndex].m_z);
+			}
+			if (m_attrib.m_binormalChannel.m_count) {
+				mesh->AddBinormal(m_attrib.m_binormalChannel[aIndex].m_x, m_attrib.m_binormalChannel[aIndex].m_y, m_attrib.m_binormalChannel[aIndex].m_z);
+			}
+			if (hasUV0) {
+				mesh->AddUV0(m_attrib.m_uv0Channel[aIndex].m_u, m_attrib.m_uv0Channel[aIndex].m_v);
+			}
+			if (m_attrib.m_uv1Channel.m_count) {
+				mesh->AddUV1(m_attrib.m_uv1Channel[aIndex].m_u, m_attrib.m_uv1Channel[aIndex].m_v);
+			}
+		}
+		mesh->EndBuildFace();
+	}
+	mesh->EndBuild(dgFloat64 (1.0e-8f), false);
 
-	// collapse the graph
-	graph.CollapseClusters (mesh, maxConcavity, maxHullsCount);
+	if (reportProgressCallback) {
+		reportProgressCallback(dgFloat32 (1.0f), reportPrgressUserData);
+	}
+	return mesh;
+}
 
-	// Create Partition Mesh
-	return graph.CreatePatitionMesh (mesh, maxVertexPerHull);
-*/
+// out of core version, only the vertex array, one slab of cells, and the simplified output 
+// are in memory at any time. the vertices are read straight into the one array the simplifier 
+// uses, the faces are read once from the .off file into a binary scratch file of triangle 
+// records, and the scratch file is read back once per slab.
+// .off files have no vertex attributes, the result gets positions and recalculated normals.
+dgMeshEffect* dgMeshEffect::CreateSimplificationFromOFF(dgMemoryAllocator* const allocator, const char* const fileName, dgInt32 maxVertexCount, dgReportProgress reportProgressCallback, void* const reportPrgressUserData, dgThreadHive* const threadPool)
+{
+	class dgOffStream
+	{
+		public:
+		dgOffStream(FILE* const file)
+			:m_file(file)
+		{
+		}
+
+		bool GetToken(char* const buffer) const
+		{
+			while (fscanf(m_file, "%255s", buffer) == 1) {
+				if (buffer[0] == '#') {
+					char tmp[1024];
+					if (!fgets(tmp, sizeof (tmp), m_file)) {
+						return false;
+					}
+				} else {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		dgInt32 GetInteger() const
+		{
+			char buffer[256];
+			return GetToken(buffer) ? atoi(buffer) : -1;
+		}
+
+		dgFloat64 GetFloat() const
+		{
+			char buffer[256];
+			return GetToken(buffer) ? atof(buffer) : dgFloat64 (0.0f);
+		}
+
+		FILE* m_file;
+	};
+
+	FILE* const file = fopen(fileName, "rb");
+	if (!file) {
+		return NULL;
+	}
+
+	dgOffStream stream(file);
+	char buffer[256];
+	if (!stream.GetToken(buffer) || _stricmp(buffer, "OFF")) {
+		fclose(file);
+		return NULL;
+	}
+
+	const dgInt32 vertexCount = stream.GetInteger();
+	const dgInt32 faceCount = stream.GetInteger();
+	stream.GetInteger();
+	if ((vertexCount <= 0) || (faceCount <= 0)) {
+		fclose(file);
+		return NULL;
+	}
+
+	dgArray<dgBigVector> points(allocator);
+	points.ResizeIfNecessary(vertexCount);
+	for (dgInt32 i = 0; i < vertexCount; i++) {
+		dgFloat64 x = stream.GetFloat();
+		dgFloat64 y = stream.GetFloat();
+		dgFloat64 z = stream.GetFloat();
+		points[i] = dgBigVector(x, y, z, dgFloat64 (0.0f));
+	}
+
+	// first pass counts the triangles, so that the grid can be sized 
+	const long faceSection = ftell(file);
+	dgInt32 triangleCount = 0;
+	for (dgInt32 i = 0; i < faceCount; i++) {
+		const dgInt32 count = stream.GetInteger();
+		for (dgInt32 j = 0; j < count; j++) {
+			stream.GetInteger();
+		}
+		triangleCount += dgMax (count - 2, 0);
+	}
+
+	FILE* const scratch = tmpfile();
+	if (!scratch) {
+		points.Clear();
+		fclose(file);
+		return NULL;
+	}
+
+	// second pass assigns every triangle to a cell and writes the records to the scratch file
+	dgMeshSimplifier simplifier (allocator, &points[0], vertexCount, triangleCount, maxVertexCount);
+	fseek(file, faceSection, SEEK_SET);
+	dgInt32 batchCount = 0;
+	dgInt32 batch[DG_SIMPLIFY_STREAM_BATCH * 4];
+	for (dgInt32 i = 0; i < faceCount; i++) {
+		dgInt32 face[DG_MESH_EFFECT_POINT_SPLITED];
+		const dgInt32 count = stream.GetInteger();
+		for (dgInt32 j = 0; j < count; j++) {
+			const dgInt32 index = stream.GetInteger();
+			if (j < DG_MESH_EFFECT_POINT_SPLITED) {
+				face[j] = index;
+			}
+		}
+		for (dgInt32 j = 2; j < dgMin (count, dgInt32 (DG_MESH_EFFECT_POINT_SPLITED)); j++) {
+			const dgInt32 i0 = face[0];
+			const dgInt32 i1 = face[j - 1];
+			const dgInt32 i2 = face[j];
+			if ((i0 >= 0) && (i1 >= 0) && (i2 >= 0) && (i0 < vertexCount) && (i1 < vertexCount) && (i2 < vertexCount)) {
+				dgInt32* const record = &batch[batchCount * 4];
+				record[0] = simplifier.MarkTriangle(i0, i1, i2);
+				record[1] = i0;
+				record[2] = i1;
+				record[3] = i2;
+				batchCount++;
+				if (batchCount == DG_SIMPLIFY_STREAM_BATCH) {
+					fwrite(batch, sizeof (dgInt32) * 4, size_t (batchCount), scratch);
+					batchCount = 0;
+				}
+			}
+		}
+	}
+	fwrite(batch, sizeof (dgInt32) * 4, size_t (batchCount), scratch);
+	fclose(file);
+
+	// one pass over the scratch file per slab of cells
+	bool progress = true;
+	dgArray<dgInt32> records(allocator);
+	const dgInt32 slabCount = simplifier.GetSlabCount();
+	for (dgInt32 slab = 0; progress && (slab < slabCount); slab++) {
+		dgInt32 recordCount = 0;
+		rewind(scratch);
+		for (size_t read = fread(batch, sizeof (dgInt32) * 4, DG_SIMPLIFY_STREAM_BATCH, scratch); read; read = fread(batch, sizeof (dgInt32) * 4, DG_SIMPLIFY_STREAM_BATCH, scratch)) {
+			for (dgInt32 i = 0; i < dgInt32 (read); i++) {
+				const dgInt32* const record = &batch[i * 4];
+				if (simplifier.GetSlab(record[0]) == slab) {
+					records.ResizeIfNecessary(recordCount * 4 + 4);
+					for (dgInt32 j = 0; j < 4; j++) {
+						records[recordCount * 4 + j] = record[j];
+					}
+					recordCount++;
+				}
+			}
+		}
+		if (recordCount) {
+			simplifier.SimplifySlab(&records[0], recordCount, threadPool);
+		}
+		if (reportProgressCallback) {
+			progress = reportProgressCallback(dgFloat32 (slab + 1) / dgFloat32 (slabCount + 1), reportPrgressUserData);
+		}
+	}
+	fclose(scratch);
+	records.Clear();
+
+	if (!progress) {
+		points.Clear();
+		return NULL;
+	}
+	dgMeshEffect* const mesh = simplifier.CreateMesh(simplifier.Finish());
+	points.Clear();
+	if (reportProgressCallback) {
+		reportProgressCallback(dgFloat32 (1.0f), reportPrgressUserData);
+	}
+	return mesh;
 }
@@ -333,828 +333,2193 @@ dgMeshEffect* dgMeshEffect::ConvexMeshIntersection (const dgMeshEffect* const co
 }
 
 
-void dgMeshEffect::ClipMesh (const dgMatrix& matrix, const dgMeshEffect* const clipMesh, dgMeshEffect** const back, dgMeshEffect** const front) const
-{
-	dgAssert (0);
-/*
-	dgMeshEffect clipper (*clipMesh);
-	clipper.TransformMesh (matrix);
 
-	dgMeshEffect* backMeshSource = NULL;
-	dgMeshEffect* frontMeshSource = NULL;
-	dgMeshEffect* backMeshClipper = NULL;
-	dgMeshEffect* frontMeshClipper = NULL;
+#define DG_BOOLEAN_TASKS_PER_THREAD		16
+#define DG_BOOLEAN_RAY_DIRECTIONS		6
+
+// Boolean operations between two closed meshes.
+// both solids are fan triangulated into flat arrays, the clipper solid is transformed and
+// offset by a tiny irrational displacement to keep exact contacts away from the predicates.
+// candidate face pairs come from a BVH vs BVH traversal split in parallel tasks, and every
+// triangle pair is intersected with exact orientation tests (dgGoogol is only used when the
+// double filter can not decide the sign). each intersection point is keyed by the edge that
+// pierces and the triangle it pierces, so neighbor triangles share the split vertices.
+// the split triangles are retriangulated in parallel by a 2d constrained triangulation,
+// fragments are flooded into regions bounded by the intersection curve, each region is
+// classified with a ray parity test against the other solid, and the selected fragments
+// are sent directly to the result mesh without intermediate mesh copies.
+class dgBooleanMeshClipper
+{
+	public:
+	enum dgOperation
+	{
+		m_union,
+		m_difference,
+		m_intersection,
+	};
 
-	ClipMesh (&clipper, &backMeshSource, &frontMeshSource);
-	if (backMeshSource && frontMeshSource) {
-		clipper.ClipMesh (this, &backMeshClipper, &frontMeshClipper);
-		if (backMeshSource && frontMeshSource) {
+	class dgTriangle
+	{
+		public:
+		dgInt32 m_vertex[3];
+		dgInt32 m_attrib[3];
+		dgInt32 m_edge[3];
+	};
 
-			dgMeshEffect* backMesh;
-			dgMeshEffect* frontMesh;
+	class dgEdgeKey
+	{
+		public:
+		dgInt32 m_v0;
+		dgInt32 m_v1;
+		dgInt32 m_slot;
+	};
 
-			backMesh = new (GetAllocator()) dgMeshEffect (GetAllocator(), true);
-			frontMesh = new (GetAllocator()) dgMeshEffect (GetAllocator(), true);
+	class dgSegment
+	{
+		public:
+		dgInt64 m_key[2];
+		dgInt32 m_triangle[2];
+	};
 
-			backMesh->BeginPolygon();
-			frontMesh->BeginPolygon();
+	class dgCurvePoint
+	{
+		public:
+		dgInt32 m_edge;
+		dgInt32 m_triangle;
+		dgFloat64 m_param;
+	};
 
-			backMesh->MergeFaces(backMeshSource);
-			backMesh->MergeFaces(backMeshClipper);
+	class dgTriangleSegment
+	{
+		public:
+		dgInt32 m_triangle;
+		dgInt32 m_point0;
+		dgInt32 m_point1;
+	};
 
-			frontMesh->MergeFaces(frontMeshSource);
-			frontMesh->ReverseMergeFaces(backMeshClipper);
+	class dgFragment
+	{
+		public:
+		dgInt32 m_triangle;
+		dgInt32 m_vertex[3];
+		dgInt32 m_constraint;
+	};
 
-			backMesh->EndPolygon(dgFloat64 (1.0e-5f));
-			frontMesh->EndPolygon(dgFloat64 (1.0e-5f));
+	class dgFragmentSpan
+	{
+		public:
+		dgInt32 m_thread;
+		dgInt32 m_start;
+		dgInt32 m_count;
+	};
 
-			*back = backMesh;
-			*front = frontMesh;
-		}
-	}
+	class dgFragmentEdge
+	{
+		public:
+		dgInt32 m_v0;
+		dgInt32 m_v1;
+		dgInt32 m_fragment;
+	};
 
-	if (backMeshClipper) {
-		delete backMeshClipper;
-	}
+	class dgNodePair
+	{
+		public:
+		dgMeshEffect::dgMeshBVH::dgMeshBVHNode* m_node0;
+		dgMeshEffect::dgMeshBVH::dgMeshBVHNode* m_node1;
+	};
 
-	if (frontMeshClipper) {
-		delete frontMeshClipper;
-	}
+	class dgBooleanMeshBVH: public dgMeshEffect::dgMeshBVH
+	{
+		public:
+		dgBooleanMeshBVH (const dgBooleanMeshClipper* const clipper, dgInt32 solid)
+			:dgMeshEffect::dgMeshBVH(clipper->m_mesh[solid])
+			,m_clipper(clipper)
+			,m_solid(solid)
+		{
+		}
 
-	if (backMeshSource) {
-		delete backMeshSource;
-	}
+		DG_CLASS_ALLOCATOR(allocator)
 
-	if (frontMeshSource) {
-		delete frontMeshSource;
-	}
-*/
-}
+		virtual void Build ()
+		{
+			const dgArray<dgEdge*>& faces = m_clipper->m_faces[m_solid];
+			for (dgInt32 i = 0; i < m_clipper->m_faceCount[m_solid]; i ++) {
+				AddFaceNode (faces[i], IntToPointer(i));
+			}
+			ImproveNodeFitness ();
+		}
 
+		protected:
+		// leaf boxes enclose the transformed triangles of the face, padded to cover the float rounding
+		virtual dgMeshBVHNode* CreateLeafNode (dgEdge* const face, void* const userData)
+		{
+			dgMemoryAllocator* const allocator = m_mesh->GetAllocator();
+			dgMeshBVHNode* const node = new (allocator) dgMeshBVHNode (m_mesh, face, userData);
+
+			const dgInt32 faceIndex = dgInt32 (PointerToInt(userData));
+			const dgInt32 start = m_clipper->m_faceTriangleStart[m_solid][faceIndex];
+			const dgInt32 end = m_clipper->m_faceTriangleStart[m_solid][faceIndex + 1];
+			dgBigVector p0 (dgFloat64 ( 1.0e30f));
+			dgBigVector p1 (dgFloat64 (-1.0e30f));
+			for (dgInt32 i = start; i < end; i ++) {
+				const dgTriangle& triangle = m_clipper->m_triangles[i];
+				for (dgInt32 j = 0; j < 3; j ++) {
+					const dgBigVector& p = m_clipper->m_points[triangle.m_vertex[j]];
+					p0 = p0.GetMin(p);
+					p1 = p1.GetMax(p);
+				}
+			}
+			const dgBigVector padding (m_clipper->m_padding, m_clipper->m_padding, m_clipper->m_padding, dgFloat64 (0.0f));
+			node->SetBox (dgVector (p0 - padding), dgVector (p1 + padding));
+			return node;
+		}
 
+		const dgBooleanMeshClipper* m_clipper;
+		dgInt32 m_solid;
+		friend class dgBooleanMeshClipper;
+	};
 
+	// open addressing map from a pair of local vertices to an index, with linear probing
+	class dgEdgeHash
+	{
+		public:
+		class dgEntry
+		{
+			public:
+			dgInt32 m_v0;
+			dgInt32 m_v1;
+			dgInt32 m_value;
+		};
+
+		dgEdgeHash (dgMemoryAllocator* const allocator)
+			:m_table(allocator)
+			,m_swap(allocator)
+			,m_mask(0)
+			,m_count(0)
+		{
+		}
 
-dgMeshEffect* dgMeshEffect::Union (const dgMatrix& matrix, const dgMeshEffect* const clipperMesh) const
-{
-	dgAssert (0);
-	return NULL;
-/*
-	dgMeshEffect copy (*this);
-	dgMeshEffect clipper (*clipperMesh);
-	clipper.TransformMesh (matrix);
-
-	dgBooleanMeshClipper::ClipMeshesAndColorize (&copy, &clipper);
-
-	dgMeshEffect* const mesh = new (GetAllocator()) dgMeshEffect (GetAllocator());
-	mesh->BeginFace();
-	dgBooleanMeshClipper::CopyPoints(mesh, &copy);
-	dgBooleanMeshClipper::AddExteriorFaces (mesh, &copy);
-
-	dgBooleanMeshClipper::AddExteriorFaces (mesh, &clipper);
-	mesh->EndFace ();
-	mesh->RepairTJoints();
-	mesh->RemoveUnusedVertices(NULL);
-	return mesh;
-*/
-}
+		void Reset (dgInt32 capacity)
+		{
+			dgInt32 size = 16;
+			while (size < capacity * 2) {
+				size *= 2;
+			}
+			m_table.ResizeIfNecessary (size);
+			for (dgInt32 i = 0; i < size; i ++) {
+				m_table[i].m_v0 = -1;
+			}
+			m_mask = size - 1;
+			m_count = 0;
+		}
 
-dgMeshEffect* dgMeshEffect::Difference (const dgMatrix& matrix, const dgMeshEffect* const clipperMesh) const
-{
-/*
-	dgMeshEffect copy (*this);
-	dgMeshEffect clipper (*clipperMesh);
-	clipper.TransformMesh (matrix);
-
-	dgBooleanMeshClipper::ClipMeshesAndColorize (&copy, &clipper);
-
-	dgMeshEffect* const mesh = new (GetAllocator()) dgMeshEffect (GetAllocator());
-	mesh->BeginFace();
-	dgBooleanMeshClipper::CopyPoints(mesh, &copy);
-	dgBooleanMeshClipper::AddExteriorFaces (mesh, &copy);
-	dgBooleanMeshClipper::AddInteriorFacesInvertWinding (mesh, &clipper);
-	mesh->EndFace ();
-	mesh->RepairTJoints();
-	mesh->RemoveUnusedVertices(NULL);
-	return mesh;
-*/
+		dgInt32 Find (dgInt32 v0, dgInt32 v1) const
+		{
+			for (dgInt32 i = Hash (v0, v1); m_table[i].m_v0 >= 0; i = (i + 1) & m_mask) {
+				if ((m_table[i].m_v0 == v0) && (m_table[i].m_v1 == v1)) {
+					return m_table[i].m_value;
+				}
+			}
+			return -1;
+		}
 
-	dgAssert (0);
-	return NULL;
-}
+		void Insert (dgInt32 v0, dgInt32 v1, dgInt32 value)
+		{
+			if ((m_count + 1) * 2 > (m_mask + 1)) {
+				Grow ();
+			}
+			dgInt32 i = Hash (v0, v1);
+			for (; m_table[i].m_v0 >= 0; i = (i + 1) & m_mask) {
+				if ((m_table[i].m_v0 == v0) && (m_table[i].m_v1 == v1)) {
+					m_table[i].m_value = value;
+					return;
+				}
+			}
+			m_table[i].m_v0 = v0;
+			m_table[i].m_v1 = v1;
+			m_table[i].m_value = value;
+			m_count ++;
+		}
 
+		void Remove (dgInt32 v0, dgInt32 v1)
+		{
+			dgInt32 i = Hash (v0, v1);
+			for (; (m_table[i].m_v0 != v0) || (m_table[i].m_v1 != v1); i = (i + 1) & m_mask) {
+				if (m_table[i].m_v0 < 0) {
+					return;
+				}
+			}
+			// shift back the rest of the probe run instead of leaving a tombstone
+			for (dgInt32 j = (i + 1) & m_mask; m_table[j].m_v0 >= 0; j = (j + 1) & m_mask) {
+				const dgInt32 home = Hash (m_table[j].m_v0, m_table[j].m_v1);
+				if (((j - home) & m_mask) >= ((j - i) & m_mask)) {
+					m_table[i] = m_table[j];
+					i = j;
+				}
+			}
+			m_table[i].m_v0 = -1;
+			m_count --;
+		}
 
-class dgBooleanMeshClipper: public dgMeshEffect::dgMeshBVH
-{
-	class dgPoint: public dgBigVector
-	{
-		public:
-		dgPoint()
-			:dgBigVector(dgFloat32 (0.0f))
-			,m_links(NULL)
-			,m_lru(0)
+		private:
+		dgInt32 Hash (dgInt32 v0, dgInt32 v1) const
 		{
-			dgAssert (0);
+			const dgUnsigned32 key = dgUnsigned32 (v0) * 0x9e3779b1 + dgUnsigned32 (v1) * 0x85ebca6b;
+			return dgInt32 (key ^ (key >> 16)) & m_mask;
 		}
 
-		dgPoint(const dgBigVector& point, dgMemoryAllocator* const allocator)
-			:dgBigVector(point)
-			,m_links(allocator)
-			,m_lru(0)
+		void Grow ()
 		{
+			const dgInt32 size = m_mask + 1;
+			m_swap.ResizeIfNecessary (size);
+			for (dgInt32 i = 0; i < size; i ++) {
+				m_swap[i] = m_table[i];
+			}
+			Reset (size);
+			for (dgInt32 i = 0; i < size; i ++) {
+				if (m_swap[i].m_v0 >= 0) {
+					Insert (m_swap[i].m_v0, m_swap[i].m_v1, m_swap[i].m_value);
+				}
+			}
 		}
-		
-		dgList<dgTree<dgPoint, dgFloat64>::dgTreeNode*> m_links;
-		dgInt32 m_lru;
+
+		dgArray<dgEntry> m_table;
+		dgArray<dgEntry> m_swap;
+		dgInt32 m_mask;
+		dgInt32 m_count;
 	};
 
-	class dgCurvesNetwork: public dgTree<dgPoint, dgFloat64>
+	// incremental 2d constrained triangulation of one split triangle
+	class dgFaceTriangulator
 	{
 		public:
-		dgCurvesNetwork ()
-			:dgTree<dgPoint, dgFloat64>(NULL)
+		class dgLocalTriangle
 		{
-			dgAssert (0);
-		}
+			public:
+			dgInt32 m_v[3];
+		};
 
-		dgCurvesNetwork (dgMemoryAllocator* const allocator)
-			:dgTree<dgPoint, dgFloat64>(allocator)
+		class dgHalfEdge
+		{
+			public:
+			dgFloat64 m_angle;
+			dgInt32 m_v0;
+			dgInt32 m_v1;
+		};
+
+		dgFaceTriangulator (dgMemoryAllocator* const allocator)
+			:m_point(allocator)
+			,m_gid(allocator)
+			,m_alias(allocator)
+			,m_triangle(allocator)
+			,m_free(allocator)
+			,m_boundary(allocator)
+			,m_polygon(allocator)
+			,m_left(allocator)
+			,m_right(allocator)
+			,m_removed(allocator)
+			,m_halfEdge(allocator)
+			,m_parent(allocator)
+			,m_edgeHash(allocator)
+			,m_constraintHash(allocator)
+			,m_halfEdgeHash(allocator)
+			,m_pointCount(0)
+			,m_triangleCount(0)
+			,m_freeCount(0)
+			,m_boundaryCount(0)
 		{
 		}
 
-		dgTreeNode* AddVertex(const dgBigVector& point, dgMemoryAllocator* const allocator)
+		// returns false if neither the constrained triangulation nor the ear clipping fallback could recover the curve
+		bool Triangulate (dgBooleanMeshClipper* const me, dgInt32 triangleIndex, const dgTriangleSegment* const segments, dgInt32 segmentCount, dgInt32 threadID)
 		{
-			dgFloat64 key = ((point.m_z * dgFloat64 (1024.0f) + point.m_y) * dgFloat64 (1024.0f)) + point.m_x;
-			dgTreeNode* node = Find(key);
-			if (!node) {
-				dgPoint entry (point, allocator);
-				node = Insert(entry, key);
+			const dgTriangle& triangle = me->m_triangles[triangleIndex];
+			const dgBigVector& q0 = me->m_points[triangle.m_vertex[0]];
+			const dgBigVector& q1 = me->m_points[triangle.m_vertex[1]];
+			const dgBigVector& q2 = me->m_points[triangle.m_vertex[2]];
+			const dgBigVector normal ((q1 - q0).CrossProduct(q2 - q0));
+
+			// drop the dominant axis and keep the winding of the triangle
+			dgInt32 axis = 0;
+			if (fabs (normal.m_y) > fabs (normal[axis])) {
+				axis = 1;
 			}
-			return node;
+			if (fabs (normal.m_z) > fabs (normal[axis])) {
+				axis = 2;
+			}
+			dgInt32 index0 = (axis + 1) % 3;
+			dgInt32 index1 = (axis + 2) % 3;
+			if (normal[axis] < dgFloat64 (0.0f)) {
+				dgSwap (index0, index1);
+			}
+
+			m_pointCount = 0;
+			ResetTriangles (3);
+			for (dgInt32 i = 0; i < 3; i ++) {
+				AddPoint (me->m_points[triangle.m_vertex[i]], triangle.m_vertex[i], index0, index1);
+			}
+
+			bool state = true;
+			if (normal[axis] != dgFloat64 (0.0f)) {
+				// collect the curve points, the list is sorted so the local vertices are deterministic
+				const dgInt32 curveBase = me->m_curveBase;
+				for (dgInt32 i = 0; i < segmentCount; i ++) {
+					m_polygon[i * 2 + 0] = segments[i].m_point0;
+					m_polygon[i * 2 + 1] = segments[i].m_point1;
+				}
+				dgSort (&m_polygon[0], segmentCount * 2, CompareIndex);
+				const dgInt32 firstPoint = m_pointCount;
+				for (dgInt32 i = 0; i < segmentCount * 2; i ++) {
+					if (!i || (m_polygon[i] != m_polygon[i - 1])) {
+						AddPoint (me->m_points[curveBase + m_polygon[i]], curveBase + m_polygon[i], index0, index1);
+					}
+				}
+				const dgInt32 lastPoint = m_pointCount;
+
+				ResetTriangles (2 * m_pointCount);
+				AddTriangle (0, 1, 2);
+
+				// split the triangle edges by the points that lay on them, ordered along each edge,
+				// the boundary loop is kept for the fallback
+				m_boundaryCount = 0;
+				for (dgInt32 k = 0; k < 3; k ++) {
+					m_boundary[m_boundaryCount] = k;
+					m_boundaryCount ++;
+					dgInt32 count = 0;
+					for (dgInt32 i = firstPoint; i < lastPoint; i ++) {
+						const dgCurvePoint& point = me->m_curvePoints[m_gid[i] - curveBase];
+						if (point.m_edge == triangle.m_edge[k]) {
+							m_left[count] = i;
+							count ++;
+						}
+					}
+					if (count) {
+						// insertion sort by the parameter along the shared edge
+						for (dgInt32 i = 1; i < count; i ++) {
+							const dgInt32 tmp = m_left[i];
+							const dgFloat64 param = me->m_curvePoints[m_gid[tmp] - curveBase].m_param;
+							dgInt32 j = i - 1;
+							for (; (j >= 0) && (me->m_curvePoints[m_gid[m_left[j]] - curveBase].m_param > param); j --) {
+								m_left[j + 1] = m_left[j];
+							}
+							m_left[j + 1] = tmp;
+						}
+						const dgInt32 k1 = (k + 1) % 3;
+						const bool reverse = triangle.m_vertex[k] > triangle.m_vertex[k1];
+						for (dgInt32 i = 0; i < count; i ++) {
+							m_boundary[m_boundaryCount] = reverse ? m_left[count - 1 - i] : m_left[i];
+							m_boundaryCount ++;
+						}
+						state = state && SplitEdge (k, k1, count, reverse);
+					}
+				}
+
+				if (state) {
+					// insert the points inside the triangle
+					for (dgInt32 i = firstPoint; i < lastPoint; i ++) {
+						const dgCurvePoint& point = me->m_curvePoints[m_gid[i] - curveBase];
+						if ((point.m_edge != triangle.m_edge[0]) && (point.m_edge != triangle.m_edge[1]) && (point.m_edge != triangle.m_edge[2])) {
+							InsertPoint (i);
+						}
+					}
+
+					// recover the intersection curve
+					for (dgInt32 i = 0; (i < segmentCount) && state; i ++) {
+						const dgInt32 a = FindLocalPoint (curveBase + segments[i].m_point0, firstPoint, lastPoint);
+						const dgInt32 b = FindLocalPoint (curveBase + segments[i].m_point1, firstPoint, lastPoint);
+						state = InsertConstraint (a, b);
+					}
+				}
+
+				if (!state) {
+					state = EarClipFaces (segments, segmentCount, firstPoint, lastPoint, curveBase);
+				}
+			} else {
+				AddTriangle (0, 1, 2);
+			}
+
+			dgArray<dgFragment>& fragments = me->m_threadFragments[threadID];
+			dgInt32& fragmentCount = me->m_threadFragmentCount[threadID];
+			const dgInt32 start = fragmentCount;
+			if (state) {
+				fragments.ResizeIfNecessary (fragmentCount + m_triangleCount);
+				for (dgInt32 i = 0; i < m_triangleCount; i ++) {
+					const dgLocalTriangle& local = m_triangle[i];
+					if (local.m_v[0] >= 0) {
+						dgFragment& fragment = fragments[fragmentCount];
+						fragment.m_triangle = triangleIndex;
+						fragment.m_constraint = 0;
+						for (dgInt32 j = 0; j < 3; j ++) {
+							fragment.m_vertex[j] = m_gid[local.m_v[j]];
+							if (IsConstraint (local.m_v[j], local.m_v[(j + 1) % 3])) {
+								fragment.m_constraint |= 1 << j;
+							}
+						}
+						fragmentCount ++;
+					}
+				}
+			}
+
+			dgFragmentSpan& span = me->m_fragmentSpans[me->m_splitIndex[triangleIndex]];
+			span.m_thread = threadID;
+			span.m_start = start;
+			span.m_count = fragmentCount - start;
+			return state;
 		}
 
-/*
-		dgCurvesNetwork(dgBooleanMeshClipper* const BVHmeshA, dgBooleanMeshClipper* const BVHmeshB)
-			:dgTree<dgPoint, dgFloat64>(BVHmeshA->m_mesh->GetAllocator())
-//			,m_meshA(BVHmeshA->m_mesh)
-//			,m_meshB(BVHmeshB->m_mesh)
-//			,m_pointBaseA(m_meshA->GetVertexCount()) 
-//			,m_pointBaseB(m_meshB->GetVertexCount()) 
-//			,m_lru(0)
+		private:
+		static dgInt32 CompareIndex (const dgInt32* const indexA, const dgInt32* const indexB, void* const context)
 		{
+			return (*indexA < *indexB) ? -1 : ((*indexA > *indexB) ? 1 : 0);
 		}
-*/
-/*
-		dgHugeVector CalculateFaceNormal (const dgMeshEffect* const mesh, dgEdge* const face)
+
+		static dgInt32 CompareHalfEdge (const dgHalfEdge* const edgeA, const dgHalfEdge* const edgeB, void* const context)
 		{
-			dgHugeVector plane(dgGoogol::m_zero, dgGoogol::m_zero, dgGoogol::m_zero, dgGoogol::m_zero);
-			dgEdge* edge = face;
-			dgHugeVector p0(mesh->GetVertex(edge->m_incidentVertex));
-			edge = edge->m_next;
-			dgHugeVector p1(mesh->GetVertex(edge->m_incidentVertex));
-			dgHugeVector p1p0(p1 - p0);
-			edge = edge->m_next;
-			do {
-				dgHugeVector p2(mesh->GetVertex(edge->m_incidentVertex));
-				dgHugeVector p2p0(p2 - p0);
-				plane += p2p0 * p1p0;
-				p1p0 = p2p0;
-				edge = edge->m_next;
-			} while (edge != face);
+			if (edgeA->m_v0 != edgeB->m_v0) {
+				return (edgeA->m_v0 < edgeB->m_v0) ? -1 : 1;
+			}
+			return (edgeA->m_angle < edgeB->m_angle) ? -1 : ((edgeA->m_angle > edgeB->m_angle) ? 1 : 0);
+		}
 
-			plane.m_w = dgGoogol::m_zero - (plane % p0);
-			return plane;
+		void AddPoint (const dgBigVector& p, dgInt32 gid, dgInt32 index0, dgInt32 index1)
+		{
+			m_point[m_pointCount] = dgBigVector (p[index0], p[index1], dgFloat64 (0.0f), dgFloat64 (0.0f));
+			m_gid[m_pointCount] = gid;
+			m_alias[m_pointCount] = m_pointCount;
+			m_pointCount ++;
 		}
 
+		dgInt32 FindLocalPoint (dgInt32 gid, dgInt32 firstPoint, dgInt32 lastPoint) const
+		{
+			dgInt32 i0 = firstPoint;
+			dgInt32 i1 = lastPoint - 1;
+			while (i0 < i1) {
+				const dgInt32 mid = (i0 + i1) >> 1;
+				if (m_gid[mid] < gid) {
+					i0 = mid + 1;
+				} else {
+					i1 = mid;
+				}
+			}
+			dgAssert (m_gid[i0] == gid);
+			return m_alias[i0];
+		}
 
-		bool IsPointInFace (const dgHugeVector& point, const dgMeshEffect* const mesh, dgEdge* const face, const dgHugeVector& normal) const 
+		// triangles are found by their directed edges through m_edgeHash, which holds index * 4 + slot,
+		// removed triangles leave a hole in m_triangle that is reused by the next added triangle
+		void ResetTriangles (dgInt32 capacity)
 		{
-			dgEdge* edge = face;
+			m_triangleCount = 0;
+			m_freeCount = 0;
+			m_edgeHash.Reset (capacity * 3);
+			m_constraintHash.Reset (capacity);
+		}
 
-			dgTrace (("%f %f %f\n", dgFloat64 (point.m_x), dgFloat64 (point.m_y), dgFloat64 (point.m_z)));
-			do {
-				dgBigVector p1(mesh->GetVertex(edge->m_incidentVertex));
-				dgTrace (("%f %f %f\n", dgFloat64 (p1.m_x), dgFloat64 (p1.m_y), dgFloat64 (p1.m_z)));
-				edge = edge->m_next;
-			} while (edge != face);
+		void LinkTriangle (dgInt32 index)
+		{
+			const dgLocalTriangle& triangle = m_triangle[index];
+			for (dgInt32 j = 0; j < 3; j ++) {
+				m_edgeHash.Insert (triangle.m_v[j], triangle.m_v[(j + 1) % 3], index * 4 + j);
+			}
+		}
 
-			dgHugeVector p0(mesh->GetVertex(face->m_incidentVertex));
-			do {
-				dgHugeVector p1(mesh->GetVertex(edge->m_twin->m_incidentVertex));
-				dgHugeVector p1p0(p1 - p0);
-				dgHugeVector q1p0(point - p0);
-				dgGoogol side (q1p0 % (normal * p1p0));
-				if (side >= dgGoogol::m_zero) {
-					return false;
+		void UnlinkTriangle (dgInt32 index)
+		{
+			const dgLocalTriangle& triangle = m_triangle[index];
+			for (dgInt32 j = 0; j < 3; j ++) {
+				const dgInt32 a = triangle.m_v[j];
+				const dgInt32 b = triangle.m_v[(j + 1) % 3];
+				if ((m_edgeHash.Find (a, b) >> 2) == index) {
+					m_edgeHash.Remove (a, b);
 				}
-				p0 = p1;
-				edge = edge->m_next;
-			} while (edge != face);
-
-			return true;
+			}
 		}
 
-		dgFloat64 ClipEdgeFace(const dgMeshEffect* const meshEdge, dgEdge* const edge, const dgMeshEffect* const meshFace, dgEdge* const face, const dgHugeVector& plane)
+		void AddTriangle (dgInt32 v0, dgInt32 v1, dgInt32 v2)
 		{
-			dgHugeVector p0 (meshEdge->GetVertex(edge->m_incidentVertex));
-			dgHugeVector p1 (meshEdge->GetVertex(edge->m_twin->m_incidentVertex));
-			
-			dgGoogol test0 (plane.EvaluePlane(p0));
-			dgGoogol test1 (plane.EvaluePlane(p1));
-
-			if ((test0 * test1) > dgGoogol::m_zero) {
-				// both point are in one side
-				return -1.0f;
-			}
-
-			if ((test0 * test1) < dgGoogol::m_zero) {
-				//point on different size, clip the line
-				dgHugeVector p1p0 (p1 - p0);
-				dgGoogol param = dgGoogol::m_zero - plane.EvaluePlane(p0) / (plane % p1p0);
-				dgHugeVector p (p0 + p1p0.Scale (param));
-				if (IsPointInFace (p, meshFace, face, plane)) {
-					return param;
-				}
-				return -1.0f;
+			dgInt32 index = m_triangleCount;
+			if (m_freeCount) {
+				m_freeCount --;
+				index = m_free[m_freeCount];
 			} else {
-				dgAssert (0);
-				//special cases;
+				m_triangleCount ++;
 			}
-			
-			return -1.0f;
+			dgLocalTriangle& triangle = m_triangle[index];
+			triangle.m_v[0] = v0;
+			triangle.m_v[1] = v1;
+			triangle.m_v[2] = v2;
+			LinkTriangle (index);
 		}
 
-		void AddPoint (dgMeshEffect* const edgeOwnerMesh, dgEdge* const edgeStart, dgMeshEffect* const faceOwnerMesh, dgEdge* const face, const dgHugeVector& plane, dgTreeNode** nodes, dgInt32& index)
+		void SetTriangle (dgInt32 index, dgInt32 v0, dgInt32 v1, dgInt32 v2)
 		{
-			dgEdge* edge = edgeStart;
-			do {
-				dgFloat64 param = ClipEdgeFace(edgeOwnerMesh, edge, faceOwnerMesh, face, plane);
-				if (param > 0.0f) {
-					dgPoint point(edgeOwnerMesh, edge, param, faceOwnerMesh, face);
-					dgTreeNode* node = Find(dgNodeKey(edge, param));
-					if (!node) {
-						node = Insert(point, dgNodeKey(edge, param));
-					}
-					nodes[index] = node;
-					index ++;
-				}
-				edge = edge->m_next;
-			} while (edge != edgeStart);
+			UnlinkTriangle (index);
+			dgLocalTriangle& triangle = m_triangle[index];
+			triangle.m_v[0] = v0;
+			triangle.m_v[1] = v1;
+			triangle.m_v[2] = v2;
+			LinkTriangle (index);
+		}
 
+		void RemoveTriangle (dgInt32 index)
+		{
+			UnlinkTriangle (index);
+			m_triangle[index].m_v[0] = -1;
+			m_free[m_freeCount] = index;
+			m_freeCount ++;
+		}
+
+		dgInt32 Orient (dgInt32 a, dgInt32 b, dgInt32 c) const
+		{
+			return Orient2d (m_point[a], m_point[b], m_point[c]);
+		}
+
+		// find the triangle with the directed edge a -> b, the position of a is returned in slot
+		dgInt32 FindTriangle (dgInt32 a, dgInt32 b, dgInt32& slot) const
+		{
+			const dgInt32 code = m_edgeHash.Find (a, b);
+			slot = code & 3;
+			return (code >= 0) ? code >> 2 : -1;
+		}
+
+		bool IsConstraint (dgInt32 a, dgInt32 b) const
+		{
+			return m_constraintHash.Find (dgMin (a, b), dgMax (a, b)) >= 0;
 		}
 
-		void ClipMeshesFaces(dgEdge* const faceA, dgEdge* const faceB)
+		void AddConstraint (dgInt32 a, dgInt32 b)
 		{
-			dgAssert (m_meshA->FindEdge(faceA->m_incidentVertex, faceA->m_twin->m_incidentVertex) == faceA);
-			dgAssert (m_meshB->FindEdge(faceB->m_incidentVertex, faceB->m_twin->m_incidentVertex) == faceB);
+			m_constraintHash.Insert (dgMin (a, b), dgMax (a, b), 0);
+		}
 
-			dgHugeVector planeA (CalculateFaceNormal (m_meshA, faceA));
-			dgHugeVector planeB (CalculateFaceNormal (m_meshB, faceB));
+		// fan the triangle on edge v0 -> v1 from its opposite vertex, the points are in m_left
+		bool SplitEdge (dgInt32 v0, dgInt32 v1, dgInt32 count, bool reverse)
+		{
+			dgInt32 slot;
+			const dgInt32 index = FindTriangle (v0, v1, slot);
+			if (index < 0) {
+				return false;
+			}
+			const dgInt32 apex = m_triangle[index].m_v[(slot + 2) % 3];
 
-			dgInt32 index = 0;
-			dgTreeNode* nodes[16];
-			AddPoint (m_meshA, faceA, m_meshB, faceB, planeB, nodes, index);
-			AddPoint (m_meshB, faceB, m_meshA, faceA, planeA, nodes, index);
-			dgAssert ((index == 0) || (index == 2));
-			if (index == 2) {
-				dgPoint& pointA = nodes[0]->GetInfo();
-				dgPoint& pointB = nodes[1]->GetInfo();
-				pointA.m_links.Append(nodes[1]);
-				pointB.m_links.Append(nodes[0]);
+			dgInt32 prev = v0;
+			for (dgInt32 i = 0; i < count; i ++) {
+				const dgInt32 point = reverse ? m_left[count - 1 - i] : m_left[i];
+				if (i == 0) {
+					SetTriangle (index, prev, point, apex);
+				} else {
+					AddTriangle (prev, point, apex);
+				}
+				prev = point;
 			}
+			AddTriangle (prev, v1, apex);
+			return true;
 		}
 
-		void GetCurve (dgList<dgTreeNode*>& curve, dgTreeNode* const node)
+		void InsertPoint (dgInt32 p)
 		{
-			dgInt32 stack = 1;
-			dgTreeNode* pool[64];
-
-			pool[0] = node;
-			while (stack) {
-				stack --;
-				dgTreeNode* const ptr = pool[stack];
-				dgPoint& point = ptr->GetInfo();
-				if (point.m_lru != m_lru) {
-					point.m_lru = m_lru;
-					curve.Append(ptr);
-					for (dgList<dgTree<dgPoint, dgNodeKey>::dgTreeNode*>::dgListNode* ptrPoint = point.m_links.GetFirst(); ptrPoint; ptrPoint = ptrPoint->GetNext()) {
-						dgTreeNode* const nextnode = ptrPoint->GetInfo();
-						dgPoint& nextPoint = nextnode->GetInfo();
-						if (nextPoint.m_lru != m_lru) {
-							pool[stack] = nextnode;
-							stack ++;
+			for (dgInt32 i = 0; i < m_triangleCount; i ++) {
+				const dgLocalTriangle triangle (m_triangle[i]);
+				if (triangle.m_v[0] < 0) {
+					continue;
+				}
+				dgInt32 test[3];
+				bool outside = false;
+				dgInt32 zeros = 0;
+				for (dgInt32 j = 0; (j < 3) && !outside; j ++) {
+					test[j] = Orient (triangle.m_v[j], triangle.m_v[(j + 1) % 3], p);
+					outside = test[j] < 0;
+					zeros += test[j] ? 0 : 1;
+				}
+				if (!outside) {
+					if (zeros == 0) {
+						SetTriangle (i, triangle.m_v[0], triangle.m_v[1], p);
+						AddTriangle (triangle.m_v[1], triangle.m_v[2], p);
+						AddTriangle (triangle.m_v[2], triangle.m_v[0], p);
+					} else if (zeros == 1) {
+						dgInt32 k = test[0] ? (test[1] ? 2 : 1) : 0;
+						const dgInt32 a = triangle.m_v[k];
+						const dgInt32 b = triangle.m_v[(k + 1) % 3];
+						const dgInt32 c = triangle.m_v[(k + 2) % 3];
+						dgInt32 slot;
+						const dgInt32 twin = FindTriangle (b, a, slot);
+						SetTriangle (i, a, p, c);
+						AddTriangle (p, b, c);
+						if (twin >= 0) {
+							const dgInt32 d = m_triangle[twin].m_v[(slot + 2) % 3];
+							SetTriangle (twin, b, p, d);
+							AddTriangle (p, a, d);
 						}
+					} else {
+						// the point is on a vertex already in the triangulation
+						m_alias[p] = test[0] ? triangle.m_v[2] : (test[1] ? triangle.m_v[0] : triangle.m_v[1]);
 					}
+					return;
+				}
+			}
+
+			// rounding left the point out of all triangles, split the one it is closest to
+			dgInt32 bestTriangle = 0;
+			dgFloat64 bestDist = dgFloat64 (-1.0e30f);
+			for (dgInt32 i = 0; i < m_triangleCount; i ++) {
+				const dgLocalTriangle& triangle = m_triangle[i];
+				if (triangle.m_v[0] < 0) {
+					continue;
+				}
+				dgFloat64 dist = dgFloat64 (1.0e30f);
+				for (dgInt32 j = 0; j < 3; j ++) {
+					const dgBigVector& a = m_point[triangle.m_v[j]];
+					const dgBigVector& b = m_point[triangle.m_v[(j + 1) % 3]];
+					const dgBigVector& c = m_point[p];
+					dist = dgMin (dist, (b.m_x - a.m_x) * (c.m_y - a.m_y) - (b.m_y - a.m_y) * (c.m_x - a.m_x));
+				}
+				if (dist > bestDist) {
+					bestDist = dist;
+					bestTriangle = i;
 				}
 			}
+			const dgLocalTriangle triangle (m_triangle[bestTriangle]);
+			SetTriangle (bestTriangle, triangle.m_v[0], triangle.m_v[1], p);
+			AddTriangle (triangle.m_v[1], triangle.m_v[2], p);
+			AddTriangle (triangle.m_v[2], triangle.m_v[0], p);
 		}
 
-		void EmbedCurveToSingleFace (dgList<dgTreeNode*>& curve, dgMeshEffect* const mesh)
+		// returns false, with the triangulation unchanged, if the segment can not be recovered
+		bool InsertConstraint (dgInt32 a, dgInt32 b)
 		{
-			dgEdge* const face = curve.GetFirst()->GetInfo()->GetInfo().m_face;
+			if (a == b) {
+				return true;
+			}
 
-			dgInt32 indexBase = mesh->GetVertexCount();
-			dgInt32 indexAttribBase = mesh->GetPropertiesCount();
+			dgInt32 slot;
+			if ((FindTriangle (a, b, slot) >= 0) || (FindTriangle (b, a, slot) >= 0)) {
+				AddConstraint (a, b);
+				return true;
+			}
 
-			for (dgList<dgTreeNode*>::dgListNode* node = curve.GetFirst(); node; node = node->GetNext()) {
-				dgPoint& point = node->GetInfo()->GetInfo();
-				dgAssert (point.m_face == face);
-				dgMeshEffect::dgVertexAtribute attribute(mesh->InterpolateVertex(point.m_posit, face));
-				mesh->AddVertex(point.m_posit);
-				mesh->AddAtribute(attribute);
+			// split the segment at vertices collinear with it
+			const dgBigVector& pa = m_point[a];
+			const dgBigVector& pb = m_point[b];
+			for (dgInt32 i = 0; i < m_pointCount; i ++) {
+				if ((m_alias[i] == i) && (i != a) && (i != b) && !Orient (a, b, i)) {
+					const dgBigVector& p = m_point[i];
+					if (((p - pa).DotProduct3(pb - pa) > dgFloat64 (0.0f)) && ((p - pb).DotProduct3(pa - pb) > dgFloat64 (0.0f))) {
+						return InsertConstraint (a, i) && InsertConstraint (i, b);
+					}
+				}
 			}
 
-			dgList<dgEdge*> list(GetAllocator());
-			dgInt32 i0 = curve.GetCount() - 1;
-			for (dgInt32 i = 0; i < curve.GetCount(); i++) {
-				dgEdge* const edge = mesh->AddHalfEdge(indexBase + i0, indexBase + i);
-				dgEdge* const twin = mesh->AddHalfEdge(indexBase + i, indexBase + i0);
+			// find the triangle around a whose wedge contains b
+			dgInt32 start = -1;
+			dgInt32 y = -1;
+			dgInt32 z = -1;
+			for (dgInt32 i = 0; (i < m_triangleCount) && (start < 0); i ++) {
+				const dgLocalTriangle& triangle = m_triangle[i];
+				for (dgInt32 j = 0; (j < 3) && (triangle.m_v[0] >= 0); j ++) {
+					if (triangle.m_v[j] == a) {
+						const dgInt32 v1 = triangle.m_v[(j + 1) % 3];
+						const dgInt32 v2 = triangle.m_v[(j + 2) % 3];
+						if ((Orient (a, v1, b) > 0) && (Orient (a, b, v2) > 0)) {
+							start = i;
+							y = v1;
+							z = v2;
+						}
+						break;
+					}
+				}
+			}
+			if (start < 0) {
+				return false;
+			}
 
-				edge->m_incidentFace = 1;
-				twin->m_incidentFace = 1;
-				edge->m_userData = indexAttribBase + i0;
-				twin->m_userData = indexAttribBase + i;
-				twin->m_twin = edge;
-				edge->m_twin = twin;
-				i0 = i;
-				list.Append(edge);
+			// walk the triangles crossed by the segment collecting the vertices on each side
+			dgInt32 leftCount = 1;
+			dgInt32 rightCount = 1;
+			dgInt32 removedCount = 1;
+			m_left[0] = z;
+			m_right[0] = y;
+			m_removed[0] = start;
+			for (;;) {
+				const dgInt32 index = FindTriangle (z, y, slot);
+				if (index < 0) {
+					return false;
+				}
+				m_removed[removedCount] = index;
+				removedCount ++;
+				const dgInt32 w = m_triangle[index].m_v[(slot + 2) % 3];
+				if (w == b) {
+					break;
+				}
+				const dgInt32 side = Orient (a, b, w);
+				if (side > 0) {
+					m_left[leftCount] = w;
+					leftCount ++;
+					z = w;
+				} else if (side < 0) {
+					m_right[rightCount] = w;
+					rightCount ++;
+					y = w;
+				} else {
+					// w is on the segment, recover the curve through it
+					return InsertConstraint (a, w) && InsertConstraint (w, b);
+				}
 			}
 
-			dgEdge* closestEdge = NULL;
-			dgFloat64 dist2 = dgFloat64 (1.0e10f);
-			dgBigVector p(mesh->GetVertex(face->m_incidentVertex));
+			// remove the crossed triangles and fill the two pseudo polygons
+			for (dgInt32 i = 0; i < removedCount; i ++) {
+				RemoveTriangle (m_removed[i]);
+			}
 
-			list.Append(list.GetFirst()->GetInfo());
-			list.Addtop(list.GetLast()->GetInfo());
-			for (dgList<dgEdge*>::dgListNode* node = list.GetFirst()->GetNext(); node != list.GetLast(); node = node->GetNext()) {
-				dgEdge* const edge = node->GetInfo();
+			m_polygon[0] = a;
+			m_polygon[1] = b;
+			for (dgInt32 i = 0; i < leftCount; i ++) {
+				m_polygon[i + 2] = m_left[leftCount - 1 - i];
+			}
+			EarClip (leftCount + 2);
 
-				dgEdge* const prev = node->GetPrev()->GetInfo();
-				edge->m_prev = prev;
-				prev->m_next = edge;
-				edge->m_twin->m_next = prev->m_twin;
-				prev->m_twin->m_prev = edge->m_twin;
+			m_polygon[0] = b;
+			m_polygon[1] = a;
+			for (dgInt32 i = 0; i < rightCount; i ++) {
+				m_polygon[i + 2] = m_right[i];
+			}
+			EarClip (rightCount + 2);
 
-				dgEdge* const next = node->GetNext()->GetInfo();
-				edge->m_next = next;
-				next->m_prev = edge;
-				edge->m_twin->m_prev = next->m_twin;
-				next->m_twin->m_next = edge->m_twin;
+			AddConstraint (a, b);
+			return true;
+		}
 
-				dgBigVector dist(mesh->GetVertex(edge->m_incidentVertex) - p);
-				dgFloat64 err2 = dist % dist;
-				if (err2 < dist2) {
-					closestEdge = edge;
-					dist2 = err2;
+		// fallback when the incremental triangulation can not recover the curve, the triangle is cut into
+		// the faces bounded by its edges and the curve segments, and each face is ear clipped on its own.
+		// segments crossing each other are not handled and return false.
+		bool EarClipFaces (const dgTriangleSegment* const segments, dgInt32 segmentCount, dgInt32 firstPoint, dgInt32 lastPoint, dgInt32 curveBase)
+		{
+			ResetTriangles (2 * m_pointCount);
+
+			// boundary edges are entered with value 1 so that segments along them are not added twice,
+			// they are removed at the end unless a segment runs along them
+			dgInt32 halfEdgeCount = 0;
+			for (dgInt32 i = 0; i < m_boundaryCount; i ++) {
+				const dgInt32 a = m_boundary[i];
+				const dgInt32 b = m_boundary[(i + 1) % m_boundaryCount];
+				m_constraintHash.Insert (dgMin (a, b), dgMax (a, b), 1);
+			}
+			for (dgInt32 i = 0; i < segmentCount; i ++) {
+				const dgInt32 a = FindLocalPoint (curveBase + segments[i].m_point0, firstPoint, lastPoint);
+				const dgInt32 b = FindLocalPoint (curveBase + segments[i].m_point1, firstPoint, lastPoint);
+				const dgInt32 code = (a != b) ? m_constraintHash.Find (dgMin (a, b), dgMax (a, b)) : 0;
+				if (code == 1) {
+					m_constraintHash.Insert (dgMin (a, b), dgMax (a, b), 0);
+				} else if (code < 0) {
+					m_constraintHash.Insert (dgMin (a, b), dgMax (a, b), 0);
+					for (dgInt32 j = 0; j < 2; j ++) {
+						dgHalfEdge& edge = m_halfEdge[halfEdgeCount + j];
+						edge.m_v0 = j ? b : a;
+						edge.m_v1 = j ? a : b;
+					}
+					halfEdgeCount += 2;
 				}
 			}
+			for (dgInt32 i = 0; i < m_boundaryCount; i ++) {
+				for (dgInt32 j = 0; j < 2; j ++) {
+					dgHalfEdge& edge = m_halfEdge[halfEdgeCount + j];
+					edge.m_v0 = m_boundary[(i + j) % m_boundaryCount];
+					edge.m_v1 = m_boundary[(i + 1 - j) % m_boundaryCount];
+				}
+				halfEdgeCount += 2;
+			}
 
-			dgBigVector faceNormal (mesh->FaceNormal(face, mesh->GetVertexPool(), mesh->GetVertexStrideInByte()));
-			dgBigVector clipNormal (mesh->FaceNormal(closestEdge, mesh->GetVertexPool(), mesh->GetVertexStrideInByte()));
-			if ((clipNormal % faceNormal) > dgFloat64(0.0f)) {
-				closestEdge = closestEdge->m_twin->m_next;
+			// curve loops that do not touch the triangle edges are holes in the face around them,
+			// each one is bridged from its leftmost vertex to a visible vertex further left
+			for (dgInt32 i = 0; i < m_pointCount; i ++) {
+				m_parent[i] = i;
 			}
-			dgEdge* const glueEdge = mesh->ConnectVertex (closestEdge, face);
-			dgAssert (glueEdge);
-			mesh->PolygonizeFace(glueEdge, mesh->GetVertexPool(), sizeof (dgBigVector));
-		}
+			for (dgInt32 i = 0; i < halfEdgeCount; i += 2) {
+				m_parent[FindRoot (&m_parent[0], m_halfEdge[i].m_v0)] = FindRoot (&m_parent[0], m_halfEdge[i].m_v1);
+			}
+			for (;;) {
+				const dgInt32 boundaryRoot = FindRoot (&m_parent[0], 0);
+				dgInt32 hole = -1;
+				for (dgInt32 i = 0; i < halfEdgeCount; i ++) {
+					const dgInt32 v = m_halfEdge[i].m_v0;
+					if ((FindRoot (&m_parent[0], v) != boundaryRoot) && ((hole < 0) || IsLeftOf (v, hole))) {
+						hole = v;
+					}
+				}
+				if (hole < 0) {
+					break;
+				}
 
-		void EmbedCurveToMulipleFaces (dgList<dgTreeNode*>& curve, dgMeshEffect* const mesh)
-		{
-			for (dgList<dgTreeNode*>::dgListNode* node = curve.GetFirst(); node; node = node->GetNext()) {
-				dgPoint& point = node->GetInfo()->GetInfo();
-				if (point.m_edgeOwnerMesh == mesh) {
-					dgEdge* const edge = point.m_edge;
-					dgBigVector p0 (mesh->GetVertex(edge->m_incidentVertex));
-					dgBigVector p1 (mesh->GetVertex(edge->m_twin->m_incidentVertex));
-					dgVector p1p0 (p1 - p0);
-					dgVector qp0 (point.m_posit - p0);
-					dgFloat64 param = (qp0 % p1p0) / (p1p0 % p1p0);
-					dgAssert (param >= dgFloat64 (0.0f));
-					dgAssert (param <= dgFloat64 (1.0f));
-					dgEdge* const newEdge = mesh->InsertEdgeVertex (edge, param);
+				const dgInt32 holeRoot = FindRoot (&m_parent[0], hole);
+				dgInt32 bridge = -1;
+				dgFloat64 bridgeDist2 = dgFloat64 (1.0e30f);
+				for (dgInt32 i = 0; i < halfEdgeCount; i ++) {
+					const dgInt32 v = m_halfEdge[i].m_v0;
+					if ((FindRoot (&m_parent[0], v) != holeRoot) && IsLeftOf (v, hole)) {
+						const dgBigVector dist (m_point[v] - m_point[hole]);
+						const dgFloat64 dist2 = dist.DotProduct3(dist);
+						if ((dist2 < bridgeDist2) && IsVisible (hole, v, halfEdgeCount)) {
+							bridge = v;
+							bridgeDist2 = dist2;
+						}
+					}
+				}
+				if (bridge < 0) {
+					return false;
+				}
+				for (dgInt32 j = 0; j < 2; j ++) {
+					dgHalfEdge& edge = m_halfEdge[halfEdgeCount + j];
+					edge.m_v0 = j ? bridge : hole;
+					edge.m_v1 = j ? hole : bridge;
+				}
+				halfEdgeCount += 2;
+				m_parent[holeRoot] = FindRoot (&m_parent[0], bridge);
+			}
+
+			// sort the outgoing half edges of each vertex counter clockwise
+			for (dgInt32 i = 0; i < halfEdgeCount; i ++) {
+				dgHalfEdge& edge = m_halfEdge[i];
+				const dgBigVector dir (m_point[edge.m_v1] - m_point[edge.m_v0]);
+				edge.m_angle = atan2 (dir.m_y, dir.m_x);
+			}
+			dgSort (&m_halfEdge[0], halfEdgeCount, CompareHalfEdge);
+			m_halfEdgeHash.Reset (halfEdgeCount);
+			for (dgInt32 i = 0; i < halfEdgeCount; i ++) {
+				m_halfEdgeHash.Insert (m_halfEdge[i].m_v0, m_halfEdge[i].m_v1, i);
+			}
+
+			// walk each face keeping it to the left, the next edge leaves the end vertex
+			// just clockwise from the way back. the face outside the triangle is the one with the
+			// reversed boundary, all others are clipped even if rounding made them flat
+			const dgFloat64 triangleArea = PolygonArea (&m_boundary[0], m_boundaryCount);
+			const dgInt32 outerEdge = m_halfEdgeHash.Find (m_boundary[1], m_boundary[0]);
+			dgFloat64 faceArea = dgFloat64 (0.0f);
+			for (dgInt32 i = 0; i < halfEdgeCount; i ++) {
+				m_removed[i] = 0;
+			}
+			for (dgInt32 i = 0; i < halfEdgeCount; i ++) {
+				if (m_removed[i]) {
+					continue;
+				}
+				dgInt32 count = 0;
+				dgInt32 edge = i;
+				bool outer = false;
+				do {
+					if (m_removed[edge] || (count >= halfEdgeCount)) {
+						return false;
+					}
+					m_removed[edge] = 1;
+					outer = outer || (edge == outerEdge);
+					m_polygon[count] = m_halfEdge[edge].m_v0;
+					count ++;
+
+					const dgInt32 v = m_halfEdge[edge].m_v1;
+					const dgInt32 twin = m_halfEdgeHash.Find (v, m_halfEdge[edge].m_v0);
+					if (twin < 0) {
+						return false;
+					}
+					edge = ((twin == 0) || (m_halfEdge[twin - 1].m_v0 != v)) ? twin : twin - 1;
+					if (edge == twin) {
+						// wrap around to the last edge leaving v
+						while ((edge + 1 < halfEdgeCount) && (m_halfEdge[edge + 1].m_v0 == v)) {
+							edge ++;
+						}
+					}
+				} while (edge != i);
+
+				if (!outer) {
+					faceArea += PolygonArea (&m_polygon[0], count);
+					EarClip (count);
 				}
-//				mesh->AddVertex(point.m_posit);
-//				mesh->AddAtribute(attribute);
 			}
+
+			for (dgInt32 i = 0; i < m_boundaryCount; i ++) {
+				const dgInt32 a = m_boundary[i];
+				const dgInt32 b = m_boundary[(i + 1) % m_boundaryCount];
+				if (m_constraintHash.Find (dgMin (a, b), dgMax (a, b)) == 1) {
+					m_constraintHash.Remove (dgMin (a, b), dgMax (a, b));
+				}
+			}
+			// a bad hole bridge or crossing segments leave faces overlapping or uncovered
+			return fabs (faceArea - triangleArea) <= (triangleArea * dgFloat64 (1.0e-6f));
 		}
 
+		bool IsLeftOf (dgInt32 a, dgInt32 b) const
+		{
+			const dgBigVector& p = m_point[a];
+			const dgBigVector& q = m_point[b];
+			return (p.m_x < q.m_x) || ((p.m_x == q.m_x) && (p.m_y < q.m_y));
+		}
 
-		void AddCurveToMesh (dgList<dgTreeNode*>& curve, dgMeshEffect* const mesh)
+		// true if segment a b does not cross any edge nor pass through any vertex, half edges come in pairs
+		bool IsVisible (dgInt32 a, dgInt32 b, dgInt32 halfEdgeCount) const
 		{
-			bool isIscribedInFace = true; 
-			dgEdge* const face = curve.GetFirst()->GetInfo()->GetInfo().m_face;
-			for (dgList<dgTreeNode*>::dgListNode* node = curve.GetFirst(); isIscribedInFace && node; node = node->GetNext()) {
-				dgPoint& point = node->GetInfo()->GetInfo();
-				isIscribedInFace = isIscribedInFace && (point.m_face == face);
-				isIscribedInFace = isIscribedInFace && (point.m_faceOwnerMesh == mesh);
+			const dgBigVector& pa = m_point[a];
+			const dgBigVector& pb = m_point[b];
+			for (dgInt32 i = 0; i < halfEdgeCount; i += 2) {
+				const dgInt32 u = m_halfEdge[i].m_v0;
+				const dgInt32 w = m_halfEdge[i].m_v1;
+				if ((u != a) && (u != b) && !Orient (a, b, u)) {
+					const dgBigVector& p = m_point[u];
+					if (((p - pa).DotProduct3(pb - pa) > dgFloat64 (0.0f)) && ((p - pb).DotProduct3(pa - pb) > dgFloat64 (0.0f))) {
+						return false;
+					}
+				}
+				if ((u != a) && (u != b) && (w != a) && (w != b)) {
+					if (((Orient (a, b, u) * Orient (a, b, w)) < 0) && ((Orient (u, w, a) * Orient (u, w, b)) < 0)) {
+						return false;
+					}
+				}
 			}
+			return true;
+		}
 
-			if (isIscribedInFace) {
-				EmbedCurveToSingleFace (curve, mesh);
-			} else {
-				EmbedCurveToMulipleFaces (curve, mesh);
+		dgFloat64 PolygonArea (const dgInt32* const polygon, dgInt32 count) const
+		{
+			dgFloat64 area = dgFloat64 (0.0f);
+			for (dgInt32 i = 0; i < count; i ++) {
+				const dgBigVector& p = m_point[polygon[i]];
+				const dgBigVector& q = m_point[polygon[(i + 1) % count]];
+				area += p.m_x * q.m_y - p.m_y * q.m_x;
 			}
+			return area * dgFloat64 (0.5f);
 		}
 
-		void Colorize()
+		void EarClip (dgInt32 count)
 		{
-			m_lru ++;
-			Iterator iter (*this);
-			for (iter.Begin(); iter; iter ++) {
-				dgPoint& point = iter.GetNode()->GetInfo();
-				if (point.m_lru != m_lru) {
-					dgList<dgTreeNode*> curve (GetAllocator());
-					GetCurve (curve, iter.GetNode());
-					AddCurveToMesh (curve, m_meshB);
-					AddCurveToMesh (curve, m_meshA);
+			while (count > 3) {
+				dgInt32 ear = -1;
+				for (dgInt32 i = 0; (i < count) && (ear < 0); i ++) {
+					const dgInt32 p = m_polygon[(i + count - 1) % count];
+					const dgInt32 c = m_polygon[i];
+					const dgInt32 q = m_polygon[(i + 1) % count];
+					if (Orient (p, c, q) > 0) {
+						bool empty = true;
+						for (dgInt32 j = 0; (j < count) && empty; j ++) {
+							const dgInt32 v = m_polygon[j];
+							if ((v != p) && (v != c) && (v != q)) {
+								empty = !((Orient (p, c, v) >= 0) && (Orient (c, q, v) >= 0) && (Orient (q, p, v) >= 0));
+							}
+						}
+						if (empty) {
+							ear = i;
+						}
+					}
+				}
+
+				if (ear < 0) {
+					// rounding made the polygon self intersect, clip the largest corner
+					dgFloat64 maxArea = dgFloat64 (-1.0e30f);
+					for (dgInt32 i = 0; i < count; i ++) {
+						const dgBigVector& p = m_point[m_polygon[(i + count - 1) % count]];
+						const dgBigVector& c = m_point[m_polygon[i]];
+						const dgBigVector& q = m_point[m_polygon[(i + 1) % count]];
+						const dgFloat64 area = (c.m_x - p.m_x) * (q.m_y - p.m_y) - (c.m_y - p.m_y) * (q.m_x - p.m_x);
+						if (area > maxArea) {
+							maxArea = area;
+							ear = i;
+						}
+					}
 				}
-			}
 
-			m_meshA->SaveOFF("xxxA0.off");
-			m_meshB->SaveOFF("xxxB0.off");
+				AddTriangle (m_polygon[(ear + count - 1) % count], m_polygon[ear], m_polygon[(ear + 1) % count]);
+				for (dgInt32 i = ear; i < count - 1; i ++) {
+					m_polygon[i] = m_polygon[i + 1];
+				}
+				count --;
+			}
+			AddTriangle (m_polygon[0], m_polygon[1], m_polygon[2]);
 		}
 
-		dgMeshEffect* m_meshA;
-		dgMeshEffect* m_meshB;
-		dgInt32 m_pointBaseA;
-		dgInt32 m_pointBaseB;
-		dgInt32 m_lru;
-*/
+		dgArray<dgBigVector> m_point;
+		dgArray<dgInt32> m_gid;
+		dgArray<dgInt32> m_alias;
+		dgArray<dgLocalTriangle> m_triangle;
+		dgArray<dgInt32> m_free;
+		dgArray<dgInt32> m_boundary;
+		dgArray<dgInt32> m_polygon;
+		dgArray<dgInt32> m_left;
+		dgArray<dgInt32> m_right;
+		dgArray<dgInt32> m_removed;
+		dgArray<dgHalfEdge> m_halfEdge;
+		dgArray<dgInt32> m_parent;
+		dgEdgeHash m_edgeHash;
+		dgEdgeHash m_constraintHash;
+		dgEdgeHash m_halfEdgeHash;
+		dgInt32 m_pointCount;
+		dgInt32 m_triangleCount;
+		dgInt32 m_freeCount;
+		dgInt32 m_boundaryCount;
 	};
 
-	class dgClippedFace: public dgMeshEffect
+	dgBooleanMeshClipper (const dgMeshEffect* const mesh, const dgMatrix& matrix, const dgMeshEffect* const clipper, dgThreadHive* const threadPool)
+		:m_points(mesh->GetAllocator())
+		,m_triangles(mesh->GetAllocator())
+		,m_edges(mesh->GetAllocator())
+		,m_segments(mesh->GetAllocator())
+		,m_curvePoints(mesh->GetAllocator())
+		,m_triangleSegments(mesh->GetAllocator())
+		,m_splitTriangles(mesh->GetAllocator())
+		,m_splitIndex(mesh->GetAllocator())
+		,m_fragmentSpans(mesh->GetAllocator())
+		,m_fragments(mesh->GetAllocator())
+		,m_fragmentRegion(mesh->GetAllocator())
+		,m_regionFragment(mesh->GetAllocator())
+		,m_regionVertex(mesh->GetAllocator())
+		,m_regionInside(mesh->GetAllocator())
+		,m_tasks(mesh->GetAllocator())
+		,m_matrix(matrix)
+		,m_allocator(mesh->GetAllocator())
+		,m_threadPool(threadPool)
+		,m_padding(dgFloat64 (0.0f))
+		,m_rayLength(dgFloat64 (0.0f))
+		,m_triangleCount(0)
+		,m_edgeCount(0)
+		,m_curveBase(0)
+		,m_curvePointCount(0)
+		,m_segmentCount(0)
+		,m_splitCount(0)
+		,m_fragmentCount(0)
+		,m_regionCount(0)
+		,m_taskCount(0)
+		,m_atomicIndex(0)
+		,m_failed(0)
 	{
-		public:
-		dgClippedFace ()
-			:dgMeshEffect()
-			,m_curveNetwork()
-		{
-			dgAssert (0);
+		m_mesh[0] = mesh;
+		m_mesh[1] = clipper;
+		m_bvh[0] = NULL;
+		m_bvh[1] = NULL;
+		for (dgInt32 i = 0; i < 2; i ++) {
+			m_faces[i].SetAllocator(m_allocator);
+			m_faceTriangleStart[i].SetAllocator(m_allocator);
+			m_faceCount[i] = 0;
+			m_vertexBase[i] = 0;
+			m_triangleBase[i] = 0;
+		}
+		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+			m_threadSegments[i].SetAllocator(m_allocator);
+			m_threadFragments[i].SetAllocator(m_allocator);
+			m_threadSegmentCount[i] = 0;
+			m_threadFragmentCount[i] = 0;
 		}
 
-		dgClippedFace (dgMemoryAllocator* const allocator)
-			:dgMeshEffect(allocator)
-			,m_curveNetwork(allocator)
-		{
+		dgMatrix invMatix (matrix.Inverse4x4());
+		invMatix.m_posit = dgVector::m_wOne;
+		m_normalMatrix = invMatix.Transpose4X4();
+
+		AddSolid (0);
+		AddSolid (1);
+		BuildEdges ();
+		BuildTrees ();
+		FindIntersectionSegments ();
+		BuildCurvePoints ();
+		SplitTriangles ();
+		if (!m_failed) {
+			BuildRegions ();
+			ClassifyRegions ();
 		}
+	}
 
-		dgClippedFace (const dgClippedFace& copy)
-			:dgMeshEffect(copy)
-			,m_curveNetwork(copy.m_curveNetwork)
-		{
+	~dgBooleanMeshClipper ()
+	{
+		for (dgInt32 i = 0; i < 2; i ++) {
+			if (m_bvh[i]) {
+				delete m_bvh[i];
+			}
 		}
+	}
 
-		void InitFace(dgMeshEffect* const mesh, dgEdge* const face)
-		{
-			dgInt32 indexCount = 0;
-			dgInt32 faceIndex[256];
-			dgInt64 faceDataIndex[256];
-			BeginFace ();
-			dgEdge* ptr = face;
-			do {
-				dgAssert (0);
-				//const dgMeshEffect::dgVertexAtribute& point =  mesh->GetAttribute(dgInt32 (ptr->m_userData));
-				//AddPoint (&point.m_vertex.m_x, dgInt32 (point.m_material));
-				faceIndex[indexCount] = indexCount;
-				faceDataIndex[indexCount] = indexCount;
-				indexCount ++;
-				ptr = ptr->m_next;
-			} while (ptr != face);
-			AddFace (indexCount, faceIndex, faceDataIndex);
-			EndFace ();
+	// returns NULL if the result is empty, if the meshes touch in a degenerated way or if some cut triangle could not be triangulated
+	dgMeshEffect* CreateMesh (dgOperation operation) const
+	{
+		if (m_failed) {
+			dgTrace (("boolean operation failed on a degenerated contact or on the intersection curve triangulation\n"));
+			return NULL;
 		}
 
+		const bool keepInside[2] = {operation == m_intersection, operation != m_union};
+		const bool flipClipper = (operation == m_difference);
 
-		void AddSegment (const dgBigVector& plane, const dgBigVector* const segment)
-		{
-			dgAssert (0);
-/*
-			dgCurvesNetwork::dgTreeNode* const node0 = m_curveNetwork.AddVertex (segment[0], GetAllocator());
-			dgCurvesNetwork::dgTreeNode* const node1 = m_curveNetwork.AddVertex (segment[1], GetAllocator());
-
-			dgPoint& pointA = node0->GetInfo();
-			dgPoint& pointB = node1->GetInfo();
-			pointA.m_links.Append(node1);
-			pointB.m_links.Append(node0);
-*/
+		dgInt32 faceCount = 0;
+		for (dgInt32 i = 0; i < m_fragmentCount; i ++) {
+			const dgInt32 solid = (m_fragments[i].m_triangle < m_triangleBase[1]) ? 0 : 1;
+			if ((m_regionInside[m_fragmentRegion[i]] != 0) == keepInside[solid]) {
+				faceCount ++;
+			}
+		}
+		if (!faceCount) {
+			return NULL;
 		}
 
-		dgCurvesNetwork m_curveNetwork;
-	};
+		const bool hasNormal = m_mesh[0]->HasNormalChannel() || m_mesh[1]->HasNormalChannel();
+		const bool hasBinormal = m_mesh[0]->HasBinormalChannel() || m_mesh[1]->HasBinormalChannel();
+		const bool hasUV0 = m_mesh[0]->HasUV0Channel() || m_mesh[1]->HasUV0Channel();
+		const bool hasUV1 = m_mesh[0]->HasUV1Channel() || m_mesh[1]->HasUV1Channel();
+		const bool hasColor = m_mesh[0]->HasVertexColorChannel() || m_mesh[1]->HasVertexColorChannel();
+
+		const dgInt32 indexCount = faceCount * 3;
+		dgStack<dgInt32> vertexMap (m_curveBase + m_curvePointCount);
+		dgStack<dgBigVector> points (m_curveBase + m_curvePointCount);
+		dgStack<dgInt32> faceIndexCount (faceCount);
+		dgStack<dgInt32> faceMaterial (faceCount);
+		dgStack<dgInt32> vertexIndex (indexCount);
+		dgStack<dgInt32> attributeIndex (indexCount);
+		dgStack<dgFloat32> normals (hasNormal ? indexCount * 3 : 1);
+		dgStack<dgFloat32> binormals (hasBinormal ? indexCount * 3 : 1);
+		dgStack<dgFloat32> uv0 (hasUV0 ? indexCount * 2 : 1);
+		dgStack<dgFloat32> uv1 (hasUV1 ? indexCount * 2 : 1);
+		dgStack<dgFloat32> colors (hasColor ? indexCount * 4 : 1);
+		memset (&vertexMap[0], -1, vertexMap.GetSizeInBytes());
+
+		dgInt32 vertexCount = 0;
+		dgInt32 corner = 0;
+		dgInt32 face = 0;
+		for (dgInt32 i = 0; i < m_fragmentCount; i ++) {
+			const dgFragment& fragment = m_fragments[i];
+			const dgInt32 solid = (fragment.m_triangle < m_triangleBase[1]) ? 0 : 1;
+			if ((m_regionInside[m_fragmentRegion[i]] != 0) != keepInside[solid]) {
+				continue;
+			}
+
+			const bool flip = flipClipper && (solid == 1);
+			const dgMeshEffect* const mesh = m_mesh[solid];
+			const dgTriangle& triangle = m_triangles[fragment.m_triangle];
+			const dgBigVector& p0 = m_points[triangle.m_vertex[0]];
+			const dgBigVector& p1 = m_points[triangle.m_vertex[1]];
+			const dgBigVector& p2 = m_points[triangle.m_vertex[2]];
+			const dgBigVector e10 (p1 - p0);
+			const dgBigVector e20 (p2 - p0);
+			const dgBigVector faceNormal (e10.CrossProduct(e20));
+			const dgFloat64 d00 = e10.DotProduct3(e10);
+			const dgFloat64 d01 = e10.DotProduct3(e20);
+			const dgFloat64 d11 = e20.DotProduct3(e20);
+			const dgFloat64 den = d00 * d11 - d01 * d01;
+			const dgFloat64 invDen = (fabs (den) > dgFloat64 (1.0e-40f)) ? dgFloat64 (1.0f) / den : dgFloat64 (0.0f);
+
+			faceIndexCount[face] = 3;
+			faceMaterial[face] = mesh->m_attrib.m_materialChannel.m_count ? mesh->m_attrib.m_materialChannel[triangle.m_attrib[0]] : 0;
+			face ++;
+
+			for (dgInt32 j = 0; j < 3; j ++) {
+				const dgInt32 gid = fragment.m_vertex[flip ? (3 - j) % 3 : j];
+				if (vertexMap[gid] < 0) {
+					vertexMap[gid] = vertexCount;
+					points[vertexCount] = m_points[gid];
+					points[vertexCount].m_w = dgFloat64 (0.0f);
+					vertexCount ++;
+				}
+				vertexIndex[corner] = vertexMap[gid];
+				attributeIndex[corner] = corner;
+
+				// barycentric weights of the corner in the source triangle
+				dgFloat64 weight[3];
+				if (gid == triangle.m_vertex[0]) {
+					weight[0] = dgFloat64 (1.0f); weight[1] = dgFloat64 (0.0f); weight[2] = dgFloat64 (0.0f);
+				} else if (gid == triangle.m_vertex[1]) {
+					weight[0] = dgFloat64 (0.0f); weight[1] = dgFloat64 (1.0f); weight[2] = dgFloat64 (0.0f);
+				} else if (gid == triangle.m_vertex[2]) {
+					weight[0] = dgFloat64 (0.0f); weight[1] = dgFloat64 (0.0f); weight[2] = dgFloat64 (1.0f);
+				} else {
+					const dgBigVector e (m_points[gid] - p0);
+					const dgFloat64 d20 = e.DotProduct3(e10);
+					const dgFloat64 d21 = e.DotProduct3(e20);
+					weight[1] = dgClamp ((d11 * d20 - d01 * d21) * invDen, dgFloat64 (0.0f), dgFloat64 (1.0f));
+					weight[2] = dgClamp ((d00 * d21 - d01 * d20) * invDen, dgFloat64 (0.0f), dgFloat64 (1.0f) - weight[1]);
+					weight[0] = dgFloat64 (1.0f) - weight[1] - weight[2];
+				}
+
+				if (hasNormal) {
+					dgVector n (dgVector::m_zero);
+					if (mesh->m_attrib.m_normalChannel.m_count) {
+						for (dgInt32 k = 0; k < 3; k ++) {
+							const dgTriplex& src = mesh->m_attrib.m_normalChannel[triangle.m_attrib[k]];
+							n += dgVector (src.m_x, src.m_y, src.m_z, dgFloat32 (0.0f)).Scale (dgFloat32 (weight[k]));
+						}
+						if (solid) {
+							n = m_normalMatrix.RotateVector(n);
+						}
+					} else {
+						n = dgVector (faceNormal);
+					}
+					n = n & dgVector::m_triplexMask;
+					const dgFloat32 mag2 = n.DotProduct(n).GetScalar();
+					n = (mag2 > dgFloat32 (1.0e-20f)) ? n.Scale (dgRsqrt (mag2)) : dgVector (dgFloat32 (0.0f), dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
+					if (flip) {
+						n = n.Scale (dgFloat32 (-1.0f));
+					}
+					normals[corner * 3 + 0] = n.m_x;
+					normals[corner * 3 + 1] = n.m_y;
+					normals[corner * 3 + 2] = n.m_z;
+				}
+
+				if (hasBinormal) {
+					dgVector n (dgVector::m_zero);
+					if (mesh->m_attrib.m_binormalChannel.m_count) {
+						for (dgInt32 k = 0; k < 3; k ++) {
+							const dgTriplex& src = mesh->m_attrib.m_binormalChannel[triangle.m_attrib[k]];
+							n += dgVector (src.m_x, src.m_y, src.m_z, dgFloat32 (0.0f)).Scale (dgFloat32 (weight[k]));
+						}
+						if (solid) {
+							n = m_normalMatrix.RotateVector(n);
+						}
+					}
+					binormals[corner * 3 + 0] = n.m_x;
+					binormals[corner * 3 + 1] = n.m_y;
+					binormals[corner * 3 + 2] = n.m_z;
+				}
+
+				if (hasUV0) {
+					dgFloat32 u = dgFloat32 (0.0f);
+					dgFloat32 v = dgFloat32 (0.0f);
+					if (mesh->m_attrib.m_uv0Channel.m_count) {
+						for (dgInt32 k = 0; k < 3; k ++) {
+							const dgMeshEffect::dgAttibutFormat::dgUV& uv = mesh->m_attrib.m_uv0Channel[triangle.m_attrib[k]];
+							u += uv.m_u * dgFloat32 (weight[k]);
+							v += uv.m_v * dgFloat32 (weight[k]);
+						}
+					}
+					uv0[corner * 2 + 0] = u;
+					uv0[corner * 2 + 1] = v;
+				}
+
+				if (hasUV1) {
+					dgFloat32 u = dgFloat32 (0.0f);
+					dgFloat32 v = dgFloat32 (0.0f);
+					if (mesh->m_attrib.m_uv1Channel.m_count) {
+						for (dgInt32 k = 0; k < 3; k ++) {
+							const dgMeshEffect::dgAttibutFormat::dgUV& uv = mesh->m_attrib.m_uv1Channel[triangle.m_attrib[k]];
+							u += uv.m_u * dgFloat32 (weight[k]);
+							v += uv.m_v * dgFloat32 (weight[k]);
+						}
+					}
+					uv1[corner * 2 + 0] = u;
+					uv1[corner * 2 + 1] = v;
+				}
+
+				if (hasColor) {
+					dgVector color (dgFloat32 (1.0f));
+					if (mesh->m_attrib.m_colorChannel.m_count) {
+						color = dgVector::m_zero;
+						for (dgInt32 k = 0; k < 3; k ++) {
+							color += mesh->m_attrib.m_colorChannel[triangle.m_attrib[k]].Scale (dgFloat32 (weight[k]));
+						}
+					}
+					colors[corner * 4 + 0] = color.m_x;
+					colors[corner * 4 + 1] = color.m_y;
+					colors[corner * 4 + 2] = color.m_z;
+					colors[corner * 4 + 3] = color.m_w;
+				}
+				corner ++;
+			}
+		}
+
+		dgMeshEffect::dgMeshVertexFormat vertexFormat;
+		vertexFormat.m_faceCount = faceCount;
+		vertexFormat.m_faceIndexCount = &faceIndexCount[0];
+		vertexFormat.m_faceMaterial = &faceMaterial[0];
+		vertexFormat.m_vertex.m_data = &points[0].m_x;
+		vertexFormat.m_vertex.m_strideInBytes = sizeof (dgBigVector);
+		vertexFormat.m_vertex.m_indexList = &vertexIndex[0];
+		if (hasNormal) {
+			vertexFormat.m_normal.m_data = &normals[0];
+			vertexFormat.m_normal.m_strideInBytes = 3 * sizeof (dgFloat32);
+			vertexFormat.m_normal.m_indexList = &attributeIndex[0];
+		}
+		if (hasBinormal) {
+			vertexFormat.m_binormal.m_data = &binormals[0];
+			vertexFormat.m_binormal.m_strideInBytes = 3 * sizeof (dgFloat32);
+			vertexFormat.m_binormal.m_indexList = &attributeIndex[0];
+		}
+		if (hasUV0) {
+			vertexFormat.m_uv0.m_data = &uv0[0];
+			vertexFormat.m_uv0.m_strideInBytes = 2 * sizeof (dgFloat32);
+			vertexFormat.m_uv0.m_indexList = &attributeIndex[0];
+		}
+		if (hasUV1) {
+			vertexFormat.m_uv1.m_data = &uv1[0];
+			vertexFormat.m_uv1.m_strideInBytes = 2 * sizeof (dgFloat32);
+			vertexFormat.m_uv1.m_indexList = &attributeIndex[0];
+		}
+		if (hasColor) {
+			vertexFormat.m_vertexColor.m_data = &colors[0];
+			vertexFormat.m_vertexColor.m_strideInBytes = 4 * sizeof (dgFloat32);
+			vertexFormat.m_vertexColor.m_indexList = &attributeIndex[0];
+		}
 
-	class dgClipppedFaces: public dgTree<dgClippedFace, dgEdge*>
+		dgMeshEffect* const mesh = new (m_allocator) dgMeshEffect (m_allocator);
+		mesh->BuildFromIndexList(&vertexFormat);
+		return mesh;
+	}
+
+	private:
+	// sign of the volume of tetrahedron p0, p1, p2, p3, exact when the double filter fails
+	static dgInt32 Orient3d (const dgBigVector& p0, const dgBigVector& p1, const dgBigVector& p2, const dgBigVector& p3)
 	{
-		public:
-		dgClipppedFaces(dgMeshEffect* const mesh)
-			:dgTree<dgClippedFace, dgEdge*>(mesh->GetAllocator())
-			,m_parentMesh (mesh)
-		{
+		dgFloat64 matrix[3][3];
+		for (dgInt32 i = 0; i < 3; i ++) {
+			matrix[0][i] = p1[i] - p0[i];
+			matrix[1][i] = p2[i] - p0[i];
+			matrix[2][i] = p3[i] - p0[i];
 		}
 
-		void ClipMeshesFaces(dgEdge* const faceA, const dgMeshEffect* const meshB, dgEdge* const faceB, const dgBigVector& planeB, const dgBigVector* const segment)
-		{
-			dgTreeNode* node = Find (faceA);
-			if (!node) {
-				dgClippedFace tmp (m_parentMesh->GetAllocator());
-				node = Insert (tmp, faceA);
-				dgClippedFace& faceHead = node->GetInfo();
-				faceHead.InitFace (m_parentMesh, faceA);
+		// the error bound of a double 3x3 determinant is about 8 ulps of its permanent, (1<<48) leaves room to spare
+		dgFloat64 error;
+		const dgFloat64 det = Determinant3x3 (matrix, &error);
+		const dgFloat64 errbound = error * (dgFloat64 (1.0f) / dgFloat64 (dgInt64 (1) << 48));
+		if (fabs (det) > errbound) {
+			return (det > dgFloat64 (0.0f)) ? 1 : -1;
+		}
+
+		dgGoogol exactMatrix[3][3];
+		for (dgInt32 i = 0; i < 3; i ++) {
+			exactMatrix[0][i] = dgGoogol(p1[i]) - dgGoogol(p0[i]);
+			exactMatrix[1][i] = dgGoogol(p2[i]) - dgGoogol(p0[i]);
+			exactMatrix[2][i] = dgGoogol(p3[i]) - dgGoogol(p0[i]);
+		}
+		const dgFloat64 exactDet = Determinant3x3(exactMatrix);
+		return (exactDet > dgFloat64 (0.0f)) ? 1 : ((exactDet < dgFloat64 (0.0f)) ? -1 : 0);
+	}
+
+	// sign of the area of triangle p0, p1, p2 on the x y plane, exact when the double filter fails
+	static dgInt32 Orient2d (const dgBigVector& p0, const dgBigVector& p1, const dgBigVector& p2)
+	{
+		dgFloat64 matrix[2][2];
+		matrix[0][0] = p1.m_x - p0.m_x;
+		matrix[0][1] = p1.m_y - p0.m_y;
+		matrix[1][0] = p2.m_x - p0.m_x;
+		matrix[1][1] = p2.m_y - p0.m_y;
+
+		dgFloat64 error;
+		const dgFloat64 det = Determinant2x2 (matrix, &error);
+		const dgFloat64 errbound = error * (dgFloat64 (1.0f) / dgFloat64 (dgInt64 (1) << 48));
+		if (fabs (det) > errbound) {
+			return (det > dgFloat64 (0.0f)) ? 1 : -1;
+		}
+
+		dgGoogol exactMatrix[2][2];
+		exactMatrix[0][0] = dgGoogol(p1.m_x) - dgGoogol(p0.m_x);
+		exactMatrix[0][1] = dgGoogol(p1.m_y) - dgGoogol(p0.m_y);
+		exactMatrix[1][0] = dgGoogol(p2.m_x) - dgGoogol(p0.m_x);
+		exactMatrix[1][1] = dgGoogol(p2.m_y) - dgGoogol(p0.m_y);
+		const dgFloat64 exactDet = Determinant2x2(exactMatrix);
+		return (exactDet > dgFloat64 (0.0f)) ? 1 : ((exactDet < dgFloat64 (0.0f)) ? -1 : 0);
+	}
+
+	// true if a segment on the plane of the triangle touches it, tested in 2d on the coordinate plane with the largest projection
+	static bool CoplanarSegmentTouchTriangle (const dgBigVector& p0, const dgBigVector& p1, const dgBigVector& q0, const dgBigVector& q1, const dgBigVector& q2)
+	{
+		const dgBigVector normal ((q1 - q0).CrossProduct(q2 - q0));
+		dgInt32 axis = (fabs (normal.m_y) > fabs (normal.m_x)) ? 1 : 0;
+		axis = (fabs (normal.m_z) > fabs (normal[axis])) ? 2 : axis;
+		const dgInt32 i = (axis + 1) % 3;
+		const dgInt32 j = (axis + 2) % 3;
+		const dgBigVector a (p0[i], p0[j], dgFloat64 (0.0f), dgFloat64 (0.0f));
+		const dgBigVector b (p1[i], p1[j], dgFloat64 (0.0f), dgFloat64 (0.0f));
+		const dgBigVector t[] = {dgBigVector (q0[i], q0[j], dgFloat64 (0.0f), dgFloat64 (0.0f)), dgBigVector (q1[i], q1[j], dgFloat64 (0.0f), dgFloat64 (0.0f)), dgBigVector (q2[i], q2[j], dgFloat64 (0.0f), dgFloat64 (0.0f))};
+
+		const dgInt32 test0 = Orient2d (t[0], t[1], a);
+		const dgInt32 test1 = Orient2d (t[1], t[2], a);
+		const dgInt32 test2 = Orient2d (t[2], t[0], a);
+		if (((test0 * test1) >= 0) && ((test1 * test2) >= 0) && ((test2 * test0) >= 0)) {
+			return true;
+		}
+		for (dgInt32 k0 = 2, k1 = 0; k1 < 3; k0 = k1, k1 ++) {
+			if (((Orient2d (a, b, t[k0]) * Orient2d (a, b, t[k1])) <= 0) && ((Orient2d (t[k0], t[k1], a) * Orient2d (t[k0], t[k1], b)) <= 0)) {
+				return true;
 			}
-			dgAssert (node);
-			dgClippedFace& faceHead = node->GetInfo();
-			faceHead.AddSegment(planeB, segment);
 		}
+		return false;
+	}
 
-		dgMeshEffect* m_parentMesh;
-	};
-	
+	// 1 if the segment crosses the triangle interior, 0 if it misses, -1 if it touches it on a vertex, an edge or the plane
+	static dgInt32 SegmentCrossTriangle (const dgBigVector& p0, const dgBigVector& p1, dgInt32 side0, dgInt32 side1, const dgBigVector& q0, const dgBigVector& q1, const dgBigVector& q2)
+	{
+		if ((side0 * side1) > 0) {
+			return 0;
+		}
+		if (!side0 && !side1) {
+			return CoplanarSegmentTouchTriangle (p0, p1, q0, q1, q2) ? -1 : 0;
+		}
+		// with one end point on the plane the line still pierces the plane at that point, so the edge tests hold
+		const dgInt32 test0 = Orient3d (p0, p1, q0, q1);
+		const dgInt32 test1 = Orient3d (p0, p1, q1, q2);
+		const dgInt32 test2 = Orient3d (p0, p1, q2, q0);
+		if (((test0 * test1) < 0) || ((test1 * test2) < 0) || ((test2 * test0) < 0)) {
+			return 0;
+		}
+		return (side0 && side1 && test0 && test1 && test2) ? 1 : -1;
+	}
 
-	public:
-	dgBooleanMeshClipper(dgMeshEffect* const mesh)
-		:dgMeshBVH(mesh)
-		,m_clippedFaces(mesh)
+	static dgInt32 CompareEdgeKey (const dgEdgeKey* const keyA, const dgEdgeKey* const keyB, void* const context)
 	{
-		dgMeshBVH::Build();
+		if (keyA->m_v0 != keyB->m_v0) {
+			return (keyA->m_v0 < keyB->m_v0) ? -1 : 1;
+		}
+		if (keyA->m_v1 != keyB->m_v1) {
+			return (keyA->m_v1 < keyB->m_v1) ? -1 : 1;
+		}
+		return (keyA->m_slot < keyB->m_slot) ? -1 : ((keyA->m_slot > keyB->m_slot) ? 1 : 0);
 	}
 
-	~dgBooleanMeshClipper()
+	static dgInt32 CompareSegment (const dgSegment* const segmentA, const dgSegment* const segmentB, void* const context)
 	{
+		for (dgInt32 i = 0; i < 2; i ++) {
+			if (segmentA->m_triangle[i] != segmentB->m_triangle[i]) {
+				return (segmentA->m_triangle[i] < segmentB->m_triangle[i]) ? -1 : 1;
+			}
+		}
+		return 0;
 	}
 
-/*
-	dgFloat64 IntersetionSegment(const dgMeshEffect* const meshEdge, dgEdge* const edge, const dgMeshEffect* const meshFace, dgEdge* const face, const dgHugeVector& plane)
+	static dgInt32 CompareCurveKey (const dgInt64* const keyA, const dgInt64* const keyB, void* const context)
 	{
-		dgHugeVector p0 (meshEdge->GetVertex(edge->m_incidentVertex));
-		dgHugeVector p1 (meshEdge->GetVertex(edge->m_twin->m_incidentVertex));
-			
-		dgGoogol test0 (plane.EvaluePlane(p0));
-		dgGoogol test1 (plane.EvaluePlane(p1));
-
-		if ((test0 * test1) > dgGoogol::m_zero) {
-			// both point are in one side
-			return -1.0f;
-		}
-
-		if ((test0 * test1) < dgGoogol::m_zero) {
-			//point on different size, clip the line
-			dgHugeVector p1p0 (p1 - p0);
-			dgGoogol param = dgGoogol::m_zero - plane.EvaluePlane(p0) / (plane % p1p0);
-			dgHugeVector p (p0 + p1p0.Scale (param));
-			if (IsPointInFace (p, meshFace, face, plane)) {
-				return param;
-			}
-			return -1.0f;
-		} else {
-			dgAssert (0);
-			//special cases;
+		return (*keyA < *keyB) ? -1 : ((*keyA > *keyB) ? 1 : 0);
+	}
+
+	static dgInt32 CompareTriangleSegment (const dgTriangleSegment* const segmentA, const dgTriangleSegment* const segmentB, void* const context)
+	{
+		if (segmentA->m_triangle != segmentB->m_triangle) {
+			return (segmentA->m_triangle < segmentB->m_triangle) ? -1 : 1;
 		}
-			
-		return -1.0f;
+		if (segmentA->m_point0 != segmentB->m_point0) {
+			return (segmentA->m_point0 < segmentB->m_point0) ? -1 : 1;
+		}
+		return (segmentA->m_point1 < segmentB->m_point1) ? -1 : ((segmentA->m_point1 > segmentB->m_point1) ? 1 : 0);
 	}
-*/
 
-	static dgHugeVector CalculateFaceNormal (const dgMeshEffect* const mesh, dgEdge* const face)
+	static dgInt32 CompareFragmentEdge (const dgFragmentEdge* const edgeA, const dgFragmentEdge* const edgeB, void* const context)
 	{
-		dgHugeVector plane(dgGoogol::m_zero, dgGoogol::m_zero, dgGoogol::m_zero, dgGoogol::m_zero);
-		dgEdge* edge = face;
-		dgHugeVector p0(mesh->GetVertex(edge->m_incidentVertex));
-		edge = edge->m_next;
-		dgHugeVector p1(mesh->GetVertex(edge->m_incidentVertex));
-		dgHugeVector p1p0(p1 - p0);
-		edge = edge->m_next;
-		do {
-			dgHugeVector p2(mesh->GetVertex(edge->m_incidentVertex));
-			dgHugeVector p2p0(p2 - p0);
-			plane += p1p0.CrossProduct(p2p0);
-			p1p0 = p2p0;
-			edge = edge->m_next;
-		} while (edge != face);
-
-		dgAssert(plane.m_w == dgGoogol(0.0));
-		plane.m_w = dgGoogol::m_zero - plane.DotProduct(p0).GetScalar();
-		return plane;
+		if (edgeA->m_v0 != edgeB->m_v0) {
+			return (edgeA->m_v0 < edgeB->m_v0) ? -1 : 1;
+		}
+		if (edgeA->m_v1 != edgeB->m_v1) {
+			return (edgeA->m_v1 < edgeB->m_v1) ? -1 : 1;
+		}
+		return (edgeA->m_fragment < edgeB->m_fragment) ? -1 : ((edgeA->m_fragment > edgeB->m_fragment) ? 1 : 0);
 	}
 
-	static bool IsPointInFace (const dgHugeVector& point, const dgMeshEffect* const mesh, dgEdge* const face, const dgHugeVector& normal)
+	// fan triangulate the faces of one solid, the clipper vertices go to the space of the mesh
+	void AddSolid (dgInt32 solid)
 	{
-		dgEdge* edge = face;
-		dgHugeVector p0(mesh->GetVertex(face->m_incidentVertex));
-		do {
-			dgHugeVector p1(mesh->GetVertex(edge->m_twin->m_incidentVertex));
-			dgHugeVector p1p0(p1 - p0);
-			dgHugeVector q1p0(point - p0);
-			dgAssert(p1p0.m_w == dgGoogol(0.0));
-			dgGoogol side (q1p0.DotProduct(p1p0.CrossProduct(normal)).GetScalar());
-			if (side >= dgGoogol::m_zero) {
-				return false;
+		const dgMeshEffect* const mesh = m_mesh[solid];
+		const dgInt32 vertexBase = solid ? m_vertexBase[0] + m_mesh[0]->m_points.m_vertex.m_count : 0;
+		const dgInt32 vertexCount = mesh->m_points.m_vertex.m_count;
+		m_vertexBase[solid] = vertexBase;
+		m_triangleBase[solid] = m_triangleCount;
+
+		m_points.ResizeIfNecessary (vertexBase + vertexCount);
+		for (dgInt32 i = 0; i < vertexCount; i ++) {
+			const dgBigVector& p = mesh->m_points.m_vertex[i];
+			dgBigVector q (p.m_x, p.m_y, p.m_z, dgFloat64 (0.0f));
+			if (solid) {
+				for (dgInt32 j = 0; j < 3; j ++) {
+					q[j] = m_matrix[0][j] * p.m_x + m_matrix[1][j] * p.m_y + m_matrix[2][j] * p.m_z + m_matrix[3][j];
+				}
 			}
-			p0 = p1;
-			edge = edge->m_next;
-		} while (edge != face);
+			m_points[vertexBase + i] = q;
+		}
 
-		return true;
+		if (solid) {
+			// a rigid motion far below the mesh tolerance, a displacement and a rotation about an axis no mesh 
+			// is likely aligned to, so coincident faces and parallel edges of the two solids are separated
+			dgBigVector minBox (dgFloat64 ( 1.0e30f));
+			dgBigVector maxBox (dgFloat64 (-1.0e30f));
+			for (dgInt32 i = 0; i < vertexBase + vertexCount; i ++) {
+				minBox = minBox.GetMin(m_points[i]);
+				maxBox = maxBox.GetMax(m_points[i]);
+			}
+			const dgBigVector size ((maxBox - minBox) & dgBigVector::m_triplexMask);
+			const dgFloat64 diagonal = sqrt (size.DotProduct3(size));
+			const dgBigVector axis (dgBigVector (dgFloat64 (0.41421356237f), dgFloat64 (0.73205080757f), dgFloat64 (0.23606797749f), dgFloat64 (0.0f)).Normalize());
+			const dgBigVector offset (axis.Scale (diagonal * dgFloat64 (1.0e-9f)));
+			const dgBigVector origin ((minBox + maxBox).Scale (dgFloat64 (0.5f)) & dgBigVector::m_triplexMask);
+			const dgBigVector angle (dgBigVector (axis.m_z, axis.m_x, axis.m_y, dgFloat64 (0.0f)).Scale (dgFloat64 (1.0e-9f)));
+			for (dgInt32 i = 0; i < vertexCount; i ++) {
+				dgBigVector& q = m_points[vertexBase + i];
+				q += angle.CrossProduct(q - origin) + offset;
+			}
+
+			const dgFloat64 extent = dgMax (dgMax (fabs (minBox.m_x), fabs (minBox.m_y)), dgMax (fabs (minBox.m_z), dgMax (dgMax (fabs (maxBox.m_x), fabs (maxBox.m_y)), fabs (maxBox.m_z))));
+			m_padding = extent * dgFloat64 (1.0e-5f) + diagonal * dgFloat64 (1.0e-6f) + dgFloat64 (1.0e-12f);
+			m_rayLength = dgFloat64 (4.0f) * (diagonal + extent) + dgFloat64 (1.0f);
+		}
+
+		const dgInt32 mark = mesh->IncLRU();
+		dgMeshEffect::Iterator iter (*mesh);
+		for (iter.Begin(); iter; iter ++) {
+			dgEdge* const face = &iter.GetNode()->GetInfo();
+			if ((face->m_mark != mark) && (face->m_incidentFace > 0)) {
+				dgEdge* ptr = face;
+				do {
+					ptr->m_mark = mark;
+					ptr = ptr->m_next;
+				} while (ptr != face);
+
+				m_faces[solid][m_faceCount[solid]] = face;
+				m_faceTriangleStart[solid][m_faceCount[solid]] = m_triangleCount;
+				m_faceCount[solid] ++;
+				for (ptr = face->m_next; ptr->m_next != face; ptr = ptr->m_next) {
+					dgTriangle& triangle = m_triangles[m_triangleCount];
+					triangle.m_vertex[0] = vertexBase + face->m_incidentVertex;
+					triangle.m_vertex[1] = vertexBase + ptr->m_incidentVertex;
+					triangle.m_vertex[2] = vertexBase + ptr->m_next->m_incidentVertex;
+					triangle.m_attrib[0] = dgInt32 (face->m_userData);
+					triangle.m_attrib[1] = dgInt32 (ptr->m_userData);
+					triangle.m_attrib[2] = dgInt32 (ptr->m_next->m_userData);
+					m_triangleCount ++;
+				}
+			}
+		}
+		m_faceTriangleStart[solid][m_faceCount[solid]] = m_triangleCount;
+		m_curveBase = vertexBase + vertexCount;
 	}
 
-	static bool ClipEdgeFace(dgBigVector& point, const dgMeshEffect* const meshEdge, dgEdge* const edgeSrc, const dgMeshEffect* const meshFace, dgEdge* const face, const dgHugeVector& plane)
+	// number the undirected triangle edges, edges are never shared across solids
+	void BuildEdges ()
 	{
-		const dgEdge* const edge = (edgeSrc->m_incidentVertex < edgeSrc->m_twin->m_incidentVertex) ? edgeSrc : edgeSrc->m_twin;
-		dgHugeVector p0 (meshEdge->GetVertex(edge->m_incidentVertex));
-		dgHugeVector p1 (meshEdge->GetVertex(edge->m_twin->m_incidentVertex));
-			
-		dgGoogol test0 (plane.EvaluePlane(p0));
-		dgGoogol test1 (plane.EvaluePlane(p1));
-
-		if ((test0 * test1) > dgGoogol::m_zero) {
-			// both point are in one side
-			return false;
-		}
-
-		if ((test0 * test1) < dgGoogol::m_zero) {
-			//point on different size, clip the line
-			dgHugeVector p1p0 (p1 - p0);
-			dgAssert(p1p0.m_w == dgGoogol(0.0));
-			dgGoogol param = dgGoogol::m_zero - plane.EvaluePlane(p0) / plane.DotProduct(p1p0).GetScalar();
-			dgHugeVector p (p0 + p1p0.Scale (param));
-			if (IsPointInFace (p, meshFace, face, plane)) {
-				point = dgBigVector(p.m_x, p.m_y, p.m_z, p.m_w);
-				return true;
+		const dgInt32 count = m_triangleCount * 3;
+		if (!count) {
+			return;
+		}
+		dgStack<dgEdgeKey> keys (count);
+		for (dgInt32 i = 0; i < m_triangleCount; i ++) {
+			const dgTriangle& triangle = m_triangles[i];
+			for (dgInt32 j = 0; j < 3; j ++) {
+				dgEdgeKey& key = keys[i * 3 + j];
+				const dgInt32 v0 = triangle.m_vertex[j];
+				const dgInt32 v1 = triangle.m_vertex[(j + 1) % 3];
+				key.m_v0 = dgMin (v0, v1);
+				key.m_v1 = dgMax (v0, v1);
+				key.m_slot = i * 3 + j;
+			}
+		}
+		dgSort (&keys[0], count, CompareEdgeKey);
+
+		m_edgeCount = 0;
+		m_edges.ResizeIfNecessary (count * 2);
+		for (dgInt32 i = 0; i < count; i ++) {
+			const dgEdgeKey& key = keys[i];
+			if (!i || (key.m_v0 != keys[i - 1].m_v0) || (key.m_v1 != keys[i - 1].m_v1)) {
+				m_edges[m_edgeCount * 2 + 0] = key.m_v0;
+				m_edges[m_edgeCount * 2 + 1] = key.m_v1;
+				m_edgeCount ++;
 			}
-			return false;
+			m_triangles[key.m_slot / 3].m_edge[key.m_slot % 3] = m_edgeCount - 1;
+		}
+	}
+
+	static void BuildTreeKernel (void* const context, void* const solid, dgInt32 threadID)
+	{
+		dgBooleanMeshClipper* const me = (dgBooleanMeshClipper*) context;
+		me->m_bvh[PointerToInt(solid)]->Build();
+	}
+
+	void BuildTrees ()
+	{
+		m_bvh[0] = new (m_allocator) dgBooleanMeshBVH (this, 0);
+		m_bvh[1] = new (m_allocator) dgBooleanMeshBVH (this, 1);
+		if (m_threadPool && (m_threadPool->GetThreadCount() > 1)) {
+			m_threadPool->QueueJob(BuildTreeKernel, this, IntToPointer(0), "dgBooleanMeshClipper::BuildTrees");
+			m_threadPool->QueueJob(BuildTreeKernel, this, IntToPointer(1), "dgBooleanMeshClipper::BuildTrees");
+			m_threadPool->SynchronizationBarrier();
 		} else {
-			dgAssert (0);
-			//special cases;
+			BuildTreeKernel (this, IntToPointer(0), 0);
+			BuildTreeKernel (this, IntToPointer(1), 0);
 		}
-			
-		return false;
 	}
 
-	static void CalculateIntersection (const dgMeshEffect* const edgeOwnerMesh, dgEdge* const edgeStart, const dgMeshEffect* const faceOwnerMesh, dgEdge* const face, const dgHugeVector& facePlane, dgBigVector* const data, dgInt32& index)
+	static bool BoxOverlap (const dgMeshEffect::dgMeshBVH::dgMeshBVHNode* const node0, const dgMeshEffect::dgMeshBVH::dgMeshBVHNode* const node1)
 	{
-		dgEdge* edge = edgeStart;
-		do {
-			bool isCleipped = ClipEdgeFace(data[index], edgeOwnerMesh, edge, faceOwnerMesh, face, facePlane);
-			if (isCleipped) {
-				index ++;
-			}
-			edge = edge->m_next;
-		} while (edge != edgeStart);
+		return dgOverlapTest (node0->m_p0, node0->m_p1, node1->m_p0, node1->m_p1) ? true : false;
 	}
 
-	static void ClipMeshesFaces(dgBooleanMeshClipper& bvhMeshA, dgEdge* const faceA, dgBooleanMeshClipper& bvhMeshB, dgEdge* const faceB)
+	// descend the pair with the larger non leaf node
+	static void SplitPair (const dgNodePair& pair, dgNodePair* const children)
 	{
-		const dgMeshEffect* const meshA = bvhMeshA.m_mesh;
-		const dgMeshEffect* const meshB = bvhMeshB.m_mesh;
-		dgAssert (meshA->FindEdge(faceA->m_incidentVertex, faceA->m_twin->m_incidentVertex) == faceA);
-		dgAssert (meshB->FindEdge(faceB->m_incidentVertex, faceB->m_twin->m_incidentVertex) == faceB);
-
-		dgHugeVector planeA (CalculateFaceNormal (meshA, faceA));
-		dgHugeVector planeB (CalculateFaceNormal (meshB, faceB));
-
-		dgBigVector points[16];
-		dgInt32 pointCount = 0;
-		CalculateIntersection (meshA, faceA, meshB, faceB, planeB, points, pointCount);
-		CalculateIntersection (meshB, faceB, meshA, faceA, planeA, points, pointCount);
-		dgAssert ((pointCount == 0) || (pointCount == 2));
-		if (pointCount == 2) {
-			dgBigVector facePlaneA (planeA.m_x, planeA.m_y, planeA.m_z, planeA.m_w);
-			dgBigVector facePlaneB (planeB.m_x, planeB.m_y, planeB.m_z, planeB.m_w);
-
-			bvhMeshA.m_clippedFaces.ClipMeshesFaces(faceA, meshB, faceB, facePlaneB, points);
-			bvhMeshB.m_clippedFaces.ClipMeshesFaces(faceB, meshA, faceA, facePlaneA, points);
+		const bool splitFirst = pair.m_node0->m_left && (!pair.m_node1->m_left || (pair.m_node0->m_area >= pair.m_node1->m_area));
+		if (splitFirst) {
+			children[0].m_node0 = pair.m_node0->m_left;
+			children[0].m_node1 = pair.m_node1;
+			children[1].m_node0 = pair.m_node0->m_right;
+			children[1].m_node1 = pair.m_node1;
+		} else {
+			children[0].m_node0 = pair.m_node0;
+			children[0].m_node1 = pair.m_node1->m_left;
+			children[1].m_node0 = pair.m_node0;
+			children[1].m_node1 = pair.m_node1->m_right;
 		}
 	}
 
-	static void ClipMeshesAndColorize(dgMeshEffect* const meshA, dgMeshEffect* const meshB)
+	static void FindSegmentsKernel (void* const context, void* const, dgInt32 threadID)
 	{
-		dgAssert (0);
-/*
-		dgBooleanMeshClipper BVHmeshA(meshA);
-		dgBooleanMeshClipper BVHmeshB(meshB);
-
-		int stack = 1;
-		
-		dgMeshBVHNode* stackPool[2 * DG_MESH_EFFECT_BVH_STACK_DEPTH][2];
-
-		stackPool[0][0] = BVHmeshA.m_rootNode;
-		stackPool[0][1] = BVHmeshB.m_rootNode;
-		while (stack) {
-			stack --;
-			dgMeshBVHNode* const nodeA = stackPool[stack][0];
-			dgMeshBVHNode* const nodeB = stackPool[stack][1];
-			if (dgOverlapTest (nodeA->m_p0, nodeA->m_p1, nodeB->m_p0, nodeB->m_p1)) {
-				if (nodeA->m_face && nodeB->m_face) {
-					ClipMeshesFaces(BVHmeshA, nodeA->m_face, BVHmeshB, nodeB->m_face);
-				} else if (nodeA->m_face) {
-					stackPool[stack][0] = nodeA;
-					stackPool[stack][1] = nodeB->m_left;
-					stack++;
-					dgAssert(stack < sizeof (stackPool) / sizeof (stackPool[0]));
-
-					stackPool[stack][0] = nodeA;
-					stackPool[stack][1] = nodeB->m_right;
-					stack++;
-					dgAssert(stack < sizeof (stackPool) / sizeof (stackPool[0]));
-					
-				} else if (nodeB->m_face) {
-					stackPool[stack][0] = nodeA->m_left;
-					stackPool[stack][1] = nodeB;
-					stack++;
-					dgAssert(stack < sizeof (stackPool) / sizeof (stackPool[0]));
-
-					stackPool[stack][0] = nodeA->m_right;
-					stackPool[stack][1] = nodeB;
-					stack++;
-					dgAssert(stack < sizeof (stackPool) / sizeof (stackPool[0]));
+		dgBooleanMeshClipper* const me = (dgBooleanMeshClipper*) context;
+		dgArray<dgNodePair> stack (me->m_allocator);
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1); i < me->m_taskCount; i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1)) {
+			dgInt32 stackCount = 1;
+			stack[0] = me->m_tasks[i];
+			while (stackCount) {
+				stackCount --;
+				const dgNodePair pair (stack[stackCount]);
+				if (BoxOverlap (pair.m_node0, pair.m_node1)) {
+					if (!pair.m_node0->m_left && !pair.m_node1->m_left) {
+						me->IntersectFaces (dgInt32 (PointerToInt(pair.m_node0->m_userData)), dgInt32 (PointerToInt(pair.m_node1->m_userData)), threadID);
+					} else {
+						stack.ResizeIfNecessary (stackCount + 2);
+						SplitPair (pair, &stack[stackCount]);
+						stackCount += 2;
+					}
+				}
+			}
+		}
+	}
 
-				} else {
-					stackPool[stack][0] = nodeA->m_left;
-					stackPool[stack][1] = nodeB->m_left;
-					stack ++;
-					dgAssert (stack < sizeof (stackPool) / sizeof (stackPool[0]));
+	void IntersectFaces (dgInt32 face0, dgInt32 face1, dgInt32 threadID)
+	{
+		const dgInt32 start0 = m_faceTriangleStart[0][face0];
+		const dgInt32 end0 = m_faceTriangleStart[0][face0 + 1];
+		const dgInt32 start1 = m_faceTriangleStart[1][face1];
+		const dgInt32 end1 = m_faceTriangleStart[1][face1 + 1];
+		for (dgInt32 i = start0; i < end0; i ++) {
+			for (dgInt32 j = start1; j < end1; j ++) {
+				IntersectTriangles (i, j, threadID);
+			}
+		}
+	}
 
-					stackPool[stack][0] = nodeA->m_left;
-					stackPool[stack][1] = nodeB->m_right;
-					stack++;
-					dgAssert(stack < sizeof (stackPool) / sizeof (stackPool[0]));
+	// intersect a triangle of the mesh with a triangle of the clipper, the result is
+	// a segment whose end points are the two edges that pierce the other triangle
+	void IntersectTriangles (dgInt32 triangle0, dgInt32 triangle1, dgInt32 threadID)
+	{
+		const dgTriangle& t0 = m_triangles[triangle0];
+		const dgTriangle& t1 = m_triangles[triangle1];
+		const dgBigVector* const p = &m_points[0];
+
+		dgBigVector min0 (p[t0.m_vertex[0]].GetMin(p[t0.m_vertex[1]]).GetMin(p[t0.m_vertex[2]]));
+		dgBigVector max0 (p[t0.m_vertex[0]].GetMax(p[t0.m_vertex[1]]).GetMax(p[t0.m_vertex[2]]));
+		dgBigVector min1 (p[t1.m_vertex[0]].GetMin(p[t1.m_vertex[1]]).GetMin(p[t1.m_vertex[2]]));
+		dgBigVector max1 (p[t1.m_vertex[0]].GetMax(p[t1.m_vertex[1]]).GetMax(p[t1.m_vertex[2]]));
+		if ((min0.m_x > max1.m_x) || (min1.m_x > max0.m_x) || (min0.m_y > max1.m_y) || (min1.m_y > max0.m_y) || (min0.m_z > max1.m_z) || (min1.m_z > max0.m_z)) {
+			return;
+		}
 
-					stackPool[stack][0] = nodeA->m_right;
-					stackPool[stack][1] = nodeB->m_left;
-					stack++;
-					dgAssert(stack < sizeof (stackPool) / sizeof (stackPool[0]));
+		dgInt32 side0[3];
+		dgInt32 side1[3];
+		for (dgInt32 i = 0; i < 3; i ++) {
+			side0[i] = Orient3d (p[t1.m_vertex[0]], p[t1.m_vertex[1]], p[t1.m_vertex[2]], p[t0.m_vertex[i]]);
+		}
+		if (((side0[0] > 0) && (side0[1] > 0) && (side0[2] > 0)) || ((side0[0] < 0) && (side0[1] < 0) && (side0[2] < 0))) {
+			return;
+		}
+		for (dgInt32 i = 0; i < 3; i ++) {
+			side1[i] = Orient3d (p[t0.m_vertex[0]], p[t0.m_vertex[1]], p[t0.m_vertex[2]], p[t1.m_vertex[i]]);
+		}
+		if (((side1[0] > 0) && (side1[1] > 0) && (side1[2] > 0)) || ((side1[0] < 0) && (side1[1] < 0) && (side1[2] < 0))) {
+			return;
+		}
 
-					stackPool[stack][0] = nodeA->m_right;
-					stackPool[stack][1] = nodeB->m_right;
-					stack++;
-					dgAssert(stack < sizeof (stackPool) / sizeof (stackPool[0]));
+		dgInt64 keys[6];
+		dgInt32 count = 0;
+		bool degenerated = false;
+		for (dgInt32 i = 0; i < 3; i ++) {
+			const dgInt32 k = (i + 1) % 3;
+			if ((side0[i] * side0[k]) <= 0) {
+				// the edge end points are always ordered by index so all triangles sharing the edge get the same answer
+				const dgInt32 edge = t0.m_edge[i];
+				const dgInt32 s0 = (t0.m_vertex[i] < t0.m_vertex[k]) ? side0[i] : side0[k];
+				const dgInt32 s1 = (t0.m_vertex[i] < t0.m_vertex[k]) ? side0[k] : side0[i];
+				const dgInt32 cross = SegmentCrossTriangle (p[m_edges[edge * 2]], p[m_edges[edge * 2 + 1]], s0, s1, p[t1.m_vertex[0]], p[t1.m_vertex[1]], p[t1.m_vertex[2]]);
+				if (cross > 0) {
+					keys[count] = dgInt64 (edge) * m_triangleCount + triangle1;
+					count ++;
+				}
+				degenerated = degenerated || (cross < 0);
+			}
+			if ((side1[i] * side1[k]) <= 0) {
+				const dgInt32 edge = t1.m_edge[i];
+				const dgInt32 s0 = (t1.m_vertex[i] < t1.m_vertex[k]) ? side1[i] : side1[k];
+				const dgInt32 s1 = (t1.m_vertex[i] < t1.m_vertex[k]) ? side1[k] : side1[i];
+				const dgInt32 cross = SegmentCrossTriangle (p[m_edges[edge * 2]], p[m_edges[edge * 2 + 1]], s0, s1, p[t0.m_vertex[0]], p[t0.m_vertex[1]], p[t0.m_vertex[2]]);
+				if (cross > 0) {
+					keys[count] = dgInt64 (edge) * m_triangleCount + triangle0;
+					count ++;
 				}
+				degenerated = degenerated || (cross < 0);
 			}
 		}
-*/
-		dgAssert (0);
-//		network.Colorize();
-	
 
-/*
-		dgInt32 baseAttibuteCountB = BVHmeshB.m_mesh->GetPropertiesCount();
+		// a pair that touches on a vertex, an edge or a shared plane can not be cut by a single
+		// segment, the result would have an open seam so the whole operation is failed instead
+		if (degenerated || (count && (count != 2))) {
+			dgInterlockedExchange (&m_failed, 1);
+		} else if (count == 2) {
+			dgArray<dgSegment>& segments = m_threadSegments[threadID];
+			dgSegment& segment = segments[m_threadSegmentCount[threadID]];
+			segment.m_key[0] = keys[0];
+			segment.m_key[1] = keys[1];
+			segment.m_triangle[0] = triangle0;
+			segment.m_triangle[1] = triangle1;
+			m_threadSegmentCount[threadID] ++;
+		}
+	}
 
-		BVHmeshA.m_mesh->SaveOFF("xxxA0.off");
-		BVHmeshB.m_mesh->SaveOFF("xxxB0.off");
+	void FindIntersectionSegments ()
+	{
+		const dgInt32 threadCount = (m_threadPool && (m_threadPool->GetThreadCount() > 1)) ? m_threadPool->GetThreadCount() : 1;
+
+		// expand the root pair level by level until there are enough tasks to balance the threads
+		m_taskCount = 0;
+		if (m_bvh[0]->m_rootNode && m_bvh[1]->m_rootNode) {
+			dgArray<dgNodePair> pairs (m_allocator);
+			m_tasks[0].m_node0 = m_bvh[0]->m_rootNode;
+			m_tasks[0].m_node1 = m_bvh[1]->m_rootNode;
+			m_taskCount = 1;
+			const dgInt32 maxTasks = (threadCount > 1) ? threadCount * DG_BOOLEAN_TASKS_PER_THREAD : 1;
+			bool expanded = true;
+			while (expanded && (m_taskCount < maxTasks)) {
+				expanded = false;
+				dgInt32 count = 0;
+				pairs.ResizeIfNecessary (m_taskCount * 2);
+				for (dgInt32 i = 0; i < m_taskCount; i ++) {
+					const dgNodePair& pair = m_tasks[i];
+					if (BoxOverlap (pair.m_node0, pair.m_node1)) {
+						if (!pair.m_node0->m_left && !pair.m_node1->m_left) {
+							pairs[count] = pair;
+							count ++;
+						} else {
+							SplitPair (pair, &pairs[count]);
+							count += 2;
+							expanded = true;
+						}
+					}
+				}
+				m_tasks.ResizeIfNecessary (count);
+				for (dgInt32 i = 0; i < count; i ++) {
+					m_tasks[i] = pairs[i];
+				}
+				m_taskCount = count;
+			}
+		}
 
-		// edge-face, edge-edge and edge-vertex intersections until not more intersections are found 
-		for (bool intersectionFound = true; intersectionFound;) {
-			intersectionFound = false;
+		m_atomicIndex = 0;
+		if (threadCount > 1) {
+			for (dgInt32 i = 0; i < threadCount; i ++) {
+				m_threadPool->QueueJob(FindSegmentsKernel, this, NULL, "dgBooleanMeshClipper::FindIntersectionSegments");
+			}
+			m_threadPool->SynchronizationBarrier();
+		} else {
+			FindSegmentsKernel (this, NULL, 0);
+		}
 
-			intersectionFound |= BVHmeshA.CalculateEdgeFacesIntersetions(BVHmeshB);
-			intersectionFound |= BVHmeshB.CalculateEdgeFacesIntersetions(BVHmeshA);
+		// merge the thread buffers, sorting by triangle pair makes the result independent of the scheduling
+		m_segmentCount = 0;
+		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+			m_segments.ResizeIfNecessary (m_segmentCount + m_threadSegmentCount[i]);
+			for (dgInt32 j = 0; j < m_threadSegmentCount[i]; j ++) {
+				m_segments[m_segmentCount + j] = m_threadSegments[i][j];
+			}
+			m_segmentCount += m_threadSegmentCount[i];
+			m_threadSegments[i].Clear();
+			m_threadSegmentCount[i] = 0;
+		}
+		if (m_segmentCount) {
+			dgSort (&m_segments[0], m_segmentCount, CompareSegment);
+		}
+	}
 
-			intersectionFound |= BVHmeshA.CalculateVertexFacesIntersetions(BVHmeshB);
-			intersectionFound |= BVHmeshB.CalculateVertexFacesIntersetions(BVHmeshA);
+	// each distinct edge triangle key is one vertex of the intersection curve
+	void BuildCurvePoints ()
+	{
+		m_curvePointCount = 0;
+		if (!m_segmentCount) {
+			return;
+		}
 
+		dgStack<dgInt64> keys (m_segmentCount * 2);
+		for (dgInt32 i = 0; i < m_segmentCount; i ++) {
+			keys[i * 2 + 0] = m_segments[i].m_key[0];
+			keys[i * 2 + 1] = m_segments[i].m_key[1];
+		}
+		dgSort (&keys[0], m_segmentCount * 2, CompareCurveKey);
+		for (dgInt32 i = 0; i < m_segmentCount * 2; i ++) {
+			if (!i || (keys[i] != keys[m_curvePointCount - 1])) {
+				keys[m_curvePointCount] = keys[i];
+				m_curvePointCount ++;
+			}
+		}
 
-			BVHmeshA.m_mesh->SaveOFF("xxxA1.off");
-			BVHmeshB.m_mesh->SaveOFF("xxxB1.off");
+		m_points.ResizeIfNecessary (m_curveBase + m_curvePointCount);
+		m_curvePoints.ResizeIfNecessary (m_curvePointCount);
+		for (dgInt32 i = 0; i < m_curvePointCount; i ++) {
+			dgCurvePoint& point = m_curvePoints[i];
+			point.m_edge = dgInt32 (keys[i] / m_triangleCount);
+			point.m_triangle = dgInt32 (keys[i] % m_triangleCount);
+
+			const dgTriangle& triangle = m_triangles[point.m_triangle];
+			const dgBigVector& q0 = m_points[triangle.m_vertex[0]];
+			const dgBigVector normal ((m_points[triangle.m_vertex[1]] - q0).CrossProduct(m_points[triangle.m_vertex[2]] - q0));
+			const dgBigVector& p0 = m_points[m_edges[point.m_edge * 2 + 0]];
+			const dgBigVector& p1 = m_points[m_edges[point.m_edge * 2 + 1]];
+			const dgFloat64 dist0 = normal.DotProduct3(p0 - q0);
+			const dgFloat64 dist1 = normal.DotProduct3(p1 - q0);
+			const dgFloat64 den = dist0 - dist1;
+			point.m_param = (fabs (den) > dgFloat64 (0.0f)) ? dgClamp (dist0 / den, dgFloat64 (0.0f), dgFloat64 (1.0f)) : dgFloat64 (0.5f);
+			m_points[m_curveBase + i] = p0 + (p1 - p0).Scale (point.m_param);
+			m_points[m_curveBase + i].m_w = dgFloat64 (0.0f);
+		}
 
-			intersectionFound |= BVHmeshA.CalculateEdgeEdgeIntersetions(BVHmeshB);
+		// every segment is recorded on the two triangles it splits
+		m_triangleSegments.ResizeIfNecessary (m_segmentCount * 2);
+		for (dgInt32 i = 0; i < m_segmentCount; i ++) {
+			const dgSegment& segment = m_segments[i];
+			const dgInt32 point0 = dgBinarySearch (&keys[0], m_curvePointCount, segment.m_key[0], CompareCurveKey);
+			const dgInt32 point1 = dgBinarySearch (&keys[0], m_curvePointCount, segment.m_key[1], CompareCurveKey);
+			for (dgInt32 j = 0; j < 2; j ++) {
+				dgTriangleSegment& triangleSegment = m_triangleSegments[i * 2 + j];
+				triangleSegment.m_triangle = segment.m_triangle[j];
+				triangleSegment.m_point0 = dgMin (point0, point1);
+				triangleSegment.m_point1 = dgMax (point0, point1);
+			}
+		}
+		dgSort (&m_triangleSegments[0], m_segmentCount * 2, CompareTriangleSegment);
+		m_segments.Clear();
+	}
 
-			BVHmeshA.m_mesh->SaveOFF("xxxA2.off");
-			BVHmeshB.m_mesh->SaveOFF("xxxB2.off");
+	static void SplitTrianglesKernel (void* const context, void* const, dgInt32 threadID)
+	{
+		dgBooleanMeshClipper* const me = (dgBooleanMeshClipper*) context;
+		dgFaceTriangulator triangulator (me->m_allocator);
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1); i < me->m_splitCount; i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1)) {
+			const dgInt32 start = me->m_splitTriangles[i];
+			const dgInt32 count = me->m_splitTriangles[i + 1] - start;
+			const dgTriangleSegment* const segments = &me->m_triangleSegments[start];
+			if (!triangulator.Triangulate (me, segments[0].m_triangle, segments, count, threadID)) {
+				dgInterlockedExchange (&me->m_failed, 1);
+			}
+		}
+	}
 
-			intersectionFound |= BVHmeshA.CalculateEdgeVertexIntersetions(BVHmeshB);
-			intersectionFound |= BVHmeshB.CalculateEdgeVertexIntersetions(BVHmeshA);
+	void SplitTriangles ()
+	{
+		// m_splitTriangles holds the start of the segment run of each split triangle
+		const dgInt32 count = m_segmentCount * 2;
+		m_splitCount = 0;
+		m_splitIndex.ResizeIfNecessary (m_triangleCount);
+		for (dgInt32 i = 0; i < m_triangleCount; i ++) {
+			m_splitIndex[i] = -1;
+		}
+		m_splitTriangles.ResizeIfNecessary (count + 1);
+		for (dgInt32 i = 0; i < count; i ++) {
+			if (!i || (m_triangleSegments[i].m_triangle != m_triangleSegments[i - 1].m_triangle)) {
+				m_splitIndex[m_triangleSegments[i].m_triangle] = m_splitCount;
+				m_splitTriangles[m_splitCount] = i;
+				m_splitCount ++;
+			}
+		}
+		m_splitTriangles[m_splitCount] = count;
+		m_fragmentSpans.ResizeIfNecessary (m_splitCount);
+
+		m_atomicIndex = 0;
+		if (m_threadPool && (m_threadPool->GetThreadCount() > 1) && (m_splitCount > 1)) {
+			const dgInt32 threadCount = m_threadPool->GetThreadCount();
+			for (dgInt32 i = 0; i < threadCount; i ++) {
+				m_threadPool->QueueJob(SplitTrianglesKernel, this, NULL, "dgBooleanMeshClipper::SplitTriangles");
+			}
+			m_threadPool->SynchronizationBarrier();
+		} else {
+			SplitTrianglesKernel (this, NULL, 0);
+		}
 
-			BVHmeshA.m_mesh->SaveOFF("xxxA3.off");
-			BVHmeshB.m_mesh->SaveOFF("xxxB3.off");
+		// gather the fragments in triangle order, whole triangles are fragments of their own
+		m_fragmentCount = 0;
+		for (dgInt32 i = 0; i < m_triangleCount; i ++) {
+			const dgInt32 split = m_splitIndex[i];
+			if (split < 0) {
+				dgFragment& fragment = m_fragments[m_fragmentCount];
+				fragment.m_triangle = i;
+				fragment.m_constraint = 0;
+				fragment.m_vertex[0] = m_triangles[i].m_vertex[0];
+				fragment.m_vertex[1] = m_triangles[i].m_vertex[1];
+				fragment.m_vertex[2] = m_triangles[i].m_vertex[2];
+				m_fragmentCount ++;
+			} else {
+				const dgFragmentSpan& span = m_fragmentSpans[split];
+				m_fragments.ResizeIfNecessary (m_fragmentCount + span.m_count);
+				for (dgInt32 j = 0; j < span.m_count; j ++) {
+					m_fragments[m_fragmentCount + j] = m_threadFragments[span.m_thread][span.m_start + j];
+				}
+				m_fragmentCount += span.m_count;
+			}
 		}
-*/		
+		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+			m_threadFragments[i].Clear();
+			m_threadFragmentCount[i] = 0;
+		}
+		m_triangleSegments.Clear();
 	}
 
-	dgClipppedFaces m_clippedFaces;
-};
+	static dgInt32 FindRoot (dgInt32* const parent, dgInt32 node)
+	{
+		dgInt32 root = node;
+		while (parent[root] != root) {
+			root = parent[root];
+		}
+		while (parent[node] != root) {
+			const dgInt32 next = parent[node];
+			parent[node] = root;
+			node = next;
+		}
+		return root;
+	}
+
+	// flood the fragments across every edge that is not part of the intersection curve
+	void BuildRegions ()
+	{
+		m_regionCount = 0;
+		if (!m_fragmentCount) {
+			return;
+		}
+
+		dgStack<dgInt32> parent (m_fragmentCount);
+		dgStack<dgFragmentEdge> edges (m_fragmentCount * 3);
+		dgInt32 edgeCount = 0;
+		for (dgInt32 i = 0; i < m_fragmentCount; i ++) {
+			const dgFragment& fragment = m_fragments[i];
+			parent[i] = i;
+			for (dgInt32 j = 0; j < 3; j ++) {
+				if (!(fragment.m_constraint & (1 << j))) {
+					const dgInt32 v0 = fragment.m_vertex[j];
+					const dgInt32 v1 = fragment.m_vertex[(j + 1) % 3];
+					dgFragmentEdge& edge = edges[edgeCount];
+					edge.m_v0 = dgMin (v0, v1);
+					edge.m_v1 = dgMax (v0, v1);
+					edge.m_fragment = i;
+					edgeCount ++;
+				}
+			}
+		}
+		dgSort (&edges[0], edgeCount, CompareFragmentEdge);
+
+		for (dgInt32 i = 1; i < edgeCount; i ++) {
+			const dgFragmentEdge& edge0 = edges[i - 1];
+			const dgFragmentEdge& edge1 = edges[i];
+			if ((edge0.m_v0 == edge1.m_v0) && (edge0.m_v1 == edge1.m_v1)) {
+				const dgInt32 root0 = FindRoot (&parent[0], edge0.m_fragment);
+				const dgInt32 root1 = FindRoot (&parent[0], edge1.m_fragment);
+				if (root0 != root1) {
+					parent[dgMax (root0, root1)] = dgMin (root0, root1);
+				}
+			}
+		}
+
+		// regions are tested from one of their original vertices, those are never on the other solid,
+		// the centroid of the largest fragment is used when the region has curve points only.
+		// roots are always the smallest fragment of the set, so regions are numbered in fragment order
+		m_regionCount = 0;
+		dgStack<dgFloat64> regionArea (m_fragmentCount);
+		m_fragmentRegion.ResizeIfNecessary (m_fragmentCount);
+		for (dgInt32 i = 0; i < m_fragmentCount; i ++) {
+			m_fragmentRegion[i] = FindRoot (&parent[0], i);
+		}
+		for (dgInt32 i = 0; i < m_fragmentCount; i ++) {
+			const dgInt32 root = m_fragmentRegion[i];
+			if (root == i) {
+				parent[i] = m_regionCount;
+				m_regionFragment[m_regionCount] = i;
+				m_regionVertex[m_regionCount] = -1;
+				regionArea[m_regionCount] = dgFloat64 (-1.0f);
+				m_regionCount ++;
+			}
+			const dgInt32 region = parent[root];
+			m_fragmentRegion[i] = region;
+
+			const dgFragment& fragment = m_fragments[i];
+			const dgBigVector& p0 = m_points[fragment.m_vertex[0]];
+			const dgBigVector normal ((m_points[fragment.m_vertex[1]] - p0).CrossProduct(m_points[fragment.m_vertex[2]] - p0));
+			const dgFloat64 area = normal.DotProduct3(normal);
+			if (area > regionArea[region]) {
+				regionArea[region] = area;
+				m_regionFragment[region] = i;
+			}
+			for (dgInt32 j = 0; (j < 3) && (m_regionVertex[region] < 0); j ++) {
+				if (fragment.m_vertex[j] < m_curveBase) {
+					m_regionVertex[region] = fragment.m_vertex[j];
+				}
+			}
+		}
+	}
+
+	// parity of the crossings of a ray against a solid, -1 if the ray touched an edge or a vertex
+	dgInt32 RayParity (dgInt32 solid, const dgBigVector& p0, const dgBigVector& p1, dgArray<dgMeshEffect::dgMeshBVH::dgMeshBVHNode*>& stack) const
+	{
+		const dgBigVector dir (p1 - p0);
+		dgInt32 crossings = 0;
+		dgInt32 stackCount = 1;
+		stack[0] = m_bvh[solid]->m_rootNode;
+		while (stackCount) {
+			stackCount --;
+			const dgMeshEffect::dgMeshBVH::dgMeshBVHNode* const node = stack[stackCount];
+
+			dgFloat64 t0 = dgFloat64 (0.0f);
+			dgFloat64 t1 = dgFloat64 (1.0f);
+			for (dgInt32 i = 0; (i < 3) && (t0 <= t1); i ++) {
+				const dgFloat64 boxMin = node->m_p0[i];
+				const dgFloat64 boxMax = node->m_p1[i];
+				if (fabs (dir[i]) < dgFloat64 (1.0e-30f)) {
+					if ((p0[i] < boxMin) || (p0[i] > boxMax)) {
+						t1 = dgFloat64 (-1.0f);
+					}
+				} else {
+					const dgFloat64 invDir = dgFloat64 (1.0f) / dir[i];
+					dgFloat64 s0 = (boxMin - p0[i]) * invDir;
+					dgFloat64 s1 = (boxMax - p0[i]) * invDir;
+					if (s0 > s1) {
+						dgSwap (s0, s1);
+					}
+					t0 = dgMax (t0, s0);
+					t1 = dgMin (t1, s1);
+				}
+			}
+			if (t0 > t1) {
+				continue;
+			}
 
+			if (!node->m_left) {
+				const dgInt32 face = dgInt32 (PointerToInt(node->m_userData));
+				const dgInt32 start = m_faceTriangleStart[solid][face];
+				const dgInt32 end = m_faceTriangleStart[solid][face + 1];
+				for (dgInt32 i = start; i < end; i ++) {
+					const dgTriangle& triangle = m_triangles[i];
+					const dgBigVector& q0 = m_points[triangle.m_vertex[0]];
+					const dgBigVector& q1 = m_points[triangle.m_vertex[1]];
+					const dgBigVector& q2 = m_points[triangle.m_vertex[2]];
+					const dgInt32 test = SegmentCrossTriangle (p0, p1, Orient3d (q0, q1, q2, p0), Orient3d (q0, q1, q2, p1), q0, q1, q2);
+					if (test < 0) {
+						return -1;
+					}
+					crossings += test;
+				}
+			} else {
+				stack.ResizeIfNecessary (stackCount + 2);
+				stack[stackCount] = node->m_left;
+				stack[stackCount + 1] = node->m_right;
+				stackCount += 2;
+			}
+		}
+		return crossings & 1;
+	}
 
+	static void ClassifyRegionsKernel (void* const context, void* const, dgInt32 threadID)
+	{
+		static const dgFloat64 directions[DG_BOOLEAN_RAY_DIRECTIONS][3] = {
+			{ dgFloat64 ( 0.5773502691f), dgFloat64 ( 0.5773502692f), dgFloat64 ( 0.5773502692f)},
+			{ dgFloat64 (-0.3141592653f), dgFloat64 ( 0.8660254037f), dgFloat64 (-0.3882030254f)},
+			{ dgFloat64 ( 0.7071067811f), dgFloat64 (-0.2718281828f), dgFloat64 ( 0.6527864045f)},
+			{ dgFloat64 (-0.6180339887f), dgFloat64 (-0.4142135623f), dgFloat64 ( 0.6681531047f)},
+			{ dgFloat64 ( 0.1234567890f), dgFloat64 (-0.8164965809f), dgFloat64 (-0.5641895835f)},
+			{ dgFloat64 (-0.8090169943f), dgFloat64 ( 0.1102230246f), dgFloat64 (-0.5773502691f)},
+		};
+
+		dgBooleanMeshClipper* const me = (dgBooleanMeshClipper*) context;
+		dgArray<dgMeshEffect::dgMeshBVH::dgMeshBVHNode*> stack (me->m_allocator);
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1); i < me->m_regionCount; i = dgAtomicExchangeAndAdd(&me->m_atomicIndex, 1)) {
+			const dgFragment& fragment = me->m_fragments[me->m_regionFragment[i]];
+			const dgInt32 otherSolid = (fragment.m_triangle < me->m_triangleBase[1]) ? 1 : 0;
+			me->m_regionInside[i] = 0;
+			if (me->m_bvh[otherSolid]->m_rootNode) {
+				const dgInt32 vertex = me->m_regionVertex[i];
+				const dgBigVector origin ((vertex >= 0) ? me->m_points[vertex] : (me->m_points[fragment.m_vertex[0]] + me->m_points[fragment.m_vertex[1]] + me->m_points[fragment.m_vertex[2]]).Scale (dgFloat64 (1.0f / 3.0f)));
+				for (dgInt32 j = 0; j < DG_BOOLEAN_RAY_DIRECTIONS; j ++) {
+					const dgBigVector dir (directions[j][0], directions[j][1], directions[j][2], dgFloat64 (0.0f));
+					const dgInt32 parity = me->RayParity (otherSolid, origin, origin + dir.Scale (me->m_rayLength), stack);
+					if (parity >= 0) {
+						me->m_regionInside[i] = parity;
+						break;
+					}
+				}
+			}
+		}
+	}
 
-dgMeshEffect* dgMeshEffect::Intersection (const dgMatrix& matrix, const dgMeshEffect* const clipperMesh) const
+	void ClassifyRegions ()
+	{
+		m_regionInside.ResizeIfNecessary (m_regionCount);
+		m_atomicIndex = 0;
+		if (m_threadPool && (m_threadPool->GetThreadCount() > 1) && (m_regionCount > 1)) {
+			const dgInt32 threadCount = m_threadPool->GetThreadCount();
+			for (dgInt32 i = 0; i < threadCount; i ++) {
+				m_threadPool->QueueJob(ClassifyRegionsKernel, this, NULL, "dgBooleanMeshClipper::ClassifyRegions");
+			}
+			m_threadPool->SynchronizationBarrier();
+		} else {
+			ClassifyRegionsKernel (this, NULL, 0);
+		}
+	}
+
+	dgArray<dgBigVector> m_points;
+	dgArray<dgTriangle> m_triangles;
+	dgArray<dgInt32> m_edges;
+	dgArray<dgSegment> m_segments;
+	dgArray<dgCurvePoint> m_curvePoints;
+	dgArray<dgTriangleSegment> m_triangleSegments;
+	dgArray<dgInt32> m_splitTriangles;
+	dgArray<dgInt32> m_splitIndex;
+	dgArray<dgFragmentSpan> m_fragmentSpans;
+	dgArray<dgFragment> m_fragments;
+	dgArray<dgInt32> m_fragmentRegion;
+	dgArray<dgInt32> m_regionFragment;
+	dgArray<dgInt32> m_regionVertex;
+	dgArray<dgInt32> m_regionInside;
+	dgArray<dgNodePair> m_tasks;
+	dgArray<dgEdge*> m_faces[2];
+	dgArray<dgInt32> m_faceTriangleStart[2];
+	dgArray<dgSegment> m_threadSegments[DG_MAX_THREADS_HIVE_COUNT];
+	dgArray<dgFragment> m_threadFragments[DG_MAX_THREADS_HIVE_COUNT];
+	dgInt32 m_threadSegmentCount[DG_MAX_THREADS_HIVE_COUNT];
+	dgInt32 m_threadFragmentCount[DG_MAX_THREADS_HIVE_COUNT];
+	dgMatrix m_matrix;
+	dgMatrix m_normalMatrix;
+	const dgMeshEffect* m_mesh[2];
+	dgBooleanMeshBVH* m_bvh[2];
+	dgMemoryAllocator* m_allocator;
+	dgThreadHive* m_threadPool;
+	dgFloat64 m_padding;
+	dgFloat64 m_rayLength;
+	dgInt32 m_faceCount[2];
+	dgInt32 m_vertexBase[2];
+	dgInt32 m_triangleBase[2];
+	dgInt32 m_triangleCount;
+	dgInt32 m_edgeCount;
+	dgInt32 m_curveBase;
+	dgInt32 m_curvePointCount;
+	dgInt32 m_segmentCount;
+	dgInt32 m_splitCount;
+	dgInt32 m_fragmentCount;
+	dgInt32 m_regionCount;
+	dgInt32 m_taskCount;
+	dgInt32 m_atomicIndex;
+	dgInt32 m_failed;
+};
+
+void dgMeshEffect::ClipMesh (const dgMatrix& matrix, const dgMeshEffect* const clipMesh, dgMeshEffect** const back, dgMeshEffect** const front, dgThreadHive* const threadPool) const
 {
-	dgMeshEffect copy (*this);
-	dgMeshEffect clipper (*clipperMesh);
-	clipper.TransformMesh (matrix);
-
-	dgBooleanMeshClipper::ClipMeshesAndColorize (&copy, &clipper);
-/*
-	dgMeshEffect* const mesh = new (GetAllocator()) dgMeshEffect (GetAllocator());
-	mesh->BeginFace();
-	dgBooleanMeshClipper::CopyPoints(mesh, &copy);
-	dgBooleanMeshClipper::AddInteriorFaces (mesh, &copy);
-	dgBooleanMeshClipper::AddInteriorFaces (mesh, &clipper);
-	mesh->EndFace ();
-	mesh->RepairTJoints();
-	mesh->RemoveUnusedVertices(NULL);
-
-	return mesh;
-*/
+	dgBooleanMeshClipper clipper (this, matrix, clipMesh, threadPool);
+	*back = clipper.CreateMesh (dgBooleanMeshClipper::m_intersection);
+	*front = clipper.CreateMesh (dgBooleanMeshClipper::m_difference);
+}
 
-	dgAssert (0);
-	return NULL;
+dgMeshEffect* dgMeshEffect::Union (const dgMatrix& matrix, const dgMeshEffect* const clipperMesh, dgThreadHive* const threadPool) const
+{
+	dgBooleanMeshClipper clipper (this, matrix, clipperMesh, threadPool);
+	return clipper.CreateMesh (dgBooleanMeshClipper::m_union);
 }
 
+dgMeshEffect* dgMeshEffect::Difference (const dgMatrix& matrix, const dgMeshEffect* const clipperMesh, dgThreadHive* const threadPool) const
+{
+	dgBooleanMeshClipper clipper (this, matrix, clipperMesh, threadPool);
+	return clipper.CreateMesh (dgBooleanMeshClipper::m_difference);
+}
 
+dgMeshEffect* dgMeshEffect::Intersection (const dgMatrix& matrix, const dgMeshEffect* const clipperMesh, dgThreadHive* const threadPool) const
+{
+	dgBooleanMeshClipper clipper (this, matrix, clipperMesh, threadPool);
+	return clipper.CreateMesh (dgBooleanMeshClipper::m_intersection);
+}
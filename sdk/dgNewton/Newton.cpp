@@ -578,6 +578,31 @@ void NewtonSyncThreadJobs(const NewtonWorld* const newtonWorld)
 	world->SynchronizationBarrier();
 }
 
+/*!
+  Run a task over the range [0, count) on the world worker threads, and wait for it to finish.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param count number of items.
+  @param grainSize maximum number of items passed to each call of the task.
+  @param task function called with each sub range, the startIndex and count of the sub range, and the thread index.
+  @param *userData user data passed to the task.
+  @param *functionName name of the task for the profiler.
+
+  Unlike calling ::NewtonDispachThreadJob once per item, only one job per thread is queued,
+  so there is no limit on the number of items. With a single thread, or when count is not larger than
+  grainSize, the task is called once on the calling thread.
+
+  This function must not be called from a task running on a worker thread.
+
+  See also: ::NewtonDispachThreadJob, ::NewtonSyncThreadJobs
+*/
+void NewtonParallelFor(const NewtonWorld* const newtonWorld, int count, int grainSize, NewtonParallelForTask task, void* const userData, const char* const functionName)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->ExecuteUserParallelFor (count, grainSize, (dgWorld::OnUserParallelFor) task, userData, functionName);
+}
+
 int NewtonGetParallelSolverOnLargeIsland(const NewtonWorld* const newtonWorld)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -585,6 +610,57 @@ int NewtonGetParallelSolverOnLargeIsland(const NewtonWorld* const newtonWorld)
 	return world->GetParallelSolverOnLargeIsland();
 }
 
+/*!
+  Enable or disable the deterministic simulation mode.
+
+  @param *newtonWorld is the pointer to the Newton world
+  @param mode 1 makes the simulation bitwise reproducible for any number of worker threads, 0 restores the default mode.
+
+  @return Nothing
+
+  In deterministic mode new contacts are sorted by body ids, the joints of each island are ordered by
+  the ids of the bodies they connect, and the large island solver adds joint forces to bodies in joint
+  order instead of in the order the worker threads finish. Solver plugins are ignored while this mode is enabled.
+  
+  Two worlds with the same history (same bodies and joints created in the same order, and the same solver 
+  settings) produce identical results, regardless of the value passed to NewtonSetThreadsCount.
+  The cost is a serial reduction per solver pass on large islands and serial sorts of the contact and joint arrays.
+
+  See also: ::NewtonWorldGetStateHash
+*/
+void NewtonSetDeterministicMode(const NewtonWorld* const newtonWorld, int mode)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetDeterministicMode(mode);
+}
+
+int NewtonGetDeterministicMode(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetDeterministicMode();
+}
+
+/*!
+  Calculate a hash of the position, orientation and velocity of all bodies in the world.
+
+  @param *newtonWorld is the pointer to the Newton world
+
+  @return a 32 bit hash of the state of the world.
+
+  Useful for checking that two simulations stay in lock step, for example a replay or a networked
+  peer against the authoritative world, or the same scene running with different numbers of threads.
+
+  See also: ::NewtonSetDeterministicMode
+*/
+unsigned NewtonWorldGetStateHash(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->CalculateStateHash();
+}
+
 /*!
   Set the solver precision mode.
 
@@ -665,6 +741,160 @@ dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld)
 	return world->GetUpdateTime();
 }
 
+/*!
+  Copy the timings and counters of the most recent world updates.
+
+  @param *newtonWorld is the pointer to the Newton world
+  @param *stats array of at least maxCount entries that receives the statistics, most recent update first.
+  @param maxCount max number of updates to copy.
+
+  @return the number of entries copied.
+
+  The world always keeps the statistics of its last 64 updates, timings are accumulated over all sub steps
+  and the counters are from the last sub step. When using NewtonUpdateAsync call this function after
+  NewtonWaitForUpdateToFinish.
+
+  See also: ::NewtonGetLastUpdateTime
+*/
+int NewtonWorldGetStepStats (const NewtonWorld* const newtonWorld, NewtonWorldStepStats* const stats, int maxCount)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+
+	dgWorldStepStats history[DG_STEP_STATS_HISTORY];
+	const dgInt32 count = world->GetStepStats(history, maxCount);
+	for (dgInt32 i = 0; i < count; i ++) {
+		const dgWorldStepStats& src = history[i];
+		NewtonWorldStepStats& dst = stats[i];
+		dst.m_stepIndex = (dLong) src.m_stepIndex;
+		dst.m_broadphaseTime = src.m_broadphaseTime;
+		dst.m_pairsTime = src.m_pairsTime;
+		dst.m_contactsTime = src.m_contactsTime;
+		dst.m_clustersTime = src.m_clustersTime;
+		dst.m_solverTime = src.m_solverTime;
+		dst.m_integrationTime = src.m_integrationTime;
+		dst.m_totalTime = src.m_totalTime;
+		dst.m_pairCount = src.m_pairCount;
+		dst.m_contactCount = src.m_contactCount;
+		dst.m_clusterCount = src.m_clusterCount;
+		dst.m_rowCount = src.m_rowCount;
+		dst.m_sleepingBodyCount = src.m_sleepingBodyCount;
+		dst.m_allocationCount = src.m_allocationCount;
+	}
+	return count;
+}
+
+/*!
+  Return the number of bodies whose matrix changed in the last update.
+
+  @param *newtonWorld is the pointer to the Newton world.
+
+  The list is built while the world updates the body transforms at the end of NewtonUpdate,
+  so it is complete when the listeners post transform callbacks and the world post update callback are called. It stays valid until the next update.
+  A body destroyed with NewtonDestroyBody is only deleted by the next update, so it can stay in the list until then.
+  NewtonDestroyAllBodies empties the list.
+
+  See also: ::NewtonWorldGetActiveTransforms
+*/
+int NewtonWorldGetActiveTransformCount (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetActiveTransformsCount();
+}
+
+/*!
+  Copy a range of the bodies whose matrix changed in the last update, and their matrices.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param startIndex first entry of the active transforms list to copy.
+  @param count number of entries to copy.
+  @param **bodies array of at least count body pointers, can be NULL.
+  @param *matrices array of at least count matrices of 16 floats each, can be NULL.
+
+  @return the number of entries copied, less than count if the range goes past the end of the list.
+
+  The order of the list is unspecified. Disjoint ranges can be copied from different threads at the same time,
+  this is how an application can export the transforms of a large scene with one job per thread.
+
+  See also: ::NewtonWorldGetActiveTransformCount
+*/
+int NewtonWorldGetActiveTransforms (const NewtonWorld* const newtonWorld, int startIndex, int count, NewtonBody** const bodies, dFloat* const matrices)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgBody* const* const activeTransforms = world->GetActiveTransforms();
+	const dgInt32 activeCount = world->GetActiveTransformsCount();
+	const dgInt32 start = dgClamp (startIndex, 0, activeCount);
+	const dgInt32 copyCount = dgClamp (count, 0, activeCount - start);
+	for (dgInt32 i = 0; i < copyCount; i ++) {
+		dgBody* const body = activeTransforms[start + i];
+		if (bodies) {
+			bodies[i] = (NewtonBody*) body;
+		}
+		if (matrices) {
+			memcpy (&matrices[i * 16], &body->GetMatrix()[0][0], sizeof (dgMatrix));
+		}
+	}
+	return copyCount;
+}
+
+/*!
+  Return the number of trigger volume overlap changes waiting to be read.
+
+  @param *newtonWorld is the pointer to the Newton world.
+
+  The broad phase records a change every time a body starts or stops overlapping a body flagged with
+  NewtonBodySetTriggerVolume, including when one of the two bodies is destroyed. The list is sorted and can be read
+  from a world pre update listener, it is cleared when the pre update listeners return.
+
+  See also: ::NewtonWorldGetTriggerEvents, ::NewtonBodySetTriggerVolume
+*/
+int NewtonWorldGetTriggerEventCount (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetBroadPhase()->GetTriggerEventsCount();
+}
+
+/*!
+  Copy a range of the trigger volume overlap changes.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param startIndex first entry of the list to copy.
+  @param count number of entries to copy.
+  @param *events array of at least count events.
+
+  @return the number of entries copied, less than count if the range goes past the end of the list.
+
+  Inside a pre update listener the events are sorted by trigger id, then by guest id, and the events of the
+  same pair are in the order they happened, so the last one tells if the guest is inside the trigger. Bodies in
+  exit events can be destroyed already, use the ids to match them with the application data and do not
+  dereference the pointers.
+
+  See also: ::NewtonWorldGetTriggerEventCount
+*/
+int NewtonWorldGetTriggerEvents (const NewtonWorld* const newtonWorld, int startIndex, int count, NewtonTriggerEvent* const events)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	const dgBroadPhase* const broadPhase = world->GetBroadPhase();
+	const dgBroadPhase::dgTriggerEvent* const triggerEvents = broadPhase->GetTriggerEvents();
+	const dgInt32 eventCount = broadPhase->GetTriggerEventsCount();
+	const dgInt32 start = dgClamp (startIndex, 0, eventCount);
+	const dgInt32 copyCount = dgClamp (count, 0, eventCount - start);
+	for (dgInt32 i = 0; i < copyCount; i ++) {
+		const dgBroadPhase::dgTriggerEvent& src = triggerEvents[start + i];
+		NewtonTriggerEvent& dst = events[i];
+		dst.m_trigger = (NewtonBody*) src.m_trigger;
+		dst.m_guest = (NewtonBody*) src.m_guest;
+		dst.m_triggerId = src.m_triggerId;
+		dst.m_guestId = src.m_guestId;
+		dst.m_enter = src.m_enter;
+	}
+	return copyCount;
+}
+
 
 void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps)
 {
@@ -680,6 +910,40 @@ int NewtonGetNumberOfSubsteps (const NewtonWorld* const newtonWorld)
 	return world->GetSubsteps ();
 }
 
+/*!
+  Set the number of solver sub steps for stiff islands.
+
+  @param *newtonWorld is the pointer to the Newton world
+  @param massRatio islands where the ratio between the heaviest and the lightest body exceeds this value are considered stiff, zero disables the test.
+  @param subSteps number of solver sub steps for stiff islands, clamped to [1, 8]
+
+  @return Nothing.
+
+  Unlike NewtonSetNumberOfSubsteps, only stiff islands pay for the extra sub steps, the rest of the world still runs one step.
+  Contacts and joint jacobians are calculated once per update and shared by all sub steps of an island.
+  Individual bodies can also request sub steps with NewtonBodySetSolverSubsteps, the island runs the largest value of all its bodies.
+*/
+void NewtonSetStiffIslandSubsteps (const NewtonWorld* const newtonWorld, dFloat massRatio, int subSteps)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	world->SetStiffClusterSubsteps (massRatio, subSteps);
+}
+
+int NewtonGetStiffIslandSubsteps (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetStiffClusterSubsteps ();
+}
+
+dFloat NewtonGetStiffIslandMassRatio (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetStiffClusterMassRatio ();
+}
+
 
 
 /*!
@@ -987,6 +1251,111 @@ void NewtonWorldSetCreateDestroyContactCallback(const NewtonWorld* const newtonW
 	world->SetCreateDestroyContactCallback((dgWorld::OnCreateContact) createContact, (dgWorld::OnDestroyContact) destroyContact);
 }
 
+/*!
+  Get the contact event buffering state of the world.
+
+  @param *newtonWorld is the pointer to the Newton world.
+
+  @return 1 if the world records contact events, 0 otherwise.
+
+  See also: ::NewtonWorldSetContactEventBuffering
+*/
+int NewtonWorldGetContactEventBuffering (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetContactEventBuffering() ? 1 : 0;
+}
+
+/*!
+  Enable or disable the recording of contact events.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param state 1 to record contact events, 0 to stop recording them.
+
+  @return Nothing.
+
+  This is the buffered alternative to ::NewtonWorldSetCreateDestroyContactCallback. Instead of calling user code
+  from inside the contact kernels, each worker thread appends to its own event buffer. At the end of NewtonUpdate the
+  buffers are merged into one list that the application reads with ::NewtonWorldGetContactEvents.
+
+  A begin event is recorded when two bodies start touching and an end event when they stop touching, or when the
+  contact is destroyed while they still touch. An impact event follows the begin event when the solver applied an
+  impulse to the new contact. Pairs with a trigger volume are not reported here, see ::NewtonWorldGetTriggerEvents.
+  Changing the state drops the events recorded so far.
+
+  See also: ::NewtonWorldGetContactEventCount, ::NewtonWorldGetContactEvents
+*/
+void NewtonWorldSetContactEventBuffering (const NewtonWorld* const newtonWorld, int state)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetContactEventBuffering(state ? true : false);
+}
+
+/*!
+  Return the number of contact events recorded in the last update.
+
+  @param *newtonWorld is the pointer to the Newton world.
+
+  The list is complete when NewtonUpdate returns, and when the world post update callback is called.
+  It stays valid until the next update. Events recorded between updates, for example when the application
+  destroys a body, are reported with the next update.
+
+  See also: ::NewtonWorldGetContactEvents, ::NewtonWorldSetContactEventBuffering
+*/
+int NewtonWorldGetContactEventCount (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetContactEventsCount();
+}
+
+/*!
+  Copy a range of the contact events recorded in the last update.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param startIndex first entry of the list to copy.
+  @param count number of entries to copy.
+  @param *events array of at least count events.
+
+  @return the number of entries copied, less than count if the range goes past the end of the list.
+
+  The events are sorted by the id of body0, then by the id of body1, and the events of the same pair are in the order
+  they happened. The list does not depend on the number of threads. Bodies in end events can be destroyed already,
+  use the ids to match them with the application data. Disjoint ranges can be copied from different threads at the same time.
+
+  See also: ::NewtonWorldGetContactEventCount
+*/
+int NewtonWorldGetContactEvents (const NewtonWorld* const newtonWorld, int startIndex, int count, NewtonContactEvent* const events)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	const dgContactEvent* const contactEvents = world->GetContactEvents();
+	const dgInt32 eventCount = world->GetContactEventsCount();
+	const dgInt32 start = dgClamp (startIndex, 0, eventCount);
+	const dgInt32 copyCount = dgClamp (count, 0, eventCount - start);
+	for (dgInt32 i = 0; i < copyCount; i ++) {
+		const dgContactEvent& src = contactEvents[start + i];
+		NewtonContactEvent& dst = events[i];
+		dst.m_body0 = (NewtonBody*) src.m_body0;
+		dst.m_body1 = (NewtonBody*) src.m_body1;
+		dst.m_point[0] = src.m_point.m_x;
+		dst.m_point[1] = src.m_point.m_y;
+		dst.m_point[2] = src.m_point.m_z;
+		dst.m_point[3] = dgFloat32 (1.0f);
+		dst.m_normal[0] = src.m_normal.m_x;
+		dst.m_normal[1] = src.m_normal.m_y;
+		dst.m_normal[2] = src.m_normal.m_z;
+		dst.m_normal[3] = dgFloat32 (0.0f);
+		dst.m_impulse = src.m_impulse;
+		dst.m_body0Id = src.m_body0Id;
+		dst.m_body1Id = src.m_body1Id;
+		dst.m_type = src.m_type;
+	}
+	return copyCount;
+}
+
 void NewtonWorldSetCollisionConstructorDestructorCallback (const NewtonWorld* const newtonWorld, NewtonCollisionCopyConstructionCallback constructor, NewtonCollisionDestructorCallback destructor)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -1044,6 +1413,25 @@ void NewtonWorldListenerSetPostUpdateCallback(const NewtonWorld* const newtonWor
 	return world->ListenerSetPostUpdate(listener, (dgWorld::OnListenerUpdateCallback) update);
 }
 
+/*!
+  Set a listener callback called once per NewtonUpdate, after the world updated the body transforms.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param *listener listener returned by NewtonWorldAddListener.
+  @param update callback, it receives the listener user data and the full time step of the update.
+
+  Post update listeners run at the end of each sub step, before the transforms are updated. 
+  This callback runs when the list read by NewtonWorldGetActiveTransforms is complete, and before the world post update callback.
+
+  See also: ::NewtonWorldGetActiveTransforms, ::NewtonSetPostUpdateCallback
+*/
+void NewtonWorldListenerSetPostTransformCallback(const NewtonWorld* const newtonWorld, void* const listener, NewtonWorldUpdateListenerCallback update)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->ListenerSetPostTransform(listener, (dgWorld::OnListenerUpdateCallback) update);
+}
+
 
 void* NewtonWorldGetListener (const NewtonWorld* const newtonWorld, const char* const nameId)
 {
@@ -1206,6 +1594,40 @@ int NewtonWorldConvexCast(const NewtonWorld* const newtonWorld, const dFloat* co
 	return world->GetBroadPhase()->ConvexCast ((dgCollisionInstance*) shape, dgMatrix (matrix), destination, param, (OnRayPrecastAction) prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
 }
 
+/*!
+  Cast a convex shape against a user supplied set of bodies instead of the full broadphase.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *bodies array of candidate bodies, usually collected once with ::NewtonWorldForEachBodyInAABBDo.
+  @param bodyCount number of bodies in the array.
+  @param *matrix pointer to an array of at least three floats containing the beginning and orientation of the shape in global space.
+  @param *target pointer to an array of at least three floats containing the end of the ray in global space.
+  @param shape collision shape used to cast the ray.
+  @param param pointer to a variable that will contain the time to closest approach to the collision.
+  @param *userData user data to be passed to the prefilter callback.
+  @param prefilter user define function to be called for each body before intersection.
+  @param *info pointer to an array of contacts at the point of intersections.
+  @param maxContactsCount maximum number of contacts to be calculated.
+  @param threadIndex thread index from where this function is called, zero if called from outside a newton update
+
+  @return the number of contacts at the intersection point.
+
+  this function behaves like ::NewtonWorldConvexCast, but it skips the broadphase tree walk.
+  it is useful when several shapes are swept through the same region, for example the tires of a vehicle,
+  since the application can query the broadphase once with the union of all sweeps and reuse the result for each cast.
+
+  See also: ::NewtonWorldConvexCast
+*/
+int NewtonWorldConvexCastBodies(const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int bodyCount, const dFloat* const matrix, const dFloat* const target, 
+								const NewtonCollision* const shape, dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, 
+								int maxContactsCount, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgVector destination (target[0], target[1], target[2], dgFloat32 (0.0f));
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetBroadPhase()->ConvexCastBodies ((dgBody**) bodies, bodyCount, (dgCollisionInstance*) shape, dgMatrix (matrix), destination, param, (OnRayPrecastAction) prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
+}
+
 int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData,  
 					   NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex)
 {
@@ -1215,6 +1637,35 @@ int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* cons
 }
 
 
+/*!
+  Collide a shape against a user supplied set of bodies instead of the full broadphase.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *bodies array of candidate bodies, usually collected once with ::NewtonWorldForEachBodyInAABBDo.
+  @param bodyCount number of bodies in the array.
+  @param *matrix pointer to an array of at least three floats containing the position and orientation of the shape in global space.
+  @param shape collision shape.
+  @param *userData user data to be passed to the prefilter callback.
+  @param prefilter user define function to be called for each body before intersection.
+  @param *info pointer to an array of contacts.
+  @param maxContactsCount maximum number of contacts to be calculated.
+  @param threadIndex thread index from where this function is called, zero if called from outside a newton update
+
+  @return the number of contacts.
+
+  this function behaves like ::NewtonWorldCollide, but it skips the broadphase tree walk.
+  it is useful for shapes that are tested several times in the same region during one update, for example character controllers.
+
+  See also: ::NewtonWorldCollide, ::NewtonWorldConvexCastBodies
+*/
+int NewtonWorldCollideBodies (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int bodyCount, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData,
+							  NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetBroadPhase()->CollideBodies((dgBody**)bodies, bodyCount, (dgCollisionInstance*)shape, dgMatrix(matrix), (OnRayPrecastAction)prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
+}
+
 /*!
   Retrieve body by index from island.
 
@@ -1388,6 +1839,34 @@ void NewtonMaterialSetSurfaceThickness(const NewtonWorld* const newtonWorld, int
 	material->m_skinThickness = dgClamp (thickness, dgFloat32 (0.0f), DG_MAX_COLLISION_AABB_PADDING * dgFloat32 (0.5f));
 }
 
+/*!
+  Set how many contacts points the engine keeps for each body pair whose physics properties are defined by this material pair
+
+  @param *newtonWorld pointer to the Newton world.
+  @param  id0 - group id0
+  @param  id1 - group id1
+  @param pointsPerManifold max number of points kept for each sub shape pair and normal direction, 0 disables the reduction; the default value is 0
+  @param maxPairContacts max number of points kept for the whole body pair, from 1 to 16; the default value is 16
+
+  @return Nothing.
+
+  Contact points are grouped into manifolds by the pair of sub shapes that generated them and by the direction of the
+  contact normal. When a manifold has more than pointsPerManifold points it is reduced to the deepest point plus the
+  points that span the largest area around it, 4 points keep the support polygon of a resting body while removing most
+  of the redundant rows of compound against mesh contacts.
+
+  The reduction runs in the contact generation worker threads and lowers the number of rows sent to the solver.
+*/
+void NewtonMaterialSetContactReduction(const NewtonWorld* const newtonWorld, int id0, int id1, int pointsPerManifold, int maxPairContacts)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgContactMaterial* const material = world->GetMaterial (dgUnsigned32 (id0), dgUnsigned32 (id1));
+
+	material->m_manifoldPoints = dgInt16 (dgClamp (pointsPerManifold, 0, DG_CONSTRAINT_MAX_ROWS / 3));
+	material->m_maxPairContacts = dgInt16 (dgClamp (maxPairContacts, 1, DG_CONSTRAINT_MAX_ROWS / 3));
+}
+
 
 /*!
   Set the default coefficients of friction for the material interaction between two physics materials .
@@ -2716,6 +3195,74 @@ int NewtonFracturedCompoundIsNodeFreeToDetach (const NewtonCollision* const frac
 	return 0;
 }
 
+int NewtonFracturedCompoundGetPrecooked (const NewtonCollision* const fracturedCompound)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*) fracturedCompound;
+
+	if (collision->IsType (dgCollision::dgCollisionCompoundBreakable_RTTI)) {
+		dgCollisionCompoundFractured* const compound = (dgCollisionCompoundFractured*) collision->GetChildShape();
+		return compound->GetPrecooked() ? 1 : 0;
+	}
+	return 0;
+}
+
+// in pre cooked mode the chunks are laid out in flat arrays and the main mesh is allocated once,
+// so breaking only clears active flags and copies index ranges.
+void NewtonFracturedCompoundSetPrecooked (const NewtonCollision* const fracturedCompound, int state)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*) fracturedCompound;
+
+	if (collision->IsType (dgCollision::dgCollisionCompoundBreakable_RTTI)) {
+		dgCollisionCompoundFractured* const compound = (dgCollisionCompoundFractured*) collision->GetChildShape();
+		compound->SetPrecooked(state ? true : false);
+	}
+}
+
+// detach a batch of chunks from a fractured body, calling the emit chunk callback for each one, and the 
+// reconstruct main mesh callback once. pooledBodies is optional, each entry should be a dynamic body
+// disabled with NewtonBodySetSimulationState, they are consumed in order and enabled as chunks are spawned.
+// must not be called from inside a NewtonUpdate.
+int NewtonFracturedCompoundDetachChunks (const NewtonBody* const fracturedBody, void** const collisionNodes, NewtonBody** const pooledBodies, int count)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody*) fracturedBody;
+	dgCollisionInstance* const collision = body->GetCollision();
+
+	if (collision->IsType (dgCollision::dgCollisionCompoundBreakable_RTTI)) {
+		dgCollisionCompoundFractured* const compound = (dgCollisionCompoundFractured*) collision->GetChildShape();
+		return compound->DetachChunks (body, (dgCollisionCompound::dgTreeArray::dgTreeNode**) collisionNodes, (dgBody**) pooledBodies, count);
+	}
+	return 0;
+}
+
+// give a fractured compound a pool of dynamic bodies disabled with NewtonBodySetSimulationState, the chunks emitted
+// by NewtonFracturedCompoundDetachChunks without an explicit pool and by the automatic fracture are taken from it
+// before new bodies are created. the bodies must stay alive until they are consumed or the pool is reset.
+void NewtonFracturedCompoundSetBodyPool (const NewtonCollision* const fracturedCompound, NewtonBody** const pooledBodies, int count)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*) fracturedCompound;
+
+	if (collision->IsType (dgCollision::dgCollisionCompoundBreakable_RTTI)) {
+		dgCollisionCompoundFractured* const compound = (dgCollisionCompoundFractured*) collision->GetChildShape();
+		compound->SetBodyPool ((dgBody**) pooledBodies, count);
+	}
+}
+
+int NewtonFracturedCompoundGetBodyPoolCount (const NewtonCollision* const fracturedCompound)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*) fracturedCompound;
+
+	if (collision->IsType (dgCollision::dgCollisionCompoundBreakable_RTTI)) {
+		dgCollisionCompoundFractured* const compound = (dgCollisionCompoundFractured*) collision->GetChildShape();
+		return compound->GetBodyPoolCount();
+	}
+	return 0;
+}
+
 NewtonFracturedCompoundMeshPart* NewtonFracturedCompoundGetFirstSubMesh(const NewtonCollision* const fracturedCompound)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -4476,6 +5023,44 @@ void NewtonBodySetCollidable (const NewtonBody* const bodyPtr, int collidable)
 	body->SetCollidable(collidable ? true : false);
 }
 
+/*!
+  Get the trigger volume state of the specified body.
+
+  @param *bodyPtr pointer to the body.
+
+  @return 1 if the body is a trigger volume, 0 otherwise.
+
+  See also: ::NewtonBodySetTriggerVolume
+*/
+int NewtonBodyGetTriggerVolume (const NewtonBody* const bodyPtr)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)bodyPtr;
+	return body->IsTrigger() ? 1 : 0;
+}
+
+/*!
+  Mark the specified body as a trigger volume.
+
+  @param *bodyPtr pointer to the body.
+  @param triggerState 1 the body is a trigger volume, 0 the body is a regular body.
+
+  @return Nothing.
+
+  Contact joints between a trigger volume and other bodies only report overlap, the joint
+  is active while the shapes intersect but it never gets solver rows, so the trigger does not
+  collide with anything. Use ::NewtonWorldGetTriggerEvents to read the bodies entering and leaving the trigger,
+  and set the shape collision mode to zero to also skip the contact points calculation.
+
+  See also: ::NewtonBodyGetTriggerVolume, ::NewtonWorldGetTriggerEvents
+*/
+void NewtonBodySetTriggerVolume (const NewtonBody* const bodyPtr, int triggerState)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)bodyPtr;
+	body->SetTrigger(triggerState ? true : false);
+}
+
 int NewtonBodyGetType (const NewtonBody* const bodyPtr)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -5832,6 +6417,30 @@ void NewtonBodySetGyroscopicTorque(const NewtonBody* const bodyPtr, int state)
 	body->SetGyroMode(state ? true : false);
 }
 
+int NewtonBodyGetSolverSubsteps(const NewtonBody* const bodyPtr)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)bodyPtr;
+	return body->GetSolverSubsteps();
+}
+
+/*!
+  Set the number of solver sub steps for the island that contains this body.
+
+  @param *bodyPtr is the pointer to the body.
+  @param subSteps number of sub steps, clamped to [1, 8]
+
+  @return Nothing.
+
+  Use this for stiff mechanisms, like vehicles, the rest of the world is not affected.
+*/
+void NewtonBodySetSolverSubsteps(const NewtonBody* const bodyPtr, int subSteps)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)bodyPtr;
+	body->SetSolverSubsteps(subSteps);
+}
+
 /*!
   Set the auto-activation mode for this body.
 
@@ -7786,6 +8395,27 @@ NewtonMesh* NewtonMeshCreateConvexHull (const NewtonWorld* const newtonWorld, in
 	return (NewtonMesh*) mesh;
 }
 
+// same as NewtonMeshCreateConvexHull but with the quick hull builder, the outside points of the faces 
+// are classified on the world worker threads, unless this is called from inside an update.
+// intended for large point clouds, the hull is the same as the one of NewtonMeshCreateConvexHull within the tolerance
+NewtonMesh* NewtonMeshCreateConvexHullParallel (const NewtonWorld* const newtonWorld, int count, const dFloat* const vertexCloud, int strideInBytes, dFloat tolerance)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgStack<dgBigVector> pool (count);
+
+	dgInt32 stride = strideInBytes / sizeof (dgFloat32);
+	for (dgInt32 i = 0; i < count; i ++) {
+		pool[i].m_x = vertexCloud[i * stride + 0];
+		pool[i].m_y = vertexCloud[i * stride + 1];
+		pool[i].m_z = vertexCloud[i * stride + 2];
+		pool[i].m_w = dgFloat64 (0.0);
+	}
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	dgMeshEffect* const mesh = new (world->dgWorld::GetAllocator()) dgMeshEffect (world->dgWorld::GetAllocator(), &pool[0].m_x, count, sizeof (dgBigVector), tolerance, threadPool);
+	return (NewtonMesh*) mesh;
+}
+
 NewtonMesh* NewtonMeshCreateTetrahedraIsoSurface(const NewtonMesh* const closeManifoldMesh)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -7805,7 +8435,9 @@ NewtonMesh* NewtonMeshCreateVoronoiConvexDecomposition (const NewtonWorld* const
 {
 	TRACE_FUNCTION(__FUNCTION__);
 	Newton* const world = (Newton *) newtonWorld;
-	return (NewtonMesh*) dgMeshEffect::CreateVoronoiConvexDecomposition (world->dgWorld::GetAllocator(), pointCount, strideInBytes, vertexCloud, materialID, dgMatrix (textureMatrix));
+	// the cells are built on the world worker threads, unless this is called from inside an update
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	return (NewtonMesh*) dgMeshEffect::CreateVoronoiConvexDecomposition (world->dgWorld::GetAllocator(), pointCount, strideInBytes, vertexCloud, materialID, dgMatrix (textureMatrix), threadPool);
 }
 
 NewtonMesh* NewtonMeshCreateFromSerialization (const NewtonWorld* const newtonWorld, NewtonDeserializeCallback deserializeFunction, void* const serializeHandle)
@@ -7963,6 +8595,18 @@ void NewtonMeshClip (const NewtonMesh* const mesh, const NewtonMesh* const clipp
 	((dgMeshEffect*) mesh)->ClipMesh (dgMatrix (clipperMatrix), (dgMeshEffect*)clipper, (dgMeshEffect**) topMesh, (dgMeshEffect**) bottomMesh);
 }
 
+// same as NewtonMeshClip, but the face pairs, the split faces and the regions are processed on the world worker threads
+void NewtonMeshClipParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix, NewtonMesh** const topMesh, NewtonMesh** const bottomMesh)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+
+	*topMesh = NULL;
+	*bottomMesh = NULL;
+	((dgMeshEffect*) mesh)->ClipMesh (dgMatrix (clipperMatrix), (dgMeshEffect*)clipper, (dgMeshEffect**) topMesh, (dgMeshEffect**) bottomMesh, threadPool);
+}
+
 
 NewtonMesh* NewtonMeshSimplify (const NewtonMesh* const mesh, int maxVertexCount, NewtonReportProgress progressReportCallback, void* const reportPrgressUserData)
 {
@@ -7970,12 +8614,39 @@ NewtonMesh* NewtonMeshSimplify (const NewtonMesh* const mesh, int maxVertexCount
 	return (NewtonMesh*) ((dgMeshEffect*) mesh)->CreateSimplification (maxVertexCount, (dgReportProgress) progressReportCallback, reportPrgressUserData);
 }
 
+// same as NewtonMeshSimplify, but the grid cells of the mesh are collapsed on the world worker threads
+NewtonMesh* NewtonMeshSimplifyParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, int maxVertexCount, NewtonReportProgress progressReportCallback, void* const reportPrgressUserData)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	return (NewtonMesh*) ((dgMeshEffect*) mesh)->CreateSimplification (maxVertexCount, (dgReportProgress) progressReportCallback, reportPrgressUserData, threadPool);
+}
+
+// simplify a .off file that may not fit in memory, the faces are streamed one slab of grid cells at a time
+NewtonMesh* NewtonMeshSimplifyOFF (const NewtonWorld* const newtonWorld, const char* const fileName, int maxVertexCount, NewtonReportProgress progressReportCallback, void* const reportPrgressUserData)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	return (NewtonMesh*) dgMeshEffect::CreateSimplificationFromOFF (world->dgWorld::GetAllocator(), fileName, maxVertexCount, (dgReportProgress) progressReportCallback, reportPrgressUserData, threadPool);
+}
+
 NewtonMesh* NewtonMeshApproximateConvexDecomposition (const NewtonMesh* const mesh, dFloat maxConcavity, dFloat backFaceDistanceFactor, int maxCount, int maxVertexPerHull, NewtonReportProgress progressReportCallback, void* const reportProgressUserData)
 {
 	TRACE_FUNCTION(__FUNCTION__);
 	return (NewtonMesh*) ((dgMeshEffect*) mesh)->CreateConvexApproximation (maxConcavity, backFaceDistanceFactor, maxCount, maxVertexPerHull, (dgReportProgress) progressReportCallback, reportProgressUserData);
 }
 
+// same as NewtonMeshApproximateConvexDecomposition, but the cluster hulls are built on the world worker threads
+NewtonMesh* NewtonMeshApproximateConvexDecompositionParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, dFloat maxConcavity, dFloat backFaceDistanceFactor, int maxCount, int maxVertexPerHull, NewtonReportProgress progressReportCallback, void* const reportProgressUserData)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	return (NewtonMesh*) ((dgMeshEffect*) mesh)->CreateConvexApproximation (maxConcavity, backFaceDistanceFactor, maxCount, maxVertexPerHull, (dgReportProgress) progressReportCallback, reportProgressUserData, threadPool);
+}
+
 
 
 NewtonMesh* NewtonMeshUnion (const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix)
@@ -7997,6 +8668,31 @@ NewtonMesh* NewtonMeshIntersection (const NewtonMesh* const mesh, const NewtonMe
 	return (NewtonMesh*) ((dgMeshEffect*) mesh)->Intersection (dgMatrix (clipperMatrix), (dgMeshEffect*)clipper);
 }
 
+// parallel versions of the boolean operations, they use the world worker threads when called outside the world update
+NewtonMesh* NewtonMeshUnionParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	return (NewtonMesh*) ((dgMeshEffect*) mesh)->Union (dgMatrix (clipperMatrix), (dgMeshEffect*)clipper, threadPool);
+}
+
+NewtonMesh* NewtonMeshDifferenceParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	return (NewtonMesh*) ((dgMeshEffect*) mesh)->Difference (dgMatrix (clipperMatrix), (dgMeshEffect*)clipper, threadPool);
+}
+
+NewtonMesh* NewtonMeshIntersectionParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgThreadHive* const threadPool = world->IsInUpdate() ? NULL : world;
+	return (NewtonMesh*) ((dgMeshEffect*) mesh)->Intersection (dgMatrix (clipperMatrix), (dgMeshEffect*)clipper, threadPool);
+}
+
 NewtonMesh* NewtonMeshConvexMeshIntersection (const NewtonMesh* const mesh, const NewtonMesh* const convexMesh)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -8580,6 +9276,89 @@ int NewtonDeformableMeshGetParticleStrideInBytes(const NewtonCollision* const de
 	return 0;
 }
 
+/*!
+  Return the self collision state of a particle system.
+
+  @param deformableMesh pointer to a deformable mesh or mass spring damper system collision.
+
+  @return 1 if the particles collide with each other, 0 otherwise.
+
+  See also: ::NewtonDeformableMeshSetSelfCollision
+*/
+int NewtonDeformableMeshGetSelfCollision(const NewtonCollision* const deformableMesh)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)deformableMesh;
+	if (collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) {
+		dgCollisionLumpedMassParticles* const deformableShape = (dgCollisionLumpedMassParticles*)collision->GetChildShape();
+		return deformableShape->GetSelfCollision() ? 1 : 0;
+	}
+	return 0;
+}
+
+/*!
+  Enable or disable collision between the particles of the same system.
+
+  @param deformableMesh pointer to a deformable mesh or mass spring damper system collision.
+  @param state 1 to enable self collision, 0 to disable it (the default).
+
+  Particles that are within a few radius of each other in the rest pose are never tested,
+  so neighbors joined by links do not push each other apart.
+
+  See also: ::NewtonDeformableMeshGetSelfCollision
+*/
+void NewtonDeformableMeshSetSelfCollision(const NewtonCollision* const deformableMesh, int state)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)deformableMesh;
+	if (collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) {
+		dgCollisionLumpedMassParticles* const deformableShape = (dgCollisionLumpedMassParticles*)collision->GetChildShape();
+		deformableShape->SetSelfCollision(state ? true : false);
+	}
+}
+
+/*!
+  Return the integration mode of a mass spring damper system.
+
+  @param massSpringSystem pointer to a collision created with NewtonCreateMassSpringDamperSystem.
+
+  @return 1 if the system uses the implicit solver, 0 if it uses the explicit sub stepping, or the collision is not a mass spring damper system.
+
+  See also: ::NewtonMassSpringDamperSystemSetImplicitIntegration
+*/
+int NewtonMassSpringDamperSystemGetImplicitIntegration(const NewtonCollision* const massSpringSystem)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)massSpringSystem;
+	if (collision->IsType(dgCollision::dgCollisionMassSpringDamperSystem_RTTI)) {
+		dgCollisionMassSpringDamperSystem* const massSpringShape = (dgCollisionMassSpringDamperSystem*)collision->GetChildShape();
+		return massSpringShape->GetImplicitIntegration() ? 1 : 0;
+	}
+	return 0;
+}
+
+/*!
+  Select the integration mode of a mass spring damper system.
+
+  @param massSpringSystem pointer to a collision created with NewtonCreateMassSpringDamperSystem.
+  @param state 1 for implicit integration, 0 for the default explicit integration.
+
+  The explicit mode runs four sub steps per update and needs small time steps with stiff springs.
+  The implicit mode solves one backward Euler step per update with a preconditioned conjugate gradient,
+  it remains stable with stiff springs at the normal update rate, at a higher cost per step.
+
+  See also: ::NewtonMassSpringDamperSystemGetImplicitIntegration, ::NewtonCreateMassSpringDamperSystem
+*/
+void NewtonMassSpringDamperSystemSetImplicitIntegration(const NewtonCollision* const massSpringSystem, int state)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)massSpringSystem;
+	if (collision->IsType(dgCollision::dgCollisionMassSpringDamperSystem_RTTI)) {
+		dgCollisionMassSpringDamperSystem* const massSpringShape = (dgCollisionMassSpringDamperSystem*)collision->GetChildShape();
+		massSpringShape->SetImplicitIntegration(state ? true : false);
+	}
+}
+
 
 
 /*
@@ -76,6 +76,10 @@ extern "C" {
 	#define NEWTON_DYNAMIC_BODY								0
 	#define NEWTON_KINEMATIC_BODY							1
 	#define NEWTON_DYNAMIC_ASYMETRIC_BODY					2
+
+	#define NEWTON_CONTACT_EVENT_BEGIN						0
+	#define NEWTON_CONTACT_EVENT_END						1
+	#define NEWTON_CONTACT_EVENT_IMPACT						2
 //	#define NEWTON_DEFORMABLE_BODY							2
 
 	#define SERIALIZE_ID_SPHERE								0
@@ -298,6 +302,45 @@ extern "C" {
 		void* m_userData;                       // user data passed to the collision geometry at creation time
 	} NewtonUserMeshCollisionRayHitDesc;
 
+	typedef struct NewtonWorldStepStats
+	{
+		dLong m_stepIndex;						// number of updates before this one
+		unsigned m_broadphaseTime;				// microseconds in force callbacks, sleep states and broadphase tree update
+		unsigned m_pairsTime;					// microseconds finding new colliding pairs
+		unsigned m_contactsTime;				// microseconds generating contacts
+		unsigned m_clustersTime;				// microseconds updating skeletons and building islands
+		unsigned m_solverTime;					// microseconds in the joint solver, small islands and soft bodies are integrated here too
+		unsigned m_integrationTime;				// microseconds integrating large islands and in transform callbacks
+		unsigned m_totalTime;					// microseconds for the whole update, same as NewtonGetLastUpdateTime
+		int m_pairCount;						// body pairs in the broadphase contact list
+		int m_contactCount;						// contact points in active pairs
+		int m_clusterCount;						// islands sent to the solver
+		int m_rowCount;							// solver rows in all islands
+		int m_sleepingBodyCount;				// sleeping dynamic bodies
+		int m_allocationCount;					// allocations made by the world during the update
+	} NewtonWorldStepStats;
+
+	typedef struct NewtonTriggerEvent
+	{
+		NewtonBody* m_trigger;					// body flagged with NewtonBodySetTriggerVolume
+		NewtonBody* m_guest;					// body that entered or left the trigger, may be already destroyed on exit
+		int m_triggerId;						// NewtonBodyGetID of the trigger
+		int m_guestId;							// NewtonBodyGetID of the guest
+		int m_enter;							// one if the guest entered the trigger, zero if it left
+	} NewtonTriggerEvent;
+
+	typedef struct NewtonContactEvent
+	{
+		NewtonBody* m_body0;					// body with the lower id, may be already destroyed on end events
+		NewtonBody* m_body1;					// body with the higher id, may be already destroyed on end events
+		dFloat m_point[4];						// point of the largest impulse, impact events only
+		dFloat m_normal[4];						// contact normal pointing as seen from body0, impact events only
+		dFloat m_impulse;						// largest normal impulse, impact events only
+		int m_body0Id;							// NewtonBodyGetID of body0
+		int m_body1Id;							// NewtonBodyGetID of body1
+		int m_type;								// NEWTON_CONTACT_EVENT_BEGIN, NEWTON_CONTACT_EVENT_END or NEWTON_CONTACT_EVENT_IMPACT
+	} NewtonContactEvent;
+
 	typedef struct NewtonHingeSliderUpdateDesc
 	{
 		dFloat m_accel;
@@ -442,6 +485,7 @@ extern "C" {
 	typedef void (*NewtonConstraintDestructor) (const NewtonJoint* const me);
 
 	typedef void (*NewtonJobTask) (NewtonWorld* const world, void* const userData, int threadIndex);
+	typedef void (*NewtonParallelForTask) (NewtonWorld* const world, void* const userData, int startIndex, int count, int threadIndex);
 	typedef int (*NewtonReportProgress) (dFloat normalizedProgressPercent, void* const userData);
 
 	// **********************************************************************************************
@@ -485,6 +529,10 @@ extern "C" {
 	NEWTON_API void NewtonSetParallelSolverOnLargeIsland (const NewtonWorld* const newtonWorld, int mode);
 	NEWTON_API int NewtonGetParallelSolverOnLargeIsland (const NewtonWorld* const newtonWorld);
 
+	NEWTON_API void NewtonSetDeterministicMode (const NewtonWorld* const newtonWorld, int mode);
+	NEWTON_API int NewtonGetDeterministicMode (const NewtonWorld* const newtonWorld);
+	NEWTON_API unsigned NewtonWorldGetStateHash (const NewtonWorld* const newtonWorld);
+
 	NEWTON_API int NewtonGetBroadphaseAlgorithm (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSelectBroadphaseAlgorithm (const NewtonWorld* const newtonWorld, int algorithmType);
 	NEWTON_API void NewtonResetBroadphase(const NewtonWorld* const newtonWorld);
@@ -495,7 +543,15 @@ extern "C" {
 
 	NEWTON_API int NewtonGetNumberOfSubsteps (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps);
+	NEWTON_API int NewtonGetStiffIslandSubsteps (const NewtonWorld* const newtonWorld);
+	NEWTON_API dFloat NewtonGetStiffIslandMassRatio (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetStiffIslandSubsteps (const NewtonWorld* const newtonWorld, dFloat massRatio, int subSteps);
 	NEWTON_API dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldGetStepStats (const NewtonWorld* const newtonWorld, NewtonWorldStepStats* const stats, int maxCount);
+	NEWTON_API int NewtonWorldGetActiveTransformCount (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldGetActiveTransforms (const NewtonWorld* const newtonWorld, int startIndex, int count, NewtonBody** const bodies, dFloat* const matrices);
+	NEWTON_API int NewtonWorldGetTriggerEventCount (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldGetTriggerEvents (const NewtonWorld* const newtonWorld, int startIndex, int count, NewtonTriggerEvent* const events);
 
 	NEWTON_API void NewtonSerializeToFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodySerializationCallback bodyCallback, void* const bodyUserData);
 	NEWTON_API void NewtonDeserializeFromFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodyDeserializationCallback bodyCallback, void* const bodyUserData);
@@ -517,6 +573,7 @@ extern "C" {
 	NEWTON_API int NewtonGetMaxThreadsCount(const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonDispachThreadJob(const NewtonWorld* const newtonWorld, NewtonJobTask task, void* const usedData, const char* const functionName);
 	NEWTON_API void NewtonSyncThreadJobs(const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonParallelFor(const NewtonWorld* const newtonWorld, int count, int grainSize, NewtonParallelForTask task, void* const userData, const char* const functionName);
 
 	// atomic operations
 	NEWTON_API int NewtonAtomicAdd (int* const ptr, int value);
@@ -538,6 +595,7 @@ extern "C" {
 	NEWTON_API void NewtonWorldListenerSetDestructorCallback (const NewtonWorld* const newtonWorld, void* const listener, NewtonWorldDestroyListenerCallback destroy);
 	NEWTON_API void NewtonWorldListenerSetPreUpdateCallback (const NewtonWorld* const newtonWorld, void* const listener, NewtonWorldUpdateListenerCallback update);
 	NEWTON_API void NewtonWorldListenerSetPostUpdateCallback (const NewtonWorld* const newtonWorld, void* const listener, NewtonWorldUpdateListenerCallback update);
+	NEWTON_API void NewtonWorldListenerSetPostTransformCallback (const NewtonWorld* const newtonWorld, void* const listener, NewtonWorldUpdateListenerCallback update);
 	NEWTON_API void NewtonWorldListenerSetDebugCallback (const NewtonWorld* const newtonWorld, void* const listener, NewtonWorldListenerDebugCallback debugCallback);
 	NEWTON_API void NewtonWorldListenerSetBodyDestroyCallback(const NewtonWorld* const newtonWorld, void* const listener, NewtonWorldListenerBodyDestroyCallback bodyDestroyCallback);
 	NEWTON_API void NewtonWorldListenerDebug(const NewtonWorld* const newtonWorld, void* const context);
@@ -549,10 +607,16 @@ extern "C" {
 	NEWTON_API void NewtonWorldSetCollisionConstructorDestructorCallback (const NewtonWorld* const newtonWorld, NewtonCollisionCopyConstructionCallback constructor, NewtonCollisionDestructorCallback destructor);
 
 	NEWTON_API void NewtonWorldSetCreateDestroyContactCallback(const NewtonWorld* const newtonWorld, NewtonCreateContactCallback createContact, NewtonDestroyContactCallback destroyContact);
+	NEWTON_API int NewtonWorldGetContactEventBuffering (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonWorldSetContactEventBuffering (const NewtonWorld* const newtonWorld, int state);
+	NEWTON_API int NewtonWorldGetContactEventCount (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldGetContactEvents (const NewtonWorld* const newtonWorld, int startIndex, int count, NewtonContactEvent* const events);
 
 	NEWTON_API void NewtonWorldRayCast (const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, NewtonWorldRayFilterCallback filter, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
 	NEWTON_API int NewtonWorldConvexCast (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const dFloat* const target, const NewtonCollision* const shape, dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
+	NEWTON_API int NewtonWorldConvexCastBodies (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int bodyCount, const dFloat* const matrix, const dFloat* const target, const NewtonCollision* const shape, dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
 	NEWTON_API int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
+	NEWTON_API int NewtonWorldCollideBodies (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int bodyCount, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
 	
 	// world utility functions
 	NEWTON_API int NewtonWorldGetBodyCount(const NewtonWorld* const newtonWorld);
@@ -578,6 +642,7 @@ extern "C" {
 	// material definitions that can not be overwritten in function callback
 	NEWTON_API void* NewtonMaterialGetUserData (const NewtonWorld* const newtonWorld, int id0, int id1);
 	NEWTON_API void NewtonMaterialSetSurfaceThickness (const NewtonWorld* const newtonWorld, int id0, int id1, dFloat thickness);
+	NEWTON_API void NewtonMaterialSetContactReduction (const NewtonWorld* const newtonWorld, int id0, int id1, int pointsPerManifold, int maxPairContacts);
 
 //	deprecated, not longer continue collision is set on the material  	
 //	NEWTON_API void NewtonMaterialSetContinuousCollisionMode (const NewtonWorld* const newtonWorld, int id0, int id1, int state);
@@ -705,6 +770,12 @@ extern "C" {
 	NEWTON_API int NewtonFracturedCompoundIsNodeFreeToDetach (const NewtonCollision* const fracturedCompound, void* const collisionNode);
 	NEWTON_API int NewtonFracturedCompoundNeighborNodeList (const NewtonCollision* const fracturedCompound, void* const collisionNode, void** const list, int maxCount);
 
+	NEWTON_API int NewtonFracturedCompoundGetPrecooked (const NewtonCollision* const fracturedCompound);
+	NEWTON_API void NewtonFracturedCompoundSetPrecooked (const NewtonCollision* const fracturedCompound, int state);
+	NEWTON_API int NewtonFracturedCompoundDetachChunks (const NewtonBody* const fracturedBody, void** const collisionNodes, NewtonBody** const pooledBodies, int count);
+	NEWTON_API void NewtonFracturedCompoundSetBodyPool (const NewtonCollision* const fracturedCompound, NewtonBody** const pooledBodies, int count);
+	NEWTON_API int NewtonFracturedCompoundGetBodyPoolCount (const NewtonCollision* const fracturedCompound);
+
 	
 	NEWTON_API NewtonFracturedCompoundMeshPart* NewtonFracturedCompoundGetMainMesh (const NewtonCollision* const fracturedCompound);
 	NEWTON_API NewtonFracturedCompoundMeshPart* NewtonFracturedCompoundGetFirstSubMesh(const NewtonCollision* const fracturedCompound);
@@ -897,6 +968,8 @@ extern "C" {
 	NEWTON_API int NewtonBodyGetType (const NewtonBody* const body);
 	NEWTON_API int NewtonBodyGetCollidable (const NewtonBody* const body);
 	NEWTON_API void NewtonBodySetCollidable (const NewtonBody* const body, int collidableState);
+	NEWTON_API int NewtonBodyGetTriggerVolume (const NewtonBody* const body);
+	NEWTON_API void NewtonBodySetTriggerVolume (const NewtonBody* const body, int triggerState);
 
 	NEWTON_API void  NewtonBodyAddForce (const NewtonBody* const body, const dFloat* const force);
 	NEWTON_API void  NewtonBodyAddTorque (const NewtonBody* const body, const dFloat* const torque);
@@ -937,6 +1010,8 @@ extern "C" {
 
 	NEWTON_API int NewtonBodyGetGyroscopicTorque(const NewtonBody* const body);
 	NEWTON_API void NewtonBodySetGyroscopicTorque(const NewtonBody* const body, int state);
+	NEWTON_API int NewtonBodyGetSolverSubsteps(const NewtonBody* const body);
+	NEWTON_API void NewtonBodySetSolverSubsteps(const NewtonBody* const body, int subSteps);
 
 	NEWTON_API void NewtonBodySetDestructorCallback (const NewtonBody* const body, NewtonBodyDestructor callback);
 	NEWTON_API NewtonBodyDestructor NewtonBodyGetDestructorCallback (const NewtonBody* const body);
@@ -1080,6 +1155,11 @@ extern "C" {
 	NEWTON_API int NewtonDeformableMeshGetParticleCount (const NewtonCollision* const deformableMesh); 
 	NEWTON_API int NewtonDeformableMeshGetParticleStrideInBytes (const NewtonCollision* const deformableMesh); 
 	NEWTON_API const dFloat* NewtonDeformableMeshGetParticleArray (const NewtonCollision* const deformableMesh); 
+	NEWTON_API int NewtonDeformableMeshGetSelfCollision (const NewtonCollision* const deformableMesh); 
+	NEWTON_API void NewtonDeformableMeshSetSelfCollision (const NewtonCollision* const deformableMesh, int state); 
+
+	NEWTON_API int NewtonMassSpringDamperSystemGetImplicitIntegration (const NewtonCollision* const massSpringSystem);
+	NEWTON_API void NewtonMassSpringDamperSystemSetImplicitIntegration (const NewtonCollision* const massSpringSystem, int state);
 
 /*
 	NEWTON_API NewtonCollision* NewtonCreateClothPatch (const NewtonWorld* const newtonWorld, NewtonMesh* const mesh, int shapeID, NewtonClothPatchMaterial* const structuralMaterial, NewtonClothPatchMaterial* const bendMaterial);
@@ -1224,6 +1304,7 @@ extern "C" {
 	NEWTON_API NewtonMesh* NewtonMeshCreateFromCollision(const NewtonCollision* const collision);
 	NEWTON_API NewtonMesh* NewtonMeshCreateTetrahedraIsoSurface(const NewtonMesh* const mesh);
 	NEWTON_API NewtonMesh* NewtonMeshCreateConvexHull (const NewtonWorld* const newtonWorld, int pointCount, const dFloat* const vertexCloud, int strideInBytes, dFloat tolerance);
+	NEWTON_API NewtonMesh* NewtonMeshCreateConvexHullParallel (const NewtonWorld* const newtonWorld, int pointCount, const dFloat* const vertexCloud, int strideInBytes, dFloat tolerance);
 	NEWTON_API NewtonMesh* NewtonMeshCreateVoronoiConvexDecomposition (const NewtonWorld* const newtonWorld, int pointCount, const dFloat* const vertexCloud, int strideInBytes, int materialID, const dFloat* const textureMatrix);
 	NEWTON_API NewtonMesh* NewtonMeshCreateFromSerialization (const NewtonWorld* const newtonWorld, NewtonDeserializeCallback deserializeFunction, void* const serializeHandle);
 	NEWTON_API void NewtonMeshDestroy(const NewtonMesh* const mesh);
@@ -1258,11 +1339,18 @@ extern "C" {
 	NEWTON_API NewtonMesh* NewtonMeshDifference (const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix);
 	NEWTON_API NewtonMesh* NewtonMeshIntersection (const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix);
 	NEWTON_API void NewtonMeshClip (const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix, NewtonMesh** const topMesh, NewtonMesh** const bottomMesh);
+	NEWTON_API NewtonMesh* NewtonMeshUnionParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix);
+	NEWTON_API NewtonMesh* NewtonMeshDifferenceParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix);
+	NEWTON_API NewtonMesh* NewtonMeshIntersectionParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix);
+	NEWTON_API void NewtonMeshClipParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, const NewtonMesh* const clipper, const dFloat* const clipperMatrix, NewtonMesh** const topMesh, NewtonMesh** const bottomMesh);
 
 	NEWTON_API NewtonMesh* NewtonMeshConvexMeshIntersection (const NewtonMesh* const mesh, const NewtonMesh* const convexMesh);
 
 	NEWTON_API NewtonMesh* NewtonMeshSimplify (const NewtonMesh* const mesh, int maxVertexCount, NewtonReportProgress reportPrograssCallback, void* const reportPrgressUserData);
+	NEWTON_API NewtonMesh* NewtonMeshSimplifyParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, int maxVertexCount, NewtonReportProgress reportProgressCallback, void* const reportProgressUserData);
+	NEWTON_API NewtonMesh* NewtonMeshSimplifyOFF (const NewtonWorld* const newtonWorld, const char* const fileName, int maxVertexCount, NewtonReportProgress reportProgressCallback, void* const reportProgressUserData);
 	NEWTON_API NewtonMesh* NewtonMeshApproximateConvexDecomposition (const NewtonMesh* const mesh, dFloat maxConcavity, dFloat backFaceDistanceFactor, int maxCount, int maxVertexPerHull, NewtonReportProgress reportProgressCallback, void* const reportProgressUserData);
+	NEWTON_API NewtonMesh* NewtonMeshApproximateConvexDecompositionParallel (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, dFloat maxConcavity, dFloat backFaceDistanceFactor, int maxCount, int maxVertexPerHull, NewtonReportProgress reportProgressCallback, void* const reportProgressUserData);
 
 	NEWTON_API void NewtonRemoveUnusedVertices(const NewtonMesh* const mesh, int* const vertexRemapTable);
 
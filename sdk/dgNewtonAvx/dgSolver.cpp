@@ -53,9 +53,9 @@ void dgSolver::CalculateJointForces(const dgBodyCluster& cluster, dgBodyInfo* co
 	m_timestep = timestep;
 	m_invTimestep = (timestep > dgFloat32(0.0f)) ? dgFloat32(1.0f) / timestep : dgFloat32(0.0f);
 
-	m_invStepRK = dgFloat32 (0.25f);
+	m_invStepRK = dgFloat32 (0.25f) / dgFloat32 (cluster.m_substeps);
 	m_timestepRK = m_timestep * m_invStepRK;
-	m_invTimestepRK = m_invTimestep * dgFloat32 (4.0f);
+	m_invTimestepRK = m_invTimestep * dgFloat32 (4 * cluster.m_substeps);
 
 	m_threadCounts = m_world->GetThreadCount();
 	m_solverPasses = m_world->GetSolverIterations();
@@ -1113,7 +1113,8 @@ void dgSolver::CalculateForces()
 	const dgInt32 threadCounts = m_world->GetThreadCount();
 
 	InitSkeletons();
-	for (dgInt32 step = 0; step < 4; step++) {
+	const dgInt32 derivativesEvaluationsRK4 = 4 * m_cluster->m_substeps;
+	for (dgInt32 step = 0; step < derivativesEvaluationsRK4; step++) {
 		CalculateJointsAcceleration();
 		dgFloat32 accNorm = DG_SOLVER_MAX_ERROR * dgFloat32(2.0f);
 		for (dgInt32 k = 0; (k < passes) && (accNorm > DG_SOLVER_MAX_ERROR); k++) {
@@ -39,6 +39,7 @@ dgBilateralConstraint::dgBilateralConstraint ()
 	:dgConstraint () 
 	,m_destructor(NULL)
 	,m_jointNode(NULL)
+	,m_serialNumber(0)
 {
 	m_maxDOF = 6;
 	m_isBilateral = true;
@@ -74,6 +75,8 @@ void dgBilateralConstraint::AppendToJointList()
 	
 	dgBilateralConstraintList* const jointList = m_body0->m_world;
 	m_jointNode = jointList->Addtop(this);
+	m_serialNumber = jointList->m_serialNumber;
+	jointList->m_serialNumber ++;
 }
 
 
@@ -32,8 +32,11 @@ class dgBilateralConstraintList: public dgList<dgBilateralConstraint*>
 	public:
 	dgBilateralConstraintList(dgMemoryAllocator* const allocator)
 		:dgList<dgBilateralConstraint*>(allocator)
+		,m_serialNumber(0)
 	{
 	}
+
+	dgUnsigned32 m_serialNumber;
 };
 
 class dgBilateralConstraint: public dgConstraint  
@@ -85,6 +88,7 @@ class dgBilateralConstraint: public dgConstraint
 	dgFloat32 m_stiffness;
 	OnConstraintDestroy m_destructor;
 	dgBilateralConstraintList::dgListNode* m_jointNode;
+	dgUnsigned32 m_serialNumber;
 	dgInt8	  m_rowIsMotor;
 	dgInt8	  m_rowIsIk;
 
@@ -157,6 +157,9 @@ class dgBody
 
 	bool GetGyroMode() const;
 	void SetGyroMode(bool state);
+
+	dgInt32 GetSolverSubsteps() const;
+	void SetSolverSubsteps(dgInt32 substeps);
 	
 	dgCollisionInstance* GetCollision () const;
 	dgBodyMasterList::dgListNode* GetMasterList() const;
@@ -172,6 +175,8 @@ class dgBody
 	const dgMatrix& GetInvInertiaMatrix () const;
 
 	bool IsCollidable() const;
+	bool IsTrigger() const;
+	void SetTrigger(bool state);
 	void UpdateCollisionMatrix(dgFloat32 timestep, dgInt32 threadIndex);
 
 	virtual dgMatrix CalculateInertiaMatrix () const;
@@ -290,6 +295,8 @@ class dgBody
 			dgUnsigned32 m_collideWithLinkedBodies	: 1;
 			dgUnsigned32 m_transformIsDirty			: 1;
 			dgUnsigned32 m_gyroTorqueOn				: 1;
+			dgUnsigned32 m_isTrigger				: 1;
+			dgUnsigned32 m_solverExtraSubsteps		: 3;
 		};
 	};
 
@@ -567,11 +574,31 @@ DG_INLINE void dgBody::SetGyroMode(bool state)
 	m_gyroTorqueOn = state;
 }
 
+DG_INLINE dgInt32 dgBody::GetSolverSubsteps() const
+{
+	return m_solverExtraSubsteps + 1;
+}
+
+DG_INLINE void dgBody::SetSolverSubsteps(dgInt32 substeps)
+{
+	m_solverExtraSubsteps = dgClamp(substeps, 1, 8) - 1;
+}
+
 DG_INLINE bool dgBody::IsCollidable() const
 {
 	return m_collidable;
 }
 
+DG_INLINE bool dgBody::IsTrigger() const
+{
+	return m_isTrigger;
+}
+
+DG_INLINE void dgBody::SetTrigger(bool state)
+{
+	m_isTrigger = state;
+}
+
 
 DG_INLINE void dgBody::SetMatrixOriginAndRotation(const dgMatrix& matrix)
 {
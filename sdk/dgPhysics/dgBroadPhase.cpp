@@ -154,6 +154,8 @@ dgBroadPhase::dgBroadPhase(dgWorld* const world)
 	,m_contactCache(world->GetAllocator())
 	,m_pendingSoftBodyCollisions(world->GetAllocator(), 64)
 	,m_pendingSoftBodyPairsCount(0)
+	,m_triggerEvents(world->GetAllocator(), 64)
+	,m_triggerEventsCount(0)
 	,m_criticalSectionLock(0)
 {
 }
@@ -309,6 +311,7 @@ void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, d
 	dgInt32* const atomicBodiesCount = &descriptor->m_atomicDynamicsCount;
 	dgInt32* const atomicPendingBodiesCount = &descriptor->m_atomicPendingBodiesCount;
 
+	dgInt32 sleepingCount = 0;
 	while (node) {
 		if (DoNeedUpdate(node)) {
 			dgBody* const body = node->GetInfo().GetBody();
@@ -344,6 +347,7 @@ void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, d
 
 				dynamicBody->m_savedExternalForce = dynamicBody->m_externalForce;
 				dynamicBody->m_savedExternalTorque = dynamicBody->m_externalTorque;
+				sleepingCount += (dynamicBody->m_sleeping && dynamicBody->GetInvMass().m_w) ? 1 : 0;
 			} else {
 				dgAssert(body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
 
@@ -355,7 +359,9 @@ void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, d
 				} else {
 					body->m_autoSleep = true;
 					body->m_sleeping = isResting;
-					descriptor->m_fullScan = !isResting;
+					if (!isResting) {
+						descriptor->m_fullScan = true;
+					}
 				}
 				body->m_equilibrium = isResting;
 
@@ -370,6 +376,7 @@ void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, d
 			node = node ? node->GetNext() : NULL;
 		}
 	}
+	dgAtomicExchangeAndAdd(&descriptor->m_atomicSleepingBodiesCount, sleepingCount);
 }
 
 
@@ -537,6 +544,73 @@ dgInt32 dgBroadPhase::ConvexCast(const dgBroadPhaseNode** stackPool, dgFloat32*
 	return totalCount;
 }
 
+dgInt32 dgBroadPhase::ConvexCastBodies(dgBody** const bodies, dgInt32 bodyCount, dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgVector boxP0;
+	dgVector boxP1;
+	dgAssert(matrix.TestOrthogonal());
+	shape->CalcAABB(matrix, boxP0, boxP1);
+
+	dgVector velocA((target - matrix.m_posit) & dgVector::m_triplexMask);
+	dgVector velocB(dgFloat32(0.0f));
+	dgFastRayTest ray(dgVector(dgFloat32(0.0f)), velocA);
+
+	dgStack<dgFloat32> distanceBuffer(bodyCount + 1);
+	dgStack<const dgBroadPhaseNode*> stackPoolBuffer(bodyCount + 1);
+	dgFloat32* const distance = &distanceBuffer[0];
+	const dgBroadPhaseNode** const stackPool = &stackPoolBuffer[0];
+
+	// the candidates are leaf nodes only, sort them so that the closest one is on top of the stack
+	dgInt32 stack = 0;
+	for (dgInt32 i = 0; i < bodyCount; i++) {
+		const dgBroadPhaseNode* const node = bodies[i]->GetBroadPhase();
+		if (node) {
+			dgVector minBox(node->m_minBox - boxP1);
+			dgVector maxBox(node->m_maxBox - boxP0);
+			dgFloat32 dist = ray.BoxIntersect(minBox, maxBox);
+			if (dist < dgFloat32(1.0f)) {
+				dgInt32 j = stack;
+				for (; j && (dist > distance[j - 1]); j--) {
+					stackPool[j] = stackPool[j - 1];
+					distance[j] = distance[j - 1];
+				}
+				stackPool[j] = node;
+				distance[j] = dist;
+				stack++;
+			}
+		}
+	}
+
+	*param = dgFloat32(1.0f);
+	return stack ? ConvexCast(stackPool, distance, stack, velocA, velocB, ray, shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex) : 0;
+}
+
+dgInt32 dgBroadPhase::CollideBodies(dgBody** const bodies, dgInt32 bodyCount, dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgVector boxP0;
+	dgVector boxP1;
+	dgAssert(matrix.TestOrthogonal());
+	shape->CalcAABB(shape->GetLocalMatrix() * matrix, boxP0, boxP1);
+
+	dgStack<dgInt32> overlapBuffer(bodyCount + 1);
+	dgStack<const dgBroadPhaseNode*> stackPoolBuffer(bodyCount + 1);
+	dgInt32* const overlaped = &overlapBuffer[0];
+	const dgBroadPhaseNode** const stackPool = &stackPoolBuffer[0];
+
+	// push the candidates in reverse so that they are visited in the order they were given
+	dgInt32 stack = 0;
+	for (dgInt32 i = bodyCount - 1; i >= 0; i--) {
+		const dgBroadPhaseNode* const node = bodies[i]->GetBroadPhase();
+		if (node && dgOverlapTest(node->m_minBox, node->m_maxBox, boxP0, boxP1)) {
+			stackPool[stack] = node;
+			overlaped[stack] = 1;
+			stack++;
+		}
+	}
+
+	return stack ? Collide(stackPool, overlaped, stack, boxP0, boxP1, shape, matrix, prefilter, userData, info, maxContacts, threadIndex) : 0;
+}
+
 dgInt32 dgBroadPhase::Collide(const dgBroadPhaseNode** stackPool, dgInt32* const ovelapStack, dgInt32 stack, const dgVector& boxP0, const dgVector& boxP1, dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgTriplex points[DG_CONVEX_CAST_POOLSIZE];
@@ -846,6 +920,44 @@ dgInt32 dgBroadPhase::CompareNodes(const dgBroadPhaseNode* const nodeA, const dg
 	return 0;
 }
 
+dgInt32 dgBroadPhase::CompareTriggerEvents(const dgTriggerEvent* const eventA, const dgTriggerEvent* const eventB, void* const)
+{
+	if (eventA->m_triggerId < eventB->m_triggerId) {
+		return -1;
+	}
+	if (eventA->m_triggerId > eventB->m_triggerId) {
+		return 1;
+	}
+	if (eventA->m_guestId < eventB->m_guestId) {
+		return -1;
+	}
+	if (eventA->m_guestId > eventB->m_guestId) {
+		return 1;
+	}
+	// a pair gets at most one event per update, so the recording order is the order the events happened 
+	return eventA->m_sequence - eventB->m_sequence;
+}
+
+dgInt32 dgBroadPhase::CompareContacts(dgContact* const* const contactA, dgContact* const* const contactB, void* const)
+{
+	const dgInt32 lowA = dgMin((*contactA)->GetBody0()->m_uniqueID, (*contactA)->GetBody1()->m_uniqueID);
+	const dgInt32 lowB = dgMin((*contactB)->GetBody0()->m_uniqueID, (*contactB)->GetBody1()->m_uniqueID);
+	if (lowA < lowB) {
+		return -1;
+	}
+	if (lowA > lowB) {
+		return 1;
+	}
+	const dgInt32 highA = dgMax((*contactA)->GetBody0()->m_uniqueID, (*contactA)->GetBody1()->m_uniqueID);
+	const dgInt32 highB = dgMax((*contactB)->GetBody0()->m_uniqueID, (*contactB)->GetBody1()->m_uniqueID);
+	if (highA < highB) {
+		return -1;
+	}
+	if (highA > highB) {
+		return 1;
+	}
+	return 0;
+}
 
 void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy, dgBroadPhaseNode** const root)
 {
@@ -1082,7 +1194,12 @@ void dgBroadPhase::CalculatePairContacts (dgPair* const pair, dgInt32 threadID)
 	pair->m_contactBuffer = contacts;
 	m_world->CalculateContacts(pair, threadID, false, false);
 
-	if (pair->m_contactCount) {
+	dgContact* const contact = pair->m_contact;
+	if (contact->m_body0->m_isTrigger | contact->m_body1->m_isTrigger) {
+		// trigger pairs only report overlap, the joint stays active 
+		// while the shapes intersect but it never gets solver rows
+		contact->m_maxDOF = 0;
+	} else if (pair->m_contactCount) {
 		dgAssert(pair->m_contactCount <= (DG_CONSTRAINT_MAX_ROWS / 3));
 		m_world->ProcessContacts(pair, threadID);
 		KinematicBodyActivation(pair->m_contact);
@@ -1236,9 +1353,12 @@ void dgBroadPhase::AddPair (dgBody* const body0, dgBody* const body1, const dgFl
 						const dgInt32 isSofBody1 = body1->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI);
 
 						if (isSofBody0 || isSofBody1) {
-							m_pendingSoftBodyCollisions[m_pendingSoftBodyPairsCount].m_body0 = body0;
-							m_pendingSoftBodyCollisions[m_pendingSoftBodyPairsCount].m_body1 = body1;
-							m_pendingSoftBodyPairsCount++;
+							if (!(isSofBody0 && isSofBody1)) {
+								dgScopeSpinPause lock(&m_criticalSectionLock);
+								m_pendingSoftBodyCollisions[m_pendingSoftBodyPairsCount].m_body0 = body0;
+								m_pendingSoftBodyCollisions[m_pendingSoftBodyPairsCount].m_body1 = body1;
+								m_pendingSoftBodyPairsCount++;
+							}
 						} else {
 							dgContactList& contactList = *m_world;
 							dgAtomicExchangeAndAdd(&contactList.m_contactCountReset, 1);
@@ -1478,30 +1598,38 @@ void dgBroadPhase::AddGeneratedBodiesContactsKernel (void* const context, void*
 	broadPhase->FindGeneratedBodiesCollidingPairs (descriptor, threadID);
 }
 
-void dgBroadPhase::UpdateSoftBodyContactKernel(void* const context, void* const worldContext, dgInt32 threadID)
+void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, void* const , dgInt32 threadID)
 {
 	D_TRACKTIME();
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->UpdateSoftBodyContacts(descriptor, descriptor->m_timestep, threadID);
+	broadPhase->UpdateRigidBodyContacts(descriptor, descriptor->m_timestep, threadID);
 }
 
-void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, void* const , dgInt32 threadID)
+void dgBroadPhase::AddTriggerEvent(const dgContact* const contact, bool enter)
 {
-	D_TRACKTIME();
-	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
-	dgWorld* const world = descriptor->m_world;
-	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->UpdateRigidBodyContacts(descriptor, descriptor->m_timestep, threadID);
+	dgBody* const body0 = contact->GetBody0();
+	dgBody* const body1 = contact->GetBody1();
+	dgAssert(body0->m_isTrigger | body1->m_isTrigger);
+
+	dgScopeSpinPause lock(&m_criticalSectionLock);
+	dgTriggerEvent& event = m_triggerEvents[m_triggerEventsCount];
+	event.m_trigger = body0->m_isTrigger ? body0 : body1;
+	event.m_guest = body0->m_isTrigger ? body1 : body0;
+	event.m_triggerId = event.m_trigger->m_uniqueID;
+	event.m_guestId = event.m_guest->m_uniqueID;
+	event.m_sequence = m_triggerEventsCount;
+	event.m_enter = enter ? 1 : 0;
+	m_triggerEventsCount++;
 }
 
 void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID)
 {
-	dgAssert(0);
-/*
+	// soft bodies do not make contact joints, each system keeps the list of bodies it touches 
+	// and resolves the particles collisions when it is integrated.
 	const dgInt32 count = m_pendingSoftBodyPairsCount;
-	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_pairsAtomicCounter, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_pairsAtomicCounter, 1)) {
+	for (dgInt32 i = 0; i < count; i ++) {
 		dgPendingCollisionSoftBodies& pair = m_pendingSoftBodyCollisions[i];
 		if (pair.m_body0->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) {
 			dgCollisionLumpedMassParticles* const lumpedMassShape = (dgCollisionLumpedMassParticles*)pair.m_body0->m_collision->GetChildShape();
@@ -1515,7 +1643,6 @@ void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const desc
 			lumpedMassShape->RegisterCollision(pair.m_body0);
 		}
 	}
-*/
 }
 
 void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID)
@@ -1529,7 +1656,9 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 
 	const dgInt32 contactCount = contactList.m_contactCount;
 	dgContact** const contactArray = &contactList[0];
+	const dgInt32 deferWakeUp = m_world->m_deterministicMode;
 
+	dgInt32 contactPointsCount = 0;
 	dgVector deltaTime(timestep);
 	for (dgInt32 i = threadID; i < contactCount; i += threadCount) {
 		dgContact* const contact = contactArray[i];
@@ -1584,6 +1713,17 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 			}
 
 			if (isActive ^ contact->m_isActive) {
+				if (body0->m_isTrigger | body1->m_isTrigger) {
+					AddTriggerEvent(contact, contact->m_isActive ? true : false);
+				} else if (m_world->m_bufferContactEvents) {
+					m_world->AddContactEvent(contact, contact->m_isActive ? dgContactEvent::m_begin : dgContactEvent::m_end, threadID);
+				}
+			}
+
+			if (deferWakeUp) {
+				// other threads read the equilibrium flags in this loop, wake the bodies after the loop is done
+				contact->m_activeStateChanged = isActive ^ contact->m_isActive;
+			} else if (isActive ^ contact->m_isActive) {
 				if (body0->GetInvMass().m_w) {
 					body0->m_equilibrium = false;
 				}
@@ -1598,7 +1738,9 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 
 		//contact->m_killContact = contact->m_killContact | (body0->m_equilibrium & body1->m_equilibrium & !(contact->m_maxDOF && contact->m_isActive));
 		contact->m_killContact = contact->m_killContact | (body0->m_equilibrium & body1->m_equilibrium & !contact->m_isActive);
+		contactPointsCount += contact->m_isActive ? contact->GetCount() : 0;
 	}
+	dgAtomicExchangeAndAdd(&descriptor->m_atomicContactPointsCount, contactPointsCount);
 }
 
 bool dgBroadPhase::SanityCheck() const
@@ -1653,6 +1795,11 @@ void dgBroadPhase::AttachNewContact(dgInt32 startCount)
 	}
 
 	dgContact** const contactArray = &contactList[0];
+	if (m_world->GetDeterministicMode()) {
+		// new contacts are pushed by the worker threads in arbitrary order, sort them 
+		// by body ids so that the contact list and the body joint lists do not depend on the thread count
+		dgSort(&contactArray[startCount], contactList.m_contactCount - startCount, CompareContacts);
+	}
 	for (dgInt32 i = contactList.m_contactCount - 1; i >= startCount; i--) {
 		dgContact* const contact = contactArray[i];
 		if (m_contactCache.AddContactJoint(contact)) {
@@ -1666,6 +1813,27 @@ void dgBroadPhase::AttachNewContact(dgInt32 startCount)
 	dgAssert(SanityCheck());
 }
 
+void dgBroadPhase::WakeUpChangedContacts()
+{
+	DG_TRACKTIME();
+	dgContactList& contactList = *m_world;
+	dgContact** const contactArray = &contactList[0];
+	for (dgInt32 i = contactList.m_contactCount - 1; i >= 0; i--) {
+		dgContact* const contact = contactArray[i];
+		if (contact->m_activeStateChanged) {
+			dgBody* const body0 = contact->GetBody0();
+			dgBody* const body1 = contact->GetBody1();
+			if (body0->GetInvMass().m_w) {
+				body0->m_equilibrium = false;
+			}
+			if (body1->GetInvMass().m_w) {
+				body1->m_equilibrium = false;
+			}
+			contact->m_activeStateChanged = 0;
+		}
+	}
+}
+
 void dgBroadPhase::DeleteDeadContact()
 {
 	DG_TRACKTIME();
@@ -1676,6 +1844,17 @@ void dgBroadPhase::DeleteDeadContact()
 	for (dgInt32 i = contactList.m_contactCount - 1; i >= 0; i--) {
 		dgContact* const contact = contactArray[i];
 		if (contact->m_killContact) {
+			if (contact->m_isActive) {
+				const dgBody* const body0 = contact->GetBody0();
+				const dgBody* const body1 = contact->GetBody1();
+				if (body0->m_isTrigger | body1->m_isTrigger) {
+					// the guest leaves the trigger when its active pair is deleted, the contact kernels are done by now
+					AddTriggerEvent(contact, false);
+				} else if (m_world->m_bufferContactEvents) {
+					// dead contacts are never deleted inside the contact kernels, the first buffer is free to use
+					m_world->AddContactEvent(contact, dgContactEvent::m_end, 0);
+				}
+			}
 			m_contactCache.RemoveContactJoint(contact);
 			m_world->RemoveContact(contact);
 			contactList.m_contactCount--;
@@ -1700,6 +1879,8 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	const dgInt32 threadsCount = m_world->GetThreadCount();
 
 	const dgBodyMasterList* const masterList = m_world;
+	dgWorldStepStats& stepStats = m_world->m_currentStepStats;
+	const dgUnsigned64 broadphaseTime = dgGetTimeInMicrosenconds();
 
 	m_world->m_bodiesMemory.ResizeIfNecessary(masterList->GetCount());
 	dgBroadphaseSyncDescriptor syncPoints(timestep, m_world);
@@ -1711,6 +1892,11 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	}
 	m_world->SynchronizationBarrier();
 
+	// trigger overlap changes since the last update, sorted by trigger and guest so that listeners can merge them
+	if (m_triggerEventsCount > 1) {
+		dgSort(&m_triggerEvents[0], m_triggerEventsCount, CompareTriggerEvents);
+	}
+
 	// update pre-listeners after the force and torque are applied
 	if (m_world->m_listeners.GetCount()) {
 		for (dgWorld::dgListenerList::dgListNode* node1 = m_world->m_listeners.GetFirst(); node1; node1 = node1->GetNext()) {
@@ -1720,6 +1906,7 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 			}
 		}
 	}
+	m_triggerEventsCount = 0;
 
 	// check for sleeping bodies states
 	node = masterList->GetFirst()->GetNext();
@@ -1739,6 +1926,9 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 
 	UpdateFitness();
 
+	const dgUnsigned64 pairsTime = dgGetTimeInMicrosenconds();
+	stepStats.m_broadphaseTime += dgUnsigned32 (pairsTime - broadphaseTime);
+
 	dgContactList& contactList = *m_world;
 	contactList.m_contactCountReset = contactList.m_contactCount;
 	syncPoints.m_contactStart = contactList.m_contactCount;
@@ -1752,17 +1942,22 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	m_world->SynchronizationBarrier();
 
 	AttachNewContact(syncPoints.m_contactStart);
+
+	const dgUnsigned64 contactsTime = dgGetTimeInMicrosenconds();
+	stepStats.m_pairsTime += dgUnsigned32 (contactsTime - pairsTime);
+
 	for (dgInt32 i = 0; i < threadsCount; i++) {
 		m_world->QueueJob(UpdateRigidBodyContactKernel, &syncPoints, NULL, "dgBroadPhase::UpdateRigidBodyContact");
 	}
 	m_world->SynchronizationBarrier();
 
+	if (m_world->m_deterministicMode) {
+		WakeUpChangedContacts();
+	}
+
 	if (m_pendingSoftBodyPairsCount) {
-		dgAssert (0);
-		//for (dgInt32 i = 0; i < threadsCount; i++) {
-		//	m_world->QueueJob(UpdateSoftBodyContactKernel, &syncPoints, contactListNode, "dgBroadPhase::UpdateSoftBodyContact");
-		//}
-		//m_world->SynchronizationBarrier();
+		// registering the pairs is cheap, the particles collisions run later with the soft body integration 
+		UpdateSoftBodyContacts(&syncPoints, timestep, 0);
 	}
 
 	//	m_recursiveChunks = false;
@@ -1783,4 +1978,9 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	}
 
 	DeleteDeadContact();
+
+	stepStats.m_contactsTime += dgUnsigned32 (dgGetTimeInMicrosenconds() - contactsTime);
+	stepStats.m_pairCount = contactList.m_contactCount;
+	stepStats.m_contactCount = syncPoints.m_atomicContactPointsCount;
+	stepStats.m_sleepingBodyCount = syncPoints.m_atomicSleepingBodiesCount;
 }
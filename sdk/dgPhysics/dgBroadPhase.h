@@ -408,6 +408,8 @@ class dgBroadPhase
 			,m_contactStart(0)
 			,m_atomicDynamicsCount(0)
 			,m_atomicPendingBodiesCount(0)
+			,m_atomicSleepingBodiesCount(0)
+			,m_atomicContactPointsCount(0)
 			,m_fullScan(false)
 		{
 		}
@@ -418,6 +420,8 @@ class dgBroadPhase
 		dgInt32 m_contactStart;
 		dgInt32 m_atomicDynamicsCount;
 		dgInt32 m_atomicPendingBodiesCount;
+		dgInt32 m_atomicSleepingBodiesCount;
+		dgInt32 m_atomicContactPointsCount;
 		bool m_fullScan;
 	};
 	
@@ -464,6 +468,17 @@ class dgBroadPhase
 		dgInt32 m_flipContacts : 1;
 	};
 
+	class dgTriggerEvent
+	{
+		public:
+		dgBody* m_trigger;
+		dgBody* m_guest;
+		dgInt32 m_triggerId;
+		dgInt32 m_guestId;
+		dgInt32 m_sequence;
+		dgInt32 m_enter;
+	};
+
 	dgBroadPhase(dgWorld* const world);
 	virtual ~dgBroadPhase();
 
@@ -500,6 +515,9 @@ class dgBroadPhase
 	virtual dgInt32 ConvexCast (dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const = 0;
 	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID) = 0;
 
+	dgInt32 ConvexCastBodies(dgBody** const bodies, dgInt32 bodyCount, dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+
+	dgInt32 CollideBodies(dgBody** const bodies, dgInt32 bodyCount, dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
 	void UpdateBody(dgBody* const body, dgInt32 threadIndex);
 	void AddInternallyGeneratedBody(dgBody* const body)
 	{
@@ -509,6 +527,10 @@ class dgBroadPhase
 	void UpdateContacts(dgFloat32 timestep);
 	void CollisionChange (dgBody* const body, dgCollisionInstance* const collisionSrc);
 
+	void AddTriggerEvent(const dgContact* const contact, bool enter);
+	dgInt32 GetTriggerEventsCount() const { return m_triggerEventsCount; }
+	const dgTriggerEvent* GetTriggerEvents() const { return &m_triggerEvents[0]; }
+
 	void MoveNodes (dgBroadPhase* const dest);
 
 	protected:
@@ -557,6 +579,7 @@ class dgBroadPhase
 	bool SanityCheck() const;
 	void DeleteDeadContact();
 	void AttachNewContact(dgInt32 startCount);
+	void WakeUpChangedContacts();
 
 	DG_INLINE bool ValidateContactCache(dgContact* const contact, const dgVector& timestep) const;
 		
@@ -566,8 +589,9 @@ class dgBroadPhase
 	static void UpdateAggregateEntropyKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void AddGeneratedBodiesContactsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void UpdateRigidBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
-	static void UpdateSoftBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static dgInt32 CompareNodes(const dgBroadPhaseNode* const nodeA, const dgBroadPhaseNode* const nodeB, void* const notUsed);
+	static dgInt32 CompareContacts(dgContact* const* const contactA, dgContact* const* const contactB, void* const notUsed);
+	static dgInt32 CompareTriggerEvents(const dgTriggerEvent* const eventA, const dgTriggerEvent* const eventB, void* const notUsed);
 
 	class dgPendingCollisionSoftBodies
 	{
@@ -585,6 +609,8 @@ class dgBroadPhase
 	dgContactCache m_contactCache;
 	dgArray<dgPendingCollisionSoftBodies> m_pendingSoftBodyCollisions;
 	dgInt32 m_pendingSoftBodyPairsCount;
+	dgArray<dgTriggerEvent> m_triggerEvents;
+	dgInt32 m_triggerEventsCount;
 	dgInt32 m_criticalSectionLock;
 
 	static dgVector m_velocTol;
@@ -643,6 +643,7 @@ dgCollisionCompoundFractured::dgDebriNodeInfo::dgDebriNodeInfo ()
 	:m_mesh(NULL)
 	,m_shapeNode(NULL)
 	,m_lru(0)
+	,m_poolIndex(-1)
 {
 }
 
@@ -872,11 +873,20 @@ dgCollisionCompoundFractured::dgCollisionCompoundFractured (const dgCollisionCom
 	,m_conectivity(source.m_conectivity)
 	,m_conectivityMap (source.m_conectivityMap)
 	,m_vertexBuffer(source.m_vertexBuffer)
+	,m_pooledChunks(source.GetAllocator())
+	,m_pooledSegments(source.GetAllocator())
+	,m_pooledMainSubMeshes(source.GetAllocator())
+	,m_pooledNeighbors(source.GetAllocator())
+	,m_pooledIndexes(source.GetAllocator())
+	,m_pooledBodies(source.GetAllocator())
 	,m_impulseStrengthPerUnitMass(source.m_impulseStrengthPerUnitMass)
 	,m_impulseAbsortionFactor(source.m_impulseAbsortionFactor)
 	,m_density(dgFloat32 (-1.0f))
 	,m_lru(0)
 	,m_materialCount(source.m_materialCount)
+	,m_pooledChunkCount(0)
+	,m_pooledBodyCount(0)
+	,m_precooked(source.m_precooked)
 	,m_emitFracturedChunk(source.m_emitFracturedChunk)
 	,m_emitFracturedCompound(source.m_emitFracturedCompound)
 	,m_reconstructMainMesh(source.m_reconstructMainMesh)
@@ -911,6 +921,9 @@ dgCollisionCompoundFractured::dgCollisionCompoundFractured (const dgCollisionCom
 
 	BuildMainMeshSubMehes();
 	m_conectivityMap.Pupolate(m_conectivity);
+	if (m_precooked) {
+		CookChunkPool();
+	}
 
 	m_density = -dgFloat32 (1.0f) / GetVolume();
 	dgAssert (SanityCheck());
@@ -921,11 +934,20 @@ dgCollisionCompoundFractured::dgCollisionCompoundFractured (dgCollisionCompoundF
 	,m_conectivity(source.GetAllocator())
 	,m_conectivityMap (source.GetAllocator())
 	,m_vertexBuffer(source.m_vertexBuffer)
+	,m_pooledChunks(source.GetAllocator())
+	,m_pooledSegments(source.GetAllocator())
+	,m_pooledMainSubMeshes(source.GetAllocator())
+	,m_pooledNeighbors(source.GetAllocator())
+	,m_pooledIndexes(source.GetAllocator())
+	,m_pooledBodies(source.GetAllocator())
 	,m_impulseStrengthPerUnitMass(source.m_impulseStrengthPerUnitMass)
 	,m_impulseAbsortionFactor(source.m_impulseAbsortionFactor)
 	,m_density(source.m_density)
 	,m_lru(0)
 	,m_materialCount(source.m_materialCount)
+	,m_pooledChunkCount(0)
+	,m_pooledBodyCount(0)
+	,m_precooked(source.m_precooked)
 	,m_emitFracturedChunk(source.m_emitFracturedChunk)
 	,m_emitFracturedCompound(source.m_emitFracturedCompound)
 	,m_reconstructMainMesh(source.m_reconstructMainMesh)
@@ -946,6 +968,10 @@ dgCollisionCompoundFractured::dgCollisionCompoundFractured (dgCollisionCompoundF
 		source.m_conectivityMap.Remove (chunkCollision);
 		source.dgCollisionCompound::RemoveCollision (nodeInfo.m_shapeNode);
 		source.m_conectivity.Unlink(chunkNode);
+		if (source.m_pooledChunkCount && (nodeInfo.m_poolIndex >= 0)) {
+			source.m_pooledChunks[nodeInfo.m_poolIndex].m_active = false;
+		}
+		nodeInfo.m_poolIndex = -1;
 
 		m_conectivity.Append(chunkNode);
 		nodeInfo.m_shapeNode = treeNode;
@@ -959,6 +985,9 @@ dgCollisionCompoundFractured::dgCollisionCompoundFractured (dgCollisionCompoundF
 
 	BuildMainMeshSubMehes();
 	m_conectivityMap.Pupolate(m_conectivity);
+	if (m_precooked) {
+		CookChunkPool();
+	}
 
 	m_density = -dgFloat32 (1.0f) / GetVolume();
 	dgAssert (SanityCheck());
@@ -968,6 +997,15 @@ dgCollisionCompoundFractured::dgCollisionCompoundFractured (dgWorld* const world
 	:dgCollisionCompound (world, deserialization, userData, myInstance, revisionNumber)
 	,m_conectivity (world->GetAllocator())
 	,m_conectivityMap (world->GetAllocator())
+	,m_pooledChunks(world->GetAllocator())
+	,m_pooledSegments(world->GetAllocator())
+	,m_pooledMainSubMeshes(world->GetAllocator())
+	,m_pooledNeighbors(world->GetAllocator())
+	,m_pooledIndexes(world->GetAllocator())
+	,m_pooledBodies(world->GetAllocator())
+	,m_pooledChunkCount(0)
+	,m_pooledBodyCount(0)
+	,m_precooked(false)
 {
 	m_conectivity.Deserialize(this, deserialization, userData);
 	m_vertexBuffer = new (m_world->GetAllocator()) dgVertexBuffer(m_world->GetAllocator(), deserialization, userData);
@@ -986,11 +1024,20 @@ dgCollisionCompoundFractured::dgCollisionCompoundFractured (
 	,m_conectivity(world->GetAllocator())
 	,m_conectivityMap (world->GetAllocator())
 	,m_vertexBuffer(NULL)
+	,m_pooledChunks(world->GetAllocator())
+	,m_pooledSegments(world->GetAllocator())
+	,m_pooledMainSubMeshes(world->GetAllocator())
+	,m_pooledNeighbors(world->GetAllocator())
+	,m_pooledIndexes(world->GetAllocator())
+	,m_pooledBodies(world->GetAllocator())
 	,m_impulseStrengthPerUnitMass(10.0f)
 	,m_impulseAbsortionFactor(0.5f)
 	,m_density(dgFloat32 (-1.0f))
 	,m_lru(0)
 	,m_materialCount(0)
+	,m_pooledChunkCount(0)
+	,m_pooledBodyCount(0)
+	,m_precooked(false)
 	,m_emitFracturedChunk(emitFracturedChunk) 
 	,m_emitFracturedCompound(emitNewCompoundFactured)
 	,m_reconstructMainMesh(reconstructMainMesh)
@@ -1109,6 +1156,11 @@ void dgCollisionCompoundFractured::SetCallbacks(OnEmitFractureChunkCallBack emit
 
 void dgCollisionCompoundFractured::BuildMainMeshSubMehes() const
 {
+	if (m_pooledChunkCount) {
+		BuildPooledMainMeshSubMehes();
+		return;
+	}
+
 	dgConectivityGraph::dgListNode* const mainNode = m_conectivity.GetLast();
 	dgMesh* const mainMesh = mainNode->GetInfo().m_nodeData.m_mesh;
 
@@ -1163,6 +1215,237 @@ void dgCollisionCompoundFractured::BuildMainMeshSubMehes() const
 	}
 }
 
+void dgCollisionCompoundFractured::CookChunkPool()
+{
+	dgConectivityGraph::dgListNode* const mainNode = m_conectivity.GetLast();
+
+	// count and enumerate chunks, the main mesh node is always the last
+	dgInt32 chunkCount = 0;
+	dgInt32 segmentCount = 0;
+	dgInt32 neighborCount = 0;
+	dgInt32 indexCount = 0;
+	for (dgConectivityGraph::dgListNode* node = m_conectivity.GetFirst(); node != mainNode; node = node->GetNext()) {
+		dgDebriNodeInfo& data = node->GetInfo().m_nodeData;
+		data.m_poolIndex = chunkCount;
+		chunkCount ++;
+		neighborCount += node->GetInfo().GetCount();
+		for (dgMesh::dgListNode* meshSegment = data.m_mesh->GetFirst(); meshSegment; meshSegment = meshSegment->GetNext()) {
+			indexCount += 3 * meshSegment->GetInfo().m_faceCount;
+			segmentCount ++;
+		}
+	}
+
+	m_pooledChunks.Resize(chunkCount + 1);
+	m_pooledSegments.Resize(segmentCount + 1);
+	m_pooledNeighbors.Resize(neighborCount + 1);
+	m_pooledIndexes.Resize(indexCount + 1);
+	m_pooledMainSubMeshes.Resize(m_materialCount + 1);
+
+	dgInt32 materials[DG_FRACTURE_MAX_METERIAL_COUNT];
+	dgInt32 faceCapacity[DG_FRACTURE_MAX_METERIAL_COUNT];
+	memset (faceCapacity, 0, m_materialCount * sizeof (dgInt32));
+
+	// lay out the chunks in flat arrays, with the index buffers already rebased to the shared vertex buffer
+	segmentCount = 0;
+	neighborCount = 0;
+	indexCount = 0;
+	m_pooledChunkCount = 0;
+	for (dgConectivityGraph::dgListNode* node = m_conectivity.GetFirst(); node != mainNode; node = node->GetNext()) {
+		dgDebriNodeInfo& data = node->GetInfo().m_nodeData;
+		dgPooledChunk& chunk = m_pooledChunks[m_pooledChunkCount];
+		chunk.m_node = node;
+		chunk.m_active = true;
+		chunk.m_segmentStart = segmentCount;
+		chunk.m_neighborStart = neighborCount;
+
+		const dgInt32 vertexOffsetStart = data.m_mesh->m_vertexOffsetStart;
+		for (dgMesh::dgListNode* meshSegment = data.m_mesh->GetFirst(); meshSegment; meshSegment = meshSegment->GetNext()) {
+			dgSubMesh* const subMesh = &meshSegment->GetInfo();
+			const dgInt32 count = 3 * subMesh->m_faceCount;
+			dgPooledSegment& segment = m_pooledSegments[segmentCount];
+			segment.m_subMesh = subMesh;
+			segment.m_indexStart = indexCount;
+			segment.m_indexCount = count;
+			segment.m_materialOrdinal = subMesh->m_materialOrdinal;
+
+			dgInt32* const indexes = &m_pooledIndexes[indexCount];
+			for (dgInt32 i = 0; i < count; i ++) {
+				indexes[i] = subMesh->m_indexes[i] + vertexOffsetStart;
+			}
+
+			faceCapacity[subMesh->m_materialOrdinal] += subMesh->m_faceCount;
+			materials[subMesh->m_materialOrdinal] = subMesh->m_material;
+			indexCount += count;
+			segmentCount ++;
+		}
+		chunk.m_segmentCount = segmentCount - chunk.m_segmentStart;
+
+		for (dgGraphNode<dgDebriNodeInfo, dgSharedNodeMesh>::dgListNode* edgeNode = node->GetInfo().GetFirst(); edgeNode; edgeNode = edgeNode->GetNext()) {
+			m_pooledNeighbors[neighborCount] = edgeNode->GetInfo().m_node->GetInfo().m_nodeData.m_poolIndex;
+			neighborCount ++;
+		}
+		chunk.m_neighborCount = neighborCount - chunk.m_neighborStart;
+		m_pooledChunkCount ++;
+	}
+
+	// allocate the main mesh once, large enough to hold every face the compound can ever expose
+	dgMesh* const mainMesh = mainNode->GetInfo().m_nodeData.m_mesh;
+	mainMesh->RemoveAll();
+	mainMesh->m_vertexCount = m_vertexBuffer->m_vertexCount;
+	for (dgInt32 i = 0; i < m_materialCount; i ++) {
+		m_pooledMainSubMeshes[i] = faceCapacity[i] ? mainMesh->AddgSubMesh (faceCapacity[i] * 3, materials[i]) : NULL;
+	}
+
+	BuildPooledMainMeshSubMehes();
+}
+
+void dgCollisionCompoundFractured::BuildPooledMainMeshSubMehes() const
+{
+	dgInt32 faceIndexIndexOffset[DG_FRACTURE_MAX_METERIAL_COUNT];
+	memset (faceIndexIndexOffset, 0, m_materialCount * sizeof (dgInt32));
+
+	const dgPooledChunk* const chunks = &m_pooledChunks[0];
+	const dgPooledSegment* const segments = &m_pooledSegments[0];
+	const dgInt32* const indexes = &m_pooledIndexes[0];
+	for (dgInt32 i = 0; i < m_pooledChunkCount; i ++) {
+		const dgPooledChunk& chunk = chunks[i];
+		if (chunk.m_active) {
+			for (dgInt32 j = 0; j < chunk.m_segmentCount; j ++) {
+				const dgPooledSegment& segment = segments[chunk.m_segmentStart + j];
+				if (segment.m_subMesh->m_visibleFaces) {
+					const dgInt32 index = segment.m_materialOrdinal;
+					dgSubMesh* const mainSubMesh = m_pooledMainSubMeshes[index];
+					memcpy (&mainSubMesh->m_indexes[faceIndexIndexOffset[index]], &indexes[segment.m_indexStart], segment.m_indexCount * sizeof (dgInt32));
+					faceIndexIndexOffset[index] += segment.m_indexCount;
+				}
+			}
+		}
+	}
+
+	for (dgInt32 i = 0; i < m_materialCount; i ++) {
+		dgSubMesh* const mainSubMesh = m_pooledMainSubMeshes[i];
+		if (mainSubMesh) {
+			mainSubMesh->m_faceCount = faceIndexIndexOffset[i] / 3;
+		}
+	}
+}
+
+void dgCollisionCompoundFractured::DeactivateChunk (dgConectivityGraph::dgListNode* const chunkNode)
+{
+	dgDebriNodeInfo& nodeInfo = chunkNode->GetInfo().m_nodeData;
+	if (m_pooledChunkCount && (nodeInfo.m_poolIndex >= 0)) {
+		dgPooledChunk& chunk = m_pooledChunks[nodeInfo.m_poolIndex];
+		chunk.m_active = false;
+		for (dgInt32 i = 0; i < chunk.m_neighborCount; i ++) {
+			const dgPooledChunk& neighbor = m_pooledChunks[m_pooledNeighbors[chunk.m_neighborStart + i]];
+			if (neighbor.m_active) {
+				neighbor.m_node->GetInfo().m_nodeData.m_mesh->m_isVisible = true;
+				for (dgInt32 j = 0; j < neighbor.m_segmentCount; j ++) {
+					m_pooledSegments[neighbor.m_segmentStart + j].m_subMesh->m_visibleFaces = true;
+				}
+			}
+		}
+	} else {
+		for (dgGraphNode<dgDebriNodeInfo, dgSharedNodeMesh>::dgListNode* edgeNode = chunkNode->GetInfo().GetFirst(); edgeNode; edgeNode = edgeNode->GetNext()) {
+			dgConectivityGraph::dgListNode* const node1 = edgeNode->GetInfo().m_node;
+			dgDebriNodeInfo& childNodeInfo = node1->GetInfo().m_nodeData;
+			childNodeInfo.m_mesh->m_isVisible = true;
+			for (dgMesh::dgListNode* meshSegment = childNodeInfo.m_mesh->GetFirst(); meshSegment; meshSegment = meshSegment->GetNext()) {
+				dgSubMesh* const subMesh = &meshSegment->GetInfo();
+				subMesh->m_visibleFaces = true;
+			}
+		}
+	}
+}
+
+bool dgCollisionCompoundFractured::GetPrecooked() const
+{
+	return m_precooked;
+}
+
+void dgCollisionCompoundFractured::SetPrecooked(bool state)
+{
+	if (state != m_precooked) {
+		m_precooked = state;
+		if (m_precooked) {
+			CookChunkPool();
+		} else {
+			for (dgConectivityGraph::dgListNode* node = m_conectivity.GetFirst(); node; node = node->GetNext()) {
+				node->GetInfo().m_nodeData.m_poolIndex = -1;
+			}
+			m_pooledChunkCount = 0;
+			m_pooledChunks.Clear();
+			m_pooledSegments.Clear();
+			m_pooledNeighbors.Clear();
+			m_pooledIndexes.Clear();
+			m_pooledMainSubMeshes.Clear();
+			BuildMainMeshSubMehes();
+		}
+	}
+}
+
+// the bodies in the pool are consumed from the back, each one should be a disabled dynamic body
+void dgCollisionCompoundFractured::SetBodyPool (dgBody** const bodies, dgInt32 count)
+{
+	m_pooledBodyCount = 0;
+	m_pooledBodies.Resize(count + 1);
+	for (dgInt32 i = 0; i < count; i ++) {
+		m_pooledBodies[m_pooledBodyCount] = bodies[i];
+		m_pooledBodyCount += bodies[i] ? 1 : 0;
+	}
+}
+
+dgInt32 dgCollisionCompoundFractured::GetBodyPoolCount () const
+{
+	return m_pooledBodyCount;
+}
+
+dgBody* dgCollisionCompoundFractured::PopPooledBody ()
+{
+	if (m_pooledBodyCount) {
+		m_pooledBodyCount --;
+		return m_pooledBodies[m_pooledBodyCount];
+	}
+	return NULL;
+}
+
+dgInt32 dgCollisionCompoundFractured::DetachChunks (dgBody* const myBody, dgTreeArray::dgTreeNode** const nodes, dgBody** const pooledBodies, dgInt32 count)
+{
+	const dgCollisionInstance* const myInstance = myBody->GetCollision();
+	dgAssert (myInstance->GetChildShape() == this);
+
+	dgVector massMatrix (myBody->GetMass());
+	if (m_density < dgFloat32 (0.0f)) {
+		m_density = dgAbs (massMatrix.m_w * m_density);
+	}
+
+	dgInt32 detachedCount = 0;
+	dgCollisionCompound::BeginAddRemove ();
+	for (dgInt32 i = 0; i < count; i ++) {
+		dgConectivityGraphMap::dgTreeNode* const mapNode = m_conectivityMap.Find(nodes[i]->GetInfo()->GetShape());
+		if (mapNode) {
+			SpawnSingleChunk (myBody, myInstance, mapNode->GetInfo(), pooledBodies ? pooledBodies[detachedCount] : PopPooledBody());
+			detachedCount ++;
+		}
+	}
+	dgCollisionCompound::EndAddRemove ();
+
+	if (detachedCount) {
+		// one main mesh rebuild and one mass update for the entire batch
+		BuildMainMeshSubMehes();
+		if (m_reconstructMainMesh) {
+			m_reconstructMainMesh (myBody, m_conectivity.GetLast(), myInstance);
+		}
+		if (m_root) {
+			dgFloat32 mass = m_centerOfMass.m_w * m_density;
+			myBody->SetMassProperties(mass, myInstance);
+		} else {
+			myBody->SetMassProperties(dgFloat32 (0.0f), myInstance);
+		}
+	}
+	return detachedCount;
+}
+
 bool dgCollisionCompoundFractured::SanityCheck() const
 {
 	for (dgConectivityGraph::dgListNode* rootNode = m_conectivity.GetFirst(); rootNode; rootNode = rootNode->GetNext() ) {
@@ -1336,16 +1619,7 @@ void dgCollisionCompoundFractured::RemoveCollision (dgTreeArray::dgTreeNode* con
 	dgAssert (mapNode);
 
 	dgConectivityGraph::dgListNode* const chunkNode = mapNode->GetInfo();
-
-	for (dgGraphNode<dgDebriNodeInfo, dgSharedNodeMesh>::dgListNode* edgeNode = chunkNode->GetInfo().GetFirst(); edgeNode; edgeNode = edgeNode->GetNext()) {
-		dgConectivityGraph::dgListNode* const node1 = edgeNode->GetInfo().m_node;
-		dgDebriNodeInfo& childNodeInfo = node1->GetInfo().m_nodeData;
-		childNodeInfo.m_mesh->m_isVisible = true;
-		for (dgMesh::dgListNode* meshSegment = childNodeInfo.m_mesh->GetFirst(); meshSegment; meshSegment = meshSegment->GetNext()) {
-			dgSubMesh* const subMesh = &meshSegment->GetInfo();
-			subMesh->m_visibleFaces = true;
-		}
-	}
+	DeactivateChunk (chunkNode);
 
 	dgDebriNodeInfo& nodeInfo = chunkNode->GetInfo().m_nodeData;
 	dgCollisionInstance* const chunkCollision = nodeInfo.m_shapeNode->GetInfo()->GetShape();
@@ -1613,7 +1887,8 @@ bool dgCollisionCompoundFractured::SpawnChunks (dgBody* const myBody, const dgCo
 					dgAssert (stack < sizeof (pool)/sizeof (pool[0]));
 				}
 			}
-			SpawnSingleChunk (myBody, myInstance, chunkNode);
+			dgDynamicBody* const chunkBody = SpawnSingleChunk (myBody, myInstance, chunkNode, PopPooledBody());
+			m_world->GetBroadPhase()->AddInternallyGeneratedBody(chunkBody);
 		}
 	}
 	return spawned;
@@ -1658,7 +1933,8 @@ void dgCollisionCompoundFractured::SpawnDisjointChunks (dgBody* const myBody, co
 			dgDebriNodeInfo& nodeInfo = node->GetInfo().m_nodeData;
 			if (nodeInfo.m_lru != m_lru) {
 				if (node->GetInfo().GetCount() == 0) {
-					SpawnSingleChunk (myBody, myInstance, node);
+					dgDynamicBody* const chunkBody = SpawnSingleChunk (myBody, myInstance, node, PopPooledBody());
+					m_world->GetBroadPhase()->AddInternallyGeneratedBody(chunkBody);
 				} else {
 					do {
 						nextNode = nextNode->GetPrev();
@@ -1673,7 +1949,7 @@ void dgCollisionCompoundFractured::SpawnDisjointChunks (dgBody* const myBody, co
 }
 
 
-void dgCollisionCompoundFractured::SpawnSingleChunk (dgBody* const myBody, const dgCollisionInstance* const myInstance, dgConectivityGraph::dgListNode* const chunkNode)
+dgDynamicBody* dgCollisionCompoundFractured::SpawnSingleChunk (dgBody* const myBody, const dgCollisionInstance* const myInstance, dgConectivityGraph::dgListNode* const chunkNode, dgBody* const pooledBody)
 {
 	const dgMatrix& matrix = myBody->GetMatrix();
 	const dgVector& veloc = myBody->GetVelocity();
@@ -1682,9 +1958,18 @@ void dgCollisionCompoundFractured::SpawnSingleChunk (dgBody* const myBody, const
 
 	dgDebriNodeInfo& nodeInfo = chunkNode->GetInfo().m_nodeData;
 	dgCollisionInstance* const chunkCollision = nodeInfo.m_shapeNode->GetInfo()->GetShape();
-	dgDynamicBody* const chunkBody = m_world->CreateDynamicBody (chunkCollision, matrix);
+
+	// a pooled body must be a disabled dynamic body with a non null shape, otherwise make a new one
+	dgDynamicBody* chunkBody = NULL;
+	if (pooledBody && pooledBody->IsRTTIType(dgBody::m_dynamicBodyRTTI) && !m_world->GetBodyEnableDisableSimulationState(pooledBody) && !pooledBody->GetCollision()->IsType(dgCollision::dgCollisionNull_RTTI)) {
+		chunkBody = (dgDynamicBody*) pooledBody;
+		chunkBody->AttachCollision (chunkCollision);
+		chunkBody->SetMatrix (matrix);
+		m_world->BodyEnableSimulation (chunkBody);
+	} else {
+		chunkBody = m_world->CreateDynamicBody (chunkCollision, matrix);
+	}
 	chunkBody->SetMassProperties(chunkCollision->GetVolume() * m_density, chunkBody->GetCollision());
-	m_world->GetBroadPhase()->AddInternallyGeneratedBody(chunkBody);
 
 	// calculate debris initial velocity
 	dgVector chunkOrigin (matrix.TransformVector(chunkCollision->GetLocalMatrix().m_posit));
@@ -1694,11 +1979,15 @@ void dgCollisionCompoundFractured::SpawnSingleChunk (dgBody* const myBody, const
 	chunkBody->SetVelocity(chunkVeloc);
 	chunkBody->SetGroupID(chunkCollision->GetUserDataID());
 
-	m_emitFracturedChunk(chunkBody, chunkNode, myInstance);
+	if (m_emitFracturedChunk) {
+		m_emitFracturedChunk(chunkBody, chunkNode, myInstance);
+	}
 
+	DeactivateChunk (chunkNode);
 	m_conectivityMap.Remove (chunkCollision);
 	dgCollisionCompound::RemoveCollision (nodeInfo.m_shapeNode);
 	m_conectivity.DeleteNode(chunkNode);
+	return chunkBody;
 }
 
 void dgCollisionCompoundFractured::SpawnComplexChunk (dgBody* const myBody, const dgCollisionInstance* const parentInstance, dgConectivityGraph::dgListNode* const chunkNode)
@@ -26,6 +26,7 @@
 
 
 class dgMeshEffect;
+class dgDynamicBody;
 
 
 
@@ -111,6 +112,7 @@ class dgCollisionCompoundFractured: public dgCollisionCompound
 		dgMesh* m_mesh;
 		dgTreeArray::dgTreeNode* m_shapeNode;
 		dgInt32 m_lru;
+		dgInt32 m_poolIndex;
 	};
 
 
@@ -156,6 +158,27 @@ class dgCollisionCompoundFractured: public dgCollisionCompound
 		}
 	};
 
+	// pre cooked chunk data, index ranges are already rebased to the shared vertex buffer
+	class dgPooledSegment
+	{
+		public:
+		dgSubMesh* m_subMesh;
+		dgInt32 m_indexStart;
+		dgInt32 m_indexCount;
+		dgInt32 m_materialOrdinal;
+	};
+
+	class dgPooledChunk
+	{
+		public:
+		dgConectivityGraph::dgListNode* m_node;
+		dgInt32 m_segmentStart;
+		dgInt32 m_segmentCount;
+		dgInt32 m_neighborStart;
+		dgInt32 m_neighborCount;
+		bool m_active;
+	};
+
 	public:
 	typedef void (*OnEmitNewCompundFractureCallBack) (dgBody* const body);
 	typedef void (*OnEmitFractureChunkCallBack) (dgBody* const body, dgConectivityGraph::dgListNode* const chunkMeshNode, const dgCollisionInstance* const myInstance);
@@ -187,6 +210,12 @@ class dgCollisionCompoundFractured: public dgCollisionCompound
 	void SetImpulsePropgationFactor(dgFloat32 factor);
 	dgFloat32 GetSetImpulsePropgationFactor() const;
 
+	bool GetPrecooked() const;
+	void SetPrecooked(bool state);
+	dgInt32 DetachChunks (dgBody* const myBody, dgTreeArray::dgTreeNode** const nodes, dgBody** const pooledBodies, dgInt32 count);
+	void SetBodyPool (dgBody** const bodies, dgInt32 count);
+	dgInt32 GetBodyPoolCount () const;
+
 	virtual void BeginAddRemove ();
 	virtual void RemoveCollision (dgTreeArray::dgTreeNode* const node);
 	virtual void EndAddRemove (bool flushCache = true);
@@ -197,7 +226,11 @@ class dgCollisionCompoundFractured: public dgCollisionCompound
 	dgCollisionCompoundFractured* PlaneClip (const dgVector& plane);
 
 	private:
+	void CookChunkPool();
 	void BuildMainMeshSubMehes() const;
+	void BuildPooledMainMeshSubMehes() const;
+	void DeactivateChunk (dgConectivityGraph::dgListNode* const chunkNode);
+	dgBody* PopPooledBody ();
 	dgVector GetObbSize() const;
 
 	virtual void Serialize(dgSerialize callback, void* const userData) const;
@@ -208,7 +241,7 @@ class dgCollisionCompoundFractured: public dgCollisionCompound
 	bool SpawnChunks (dgBody* const myBody, const dgCollisionInstance* const myInstance, dgConectivityGraph::dgListNode* const rootNode, dgFloat32 impulseStimate2, dgFloat32 impulseStimateCut2);
 	void SpawnDisjointChunks (dgBody* const myBody, const dgCollisionInstance* const myInstance, dgConectivityGraph::dgListNode* const rootNode, dgFloat32 impulseStimate2, dgFloat32 impulseStimateCut2);
 
-	void SpawnSingleChunk (dgBody* const myBody, const dgCollisionInstance* const myInstance, dgConectivityGraph::dgListNode* const chunkNode);
+	dgDynamicBody* SpawnSingleChunk (dgBody* const myBody, const dgCollisionInstance* const myInstance, dgConectivityGraph::dgListNode* const chunkNode, dgBody* const pooledBody);
 	void SpawnComplexChunk (dgBody* const myBody, const dgCollisionInstance* const myInstance, dgConectivityGraph::dgListNode* const chunkNode);
     bool CanChunk (dgConectivityGraph::dgListNode* const node) const;
 	
@@ -221,11 +254,20 @@ class dgCollisionCompoundFractured: public dgCollisionCompound
 	dgConectivityGraph m_conectivity;
 	dgConectivityGraphMap m_conectivityMap;
 	dgVertexBuffer* m_vertexBuffer;
+	dgArray<dgPooledChunk> m_pooledChunks;
+	dgArray<dgPooledSegment> m_pooledSegments;
+	dgArray<dgSubMesh*> m_pooledMainSubMeshes;
+	dgArray<dgInt32> m_pooledNeighbors;
+	dgArray<dgInt32> m_pooledIndexes;
+	dgArray<dgBody*> m_pooledBodies;
 	dgFloat32 m_impulseStrengthPerUnitMass;
 	dgFloat32 m_impulseAbsortionFactor;
 	dgFloat32 m_density;
 	dgInt32 m_lru;
 	dgInt32 m_materialCount;
+	dgInt32 m_pooledChunkCount;
+	dgInt32 m_pooledBodyCount;
+	bool m_precooked;
 	OnEmitFractureChunkCallBack m_emitFracturedChunk;
 	OnEmitNewCompundFractureCallBack m_emitFracturedCompound;
 	OnReconstructFractureMainMeshCallBack m_reconstructMainMesh;
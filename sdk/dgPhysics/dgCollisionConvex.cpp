@@ -714,7 +714,7 @@ dgInt32 dgCollisionConvex::CalculatePlaneIntersection (const dgVector& normal, c
 	const dgConvexSimplexEdge** const vertToEdgeMapping = GetVertexToEdgeMapping();
 	dgAssert (normal.m_w == dgFloat32 (0.0f));
 	if (vertToEdgeMapping) {
-		dgInt32 edgeIndex;
+		dgInt32 edgeIndex = -1;
 		featureCount = 1;
 		support[0] = SupportVertex (normal, &edgeIndex);
 		edge = vertToEdgeMapping[edgeIndex];
@@ -31,7 +31,9 @@
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-#define DG_CONVEX_VERTEX_CHUNK_SIZE	4
+#define DG_CONVEX_VERTEX_CHUNK_SIZE		4
+#define DG_CONVEX_SOA_VERTEX_COUNT		32
+#define DG_CONVEX_CLIMB_MAX_STEPS		32
 
 DG_MSC_VECTOR_ALIGMENT
 class dgCollisionConvexHull::dgConvexBox
@@ -51,6 +53,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgMemoryAllocator* const allocator,
 	,m_faceArray (NULL)
 	,m_vertexToEdgeMapping(NULL)
 	,m_supportTree (NULL)
+	,m_soaVertex (NULL)
 {
 	m_edgeCount = 0;
 	m_vertexCount = 0;
@@ -66,6 +69,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgMemoryAllocator* const allocator,
 	,m_faceArray (NULL)
 	,m_vertexToEdgeMapping(NULL)
 	,m_supportTree (NULL)
+	,m_soaVertex (NULL)
 {
 	m_edgeCount = 0;
 	m_vertexCount = 0;
@@ -83,6 +87,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgWorld* const world, dgDeserialize
 	,m_faceArray (NULL)
 	,m_vertexToEdgeMapping(NULL)
 	,m_supportTree (NULL)
+	,m_soaVertex (NULL)
 {
 	m_rtti |= dgCollisionConvexHull_RTTI;
 	deserialization (userData, &m_vertexCount, sizeof (dgInt32));
@@ -123,6 +128,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgWorld* const world, dgDeserialize
 		m_vertexToEdgeMapping[i] = m_simplex + faceOffset; 
 	}
 
+	BuildSoaVertexArray ();
 	SetVolumeAndCG ();
 }
 
@@ -138,6 +144,9 @@ dgCollisionConvexHull::~dgCollisionConvexHull()
 	if (m_supportTree) {
 		m_allocator->Free(m_supportTree);
 	}
+	if (m_soaVertex) {
+		m_allocator->Free(m_soaVertex);
+	}
 }
 
 void dgCollisionConvexHull::BuildHull (dgInt32 count, dgInt32 strideInBytes, dgFloat32 tolerance, const dgFloat32* const vertexArray)
@@ -700,10 +709,28 @@ bool dgCollisionConvexHull::Create (dgInt32 count, dgInt32 strideInBytes, const
 		m_vertexToEdgeMapping[edge->m_vertex] = edge;
 	}
 
+	BuildSoaVertexArray ();
 	SetVolumeAndCG ();
 	return true;
 }
 
+// small hulls keep a copy of the vertex array in groups of four (x x x x, y y y y, z z z z), 
+// padded to a multiple of eight with copies of the first vertex, for the brute force support search. 
+void dgCollisionConvexHull::BuildSoaVertexArray ()
+{
+	if ((m_vertexCount > 0) && (m_vertexCount <= DG_CONVEX_SOA_VERTEX_COUNT)) {
+		const dgInt32 groupCount = ((m_vertexCount + 7) & -8) >> 2;
+		m_soaVertex = (dgVector*) m_allocator->Malloc(dgInt32 (3 * groupCount * sizeof (dgVector)));
+		for (dgInt32 i = 0; i < groupCount * 4; i ++) {
+			const dgVector& p = m_vertex[(i < m_vertexCount) ? i : 0];
+			dgVector* const group = &m_soaVertex[(i >> 2) * 3];
+			group[0][i & 3] = p.m_x;
+			group[1][i & 3] = p.m_y;
+			group[2][i & 3] = p.m_z;
+		}
+	}
+}
+
 dgInt32 dgCollisionConvexHull::CalculateSignature (dgInt32 vertexCount, const dgFloat32* const vertexArray, dgInt32 strideInBytes)
 {
 	dgStack<dgUnsigned32> buffer(1 + 3 * vertexCount);  
@@ -760,7 +787,7 @@ void dgCollisionConvexHull::DebugCollision (const dgMatrix& matrix, dgCollision:
 	}
 }
 
-dgVector dgCollisionConvexHull::SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const
+dgInt32 dgCollisionConvexHull::SupportVertexTree (const dgVector& dir) const
 {
 	dgAssert (dir.m_w == dgFloat32 (0.0f));
 	dgInt32 index = -1;
@@ -864,10 +891,105 @@ dgVector dgCollisionConvexHull::SupportVertex (const dgVector& dir, dgInt32* con
 		}
 	}
 
+	dgAssert (index != -1);
+	return index;
+}
+
+// steepest ascent over the vertex adjacency of the hull, a vertex with no better neighbor is the support vertex.
+// from a coherent seed this is one or two steps, if the seed is far the search ends in the support tree.
+dgInt32 dgCollisionConvexHull::SupportVertexClimb (const dgVector& dir, dgInt32 seedIndex) const
+{
+	dgAssert (dir.m_w == dgFloat32 (0.0f));
+	dgInt32 index = seedIndex;
+	dgFloat32 maxProj = m_vertex[index].DotProduct(dir).GetScalar();
+	for (dgInt32 step = 0; step < DG_CONVEX_CLIMB_MAX_STEPS; step ++) {
+		dgInt32 bestIndex = index;
+		const dgConvexSimplexEdge* const edge = m_vertexToEdgeMapping[index];
+		const dgConvexSimplexEdge* ptr = edge;
+		do {
+			const dgInt32 neighbor = ptr->m_twin->m_vertex;
+			const dgFloat32 dist = m_vertex[neighbor].DotProduct(dir).GetScalar();
+			if (dist > maxProj) {
+				maxProj = dist;
+				bestIndex = neighbor;
+			}
+			ptr = ptr->m_twin->m_next;
+		} while (ptr != edge);
+
+		if (bestIndex == index) {
+			return index;
+		}
+		index = bestIndex;
+	}
+	return SupportVertexTree (dir);
+}
+
+// brute force over the vertex groups, eight vertex per iteration in two independent sets of lanes.
+dgInt32 dgCollisionConvexHull::SupportVertexSoa (const dgVector& dir) const
+{
+	dgAssert (m_soaVertex);
+	const dgVector x (dir.BroadcastX());
+	const dgVector y (dir.BroadcastY());
+	const dgVector z (dir.BroadcastZ());
+	const dgVector eight (dgFloat32 (8.0f));
+
+	dgVector index0 (dgFloat32 (0.0f), dgFloat32 (1.0f), dgFloat32 (2.0f), dgFloat32 (3.0f));
+	dgVector index1 (index0 + dgVector (dgFloat32 (4.0f)));
+	dgVector maxIndex0 (index0);
+	dgVector maxIndex1 (index1);
+	dgVector maxProj0 (dgFloat32 (-1.0e20f));
+	dgVector maxProj1 (dgFloat32 (-1.0e20f));
+
+	const dgInt32 groupCount = ((m_vertexCount + 7) & -8) >> 2;
+	for (dgInt32 i = 0; i < groupCount; i += 2) {
+		const dgVector* const group = &m_soaVertex[i * 3];
+		const dgVector dist0 (group[0] * x + group[1] * y + group[2] * z);
+		const dgVector dist1 (group[3] * x + group[4] * y + group[5] * z);
+		const dgVector mask0 (dist0 > maxProj0);
+		const dgVector mask1 (dist1 > maxProj1);
+		maxIndex0 = maxIndex0.Select(index0, mask0);
+		maxIndex1 = maxIndex1.Select(index1, mask1);
+		maxProj0 = maxProj0.GetMax(dist0);
+		maxProj1 = maxProj1.GetMax(dist1);
+		index0 += eight;
+		index1 += eight;
+	}
+
+	// the lowest index wins the ties, so that the padding never does
+	dgInt32 index = dgInt32 (maxIndex0[0]);
+	dgFloat32 maxProj = maxProj0[0];
+	for (dgInt32 i = 1; i < 4; i ++) {
+		const dgInt32 lane = dgInt32 (maxIndex0[i]);
+		if ((maxProj0[i] > maxProj) || ((maxProj0[i] == maxProj) && (lane < index))) {
+			maxProj = maxProj0[i];
+			index = lane;
+		}
+	}
+	for (dgInt32 i = 0; i < 4; i ++) {
+		const dgInt32 lane = dgInt32 (maxIndex1[i]);
+		if ((maxProj1[i] > maxProj) || ((maxProj1[i] == maxProj) && (lane < index))) {
+			maxProj = maxProj1[i];
+			index = lane;
+		}
+	}
+	dgAssert (index < m_vertexCount);
+	return index;
+}
+
+// if vertexIndex is not NULL, and it holds the index returned by a previous call, the search start from that vertex.
+dgVector dgCollisionConvexHull::SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const
+{
+	dgInt32 index;
+	if (vertexIndex && (*vertexIndex >= 0) && (*vertexIndex < m_vertexCount)) {
+		index = SupportVertexClimb (dir, *vertexIndex);
+	} else if (m_soaVertex) {
+		index = SupportVertexSoa (dir);
+	} else {
+		index = SupportVertexTree (dir);
+	}
 	if (vertexIndex) {
 		*vertexIndex = index;
 	}
-	dgAssert (index != -1);
 	return m_vertex[index];
 }
 
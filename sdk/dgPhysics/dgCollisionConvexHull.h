@@ -48,6 +48,10 @@ class dgCollisionConvexHull: public dgCollisionConvex
 	bool CheckConvex (dgPolyhedra& polyhedra, const dgBigVector* hullVertexArray) const;
 
 	virtual dgVector SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const;
+	dgInt32 SupportVertexTree (const dgVector& dir) const;
+	dgInt32 SupportVertexClimb (const dgVector& dir, dgInt32 seedIndex) const;
+	dgInt32 SupportVertexSoa (const dgVector& dir) const;
+	void BuildSoaVertexArray ();
 
 	virtual dgInt32 CalculateSignature () const;
 	virtual void SetCollisionBBox (const dgVector& p0, const dgVector& p1);
@@ -64,6 +68,7 @@ class dgCollisionConvexHull: public dgCollisionConvex
 	dgConvexSimplexEdge** m_faceArray;
 	const dgConvexSimplexEdge** m_vertexToEdgeMapping;
 	dgConvexBox* m_supportTree;
+	dgVector* m_soaVertex;
 
 	friend class dgWorld;
 	friend class dgCollisionConvex;
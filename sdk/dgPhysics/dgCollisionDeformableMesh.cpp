@@ -38,7 +38,9 @@ dgVector dgCollisionDeformableMesh::m_smallestLenght2	(DG_SMALLEST_SPRING_LENGTH
 dgCollisionDeformableMesh::dgCollisionDeformableMesh(dgWorld* const world, dgCollisionID collisionID)
 	:dgCollisionLumpedMassParticles(world, collisionID)
 	,m_linkList(world->GetAllocator())
+	,m_linkBlocks(world->GetAllocator())
 	,m_linksCount(0)
+	,m_linkBlocksCount(0)
 {
 	m_rtti |= dgCollisionDeformableMesh_RTTI;
 }
@@ -46,7 +48,9 @@ dgCollisionDeformableMesh::dgCollisionDeformableMesh(dgWorld* const world, dgCol
 dgCollisionDeformableMesh::dgCollisionDeformableMesh(const dgCollisionDeformableMesh& source)
 	:dgCollisionLumpedMassParticles(source)
 	,m_linkList(source.m_linkList, source.m_linksCount)
+	,m_linkBlocks(source.m_linkBlocks, source.m_linkBlocksCount)
 	,m_linksCount(source.m_linksCount)
+	,m_linkBlocksCount(source.m_linkBlocksCount)
 {
 	m_rtti = source.m_rtti;
 }
@@ -54,7 +58,9 @@ dgCollisionDeformableMesh::dgCollisionDeformableMesh(const dgCollisionDeformable
 dgCollisionDeformableMesh::dgCollisionDeformableMesh(dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
 	:dgCollisionLumpedMassParticles(world, deserialization, userData, revisionNumber)
 	,m_linkList(world->GetAllocator())
+	,m_linkBlocks(world->GetAllocator())
 	,m_linksCount(0)
+	,m_linkBlocksCount(0)
 {
 	dgAssert(0);
 }
@@ -66,6 +72,30 @@ dgCollisionDeformableMesh::~dgCollisionDeformableMesh(void)
 void dgCollisionDeformableMesh::FinalizeBuild()
 {
 	dgCollisionLumpedMassParticles::FinalizeBuild();
+
+	// pack the links four at a time, the padding lanes are zero stiffness springs attached to particle zero
+	m_linkBlocksCount = (m_linksCount + 3) >> 2;
+	m_linkBlocks.Resize(m_linkBlocksCount);
+	for (dgInt32 i = 0; i < m_linkBlocksCount; i++) {
+		dgSpringDamperLinkBlock& block = m_linkBlocks[i];
+		for (dgInt32 j = 0; j < 4; j++) {
+			const dgInt32 index = i * 4 + j;
+			if (index < m_linksCount) {
+				const dgSpringDamperLink& link = m_linkList[index];
+				block.m_m0[j] = link.m_m0;
+				block.m_m1[j] = link.m_m1;
+				block.m_spring[j] = link.m_spring;
+				block.m_damper[j] = link.m_damper;
+				block.m_restlength[j] = link.m_restlength;
+			} else {
+				block.m_m0[j] = 0;
+				block.m_m1[j] = 0;
+				block.m_spring[j] = dgFloat32(0.0f);
+				block.m_damper[j] = dgFloat32(0.0f);
+				block.m_restlength[j] = dgFloat32(0.0f);
+			}
+		}
+	}
 }
 
 void dgCollisionDeformableMesh::Serialize(dgSerialize callback, void* const userData) const
@@ -95,7 +125,7 @@ void dgCollisionDeformableMesh::DisableInactiveLinks ()
 */
 }
 
-const dgInt16* dgCollisionDeformableMesh::GetLinks() const
+const dgInt32* dgCollisionDeformableMesh::GetLinks() const
 {
 	return &m_linkList[0].m_m0;
 }
@@ -177,6 +207,12 @@ dgAssert (0);
 	for (dgInt32 i = 0; i < m_particlesCount; i++) {
 		posit[i] -= localCom;
 	}
+
+	// the body integration moves the origin by the center of mass velocity, any other offset of the particles center 
+	// goes to the origin now, so that origin plus particle is still the particle world position
+	dgVector originOffset((localCom - comVeloc * timeV) & dgVector::m_triplexMask);
+	m_body->m_globalCentreOfMass += originOffset;
+	m_body->m_matrix.m_posit += originOffset;
 }
 
 
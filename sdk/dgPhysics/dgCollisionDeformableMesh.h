@@ -36,7 +36,7 @@ class dgCollisionDeformableMesh: public dgCollisionLumpedMassParticles
 	virtual ~dgCollisionDeformableMesh(void);
 
 	dgInt32 GetLinksCount() const;
-	const dgInt16* GetLinks() const;
+	const dgInt32* GetLinks() const;
 	
 	virtual void ConstraintParticle(dgInt32 particleIndex, const dgVector& posit, const dgBody* const body);
 
@@ -49,10 +49,22 @@ class dgCollisionDeformableMesh: public dgCollisionLumpedMassParticles
 		dgFloat32 m_spring;
 		dgFloat32 m_damper;
 		dgFloat32 m_restlength;
-		dgInt16 m_m0;
-		dgInt16 m_m1;
+		dgInt32 m_m0;
+		dgInt32 m_m1;
 	};
 
+	// four links in SoA layout, so that the spring loop runs one link per simd lane
+	DG_MSC_VECTOR_ALIGMENT
+	class dgSpringDamperLinkBlock
+	{
+		public:
+		dgVector m_spring;
+		dgVector m_damper;
+		dgVector m_restlength;
+		dgInt32 m_m0[4];
+		dgInt32 m_m1[4];
+	} DG_GCC_VECTOR_ALIGMENT;
+
 
 	virtual void CalculateAcceleration(dgFloat32 timestep) = 0;
 
@@ -62,7 +74,9 @@ class dgCollisionDeformableMesh: public dgCollisionLumpedMassParticles
 	virtual void DebugCollision (const dgMatrix& matrix, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const;
 	
 	dgArray<dgSpringDamperLink> m_linkList;
+	dgArray<dgSpringDamperLinkBlock> m_linkBlocks;
 	dgInt32 m_linksCount;
+	dgInt32 m_linkBlocksCount;
 
 	static dgVector m_smallestLenght2;
 };
@@ -31,6 +31,7 @@
 #define DG_MINIMIM_ZERO_SPEED			dgFloat32 (1.0e-3f)
 #define DG_MINIMIM_PARTCLE_RADIUS		dgFloat32 (1.0f/16.0f)
 #define DG_MINIMIM_ZERO_SURFACE			(DG_MINIMIM_PARTCLE_RADIUS * dgFloat32 (0.25f))
+#define DG_PARTICLE_NO_CONTACT			dgFloat32 (-1.0e10f)
 
 
 dgCollisionLumpedMassParticles::dgCollisionLumpedMassParticles(dgWorld* const world, dgCollisionID collisionID)
@@ -41,10 +42,25 @@ dgCollisionLumpedMassParticles::dgCollisionLumpedMassParticles(dgWorld* const wo
 	,m_externalAccel(world->GetAllocator())
 	,m_mass(world->GetAllocator())
 	,m_invMass(world->GetAllocator())
+	,m_normalDir(world->GetAllocator())
+	,m_normalAccel(world->GetAllocator())
+	,m_frictionCoefficient(world->GetAllocator())
+	,m_contacts(world->GetAllocator())
+	,m_restPosit(world->GetAllocator())
+	,m_hashCellStart(world->GetAllocator())
+	,m_hashParticles(world->GetAllocator())
+	,m_hashKey(world->GetAllocator())
+	,m_hashGrainBounds(world->GetAllocator())
+	,m_collidingBodies(world->GetAllocator())
 	,m_body(NULL)
 	,m_totalMass(dgFloat32(1.0f))	
 	,m_particleRadius(DG_MINIMIM_PARTCLE_RADIUS)
+	,m_hashInvCellSize(dgFloat32 (0.5f) / DG_MINIMIM_PARTCLE_RADIUS)
 	,m_particlesCount(0)
+	,m_hashMask(0)
+	,m_collidingBodiesCount(0)
+	,m_collidingBodiesLru(0)
+	,m_selfCollision(false)
 {
 	m_rtti |= dgCollisionLumpedMass_RTTI;
 }
@@ -57,10 +73,25 @@ dgCollisionLumpedMassParticles::dgCollisionLumpedMassParticles (const dgCollisio
 	,m_externalAccel(source.m_externalAccel, source.m_particlesCount)
 	,m_mass(source.m_mass, source.m_particlesCount)
 	,m_invMass(source.m_invMass, source.m_particlesCount)
+	,m_normalDir(source.m_normalDir, source.m_particlesCount)
+	,m_normalAccel(source.m_normalAccel, source.m_particlesCount)
+	,m_frictionCoefficient(source.m_frictionCoefficient, source.m_particlesCount)
+	,m_contacts(source.m_contacts, source.m_particlesCount)
+	,m_restPosit(source.m_restPosit, source.m_particlesCount)
+	,m_hashCellStart(source.m_hashCellStart, source.m_hashMask + 2)
+	,m_hashParticles(source.m_hashParticles, source.m_particlesCount)
+	,m_hashKey(source.m_hashKey, source.m_particlesCount)
+	,m_hashGrainBounds(source.m_hashGrainBounds, (source.m_particlesCount + DG_LUMPED_MASS_PARALLEL_GRAIN - 1) / DG_LUMPED_MASS_PARALLEL_GRAIN * 3)
+	,m_collidingBodies(source.m_collidingBodies.GetAllocator())
 	,m_body(NULL)
 	,m_totalMass(source.m_totalMass)
 	,m_particleRadius(source.m_particleRadius)
+	,m_hashInvCellSize(source.m_hashInvCellSize)
 	,m_particlesCount(source.m_particlesCount)
+	,m_hashMask(source.m_hashMask)
+	,m_collidingBodiesCount(0)
+	,m_collidingBodiesLru(0)
+	,m_selfCollision(source.m_selfCollision)
 {
 	m_rtti |= dgCollisionLumpedMass_RTTI;
 }
@@ -74,10 +105,25 @@ dgCollisionLumpedMassParticles::dgCollisionLumpedMassParticles (dgWorld* const w
 	,m_externalAccel(world->GetAllocator())
 	,m_mass(world->GetAllocator())
 	,m_invMass(world->GetAllocator())
+	,m_normalDir(world->GetAllocator())
+	,m_normalAccel(world->GetAllocator())
+	,m_frictionCoefficient(world->GetAllocator())
+	,m_contacts(world->GetAllocator())
+	,m_restPosit(world->GetAllocator())
+	,m_hashCellStart(world->GetAllocator())
+	,m_hashParticles(world->GetAllocator())
+	,m_hashKey(world->GetAllocator())
+	,m_hashGrainBounds(world->GetAllocator())
+	,m_collidingBodies(world->GetAllocator())
 	,m_body(NULL)
 	,m_totalMass(dgFloat32(1.0f))	
 	,m_particleRadius (DG_MINIMIM_PARTCLE_RADIUS)
+	,m_hashInvCellSize(dgFloat32 (0.5f) / DG_MINIMIM_PARTCLE_RADIUS)
 	,m_particlesCount(0)
+	,m_hashMask(0)
+	,m_collidingBodiesCount(0)
+	,m_collidingBodiesLru(0)
+	,m_selfCollision(false)
 {
 	m_rtti |= dgCollisionLumpedMass_RTTI;
 	dgAssert (0);
@@ -92,6 +138,25 @@ void dgCollisionLumpedMassParticles::FinalizeBuild()
 	m_veloc.Resize(m_particlesCount);
 	m_accel.Resize(m_particlesCount);
 	m_externalAccel.Resize(m_particlesCount);
+	m_normalDir.Resize(m_particlesCount);
+	m_normalAccel.Resize(m_particlesCount);
+	m_frictionCoefficient.Resize(m_particlesCount);
+	m_contacts.Resize(m_particlesCount);
+	m_restPosit.Resize(m_particlesCount);
+	m_hashParticles.Resize(m_particlesCount);
+	m_hashKey.Resize(m_particlesCount);
+	m_hashGrainBounds.Resize((m_particlesCount + DG_LUMPED_MASS_PARALLEL_GRAIN - 1) / DG_LUMPED_MASS_PARALLEL_GRAIN * 3 + 1);
+
+	// twice as many hash cells as particles keeps the buckets short
+	m_hashMask = 16;
+	while (m_hashMask < m_particlesCount * 2) {
+		m_hashMask *= 2;
+	}
+	m_hashCellStart.Resize(m_hashMask + 1);
+	m_hashMask -= 1;
+
+	// one particle diameter per cell, so that self collision only needs to search the neighbor cells
+	m_hashInvCellSize = dgFloat32 (0.5f) / m_particleRadius;
 
 	dgVector com(dgFloat32(0.0f));
 	dgVector* const posit = &m_posit[0];
@@ -104,9 +169,10 @@ void dgCollisionLumpedMassParticles::FinalizeBuild()
 		m_accel[i] = dgVector::m_zero;
 		m_veloc[i] = dgVector::m_zero;
 		m_externalAccel[i] = dgVector::m_zero;
+		m_contacts[i] = dgVector (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), DG_PARTICLE_NO_CONTACT);
 	}
 
-	// for now use a fix size box
+	// the box is updated each step from the particles positions
 	m_boxSize = dgVector::m_half * (maxp - minp);
 	m_boxOrigin = dgVector::m_half * (maxp + minp);
 }
@@ -138,6 +204,7 @@ void dgCollisionLumpedMassParticles::SetOwnerAndMassPraperties (dgDynamicBody* c
 		massSum += mass[i];
 		//inertiaSum += mass[i] * radius2;
 		posit[i] = scaledTranform.TransformVector(posit[i]) & dgVector::m_triplexMask;
+		m_restPosit[i] = posit[i];
 		xMassSum += posit[i].Scale (mass[i]);
 		//xxMassSum += posit[i] * posit[i].Scale (mass[i]);
 		//xyMassSum += posit[i] * (posit[i].ShiftTripleRight()).Scale (mass[i]);
@@ -192,6 +259,12 @@ const dgVector* dgCollisionLumpedMassParticles::GetAcceleration() const
 	return &m_accel[0];
 }
 
+// systems that split their own integration across the world threads can not run inside a solver job
+bool dgCollisionLumpedMassParticles::SplitAcrossThreads () const
+{
+	return false;
+}
+
 dgInt32 dgCollisionLumpedMassParticles::CalculateSignature() const
 {
 	dgAssert (0);
@@ -210,7 +283,25 @@ void dgCollisionLumpedMassParticles::Serialize(dgSerialize callback, void* const
 
 void dgCollisionLumpedMassParticles::RegisterCollision(const dgBody* const otherBody)
 {
-//	dgAssert (0);
+	const dgUnsigned32 lru = m_body->GetWorld()->GetBroadPhase()->GetLRU();
+	if (m_collidingBodiesLru != lru) {
+		m_collidingBodiesLru = lru;
+		m_collidingBodiesCount = 0;
+	}
+
+	for (dgInt32 i = 0; i < m_collidingBodiesCount; i++) {
+		if (m_collidingBodies[i].m_body == otherBody) {
+			return;
+		}
+	}
+
+	// take a snapshot of the body, the solver may move it while the particles are integrated
+	dgCollidingBody& entry = m_collidingBodies[m_collidingBodiesCount];
+	entry.m_body = otherBody;
+	entry.m_collision = otherBody->GetCollision();
+	entry.m_matrix = entry.m_collision->GetGlobalMatrix();
+	otherBody->GetAABB(entry.m_minBox, entry.m_maxBox);
+	m_collidingBodiesCount++;
 }
 
 void dgCollisionLumpedMassParticles::CalcAABB(const dgMatrix& matrix, dgVector& p0, dgVector& p1) const
@@ -262,76 +353,309 @@ dgMatrix dgCollisionLumpedMassParticles::CalculateInertiaAndCenterOfMass(const d
 	return inertia;
 }
 
-/*
-dgFloat32 dgCollisionLumpedMassParticles::CalculaleContactPenetration(const dgVector& point, const dgVector& normal) const
+// systems split across threads are only updated from the calling thread of the world update, so they can queue their own jobs.
+// all other systems run inside a solver job and call the kernel directly, the results are the same in both cases.
+void dgCollisionLumpedMassParticles::ParallelFor(dgInt32 count, void* const context, void (dgApi *kernel) (dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)) const
 {
-	dgVector otherPoint (point);
-	otherPoint.m_y = dgFloat32 (0.0f);
-	dgFloat32 penetration = normal.DotProduct(point - otherPoint).GetScalar();
-	return penetration;
+	dgWorld* const world = m_body->GetWorld();
+	if (SplitAcrossThreads()) {
+		world->ExecuteUserParallelFor(count, DG_LUMPED_MASS_PARALLEL_GRAIN, kernel, context, "dgCollisionLumpedMassParticles::ParallelFor");
+	} else {
+		kernel(world, context, 0, count, 0);
+	}
+}
+
+void dgCollisionLumpedMassParticles::BuildHashKeysKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgCollisionLumpedMassParticles* const me = (dgCollisionLumpedMassParticles*)context;
+	const dgVector* const posit = &me->m_posit[0];
+	const dgVector* const veloc = &me->m_veloc[0];
+	dgInt32* const cellStart = &me->m_hashCellStart[0];
+	dgInt32* const particleKey = &me->m_hashKey[0];
+	dgVector* const grainBounds = &me->m_hashGrainBounds[0];
+	const dgVector invCellSize (me->m_hashInvCellSize);
+
+	dgAssert(!(start % DG_LUMPED_MASS_PARALLEL_GRAIN));
+	for (dgInt32 base = start; base < start + count; base += DG_LUMPED_MASS_PARALLEL_GRAIN) {
+		dgVector minp(dgFloat32(1.0e10f));
+		dgVector maxp(dgFloat32(-1.0e10f));
+		dgVector maxVeloc2(dgFloat32(0.0f));
+		const dgInt32 end = dgMin(base + DG_LUMPED_MASS_PARALLEL_GRAIN, start + count);
+		for (dgInt32 i = base; i < end; i++) {
+			minp = minp.GetMin(posit[i]);
+			maxp = maxp.GetMax(posit[i]);
+			maxVeloc2 = maxVeloc2.GetMax(veloc[i].DotProduct(veloc[i]));
+
+			const dgVector cell ((posit[i] * invCellSize).Floor());
+			const dgInt32 key = me->GetHashKey (dgInt32 (cell.m_x), dgInt32 (cell.m_y), dgInt32 (cell.m_z));
+			particleKey[i] = key;
+			dgAtomicExchangeAndAdd(&cellStart[key], 1);
+		}
+		dgVector* const bounds = &grainBounds[base / DG_LUMPED_MASS_PARALLEL_GRAIN * 3];
+		bounds[0] = minp;
+		bounds[1] = maxp;
+		bounds[2] = maxVeloc2;
+	}
+}
+
+void dgCollisionLumpedMassParticles::ScatterHashKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgCollisionLumpedMassParticles* const me = (dgCollisionLumpedMassParticles*)context;
+	dgInt32* const cellStart = &me->m_hashCellStart[0];
+	dgInt32* const particles = &me->m_hashParticles[0];
+	const dgInt32* const particleKey = &me->m_hashKey[0];
+	for (dgInt32 i = start; i < start + count; i++) {
+		const dgInt32 index = dgAtomicExchangeAndAdd(&cellStart[particleKey[i]], -1) - 1;
+		particles[index] = i;
+	}
+}
+
+// the scatter leaves each cell in thread order, sort them back by particle index 
+// so that the contacts do not depend on the number of threads
+void dgCollisionLumpedMassParticles::SortHashCellsKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgCollisionLumpedMassParticles* const me = (dgCollisionLumpedMassParticles*)context;
+	const dgInt32* const cellStart = &me->m_hashCellStart[0];
+	dgInt32* const particles = &me->m_hashParticles[0];
+	for (dgInt32 i = start; i < start + count; i++) {
+		const dgInt32 end = cellStart[i + 1];
+		for (dgInt32 j = cellStart[i] + 1; j < end; j++) {
+			const dgInt32 particle = particles[j];
+			dgInt32 k = j - 1;
+			for (; (k >= cellStart[i]) && (particles[k] > particle); k--) {
+				particles[k + 1] = particles[k];
+			}
+			particles[k + 1] = particle;
+		}
+	}
+}
+
+void dgCollisionLumpedMassParticles::BuildSpatialHash(dgFloat32 timestep)
+{
+	dgInt32* const cellStart = &m_hashCellStart[0];
+	const dgInt32 cellsCount = m_hashMask + 1;
+
+	memset (cellStart, 0, (cellsCount + 1) * sizeof (dgInt32));
+	ParallelFor(m_particlesCount, this, BuildHashKeysKernel);
+
+	for (dgInt32 i = 1; i < cellsCount; i++) {
+		cellStart[i] += cellStart[i - 1];
+	}
+	ParallelFor(m_particlesCount, this, ScatterHashKernel);
+	cellStart[cellsCount] = m_particlesCount;
+	ParallelFor(cellsCount, this, SortHashCellsKernel);
+
+	// grow the box by the particle radius and by how far the fastest particle can travel in one step
+	if (m_particlesCount) {
+		dgVector minp(dgFloat32(1.0e10f));
+		dgVector maxp(dgFloat32(-1.0e10f));
+		dgVector maxVeloc2(dgFloat32(0.0f));
+		const dgVector* const grainBounds = &m_hashGrainBounds[0];
+		for (dgInt32 i = 0; i < m_particlesCount; i += DG_LUMPED_MASS_PARALLEL_GRAIN) {
+			const dgVector* const bounds = &grainBounds[i / DG_LUMPED_MASS_PARALLEL_GRAIN * 3];
+			minp = minp.GetMin(bounds[0]);
+			maxp = maxp.GetMax(bounds[1]);
+			maxVeloc2 = maxVeloc2.GetMax(bounds[2]);
+		}
+		const dgFloat32 padding = m_particleRadius + dgSqrt (maxVeloc2.GetScalar()) * timestep * dgFloat32 (2.0f);
+		m_boxSize = (dgVector::m_half * (maxp - minp) + dgVector (padding)) & dgVector::m_triplexMask;
+		m_boxOrigin = (dgVector::m_half * (maxp + minp)) & dgVector::m_triplexMask;
+	}
 }
-*/
 
-dgVector dgCollisionLumpedMassParticles::CalculateContactNormalAndPenetration(const dgVector& worldPosition) const
+void dgCollisionLumpedMassParticles::CalculateSelfContacts()
 {
-	dgVector contactNormal(dgFloat32(0.0f), dgFloat32(1.0f), dgFloat32(0.0f), dgFloat32(0.0f));
-	dgVector otherPoint(worldPosition);
-	otherPoint.m_y = dgFloat32(0.0f);
-	dgVector point(worldPosition - contactNormal.Scale (m_particleRadius));
-	contactNormal.m_w = contactNormal.DotProduct(otherPoint - point).GetScalar();
+	const dgVector* const posit = &m_posit[0];
+	const dgVector* const restPosit = &m_restPosit[0];
+	const dgInt32* const cellStart = &m_hashCellStart[0];
+	const dgInt32* const particles = &m_hashParticles[0];
+	dgVector* const contacts = &m_contacts[0];
+
+	const dgInt32 cellsCount = m_hashMask + 1;
+	const dgVector invCellSize (m_hashInvCellSize);
+	const dgFloat32 diameter = m_particleRadius * dgFloat32 (2.0f);
+	const dgFloat32 diameter2 = diameter * diameter;
+	const dgFloat32 exclusion = m_particleRadius * DG_PARTICLE_SELF_COLLISION_EXCLUSION;
+	const dgFloat32 exclusion2 = exclusion * exclusion;
+
+	// each pair is tested once by searching only the forward half of the neighbor cells, 
+	// the own cell, the next cell along x, and the rows above in y and z. 
+	// rows are given as first cell offset and cells count, and particles in the own cell only test higher indices.
+	static const dgInt32 forwardRows[][4] = {{0, 0, 0, 1}, {1, 0, 0, 1}, {-1, 1, 0, 3}, {-1, -1, 1, 3}, {-1, 0, 1, 3}, {-1, 1, 1, 3}};
 
-	return contactNormal;
+	for (dgInt32 i = 0; i < m_particlesCount; i++) {
+		const dgVector p0 (posit[i]);
+		const dgVector cell ((p0 * invCellSize).Floor());
+		const dgInt32 x0 = dgInt32 (cell.m_x);
+		const dgInt32 y0 = dgInt32 (cell.m_y);
+		const dgInt32 z0 = dgInt32 (cell.m_z);
+		for (dgInt32 row = 0; row < dgInt32 (sizeof (forwardRows) / sizeof (forwardRows[0])); row++) {
+			const dgInt32 rowKey = GetHashKey (x0 + forwardRows[row][0], y0 + forwardRows[row][1], z0 + forwardRows[row][2]);
+			const dgInt32 rowCells = forwardRows[row][3];
+			const dgInt32 minIndex = row ? -1 : i;
+			for (dgInt32 rowCell = 0; rowCell < rowCells; ) {
+				// consecutive cells of a row are one range, unless the row wraps around the table
+				const dgInt32 key = (rowKey + rowCell) & m_hashMask;
+				const dgInt32 count = dgMin (rowCells - rowCell, cellsCount - key);
+				const dgInt32 end = cellStart[key + count];
+				rowCell += count;
+				for (dgInt32 k = cellStart[key]; k < end; k++) {
+					const dgInt32 j = particles[k];
+					const dgVector step (p0 - posit[j]);
+					const dgFloat32 dist2 = step.DotProduct(step).GetScalar();
+					if ((j > minIndex) && (dist2 < diameter2) && (dist2 > dgFloat32 (1.0e-12f))) {
+						const dgVector restStep (restPosit[i] - restPosit[j]);
+						if ((j != i) && (restStep.DotProduct(restStep).GetScalar() > exclusion2)) {
+							// each particle of the pair takes half the penetration
+							const dgFloat32 dist = dgSqrt (dist2);
+							const dgFloat32 penetration = (diameter - dist) * dgFloat32 (0.5f);
+							const dgVector normal (step.Scale (dgFloat32 (1.0f) / dist));
+							if (penetration > contacts[i].m_w) {
+								contacts[i] = normal;
+								contacts[i].m_w = penetration;
+							}
+							if (penetration > contacts[j].m_w) {
+								contacts[j] = normal * dgVector::m_negOne;
+								contacts[j].m_w = penetration;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void dgCollisionLumpedMassParticles::CalculateParticleContact(const dgCollidingBody& collidingBody, dgInt32 index, const dgVector& origin, dgFloat32 timestep)
+{
+	// sweep the particle along its projected velocity, a particle not moving toward the body can not collide with it.
+	// the ray starts one radius behind the particle, so that particles already touching the surface still hit it
+	const dgVector veloc (m_veloc[index] + (m_accel[index] + m_externalAccel[index]).Scale (timestep));
+	const dgFloat32 speed2 = veloc.DotProduct(veloc).GetScalar();
+	if (speed2 > dgFloat32 (1.0e-12f)) {
+		const dgFloat32 speed = dgSqrt (speed2);
+		const dgFloat32 length = speed * timestep + m_particleRadius * dgFloat32 (2.0f);
+		const dgVector dir (veloc.Scale (dgFloat32 (1.0f) / speed));
+		const dgVector p0 (origin + m_posit[index] - dir.Scale (m_particleRadius));
+		const dgVector p1 (p0 + dir.Scale (length));
+		const dgVector localP0 (collidingBody.m_matrix.UntransformVector (p0) & dgVector::m_triplexMask);
+		const dgVector localP1 (collidingBody.m_matrix.UntransformVector (p1) & dgVector::m_triplexMask);
+
+		dgContactPoint contact;
+		const dgFloat32 t = collidingBody.m_collision->RayCast (localP0, localP1, dgFloat32 (1.0f), contact, NULL, collidingBody.m_body, NULL);
+		if (t < dgFloat32 (1.0f)) {
+			const dgVector normal (collidingBody.m_matrix.RotateVector (contact.m_normal) & dgVector::m_triplexMask);
+			const dgFloat32 height = -(t * length - m_particleRadius) * normal.DotProduct(dir).GetScalar();
+			const dgFloat32 penetration = m_particleRadius - height;
+			if (penetration > m_contacts[index].m_w) {
+				m_contacts[index] = normal;
+				m_contacts[index].m_w = penetration;
+			}
+		}
+	}
+}
+
+void dgCollisionLumpedMassParticles::CalculateWorldContacts(const dgCollidingBody& collidingBody, const dgVector& origin, dgFloat32 timestep)
+{
+	const dgVector padding (m_particleRadius);
+	const dgVector minBox ((collidingBody.m_minBox - origin - padding) & dgVector::m_triplexMask);
+	const dgVector maxBox ((collidingBody.m_maxBox - origin + padding) & dgVector::m_triplexMask);
+	const dgVector invCellSize (m_hashInvCellSize);
+	const dgVector minCell ((minBox * invCellSize).Floor());
+	const dgVector maxCell ((maxBox * invCellSize).Floor());
+	const dgVector cells (maxCell - minCell + dgVector::m_one);
+	const dgFloat32 cellsCount = cells.m_x * cells.m_y * cells.m_z;
+
+	const dgVector* const posit = &m_posit[0];
+	if (cellsCount < dgFloat32 (m_particlesCount)) {
+		// small body, only visit the particles in the hash cells overlapping its box
+		const dgInt32* const cellStart = &m_hashCellStart[0];
+		const dgInt32* const particles = &m_hashParticles[0];
+		const dgInt32 x0 = dgInt32 (minCell.m_x);
+		const dgInt32 y0 = dgInt32 (minCell.m_y);
+		const dgInt32 z0 = dgInt32 (minCell.m_z);
+		const dgInt32 x1 = dgInt32 (maxCell.m_x);
+		const dgInt32 y1 = dgInt32 (maxCell.m_y);
+		const dgInt32 z1 = dgInt32 (maxCell.m_z);
+		for (dgInt32 z = z0; z <= z1; z++) {
+			for (dgInt32 y = y0; y <= y1; y++) {
+				for (dgInt32 x = x0; x <= x1; x++) {
+					const dgInt32 key = GetHashKey (x, y, z);
+					const dgInt32 end = cellStart[key + 1];
+					for (dgInt32 k = cellStart[key]; k < end; k++) {
+						const dgInt32 i = particles[k];
+						if (dgOverlapTest (posit[i], posit[i], minBox, maxBox)) {
+							CalculateParticleContact (collidingBody, i, origin, timestep);
+						}
+					}
+				}
+			}
+		}
+	} else {
+		// large body, a linear pass over the particles is cheaper than visiting the cells
+		for (dgInt32 i = 0; i < m_particlesCount; i++) {
+			if (dgOverlapTest (posit[i], posit[i], minBox, maxBox)) {
+				CalculateParticleContact (collidingBody, i, origin, timestep);
+			}
+		}
+	}
 }
 
 void dgCollisionLumpedMassParticles::HandleCollision(dgFloat32 timestep, dgVector* const normalDir, dgVector* const normalAccel, dgFloat32* const frictionCoefficient)
 {
 	const dgMatrix& matrix = m_body->GetCollision()->GetGlobalMatrix();
-	dgVector origin(matrix.m_posit);
+	dgVector origin(matrix.m_posit & dgVector::m_triplexMask);
+
+	// contacts with negative penetration are speculative, the particle will reach the surface this step
+	dgVector* const contacts = &m_contacts[0];
+	const dgVector noContact (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), DG_PARTICLE_NO_CONTACT);
+	for (dgInt32 i = 0; i < m_particlesCount; i++) {
+		contacts[i] = noContact;
+	}
+
+	BuildSpatialHash(timestep);
+	if (m_collidingBodiesLru == m_body->GetWorld()->GetBroadPhase()->GetLRU()) {
+		for (dgInt32 i = 0; i < m_collidingBodiesCount; i++) {
+			CalculateWorldContacts (m_collidingBodies[i], origin, timestep);
+		}
+	}
+	if (m_selfCollision) {
+		CalculateSelfContacts();
+	}
 
 	dgFloat32 coeficientOfFriction = dgFloat32(0.6f);
-	dgFloat32 coeficientOfPenetration = dgFloat32(0.1f);
-coeficientOfPenetration *= 1.0f;
 
 	dgVector timestepV(timestep);
 	dgFloat32 invTimeStep = dgFloat32 (1.0f) / timestep;
 	dgVector* const veloc = &m_veloc[0];
 	const dgVector* const accel = &m_accel[0];
-	const dgVector* const posit = &m_posit[0];
 	const dgVector* const extAccel = &m_externalAccel[0];
 
-static int xxx;
-xxx ++;
-//dgTrace (("%d %f %f\n", xxx, externAccel[0].m_y, veloc[0].m_y));
-
 	for (dgInt32 i = 0; i < m_particlesCount; i++) {
 		dgVector normal(dgVector::m_zero);
 		dgVector accel1(dgVector::m_zero);
-		dgVector tangent0(dgVector::m_zero);
-		dgVector tangent1(dgVector::m_zero);
 
-		dgVector contactPosition(origin + posit[i]);
-		dgVector contactNormal(CalculateContactNormalAndPenetration (contactPosition));
+		const dgVector contactNormal(contacts[i]);
 
 		dgFloat32 frictionCoef = dgFloat32(0.0f);
-		if (contactNormal.m_w > dgFloat32 (0.0f)) {
+		if (contactNormal.m_w > DG_PARTICLE_NO_CONTACT) {
 			dgVector projectedVelocity(veloc[i] + timestepV * (accel[i] + extAccel[i]));
 			dgAssert (projectedVelocity.m_w == dgFloat32 (0.0f));
-			dgFloat32 projectedNormalSpeed = contactNormal.DotProduct(projectedVelocity).GetScalar();
-			if (projectedNormalSpeed < DG_MINIMIM_ZERO_SPEED) {
-				if (contactNormal.m_w > DG_MINIMIM_ZERO_SURFACE) {
-					normal = contactNormal & dgVector::m_triplexMask;
-					dgFloat32 penetration = dgClamp(contactNormal.m_w - DG_MINIMIM_ZERO_SURFACE, dgFloat32(0.0f), dgFloat32(0.125f));
-					dgFloat32 s = dgFloat32 (2.0f) * invTimeStep * penetration;
-					dgFloat32 a = -s * invTimeStep;
-					veloc[i] += normal.Scale (s - veloc[i].DotProduct(normal).GetScalar());
-					//dgVector penetrationSpeed(invTimeStep.Scale(coeficientOfPenetration * penetration));
-					//dgVector normalSpeed(normal.DotProduct(veloc[i] * dgVector::m_negOne));
-					//dgVector restoringSpeed(normalSpeed.GetMax(penetrationSpeed));
-					//dgVector normalVelocity(normal * restoringSpeed);
-					//accel1 = invTimeStep * normalVelocity;
-					accel1 = normal.Scale(a);
-					frictionCoef = coeficientOfFriction;
-				}
+			dgFloat32 projectedNormalSpeed = (contactNormal & dgVector::m_triplexMask).DotProduct(projectedVelocity).GetScalar();
+			// a separated particle only needs a contact if it is going to cross the surface this step
+			dgFloat32 penetration = contactNormal.m_w - DG_MINIMIM_ZERO_SURFACE;
+			dgFloat32 approachSpeed = (penetration > dgFloat32 (0.0f)) ? DG_MINIMIM_ZERO_SPEED : penetration * invTimeStep;
+			if (projectedNormalSpeed < approachSpeed) {
+				normal = contactNormal & dgVector::m_triplexMask;
+				penetration = dgMin(penetration, dgFloat32(0.125f));
+				dgFloat32 s = dgFloat32 (2.0f) * invTimeStep * penetration;
+				dgFloat32 a = -s * invTimeStep;
+				veloc[i] += normal.Scale (s - veloc[i].DotProduct(normal).GetScalar());
+				accel1 = normal.Scale(a);
+				frictionCoef = coeficientOfFriction;
 			}
 		}
 
@@ -340,5 +664,3 @@ xxx ++;
 		frictionCoefficient[i] = frictionCoef;
 	}
 }
-
-
@@ -27,6 +27,11 @@
 #include "dgCollision.h"
 #include "dgCollisionConvex.h"
 
+// particles closer than this many radius in the rest pose never collide with each other 
+#define DG_PARTICLE_SELF_COLLISION_EXCLUSION	dgFloat32 (4.0f)
+
+// particles and hash cells are handed to the world threads in grains of this many
+#define DG_LUMPED_MASS_PARALLEL_GRAIN			256
 
 class dgCollisionLumpedMassParticles: public dgCollisionConvex
 {
@@ -42,11 +47,26 @@ class dgCollisionLumpedMassParticles: public dgCollisionConvex
 	const dgVector* GetPositions() const;
 	const dgVector* GetAcceleration() const;
 
+	bool GetSelfCollision() const;
+	void SetSelfCollision(bool state);
+
 	dgDynamicBody* GetOwner () const;
 	void SetOwnerAndMassPraperties (dgDynamicBody* const body);
 	virtual void IntegrateForces (dgFloat32 timestep) = 0;
+	virtual bool SplitAcrossThreads () const;
 
 	protected:
+	DG_MSC_VECTOR_ALIGMENT
+	class dgCollidingBody
+	{
+		public:
+		dgMatrix m_matrix;
+		dgVector m_minBox;
+		dgVector m_maxBox;
+		const dgBody* m_body;
+		const dgCollisionInstance* m_collision;
+	} DG_GCC_VECTOR_ALIGMENT;
+
 	virtual void FinalizeBuild();
 	virtual dgInt32 CalculateSignature() const;
 	virtual void RegisterCollision(const dgBody* const otherBody);
@@ -58,11 +78,17 @@ class dgCollisionLumpedMassParticles: public dgCollisionConvex
 	virtual void DebugCollision (const dgMatrix& matrix, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const;
 	dgFloat32 RayCast(const dgVector& localP0, const dgVector& localP1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const;
 
-	//dgFloat32 CalculaleContactPenetration(const dgVector& point, const dgVector& normal) const;
-	dgVector CalculateContactNormalAndPenetration(const dgVector& worldPosition) const;
+	void BuildSpatialHash(dgFloat32 timestep);
+	void ParallelFor(dgInt32 count, void* const context, void (dgApi *kernel) (dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)) const;
+	dgInt32 GetHashKey(dgInt32 x, dgInt32 y, dgInt32 z) const;
+	void CalculateSelfContacts();
+	void CalculateWorldContacts(const dgCollidingBody& collidingBody, const dgVector& origin, dgFloat32 timestep);
+	void CalculateParticleContact(const dgCollidingBody& collidingBody, dgInt32 index, const dgVector& origin, dgFloat32 timestep);
 	virtual void HandleCollision (dgFloat32 timestep, dgVector* const normalDir, dgVector* const normalAccel, dgFloat32* const frictionCoefficient);
 
-	virtual dgInt32 GetMemoryBufferSizeInBytes() const = 0;
+	static void dgApi BuildHashKeysKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi ScatterHashKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi SortHashCellsKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
 
 	dgArray<dgVector> m_posit;
 	dgArray<dgVector> m_veloc;
@@ -70,10 +96,35 @@ class dgCollisionLumpedMassParticles: public dgCollisionConvex
 	dgArray<dgVector> m_externalAccel;
 	dgArray<dgFloat32> m_mass;
 	dgArray<dgFloat32> m_invMass;
+
+	// per particle solver scratch, sized once when the shape is built and reused every step
+	dgArray<dgVector> m_normalDir;
+	dgArray<dgVector> m_normalAccel;
+	dgArray<dgFloat32> m_frictionCoefficient;
+
+	// per particle contact, normal in xyz and penetration in w
+	dgArray<dgVector> m_contacts;
+	dgArray<dgVector> m_restPosit;
+
+	// spatial hash rebuilt each step, particles are sorted by cell key
+	dgArray<dgInt32> m_hashCellStart;
+	dgArray<dgInt32> m_hashParticles;
+	dgArray<dgInt32> m_hashKey;
+	// min, max and largest squared speed of each grain of particles
+	dgArray<dgVector> m_hashGrainBounds;
+
+	// bodies reported by the broad phase this step
+	dgArray<dgCollidingBody> m_collidingBodies;
+
 	dgDynamicBody* m_body;
 	dgFloat32 m_totalMass;
 	dgFloat32 m_particleRadius;
+	dgFloat32 m_hashInvCellSize;
 	dgInt32 m_particlesCount;
+	dgInt32 m_hashMask;
+	dgInt32 m_collidingBodiesCount;
+	dgUnsigned32 m_collidingBodiesLru;
+	bool m_selfCollision;
 
 	friend class dgBroadPhase;
 	friend class dgDynamicBody;
@@ -84,5 +135,22 @@ inline dgDynamicBody* dgCollisionLumpedMassParticles::GetOwner () const
 {
 	return m_body;
 }
+
+inline bool dgCollisionLumpedMassParticles::GetSelfCollision() const
+{
+	return m_selfCollision;
+}
+
+inline void dgCollisionLumpedMassParticles::SetSelfCollision(bool state)
+{
+	m_selfCollision = state;
+}
+
+inline dgInt32 dgCollisionLumpedMassParticles::GetHashKey(dgInt32 x, dgInt32 y, dgInt32 z) const
+{
+	// cells along x map to consecutive keys, so a row of neighbor cells is a single range of the sorted particles
+	const dgUnsigned32 key = ((dgUnsigned32 (y) * 19349663u) ^ (dgUnsigned32 (z) * 83492791u)) + dgUnsigned32 (x);
+	return dgInt32 (key & dgUnsigned32 (m_hashMask));
+}
 #endif 
 
@@ -30,6 +30,18 @@
 
 dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem (dgWorld* const world, dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, const dgFloat32* const pointsMasses, dgInt32 linksCount, const dgInt32* const links, const dgFloat32* const linksSpring, const dgFloat32* const LinksDamper)
 	:dgCollisionDeformableMesh(world, m_deformableSolidMesh)
+	,m_linkJacobians(world->GetAllocator())
+	,m_deltaVeloc(world->GetAllocator())
+	,m_residual(world->GetAllocator())
+	,m_searchDir(world->GetAllocator())
+	,m_jacobianTimesDir(world->GetAllocator())
+	,m_invDiagonal(world->GetAllocator())
+	,m_particleLinkStart(world->GetAllocator())
+	,m_particleLinks(world->GetAllocator())
+	,m_linkForces(world->GetAllocator())
+	,m_linkDiagonal(world->GetAllocator())
+	,m_partialSums(world->GetAllocator())
+	,m_implicitIntegration(false)
 {
 	m_rtti |= dgCollisionMassSpringDamperSystem_RTTI;
 
@@ -56,8 +68,8 @@ dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem (dgWorld* c
 		dgAssert(v1 >= 0);
 		dgAssert(v0 < pointCount);
 		dgAssert(v1 < pointCount);
-		m_linkList[i].m_m0 = dgInt16(dgMin(v0, v1));
-		m_linkList[i].m_m1 = dgInt16(dgMax(v0, v1));
+		m_linkList[i].m_m0 = dgMin(v0, v1);
+		m_linkList[i].m_m1 = dgMax(v0, v1);
 		m_linkList[i].m_spring = linksSpring[i];
 		m_linkList[i].m_damper = LinksDamper[i];
 
@@ -75,12 +87,38 @@ dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem (dgWorld* c
 
 dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem(const dgCollisionMassSpringDamperSystem& source)
 	:dgCollisionDeformableMesh(source)
+	,m_linkJacobians(source.m_linkJacobians.GetAllocator())
+	,m_deltaVeloc(source.m_deltaVeloc.GetAllocator())
+	,m_residual(source.m_residual.GetAllocator())
+	,m_searchDir(source.m_searchDir.GetAllocator())
+	,m_jacobianTimesDir(source.m_jacobianTimesDir.GetAllocator())
+	,m_invDiagonal(source.m_invDiagonal.GetAllocator())
+	,m_particleLinkStart(source.m_particleLinkStart.GetAllocator())
+	,m_particleLinks(source.m_particleLinks.GetAllocator())
+	,m_linkForces(source.m_linkForces.GetAllocator())
+	,m_linkDiagonal(source.m_linkDiagonal.GetAllocator())
+	,m_partialSums(source.m_partialSums.GetAllocator())
+	,m_implicitIntegration(source.m_implicitIntegration)
 {
 	m_rtti |= source.m_rtti;
+	BuildParticleLinks();
+	SetImplicitIntegration(m_implicitIntegration);
 }
 
 dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem(dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
 	:dgCollisionDeformableMesh(world, deserialization, userData, revisionNumber)
+	,m_linkJacobians(world->GetAllocator())
+	,m_deltaVeloc(world->GetAllocator())
+	,m_residual(world->GetAllocator())
+	,m_searchDir(world->GetAllocator())
+	,m_jacobianTimesDir(world->GetAllocator())
+	,m_invDiagonal(world->GetAllocator())
+	,m_particleLinkStart(world->GetAllocator())
+	,m_particleLinks(world->GetAllocator())
+	,m_linkForces(world->GetAllocator())
+	,m_linkDiagonal(world->GetAllocator())
+	,m_partialSums(world->GetAllocator())
+	,m_implicitIntegration(false)
 {
 }
 
@@ -88,12 +126,62 @@ dgCollisionMassSpringDamperSystem::~dgCollisionMassSpringDamperSystem(void)
 {
 }
 
-dgInt32 dgCollisionMassSpringDamperSystem::GetMemoryBufferSizeInBytes() const
+void dgCollisionMassSpringDamperSystem::FinalizeBuild()
 {
-	dgInt32 sizeInByte = 0;
-	sizeInByte += 3 * m_particlesCount * sizeof (dgVector);
-	sizeInByte += 1 * m_particlesCount * sizeof (dgFloat32);
-	return sizeInByte;
+	dgCollisionDeformableMesh::FinalizeBuild();
+	BuildParticleLinks();
+	SetImplicitIntegration(m_implicitIntegration);
+}
+
+void dgCollisionMassSpringDamperSystem::BuildParticleLinks()
+{
+	m_particleLinkStart.ResizeIfNecessary(m_particlesCount + 1);
+	m_particleLinks.ResizeIfNecessary(m_linksCount * 2 + 1);
+	m_linkForces.ResizeIfNecessary(m_linkBlocksCount * 4 + 1);
+	m_partialSums.ResizeIfNecessary((m_particlesCount + DG_MASS_SPRING_PARALLEL_GRAIN - 1) / DG_MASS_SPRING_PARALLEL_GRAIN + 1);
+
+	dgInt32* const start = &m_particleLinkStart[0];
+	memset(start, 0, (m_particlesCount + 1) * sizeof(dgInt32));
+	for (dgInt32 i = 0; i < m_linksCount; i++) {
+		start[m_linkList[i].m_m0 + 1] ++;
+		start[m_linkList[i].m_m1 + 1] ++;
+	}
+	for (dgInt32 i = 0; i < m_particlesCount; i++) {
+		start[i + 1] += start[i];
+	}
+
+	// the padding lanes are not linked, their forces are always zero
+	dgInt32* const links = &m_particleLinks[0];
+	for (dgInt32 i = 0; i < m_linksCount; i++) {
+		links[start[m_linkList[i].m_m0]] = i * 2;
+		start[m_linkList[i].m_m0] ++;
+		links[start[m_linkList[i].m_m1]] = i * 2 + 1;
+		start[m_linkList[i].m_m1] ++;
+	}
+	for (dgInt32 i = m_particlesCount; i > 0; i--) {
+		start[i] = start[i - 1];
+	}
+	start[0] = 0;
+}
+
+bool dgCollisionMassSpringDamperSystem::GetImplicitIntegration() const
+{
+	return m_implicitIntegration;
+}
+
+void dgCollisionMassSpringDamperSystem::SetImplicitIntegration(bool state)
+{
+	// the implicit solver scratch is only allocated by systems that use it
+	m_implicitIntegration = state;
+	if (m_implicitIntegration) {
+		m_linkJacobians.ResizeIfNecessary(m_linkBlocksCount);
+		m_linkDiagonal.ResizeIfNecessary(m_linkBlocksCount * 4 + 1);
+		m_deltaVeloc.ResizeIfNecessary(m_particlesCount);
+		m_residual.ResizeIfNecessary(m_particlesCount);
+		m_searchDir.ResizeIfNecessary(m_particlesCount);
+		m_jacobianTimesDir.ResizeIfNecessary(m_particlesCount);
+		m_invDiagonal.ResizeIfNecessary(m_particlesCount);
+	}
 }
 
 #if 0
@@ -232,43 +320,7 @@ void dgCollisionMassSpringDamperSystem::CalculateAcceleration(dgFloat32 timestep
 	// Ks is in [sec^-2] a spring constant unit acceleration, not a spring force acceleration. 
 	// Kc is in [sec^-1] a damper constant unit velocity, not a damper force acceleration. 
 
-	dgInt32 iter = 4;
-	dgVector* const accel = &m_accel[0];
-	dgVector* const veloc = &m_veloc[0];
-	dgVector* const posit = &m_posit[0];
 	dgVector* const extAccel = &m_externalAccel[0];
-	const dgSpringDamperLink* const links = &m_linkList[0];
-/*
-	
-	dgVector* const dx = dgAlloca(dgVector, m_linksCount);
-	dgVector* const dv = dgAlloca(dgVector, m_linksCount);
-	dgVector* const dpdv = dgAlloca(dgVector, m_linksCount);
-
-	dgVector* const normalDir = dgAlloca(dgVector, m_particlesCount);
-	dgVector* const normalAccel = dgAlloca(dgVector, m_particlesCount);
-	dgFloat32* const spring_A01 = dgAlloca(dgFloat32, m_linksCount);
-	dgFloat32* const spring_B01 = dgAlloca(dgFloat32, m_linksCount);
-	dgFloat32* const frictionCoeffecient = dgAlloca(dgFloat32, m_particlesCount);
-*/
-	//	dgFloat32* const damper_A01 = dgAlloca(dgFloat32, m_linksCount);
-	//	dgFloat32* const damper_B01 = dgAlloca(dgFloat32, m_linksCount);
-	//	dgFloat32* const damper_C01 = dgAlloca(dgFloat32, m_linksCount);
-	//	dgVector* const collisionDir1 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const collisionDir2 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const tmp1 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const tmp2 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const diag = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const offDiag = dgAlloca(dgVector, m_particlesCount);
-	//dgVector deltaOmega(m_body->m_invWorldInertiaMatrix.RotateVector(m_body->m_externalTorque.Scale(timestep)));
-
-	dgWorld* const world = m_body->GetWorld();
-	world->m_solverJacobiansMemory.ResizeIfNecessary(GetMemoryBufferSizeInBytes() + 1024);
-
-	dgVector* const normalAccel = (dgVector*)&world->m_solverJacobiansMemory[0];
-	dgVector* const normalDir = &normalAccel[m_particlesCount];
-	dgVector* const diagonal = &normalDir[m_particlesCount];
-	dgFloat32* const frictionCoeffecient = (dgFloat32*)&diagonal[m_particlesCount];
-
 	dgVector unitAccel(m_body->m_externalForce * dgVector(m_body->m_invMass.m_w));
 
 	// here I need to add all other external acceleration like wind and pressure, friction and collision.
@@ -282,104 +334,421 @@ void dgCollisionMassSpringDamperSystem::CalculateAcceleration(dgFloat32 timestep
 	m_body->m_externalForce = dgVector::m_zero;
 	m_body->m_externalTorque = dgVector::m_zero;
 
-	//dgFloat32 ks_dt = -timestep * kSpring;
-	//dgFloat32 kd_dt0 = -timestep * kDamper;
-	//dgFloat32 kd_dt1 = -timestep * kDamper * dgFloat32(2.0f);
+	HandleCollision(timestep, &m_normalDir[0], &m_normalAccel[0], &m_frictionCoefficient[0]);
+	if (m_implicitIntegration) {
+		IntegrateImplicit(timestep);
+	} else {
+		IntegrateExplicit(timestep);
+	}
+}
 
-	//dgFloat32 dtRK4__ = timestep / iter;
-	dgVector dtRK4 (timestep / iter);
-	dgVector epsilon(dgFloat32(1.0e-14f));
+bool dgCollisionMassSpringDamperSystem::SplitAcrossThreads() const
+{
+	return m_particlesCount >= DG_MASS_SPRING_PARALLEL_PARTICLES;
+}
 
-//	dtRK4 = dtRK4 & dgVector::m_triplexMask;
-	HandleCollision(timestep, normalDir, normalAccel, frictionCoeffecient);
-	for (dgInt32 k = 0; k < iter; k++) {
-		for (dgInt32 i = 0; i < m_particlesCount; i++) {
-			accel[i] = dgVector::m_zero; 
-			diagonal[i] = dgVector::m_zero; 
-		}
-/*
-		for (dgInt32 i = 0; i < m_linksCount; i++) {
-			const dgInt32 j0 = links[i].m_m0;
-			const dgInt32 j1 = links[i].m_m1;
+// the dot products are summed per grain of particles and then in grain order, so they do not depend on the thread count
+dgVector dgCollisionMassSpringDamperSystem::ReduceSum(dgInt32 count) const
+{
+	dgVector sum(dgVector::m_zero);
+	const dgVector* const partialSums = &m_partialSums[0];
+	for (dgInt32 i = 0; i < count; i += DG_MASS_SPRING_PARALLEL_GRAIN) {
+		sum += partialSums[i / DG_MASS_SPRING_PARALLEL_GRAIN];
+	}
+	return sum;
+}
 
-			const dgVector p0p1(posit[j0] - posit[j1]);
-			const dgVector v0v1(veloc[j0] - veloc[j1]);
-			const dgVector dpdv(p0p1 * v0v1);
+void dgCollisionMassSpringDamperSystem::IntegrateExplicit(dgFloat32 timestep)
+{
+	dgInt32 iter = 4;
+	dgSolverContext context;
+	context.m_me = this;
+	context.m_timestep = dgVector(timestep / iter);
+	context.m_scale = dgVector::m_zero;
 
-			const dgVector mag2(p0p1.DotProduct(p0p1));
-			const dgVector mask(mag2 > m_smallestLenght2);
+	for (dgInt32 k = 0; k < iter; k++) {
+		ParallelFor(m_linkBlocksCount, &context, CalculateLinkForcesKernel);
+		ParallelFor(m_particlesCount, &context, IntegrateParticlesKernel);
+	}
+}
 
-			const dgVector lenght2((mag2 & mask) | mag2.And__Not(mask));
-			const dgFloat32 length = (lenght2.Sqrt()).GetScalar();
-			const dgFloat32 invDen = dgFloat32(1.0f) / length;
-			const dgFloat32 lenghtRatio = restLenght[i] * invDen;
-			const dgFloat32 compression = dgFloat32(1.0f) - lenghtRatio;
-			const dgVector fs(p0p1.Scale(kSpring * compression));
-			const dgVector fd(p0p1.Scale(kDamper * invDen * invDen * (v0v1.DotProduct(p0p1)).GetScalar()));
-			const dgVector dfsdx(v0v1.Scale (ks_dt * compression) + ((p0p1 * dpdv).Scale (ks_dt * lenghtRatio * invDen * invDen)));
-			dgAssert(fs.m_w == dgFloat32(0.0f));
-			dgAssert(fs.m_w == dgFloat32(0.0f));
-			dgAssert(p0p1.m_w == dgFloat32(0.0f));
-			dgAssert(dfsdx.m_w == dgFloat32(0.0f));
+void dgCollisionMassSpringDamperSystem::CalculateLinkForcesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	const dgVector* const veloc = &me->m_veloc[0];
+	const dgVector* const posit = &me->m_posit[0];
+	const dgSpringDamperLinkBlock* const linkBlocks = &me->m_linkBlocks[0];
+	dgVector* const forces = &me->m_linkForces[0];
+	const dgVector dtRK4(solverContext->m_timestep);
+
+	// each lane of the vector registers is one link
+	for (dgInt32 i = start; i < start + count; i++) {
+		const dgSpringDamperLinkBlock& block = linkBlocks[i];
+		const dgInt32* const m0 = block.m_m0;
+		const dgInt32* const m1 = block.m_m1;
+
+		dgVector dx;
+		dgVector dy;
+		dgVector dz;
+		dgVector dw;
+		dgVector::Transpose4x4(dx, dy, dz, dw, posit[m0[0]] - posit[m1[0]], posit[m0[1]] - posit[m1[1]], posit[m0[2]] - posit[m1[2]], posit[m0[3]] - posit[m1[3]]);
+
+		dgVector dvx;
+		dgVector dvy;
+		dgVector dvz;
+		dgVector dvw;
+		dgVector::Transpose4x4(dvx, dvy, dvz, dvw, veloc[m0[0]] - veloc[m1[0]], veloc[m0[1]] - veloc[m1[1]], veloc[m0[2]] - veloc[m1[2]], veloc[m0[3]] - veloc[m1[3]]);
+
+		const dgVector p0p1Mag2(dx * dx + dy * dy + dz * dz);
+		const dgVector p0p1Mask(p0p1Mag2 > m_smallestLenght2);
+		const dgVector p0p1Length(m_smallestLenght2.Select(p0p1Mag2, p0p1Mask).Sqrt());
+		const dgVector p0p1InvMag(p0p1Length.Reciproc());
+		const dgVector p0p1InvMag2(p0p1InvMag * p0p1InvMag);
+		const dgVector v0v1DotP0p1(dvx * dx + dvy * dy + dvz * dz);
+
+		const dgVector k01(block.m_spring * (block.m_restlength - p0p1Length) * p0p1InvMag);
+		const dgVector d01(block.m_damper * v0v1DotP0p1 * p0p1InvMag2 * dgVector::m_negOne);
+		const dgVector h01dt(dtRK4 * block.m_spring * block.m_restlength * p0p1InvMag2 * p0p1InvMag * dgVector::m_negOne);
+		const dgVector netForce(k01 + d01 + h01dt * v0v1DotP0p1);
+
+		dgVector* const force = &forces[i * 4];
+		dgVector::Transpose4x4(force[0], force[1], force[2], force[3], dx * netForce, dy * netForce, dz * netForce, dgVector::m_zero);
+	}
+}
 
-			const dgVector nextAccel(fs + fd - dfsdx);
-			accel[j0] -= nextAccel;
-			accel[j1] += nextAccel;
+void dgCollisionMassSpringDamperSystem::IntegrateParticlesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	dgVector* const accel = &me->m_accel[0];
+	dgVector* const veloc = &me->m_veloc[0];
+	dgVector* const posit = &me->m_posit[0];
+	const dgVector* const extAccel = &me->m_externalAccel[0];
+	const dgVector* const normalDir = &me->m_normalDir[0];
+	const dgVector* const normalAccel = &me->m_normalAccel[0];
+	const dgFloat32* const frictionCoeffecient = &me->m_frictionCoefficient[0];
+	const dgInt32* const linkStart = &me->m_particleLinkStart[0];
+	const dgInt32* const links = &me->m_particleLinks[0];
+	const dgVector* const forces = &me->m_linkForces[0];
+	const dgVector dtRK4(solverContext->m_timestep);
+	const dgVector epsilon(dgFloat32(1.0e-14f));
+
+	for (dgInt32 i = start; i < start + count; i++) {
+		// the forces are added in link order, the same order a serial scatter would use
+		dgVector linkAccel(dgVector::m_zero);
+		for (dgInt32 j = linkStart[i]; j < linkStart[i + 1]; j++) {
+			const dgInt32 link = links[j];
+			if (link & 1) {
+				linkAccel -= forces[link >> 1];
+			} else {
+				linkAccel += forces[link >> 1];
+			}
 		}
-*/
-
-		for (dgInt32 i = 0; i < m_linksCount; i++) {
-			const dgInt32 j0 = links[i].m_m0;
-			const dgInt32 j1 = links[i].m_m1;
-			const dgVector p0p1(posit[j0] - posit[j1]);
-			const dgVector v0v1(veloc[j0] - veloc[j1]);
-			const dgVector dvdp(v0v1 * p0p1);
+		accel[i] = linkAccel;
+
+		dgVector netAccel (accel[i] + extAccel[i]);
+		dgVector tangentDir(veloc[i] - normalDir[i] * (normalDir[i].DotProduct(veloc[i])));
+		dgVector mag(tangentDir.DotProduct(tangentDir) + epsilon);
+		
+		dgFloat32 tangentFrictionAccel = dgAbs(netAccel.DotProduct(normalDir[i]).GetScalar());
+		dgVector friction(tangentDir.Scale(frictionCoeffecient[i] * tangentFrictionAccel / dgSqrt(mag.GetScalar())));
+
+		dgVector normalDirAccel(normalDir[i] * (netAccel.DotProduct(normalDir[i])));
+		netAccel = netAccel + normalAccel[i] - normalDirAccel - friction;
+		veloc[i] += netAccel * dtRK4;
+		posit[i] += veloc[i] * dtRK4;
+	}
+}
 
-			const dgVector p0p1Mag2(p0p1.DotProduct(p0p1));
-			const dgVector p0p1Mask(p0p1Mag2 > m_smallestLenght2);
-			//const dgVector p0p1Lenght2((p0p1Mag2 & p0p1Mask) | m_smallestLenght2.AndNot(p0p1Mask));
-			const dgVector p0p1Lenght2(m_smallestLenght2.Select (p0p1Mag2, p0p1Mask));
+// one backward Euler step: (I - h^2 * df/dx - h * df/dv) * dv = h * (f + h * df/dx * v)
+// solved with a Jacobi preconditioned conjugate gradient, the Jacobian is never assembled.
+// colliding particles can not accelerate into the contact, the rejected normal acceleration scales the friction
+// the same filter is applied to the search directions, so the solve never moves a particle along its contact normal
+void dgCollisionMassSpringDamperSystem::IntegrateImplicit(dgFloat32 timestep)
+{
+	dgSolverContext context;
+	context.m_me = this;
+	context.m_timestep = dgVector(timestep);
+	context.m_scale = dgVector(timestep * timestep);
+
+	ParallelFor(m_linkBlocksCount, &context, LinearizeLinksKernel);
+	ParallelFor(m_particlesCount, &context, InitResidualKernel);
+	dgVector residualDotResidual(ReduceSum(m_particlesCount));
+
+	const dgVector tolerance(residualDotResidual * dgVector(DG_MASS_SPRING_PCG_TOLERANCE));
+	for (dgInt32 j = 0; (j < DG_MASS_SPRING_PCG_MAX_ITERATIONS) && (residualDotResidual.GetScalar() > tolerance.GetScalar()); j++) {
+		ParallelFor(m_linkBlocksCount, &context, JacobianLinksKernel);
+		ParallelFor(m_particlesCount, &context, JacobianParticlesKernel);
+		const dgVector dirDotJacobianDir(ReduceSum(m_particlesCount));
+		if (dirDotJacobianDir.GetScalar() <= dgFloat32(1.0e-20f)) {
+			break;
+		}
 
-			const dgFloat32 p0p1Length = p0p1Lenght2.Sqrt().GetScalar();
-			const dgFloat32 p0p1InvMag = dgFloat32 (1.0f) / p0p1Length;
+		context.m_scale = dgVector(residualDotResidual.GetScalar() / dirDotJacobianDir.GetScalar());
+		ParallelFor(m_particlesCount, &context, UpdateResidualKernel);
+		const dgVector nextResidualDotResidual(ReduceSum(m_particlesCount));
 
-			const dgFloat32 k01 = -links[i].m_spring * (p0p1Length - links[i].m_restlength) * p0p1InvMag;
-			const dgFloat32 d01 = -links[i].m_damper * dvdp.GetScalar() * p0p1InvMag * p0p1InvMag;
-			const dgFloat32 h01dt = - dtRK4.GetScalar() * links[i].m_spring * links[i].m_restlength * p0p1InvMag * p0p1InvMag * p0p1InvMag;
+		context.m_scale = dgVector(nextResidualDotResidual.GetScalar() / residualDotResidual.GetScalar());
+		residualDotResidual = nextResidualDotResidual;
+		ParallelFor(m_particlesCount, &context, UpdateSearchDirKernel);
+	}
 
-			const dgVector diag ((p0p1 * p0p1).Scale(h01dt * dtRK4.GetScalar()));
+	ParallelFor(m_particlesCount, &context, IntegrateImplicitParticlesKernel);
+}
 
-			const dgFloat32 dtdfp0dx0 = h01dt * v0v1.DotProduct(p0p1).GetScalar();
-			const dgVector netForce (p0p1.Scale(k01 + d01 + dtdfp0dx0));
-			
+// linearize all links around the current state, each lane writes its right hand side and preconditioner terms
+void dgCollisionMassSpringDamperSystem::LinearizeLinksKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	const dgVector* const veloc = &me->m_veloc[0];
+	const dgVector* const posit = &me->m_posit[0];
+	const dgSpringDamperLinkBlock* const linkBlocks = &me->m_linkBlocks[0];
+	dgSpringDamperJacobianBlock* const jacobians = &me->m_linkJacobians[0];
+	dgVector* const forces = &me->m_linkForces[0];
+	dgVector* const diagonal = &me->m_linkDiagonal[0];
+	const dgVector h(solverContext->m_timestep);
+	const dgVector h2(solverContext->m_scale);
+
+	for (dgInt32 i = start; i < start + count; i++) {
+		const dgSpringDamperLinkBlock& block = linkBlocks[i];
+		const dgInt32* const m0 = block.m_m0;
+		const dgInt32* const m1 = block.m_m1;
+
+		dgVector dx;
+		dgVector dy;
+		dgVector dz;
+		dgVector dw;
+		dgVector::Transpose4x4(dx, dy, dz, dw, posit[m0[0]] - posit[m1[0]], posit[m0[1]] - posit[m1[1]], posit[m0[2]] - posit[m1[2]], posit[m0[3]] - posit[m1[3]]);
+
+		dgVector dvx;
+		dgVector dvy;
+		dgVector dvz;
+		dgVector dvw;
+		dgVector::Transpose4x4(dvx, dvy, dvz, dvw, veloc[m0[0]] - veloc[m1[0]], veloc[m0[1]] - veloc[m1[1]], veloc[m0[2]] - veloc[m1[2]], veloc[m0[3]] - veloc[m1[3]]);
+
+		const dgVector p0p1Mag2(dx * dx + dy * dy + dz * dz);
+		const dgVector p0p1Mask(p0p1Mag2 > m_smallestLenght2);
+		const dgVector p0p1Length(m_smallestLenght2.Select(p0p1Mag2, p0p1Mask).Sqrt());
+		const dgVector p0p1InvMag(p0p1Length.Reciproc());
+
+		const dgVector nx(dx * p0p1InvMag);
+		const dgVector ny(dy * p0p1InvMag);
+		const dgVector nz(dz * p0p1InvMag);
+		const dgVector normalSpeed(dvx * nx + dvy * ny + dvz * nz);
+
+		// a compressed spring has an indefinite transverse stiffness, clamping it keeps the system positive definite
+		const dgVector transverse((dgVector::m_one - block.m_restlength * p0p1InvMag).GetMax(dgVector::m_zero));
+		const dgVector stiffness(h2 * block.m_spring);
+		const dgVector alpha(stiffness * transverse);
+		const dgVector axialStiffness(stiffness - alpha);
+		const dgVector beta(axialStiffness + h * block.m_damper);
+
+		jacobians[i].m_nx = nx;
+		jacobians[i].m_ny = ny;
+		jacobians[i].m_nz = nz;
+		jacobians[i].m_alpha = alpha;
+		jacobians[i].m_beta = beta;
+
+		// h * f - h^2 * df/dx * v
+		const dgVector force((block.m_spring * (block.m_restlength - p0p1Length) - block.m_damper * normalSpeed) * h - axialStiffness * normalSpeed);
+		dgVector* const linkForce = &forces[i * 4];
+		dgVector::Transpose4x4(linkForce[0], linkForce[1], linkForce[2], linkForce[3], nx * force - alpha * dvx, ny * force - alpha * dvy, nz * force - alpha * dvz, dgVector::m_zero);
+
+		dgVector* const linkDiagonal = &diagonal[i * 4];
+		dgVector::Transpose4x4(linkDiagonal[0], linkDiagonal[1], linkDiagonal[2], linkDiagonal[3], alpha + beta * nx * nx, alpha + beta * ny * ny, alpha + beta * nz * nz, dgVector::m_zero);
+	}
+}
 
-			diagonal[j0] -= diag;
-			diagonal[j1] -= diag;
-			accel[j0] += netForce;
-			accel[j1] -= netForce;
+void dgCollisionMassSpringDamperSystem::InitResidualKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	const dgVector* const extAccel = &me->m_externalAccel[0];
+	const dgVector* const normalDir = &me->m_normalDir[0];
+	dgFloat32* const frictionAccel = &me->m_frictionCoefficient[0];
+	dgVector* const deltaVeloc = &me->m_deltaVeloc[0];
+	dgVector* const residual = &me->m_residual[0];
+	dgVector* const searchDir = &me->m_searchDir[0];
+	dgVector* const invDiagonal = &me->m_invDiagonal[0];
+	dgVector* const partialSums = &me->m_partialSums[0];
+	const dgInt32* const linkStart = &me->m_particleLinkStart[0];
+	const dgInt32* const links = &me->m_particleLinks[0];
+	const dgVector* const forces = &me->m_linkForces[0];
+	const dgVector* const diagonal = &me->m_linkDiagonal[0];
+	const dgVector h(solverContext->m_timestep);
+	const dgFloat32 invTimestep = dgFloat32(1.0f) / solverContext->m_timestep.GetScalar();
+
+	dgAssert(!(start % DG_MASS_SPRING_PARALLEL_GRAIN));
+	for (dgInt32 base = start; base < start + count; base += DG_MASS_SPRING_PARALLEL_GRAIN) {
+		dgVector residualDotResidual(dgVector::m_zero);
+		const dgInt32 end = dgMin(base + DG_MASS_SPRING_PARALLEL_GRAIN, start + count);
+		for (dgInt32 i = base; i < end; i++) {
+			residual[i] = extAccel[i] * h;
+			invDiagonal[i] = dgVector::m_one;
+			for (dgInt32 j = linkStart[i]; j < linkStart[i + 1]; j++) {
+				const dgInt32 link = links[j];
+				if (link & 1) {
+					residual[i] -= forces[link >> 1];
+				} else {
+					residual[i] += forces[link >> 1];
+				}
+				invDiagonal[i] += diagonal[link >> 1];
+			}
+
+			const dgVector normalImpulse(normalDir[i].DotProduct(residual[i]));
+			frictionAccel[i] *= dgAbs(normalImpulse.GetScalar()) * invTimestep;
+			residual[i] -= normalDir[i] * normalImpulse;
+			invDiagonal[i] = invDiagonal[i].Reciproc();
+			deltaVeloc[i] = dgVector::m_zero;
+			searchDir[i] = invDiagonal[i] * residual[i];
+			searchDir[i] -= normalDir[i] * normalDir[i].DotProduct(searchDir[i]);
+			residualDotResidual += searchDir[i].DotProduct(residual[i]);
 		}
+		partialSums[base / DG_MASS_SPRING_PARALLEL_GRAIN] = residualDotResidual;
+	}
+}
 
+// out = (I + sum (P)) * x, where each link adds P = alpha * I + beta * n * n' to the difference of its two particles
+void dgCollisionMassSpringDamperSystem::JacobianLinksKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	const dgVector* const x = &me->m_searchDir[0];
+	const dgSpringDamperLinkBlock* const linkBlocks = &me->m_linkBlocks[0];
+	const dgSpringDamperJacobianBlock* const jacobians = &me->m_linkJacobians[0];
+	dgVector* const forces = &me->m_linkForces[0];
+
+	for (dgInt32 i = start; i < start + count; i++) {
+		const dgInt32* const m0 = linkBlocks[i].m_m0;
+		const dgInt32* const m1 = linkBlocks[i].m_m1;
+		const dgSpringDamperJacobianBlock& jacobian = jacobians[i];
+
+		dgVector dx;
+		dgVector dy;
+		dgVector dz;
+		dgVector dw;
+		dgVector::Transpose4x4(dx, dy, dz, dw, x[m0[0]] - x[m1[0]], x[m0[1]] - x[m1[1]], x[m0[2]] - x[m1[2]], x[m0[3]] - x[m1[3]]);
+
+		const dgVector projection(jacobian.m_beta * (jacobian.m_nx * dx + jacobian.m_ny * dy + jacobian.m_nz * dz));
+
+		dgVector* const force = &forces[i * 4];
+		dgVector::Transpose4x4(force[0], force[1], force[2], force[3], jacobian.m_alpha * dx + jacobian.m_nx * projection, jacobian.m_alpha * dy + jacobian.m_ny * projection, jacobian.m_alpha * dz + jacobian.m_nz * projection, dgVector::m_zero);
+	}
+}
 
-		for (dgInt32 i = 0; i < m_particlesCount; i++) {
-			//dgVector dirAccel1 (collisionDir1[i] * accel[i].DotProduct(collisionDir1[i]));
-			//dgVector dirAccel2 (collisionDir2[i] * accel[i].DotProduct(collisionDir2[i]));
-			//tmp0[i] = accel[i] + collidingAccel[i] - dirAccel0 - dirAccel1 - dirAccel2;
-
-			dgVector netAccel (accel[i] + extAccel[i]);
-			dgVector tangentDir(veloc[i] - normalDir[i] * (normalDir[i].DotProduct(veloc[i])));
-			dgVector mag(tangentDir.DotProduct(tangentDir) + epsilon);
-			
-			dgFloat32 tangentFrictionAccel = dgAbs(netAccel.DotProduct(normalDir[i]).GetScalar());
-			dgVector friction(tangentDir.Scale(frictionCoeffecient[i] * tangentFrictionAccel / dgSqrt(mag.GetScalar())));
+// colliding particles have the component along the contact normal filtered out.
+void dgCollisionMassSpringDamperSystem::JacobianParticlesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	const dgVector* const normalDir = &me->m_normalDir[0];
+	const dgVector* const searchDir = &me->m_searchDir[0];
+	dgVector* const jacobianTimesDir = &me->m_jacobianTimesDir[0];
+	dgVector* const partialSums = &me->m_partialSums[0];
+	const dgInt32* const linkStart = &me->m_particleLinkStart[0];
+	const dgInt32* const links = &me->m_particleLinks[0];
+	const dgVector* const forces = &me->m_linkForces[0];
+
+	dgAssert(!(start % DG_MASS_SPRING_PARALLEL_GRAIN));
+	for (dgInt32 base = start; base < start + count; base += DG_MASS_SPRING_PARALLEL_GRAIN) {
+		dgVector dirDotJacobianDir(dgVector::m_zero);
+		const dgInt32 end = dgMin(base + DG_MASS_SPRING_PARALLEL_GRAIN, start + count);
+		for (dgInt32 i = base; i < end; i++) {
+			dgVector out(searchDir[i]);
+			for (dgInt32 j = linkStart[i]; j < linkStart[i + 1]; j++) {
+				const dgInt32 link = links[j];
+				if (link & 1) {
+					out -= forces[link >> 1];
+				} else {
+					out += forces[link >> 1];
+				}
+			}
+			out -= normalDir[i] * normalDir[i].DotProduct(out);
+			out -= normalDir[i] * normalDir[i].DotProduct(out);
+			jacobianTimesDir[i] = out;
+			dirDotJacobianDir += searchDir[i].DotProduct(out);
+		}
+		partialSums[base / DG_MASS_SPRING_PARALLEL_GRAIN] = dirDotJacobianDir;
+	}
+}
 
-			//dgVector particleAccel (accel[i] + normalAccel[i] - normalDirAccel);
-			dgVector normalDirAccel(normalDir[i] * (netAccel.DotProduct(normalDir[i])));
-			//accel[i] = accel[i] + normalAccel[i] - normalDirAccel - friction;
-			netAccel = netAccel + normalAccel[i] - normalDirAccel - friction;
-			veloc[i] += netAccel * dtRK4;
-			posit[i] += veloc[i] * dtRK4;
+void dgCollisionMassSpringDamperSystem::UpdateResidualKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	const dgVector* const searchDir = &me->m_searchDir[0];
+	const dgVector* const jacobianTimesDir = &me->m_jacobianTimesDir[0];
+	const dgVector* const invDiagonal = &me->m_invDiagonal[0];
+	dgVector* const deltaVeloc = &me->m_deltaVeloc[0];
+	dgVector* const residual = &me->m_residual[0];
+	dgVector* const partialSums = &me->m_partialSums[0];
+	const dgVector step(solverContext->m_scale);
+
+	dgAssert(!(start % DG_MASS_SPRING_PARALLEL_GRAIN));
+	for (dgInt32 base = start; base < start + count; base += DG_MASS_SPRING_PARALLEL_GRAIN) {
+		dgVector nextResidualDotResidual(dgVector::m_zero);
+		const dgInt32 end = dgMin(base + DG_MASS_SPRING_PARALLEL_GRAIN, start + count);
+		for (dgInt32 i = base; i < end; i++) {
+			deltaVeloc[i] += searchDir[i] * step;
+			residual[i] -= jacobianTimesDir[i] * step;
+			nextResidualDotResidual += residual[i].DotProduct(invDiagonal[i] * residual[i]);
 		}
+		partialSums[base / DG_MASS_SPRING_PARALLEL_GRAIN] = nextResidualDotResidual;
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::UpdateSearchDirKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	const dgVector* const normalDir = &me->m_normalDir[0];
+	const dgVector* const residual = &me->m_residual[0];
+	const dgVector* const invDiagonal = &me->m_invDiagonal[0];
+	dgVector* const searchDir = &me->m_searchDir[0];
+	const dgVector conjugate(solverContext->m_scale);
+
+	for (dgInt32 i = start; i < start + count; i++) {
+		const dgVector dir(invDiagonal[i] * residual[i]);
+		searchDir[i] = dir - normalDir[i] * normalDir[i].DotProduct(dir) + searchDir[i] * conjugate;
+	}
+}
+
+// the contact sets twice the separating speed and an acceleration that cancels it over the step, 
+// with a backward step the end velocity moves the particle, so only half of the acceleration is applied
+void dgCollisionMassSpringDamperSystem::IntegrateImplicitParticlesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSolverContext* const solverContext = (dgSolverContext*)context;
+	dgCollisionMassSpringDamperSystem* const me = solverContext->m_me;
+	dgVector* const veloc = &me->m_veloc[0];
+	dgVector* const posit = &me->m_posit[0];
+	const dgVector* const normalDir = &me->m_normalDir[0];
+	const dgVector* const normalAccel = &me->m_normalAccel[0];
+	const dgFloat32* const frictionAccel = &me->m_frictionCoefficient[0];
+	const dgVector* const deltaVeloc = &me->m_deltaVeloc[0];
+	const dgVector h(solverContext->m_timestep);
+	const dgFloat32 timestep = h.GetScalar();
+
+	const dgVector epsilon(dgFloat32(1.0e-14f));
+	const dgVector halfStep(h * dgVector::m_half);
+	for (dgInt32 i = start; i < start + count; i++) {
+		dgVector particleVeloc(veloc[i] + deltaVeloc[i] + normalAccel[i] * halfStep);
+		dgVector tangentDir(particleVeloc - normalDir[i] * normalDir[i].DotProduct(particleVeloc));
+		dgVector tangentSpeed((tangentDir.DotProduct(tangentDir) + epsilon).Sqrt());
+		dgFloat32 frictionSpeed = dgMin(frictionAccel[i] * timestep, tangentSpeed.GetScalar());
+		veloc[i] = particleVeloc - tangentDir.Scale(frictionSpeed / tangentSpeed.GetScalar());
+		posit[i] += veloc[i] * h;
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -29,6 +29,14 @@
 #include "dgCollisionDeformableMesh.h"
 
 
+#define DG_MASS_SPRING_PCG_MAX_ITERATIONS	64
+#define DG_MASS_SPRING_PCG_TOLERANCE		dgFloat32 (1.0e-6f)
+
+// systems with this many particles are integrated phase by phase by all the world threads, 
+// instead of as one job next to the rigid clusters
+#define DG_MASS_SPRING_PARALLEL_PARTICLES	4096
+#define DG_MASS_SPRING_PARALLEL_GRAIN		DG_LUMPED_MASS_PARALLEL_GRAIN
+
 class dgCollisionMassSpringDamperSystem: public dgCollisionDeformableMesh
 {
 	public:
@@ -37,9 +45,66 @@ class dgCollisionMassSpringDamperSystem: public dgCollisionDeformableMesh
 	dgCollisionMassSpringDamperSystem (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
 
 	virtual ~dgCollisionMassSpringDamperSystem(void);
+
+	bool GetImplicitIntegration() const;
+	void SetImplicitIntegration(bool state);
+	virtual bool SplitAcrossThreads() const;
+
+	protected:
+	// the linearized links of the implicit solver, four links in SoA layout
+	DG_MSC_VECTOR_ALIGMENT
+	class dgSpringDamperJacobianBlock
+	{
+		public:
+		dgVector m_nx;
+		dgVector m_ny;
+		dgVector m_nz;
+		dgVector m_alpha;
+		dgVector m_beta;
+	} DG_GCC_VECTOR_ALIGMENT;
+
+	DG_MSC_VECTOR_ALIGMENT
+	class dgSolverContext
+	{
+		public:
+		dgVector m_timestep;
+		dgVector m_scale;
+		dgCollisionMassSpringDamperSystem* m_me;
+	} DG_GCC_VECTOR_ALIGMENT;
+
+	virtual void FinalizeBuild();
 	virtual void CalculateAcceleration(dgFloat32 timestep);
 
-	dgInt32 GetMemoryBufferSizeInBytes() const;
+	void IntegrateExplicit(dgFloat32 timestep);
+	void IntegrateImplicit(dgFloat32 timestep);
+	void BuildParticleLinks();
+	dgVector ReduceSum(dgInt32 count) const;
+
+	static void dgApi CalculateLinkForcesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi IntegrateParticlesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi LinearizeLinksKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi InitResidualKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi JacobianLinksKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi JacobianParticlesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi UpdateResidualKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi UpdateSearchDirKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+	static void dgApi IntegrateImplicitParticlesKernel(dgWorld* const world, void* const context, dgInt32 start, dgInt32 count, dgInt32 threadID);
+
+	dgArray<dgSpringDamperJacobianBlock> m_linkJacobians;
+	dgArray<dgVector> m_deltaVeloc;
+	dgArray<dgVector> m_residual;
+	dgArray<dgVector> m_searchDir;
+	dgArray<dgVector> m_jacobianTimesDir;
+	dgArray<dgVector> m_invDiagonal;
+
+	// the links of each particle in link order, lane index * 2 plus one when the particle is the link second end.
+	// links write their forces to one slot per lane and the particles gather them, so no two threads write the same particle
+	dgArray<dgInt32> m_particleLinkStart;
+	dgArray<dgInt32> m_particleLinks;
+	dgArray<dgVector> m_linkForces;
+	dgArray<dgVector> m_linkDiagonal;
+	dgArray<dgVector> m_partialSums;
+	bool m_implicitIntegration;
 };
 
 
@@ -61,6 +61,8 @@ dgContactMaterial::dgContactMaterial()
 	m_normal_Force.m_force = dgFloat32 (0.0f);
 	m_normal_Force.m_impact = dgFloat32 (0.0f);
 	m_skinThickness = dgFloat32 (0.0f);
+	m_manifoldPoints = 0;
+	m_maxPairContacts = DG_CONSTRAINT_MAX_ROWS / 3;
 	m_flags = m_collisionEnable | m_friction0Enable | m_friction1Enable;
 }
 
@@ -80,8 +82,11 @@ dgContact::dgContact(dgWorld* const world, const dgContactMaterial* const materi
 	,m_isNewContact(1)
 	,m_skeletonIntraCollision(1)
 	,m_skeletonSelftCollision(1)
+	,m_activeStateChanged(0)
 {
 	dgAssert ((((dgUnsigned64) this) & 15) == 0);
+	m_supportVertexIndex[0] = -1;
+	m_supportVertexIndex[1] = -1;
 	m_maxDOF = 0;
 	m_isActive = 0;
 	m_enableCollision = true;
@@ -117,8 +122,11 @@ dgContact::dgContact(dgContact* const clone)
 	,m_isNewContact(clone->m_isNewContact)
 	,m_skeletonIntraCollision(clone->m_skeletonIntraCollision)
 	,m_skeletonSelftCollision(clone->m_skeletonSelftCollision)
+	,m_activeStateChanged(0)
 {
 	dgAssert((((dgUnsigned64) this) & 15) == 0);
+	m_supportVertexIndex[0] = clone->m_supportVertexIndex[0];
+	m_supportVertexIndex[1] = clone->m_supportVertexIndex[1];
 	m_body0 = clone->m_body0;
 	m_body1 = clone->m_body1;
 	m_maxDOF = clone->m_maxDOF;
@@ -148,6 +156,7 @@ void dgContact::SwapBodies()
 {
 	dgSwap (m_body0, m_body1);
 	dgSwap (m_link0, m_link1);
+	dgSwap (m_supportVertexIndex[0], m_supportVertexIndex[1]);
 }
 
 void dgContact::GetInfo (dgConstraintInfo* const info) const
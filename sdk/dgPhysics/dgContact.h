@@ -37,6 +37,7 @@ class dgCollisionInstance;
 #define DG_MAX_CONTATCS					128
 #define DG_RESTING_CONTACT_PENETRATION	(DG_PENETRATION_TOL + dgFloat32 (1.0f / 1024.0f))
 #define DG_DIAGONAL_PRECONDITIONER		dgFloat32 (25.0f)
+#define DG_MANIFOLD_NORMAL_TOLERANCE	dgFloat32 (0.9f)
 
 class dgContactList: public dgArray<dgContact*>
 {
@@ -175,6 +176,8 @@ class dgContactMaterial: public dgContactPoint
 	dgFloat32 m_dynamicFriction1;
 	dgFloat32 m_skinThickness;
 	dgInt32 m_flags;
+	dgInt16 m_manifoldPoints;
+	dgInt16 m_maxPairContacts;
 
 	private:
 	void *m_userData;
@@ -244,10 +247,12 @@ class dgContact: public dgConstraint, public dgList<dgContactMaterial>
 	dgFloat32 m_impulseSpeed;
 	dgFloat32 m_contactPruningTolereance;
 	dgUnsigned32 m_broadphaseLru;
+	dgInt32 m_supportVertexIndex[2];
 	dgUnsigned32 m_killContact				: 1;
 	dgUnsigned32 m_isNewContact				: 1;
 	dgUnsigned32 m_skeletonIntraCollision	: 1;
 	dgUnsigned32 m_skeletonSelftCollision	: 1;
+	dgUnsigned32 m_activeStateChanged		: 1;
 
     friend class dgBody;
 	friend class dgWorld;
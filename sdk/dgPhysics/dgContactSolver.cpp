@@ -62,8 +62,11 @@ dgContactSolver::dgContactSolver(dgCollisionInstance* const instance)
 	,m_proxy (NULL)
 	,m_instance0(instance)
 	,m_instance1(instance)
+	,m_supportVertexIndex(m_localSupportVertexIndex)
 	,m_vertexIndex(0)
 {
+	m_localSupportVertexIndex[0] = -1;
+	m_localSupportVertexIndex[1] = -1;
 }
 
 dgContactSolver::dgContactSolver(dgCollisionParamProxy* const proxy)
@@ -72,6 +75,7 @@ dgContactSolver::dgContactSolver(dgCollisionParamProxy* const proxy)
 	,m_proxy (proxy)
 	,m_instance0(proxy->m_instance0)
 	,m_instance1(proxy->m_instance1)
+	,m_supportVertexIndex(proxy->m_contactJoint->m_supportVertexIndex)
 	,m_vertexIndex(0)
 {
 }
@@ -86,8 +90,10 @@ DG_INLINE void dgContactSolver::SupportVertex(const dgVector& dir0, dgInt32 vert
 
 	const dgMatrix& matrix0 = m_instance0->m_globalMatrix;
 	const dgMatrix& matrix1 = m_instance1->m_globalMatrix;
-	dgVector p(matrix0.TransformVector(m_instance0->SupportVertexSpecial(matrix0.UnrotateVector (dir0), NULL)) & dgVector::m_triplexMask);
-	dgVector q(matrix1.TransformVector(m_instance1->SupportVertexSpecial(matrix1.UnrotateVector (dir1), NULL)) & dgVector::m_triplexMask);
+	// the support vertex of each shape is seeded with the previous one of the same contact, 
+	// successive directions are close, so hulls find the new support vertex in a few steps.
+	dgVector p(matrix0.TransformVector(m_instance0->SupportVertexSpecial(matrix0.UnrotateVector (dir0), &m_supportVertexIndex[0])) & dgVector::m_triplexMask);
+	dgVector q(matrix1.TransformVector(m_instance1->SupportVertexSpecial(matrix1.UnrotateVector (dir1), &m_supportVertexIndex[1])) & dgVector::m_triplexMask);
 	m_hullDiff[vertexIndex] = p - q;
 	m_hullSum[vertexIndex] = p + q;
 }
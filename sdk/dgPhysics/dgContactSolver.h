@@ -111,6 +111,8 @@ class dgContactSolver: public dgDownHeap<dgMinkFace *, dgFloat32>
 	dgCollisionInstance* m_instance1;
 	
 	dgFaceFreeList* m_freeFace; 
+	dgInt32* m_supportVertexIndex;
+	dgInt32 m_localSupportVertexIndex[2];
 	dgInt32 m_vertexIndex;
 	dgInt32 m_faceIndex;
 
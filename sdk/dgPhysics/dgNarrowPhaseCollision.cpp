@@ -1196,11 +1196,188 @@ dgInt32 dgWorld::PruneContacts (dgInt32 count, dgContactPoint* const contactArra
 			contactArray[0] = c0;
 			contactArray[1] = c1;
 		}
-		return 2;
+		// a material can limit a pair to a single contact
+		return dgMin (dgInt32 (2), maxCount);
 	}
 	return 1;
 }
 
+dgInt32 dgWorld::ReduceManifold(dgInt32 count, const dgContactPoint* const contactArray, const dgInt32* const indices, dgInt32 pointsPerManifold, dgInt8* const keep) const
+{
+	if (count <= pointsPerManifold) {
+		for (dgInt32 i = 0; i < count; i++) {
+			keep[indices[i]] = 1;
+		}
+		return count;
+	}
+
+	dgInt32 selected[DG_CONSTRAINT_MAX_ROWS / 3];
+	dgAssert(pointsPerManifold <= dgInt32 (sizeof (selected) / sizeof (selected[0])));
+	const dgFloat32 areaTol = dgFloat32(1.0e-6f);
+
+	// start with the deepest point
+	dgInt32 i0 = 0;
+	for (dgInt32 i = 1; i < count; i++) {
+		if (contactArray[indices[i]].m_penetration > contactArray[indices[i0]].m_penetration) {
+			i0 = i;
+		}
+	}
+	selected[0] = indices[i0];
+	dgInt32 selectedCount = 1;
+
+	const dgVector normal(contactArray[indices[i0]].m_normal);
+	const dgVector p0(contactArray[indices[i0]].m_point);
+
+	// the point farthest from it
+	dgInt32 i1 = -1;
+	dgFloat32 maxDist2 = areaTol;
+	for (dgInt32 i = 0; i < count; i++) {
+		const dgVector dp(contactArray[indices[i]].m_point - p0);
+		const dgFloat32 dist2 = dp.DotProduct(dp & dgVector::m_triplexMask).GetScalar();
+		if (dist2 > maxDist2) {
+			i1 = i;
+			maxDist2 = dist2;
+		}
+	}
+
+	dgInt32 i2 = -1;
+	dgFloat32 side = dgFloat32(0.0f);
+	if ((i1 >= 0) && (pointsPerManifold > 1)) {
+		selected[selectedCount++] = indices[i1];
+		const dgVector p1(contactArray[indices[i1]].m_point);
+
+		// the point that makes the largest triangle
+		const dgVector e10((p1 - p0) & dgVector::m_triplexMask);
+		dgFloat32 maxArea = areaTol;
+		for (dgInt32 i = 0; i < count; i++) {
+			const dgVector dp((contactArray[indices[i]].m_point - p0) & dgVector::m_triplexMask);
+			const dgFloat32 area = normal.DotProduct(e10.CrossProduct(dp)).GetScalar();
+			if (dgAbs(area) > maxArea) {
+				i2 = i;
+				side = area;
+				maxArea = dgAbs(area);
+			}
+		}
+
+		if ((i2 >= 0) && (pointsPerManifold > 2)) {
+			selected[selectedCount++] = indices[i2];
+			const dgVector p2(contactArray[indices[i2]].m_point);
+
+			// the point that adds the most area outside the triangle
+			const dgVector e21((p2 - p1) & dgVector::m_triplexMask);
+			const dgVector e02((p0 - p2) & dgVector::m_triplexMask);
+			const dgFloat32 sign = (side > dgFloat32(0.0f)) ? dgFloat32(1.0f) : dgFloat32(-1.0f);
+			dgInt32 i3 = -1;
+			dgFloat32 maxOutside = areaTol;
+			for (dgInt32 i = 0; (i < count) && (pointsPerManifold > 3); i++) {
+				const dgVector p(contactArray[indices[i]].m_point);
+				const dgFloat32 area0 = normal.DotProduct(e10.CrossProduct((p - p0) & dgVector::m_triplexMask)).GetScalar();
+				const dgFloat32 area1 = normal.DotProduct(e21.CrossProduct((p - p1) & dgVector::m_triplexMask)).GetScalar();
+				const dgFloat32 area2 = normal.DotProduct(e02.CrossProduct((p - p2) & dgVector::m_triplexMask)).GetScalar();
+				const dgFloat32 outside = -dgMin(sign * area0, dgMin(sign * area1, sign * area2));
+				if (outside > maxOutside) {
+					i3 = i;
+					maxOutside = outside;
+				}
+			}
+			if (i3 >= 0) {
+				selected[selectedCount++] = indices[i3];
+			}
+		}
+	}
+
+	// spread any extra points as far as possible from the ones already selected
+	while (selectedCount < pointsPerManifold) {
+		dgInt32 index = -1;
+		dgFloat32 maxMinDist2 = areaTol;
+		for (dgInt32 i = 0; i < count; i++) {
+			const dgVector p(contactArray[indices[i]].m_point);
+			dgFloat32 minDist2 = dgFloat32(1.0e20f);
+			for (dgInt32 j = 0; j < selectedCount; j++) {
+				const dgVector dp((p - contactArray[selected[j]].m_point) & dgVector::m_triplexMask);
+				minDist2 = dgMin(minDist2, dp.DotProduct(dp).GetScalar());
+			}
+			if (minDist2 > maxMinDist2) {
+				index = i;
+				maxMinDist2 = minDist2;
+			}
+		}
+		if (index < 0) {
+			break;
+		}
+		selected[selectedCount++] = indices[index];
+	}
+
+	for (dgInt32 i = 0; i < selectedCount; i++) {
+		keep[selected[i]] = 1;
+	}
+	return selectedCount;
+}
+
+dgInt32 dgWorld::ReduceContactManifolds(dgInt32 count, dgContactPoint* const contactArray, dgInt32 pointsPerManifold) const
+{
+	dgInt32 manifold[DG_MAX_CONTATCS];
+	dgInt32 manifoldFirst[DG_MAX_CONTATCS];
+	dgInt32 manifoldStart[DG_MAX_CONTATCS + 1];
+
+	// points from the same pair of sub shapes with similar normals form one manifold
+	dgAssert(count <= DG_MAX_CONTATCS);
+	dgInt32 manifoldCount = 0;
+	memset(manifoldStart, 0, sizeof(manifoldStart));
+	for (dgInt32 i = 0; i < count; i++) {
+		const dgContactPoint& point = contactArray[i];
+		dgInt32 index = manifoldCount;
+		for (dgInt32 j = 0; j < manifoldCount; j++) {
+			const dgContactPoint& first = contactArray[manifoldFirst[j]];
+			if ((first.m_collision0 == point.m_collision0) && (first.m_collision1 == point.m_collision1) && (first.m_normal.DotProduct(point.m_normal & dgVector::m_triplexMask).GetScalar() > DG_MANIFOLD_NORMAL_TOLERANCE)) {
+				index = j;
+				break;
+			}
+		}
+		if (index == manifoldCount) {
+			manifoldFirst[manifoldCount] = i;
+			manifoldCount++;
+		}
+		manifold[i] = index;
+		manifoldStart[index + 1]++;
+	}
+
+	bool reduce = false;
+	for (dgInt32 i = 0; i < manifoldCount; i++) {
+		reduce = reduce || (manifoldStart[i + 1] > pointsPerManifold);
+		manifoldStart[i + 1] += manifoldStart[i];
+	}
+	if (!reduce) {
+		return count;
+	}
+
+	dgInt32 sortedIndex[DG_MAX_CONTATCS];
+	dgInt32 scan[DG_MAX_CONTATCS];
+	memcpy(scan, manifoldStart, manifoldCount * sizeof(dgInt32));
+	for (dgInt32 i = 0; i < count; i++) {
+		sortedIndex[scan[manifold[i]]++] = i;
+	}
+
+	dgInt8 keep[DG_MAX_CONTATCS];
+	memset(keep, 0, count * sizeof(dgInt8));
+	for (dgInt32 i = 0; i < manifoldCount; i++) {
+		const dgInt32 start = manifoldStart[i];
+		ReduceManifold(manifoldStart[i + 1] - start, contactArray, &sortedIndex[start], pointsPerManifold, keep);
+	}
+
+	// compact in place, keeping the original order
+	dgInt32 newCount = 0;
+	for (dgInt32 i = 0; i < count; i++) {
+		if (keep[i]) {
+			if (i != newCount) {
+				contactArray[newCount] = contactArray[i];
+			}
+			newCount++;
+		}
+	}
+	return newCount;
+}
+
 dgInt32 dgWorld::PruneContactsByRank(dgInt32 count, dgCollisionParamProxy& proxy, dgInt32 maxCount) const
 {
 	dgJacobian jt[DG_CONSTRAINT_MAX_ROWS / 3];
@@ -1655,7 +1832,10 @@ void dgWorld::CalculateContacts (dgBroadPhase::dgPair* const pair, dgInt32 threa
 	}
 
 	if (pair->m_contactCount > 1) {
-		pair->m_contactCount = PruneContacts (pair->m_contactCount, pair->m_contactBuffer, contact->GetPruningTolerance(), 16);
+		if (material->m_manifoldPoints) {
+			pair->m_contactCount = ReduceContactManifolds (pair->m_contactCount, pair->m_contactBuffer, material->m_manifoldPoints);
+		}
+		pair->m_contactCount = PruneContacts (pair->m_contactCount, pair->m_contactBuffer, contact->GetPruningTolerance(), material->m_maxPairContacts);
 	}
 	pair->m_timestep = proxy.m_timestep;
 }
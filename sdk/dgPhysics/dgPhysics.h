@@ -53,6 +53,7 @@
 #include "dgCollisionHeightField.h"
 #include "dgCollisionConvexPolygon.h"
 #include "dgCollisionDeformableMesh.h"
+#include "dgCollisionMassSpringDamperSystem.h"
 #include "dgCollisionCompoundFractured.h"
 #include "dgCollisionLumpedMassParticles.h"
 
@@ -1424,6 +1424,19 @@ void dgSkeletonContainer::InitMassMatrix(const dgJointInfo* const jointInfoArray
 	m_rowCount = dgInt16 (rowCount);
 	m_auxiliaryRowCount = dgInt16 (auxiliaryCount);
 
+	if (m_world->GetDeterministicMode()) {
+		// self collision joints are added by the worker threads in arbitrary order, sort them by body ids
+		dgConstraint** const dynamicLoops = &m_loopingJoints[m_loopCount];
+		for (dgInt32 i = 1; i < m_dynamicsLoopCount; i++) {
+			dgInt32 j = i;
+			dgConstraint* const tmp = dynamicLoops[i];
+			for (; (j > 0) && (dgWorldDynamicUpdate::CompareJointBodies(dynamicLoops[j - 1], tmp) > 0); j--) {
+				dynamicLoops[j] = dynamicLoops[j - 1];
+			}
+			dynamicLoops[j] = tmp;
+		}
+	}
+
 	dgInt32 loopRowCount = 0;
 	const dgInt32 loopCount = m_loopCount + m_dynamicsLoopCount;
 	for (dgInt32 j = 0; j < loopCount; j++) {
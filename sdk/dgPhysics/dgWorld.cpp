@@ -235,6 +235,11 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	,m_solverJacobiansMemory (allocator, 64)
 	,m_solverRightHandSideMemory (allocator, 64)
 	,m_solverForceAccumulatorMemory (allocator, 64)
+	,m_activeTransforms (allocator)
+	,m_activeTransformsCount (0)
+	,m_contactEvents (allocator)
+	,m_contactEventsCount (0)
+	,m_contactEventsSequence (0)
 //	,m_concurrentUpdate(false)
 {
 	//TestAStart();
@@ -250,6 +255,11 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_solverJacobiansMemory.Resize(1024 * 64);
 	m_solverRightHandSideMemory.Resize(1024 * 64);
 	m_solverForceAccumulatorMemory.Resize(1024 * 32);
+	m_activeTransforms.Resize(1024);
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_threadContactEvents[i].SetAllocator(allocator);
+		m_threadContactEventsCount[i] = 0;
+	}
 
 	m_savetimestep = dgFloat32 (0.0f);
 	m_allocator = allocator;
@@ -263,16 +273,22 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_inUpdate = 0;
 	m_bodyGroupID = 0;
 	m_lastExecutionTime = 0;
+	m_stepStatsCount = 0;
+	memset (&m_currentStepStats, 0, sizeof (m_currentStepStats));
 	
 	m_defualtBodyGroupID = CreateBodyGroupID();
 	m_genericLRUMark = 0;
 	m_clusterLRU = 0;
 
 	m_useParallelSolver = 1;
+	m_deterministicMode = 0;
+	m_bufferContactEvents = 0;
 
 	m_solverIterations = DG_DEFAULT_SOLVER_ITERATION_COUNT;
 	m_dynamicsLru = 0;
 	m_numberOfSubsteps = 1;
+	m_stiffClusterSubsteps = 1;
+	m_stiffClusterMassRatio = dgFloat32 (0.0f);
 		
 	m_bodiesUniqueID = 0;
 	m_frictiomTheshold = dgFloat32 (0.25f);
@@ -392,6 +408,9 @@ void dgWorld::DestroyAllBodies()
 	jointList.DestroyJoints(*this);
 	bodyList.DestroyBodies(*this);
 
+	// the active transforms list can not hold deleted bodies
+	m_activeTransformsCount = 0;
+
 	dgAssert(me.GetFirst()->GetInfo().GetCount() == 0);
 	dgAssert(dgBodyCollisionList::GetCount() == 0);
 }
@@ -441,6 +460,33 @@ dgInt32 dgWorld::GetParallelSolverOnLargeIsland() const
 	return m_useParallelSolver ? 1 : 0;
 }
 
+void dgWorld::SetDeterministicMode(dgInt32 mode)
+{
+	m_deterministicMode = mode ? 1 : 0;
+}
+
+dgUnsigned32 dgWorld::CalculateStateHash() const
+{
+	// the master list order only depends on the order bodies were added and removed, 
+	// so two worlds with the same history hash their bodies in the same order.
+	dgUnsigned32 hash = 0;
+	const dgBodyMasterList& masterList = *this;
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst(); node; node = node->GetNext()) {
+		const dgBody* const body = node->GetInfo().GetBody();
+		if (body != m_sentinelBody) {
+			const dgInt32 uniqueID = body->GetUniqueID();
+			const dgMatrix& matrix = body->GetMatrix();
+			const dgVector& veloc = body->GetVelocity();
+			const dgVector& omega = body->GetOmega();
+			hash = dgCRC (&uniqueID, sizeof (uniqueID), hash);
+			hash = dgCRC (&matrix, sizeof (dgMatrix), hash);
+			hash = dgCRC (&veloc, sizeof (dgVector), hash);
+			hash = dgCRC (&omega, sizeof (dgVector), hash);
+		}
+	}
+	return hash;
+}
+
 
 void dgWorld::SetFrictionThreshold (dgFloat32 acceleration)
 {
@@ -580,6 +626,53 @@ void dgWorld::ExecuteUserJob (dgWorkerThreadTaskCallback userJobKernel, void* co
 	QueueJob (userJobKernel, this, userJobKernelContext, functionName);
 }
 
+class dgUserParallelForContext
+{
+	public:
+	dgWorld::OnUserParallelFor m_callback;
+	void* m_userData;
+	dgInt32 m_count;
+	dgInt32 m_grainSize;
+	dgInt32 m_atomicIndex;
+};
+
+void dgWorld::UserParallelForKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgUserParallelForContext* const parallelFor = (dgUserParallelForContext*) context;
+	dgWorld* const world = (dgWorld*) worldContext;
+	const dgInt32 count = parallelFor->m_count;
+	const dgInt32 grainSize = parallelFor->m_grainSize;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&parallelFor->m_atomicIndex, grainSize); i < count; i = dgAtomicExchangeAndAdd(&parallelFor->m_atomicIndex, grainSize)) {
+		parallelFor->m_callback (world, parallelFor->m_userData, i, dgMin (grainSize, count - i), threadID);
+	}
+}
+
+// calls back with ranges of at most grainSize items, the worker threads pull ranges until all items are done.
+// only one job per thread goes to the queue, regardless of the number of items.
+void dgWorld::ExecuteUserParallelFor (dgInt32 count, dgInt32 grainSize, OnUserParallelFor callback, void* const userData, const char* const functionName)
+{
+	grainSize = dgMax (grainSize, 1);
+	const dgInt32 threadCount = GetThreadCount();
+	if ((threadCount <= 1) || (count <= grainSize)) {
+		if (count > 0) {
+			callback (this, userData, 0, count, 0);
+		}
+	} else {
+		dgUserParallelForContext parallelFor;
+		parallelFor.m_callback = callback;
+		parallelFor.m_userData = userData;
+		parallelFor.m_count = count;
+		parallelFor.m_grainSize = grainSize;
+		parallelFor.m_atomicIndex = 0;
+		const dgInt32 jobCount = dgMin (threadCount, (count + grainSize - 1) / grainSize);
+		for (dgInt32 i = 0; i < jobCount; i ++) {
+			QueueJob (UserParallelForKernel, &parallelFor, this, functionName);
+		}
+		SynchronizationBarrier();
+	}
+}
+
 void dgWorld::SetUserData (void* const userData)
 {
 	m_userData = userData;
@@ -629,6 +722,12 @@ void dgWorld::ListenerSetPostUpdate(void* const listenerNode, OnListenerUpdateCa
 	listener.m_onPostUpdate = updateCallback;
 }
 
+void dgWorld::ListenerSetPostTransform(void* const listenerNode, OnListenerUpdateCallback updateCallback)
+{
+	dgListener& listener = ((dgListenerList::dgListNode*) listenerNode)->GetInfo();
+	listener.m_onPostTransform = updateCallback;
+}
+
 
 
 void* dgWorld::GetListenerUserData (void* const listenerNode) const
@@ -907,9 +1006,17 @@ void dgWorld::StepDynamics (dgFloat32 timestep)
 	m_inUpdate ++;
 
 	D_TRACKTIME();
+	const dgUnsigned64 skeletonTime = dgGetTimeInMicrosenconds();
 	UpdateSkeletons();
+	m_currentStepStats.m_clustersTime += dgUnsigned32 (dgGetTimeInMicrosenconds() - skeletonTime);
+
+	// events of the same pair recorded in different phases of the step are ordered by this sequence
+	m_contactEventsSequence ++;
 	UpdateBroadphase(timestep);
 	UpdateDynamics (timestep);
+	if (m_bufferContactEvents) {
+		CalculateContactImpacts();
+	}
 
 	if (m_listeners.GetCount()) {
 		for (dgListenerList::dgListNode* node = m_listeners.GetFirst(); node; node = node->GetNext()) {
@@ -941,11 +1048,26 @@ void dgWorld::Execute (dgInt32 threadID)
 
 void dgWorld::UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID)
 {
+	// moving bodies are collected in small local batches, so that threads only contend once per batch
+	const dgInt32 batchSize = 64;
+	dgBody* batch[batchSize];
+	dgInt32 batchCount = 0;
+	dgBody** const activeTransforms = &m_activeTransforms[0];
+
 	const dgInt32 threadsCount = GetThreadCount();
 	while (node) {
 		dgBody* const body = node->GetInfo().GetBody();
-		if (body->m_transformIsDirty && body->m_matrixUpdate) {
-			body->m_matrixUpdate (*body, body->m_matrix, threadID);
+		if (body->m_transformIsDirty) {
+			if (body->m_matrixUpdate) {
+				body->m_matrixUpdate (*body, body->m_matrix, threadID);
+			}
+			batch[batchCount] = body;
+			batchCount += (body != m_sentinelBody) ? 1 : 0;
+			if (batchCount == batchSize) {
+				const dgInt32 start = dgAtomicExchangeAndAdd(&m_activeTransformsCount, batchCount);
+				memcpy (&activeTransforms[start], batch, batchCount * sizeof (dgBody*));
+				batchCount = 0;
+			}
 		}
 		body->m_transformIsDirty = false;
 
@@ -953,6 +1075,10 @@ void dgWorld::UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threa
 			node = node ? node->GetNext() : NULL;
 		}
 	}
+	if (batchCount) {
+		const dgInt32 start = dgAtomicExchangeAndAdd(&m_activeTransformsCount, batchCount);
+		memcpy (&activeTransforms[start], batch, batchCount * sizeof (dgBody*));
+	}
 }
 
 void dgWorld::UpdateTransforms(void* const context, void* const nodePtr, dgInt32 threadID)
@@ -968,6 +1094,8 @@ void dgWorld::RunStep ()
 	
 	BeginSection();
 	dgUnsigned64 timeAcc = dgGetTimeInMicrosenconds();
+	const dgInt32 allocationCount = m_allocator->GetAllocationCount();
+	memset (&m_currentStepStats, 0, sizeof (m_currentStepStats));
 
 	dgFloat32 step = m_savetimestep / m_numberOfSubsteps;
 	for (dgUnsigned32 i = 0; i < m_numberOfSubsteps; i ++) {
@@ -979,24 +1107,194 @@ void dgWorld::RunStep ()
 		jointList.DestroyJoints (*this);
 		bodyList.DestroyBodies (*this);
 	}
+	MergeContactEvents();
 
 	const dgBodyMasterList* const masterList = this;
 	dgBodyMasterList::dgListNode* node = masterList->GetFirst();
 	const dgInt32 threadsCount = GetThreadCount();
+	const dgUnsigned64 transformTime = dgGetTimeInMicrosenconds();
+	m_activeTransformsCount = 0;
+	m_activeTransforms.ResizeIfNecessary(masterList->GetCount());
 	for (dgInt32 i = 0; i < threadsCount; i++) {
 		QueueJob(UpdateTransforms, this, node, "dgWorld::UpdateTransforms");
 		node = node ? node->GetNext() : NULL;
 	}
 	SynchronizationBarrier();
+	m_currentStepStats.m_integrationTime += dgUnsigned32 (dgGetTimeInMicrosenconds() - transformTime);
+
+	// the active transforms list is complete here, listeners that export it run before the user post update
+	for (dgListenerList::dgListNode* listenerNode = m_listeners.GetFirst(); listenerNode; listenerNode = listenerNode->GetNext()) {
+		dgListener& listener = listenerNode->GetInfo();
+		if (listener.m_onPostTransform) {
+			listener.m_onPostTransform(this, listener.m_userData, m_savetimestep);
+		}
+	}
 
 	if (m_onPostUpdateCallback) {
 		m_onPostUpdateCallback (this, m_savetimestep);
 	}
 
-	m_lastExecutionTime = (dgGetTimeInMicrosenconds() - timeAcc) * dgFloat32 (1.0e-6f);
+	const dgUnsigned64 executionTime = dgGetTimeInMicrosenconds() - timeAcc;
+	m_lastExecutionTime = executionTime * dgFloat32 (1.0e-6f);
+
+	m_currentStepStats.m_stepIndex = m_stepStatsCount;
+	m_currentStepStats.m_totalTime = dgUnsigned32 (executionTime);
+	m_currentStepStats.m_allocationCount = m_allocator->GetAllocationCount() - allocationCount;
+	m_stepStatsHistory[m_stepStatsCount & (DG_STEP_STATS_HISTORY - 1)] = m_currentStepStats;
+	m_stepStatsCount ++;
 	EndSection();
 }
 
+dgInt32 dgWorld::GetStepStats(dgWorldStepStats* const stats, dgInt32 maxCount) const
+{
+	// most recent step first
+	dgAssert (!(DG_STEP_STATS_HISTORY & (DG_STEP_STATS_HISTORY - 1)));
+	const dgInt32 count = dgInt32 (dgMin (dgUnsigned64 (dgClamp (maxCount, 0, DG_STEP_STATS_HISTORY)), m_stepStatsCount));
+	for (dgInt32 i = 0; i < count; i ++) {
+		stats[i] = m_stepStatsHistory[(m_stepStatsCount - 1 - i) & (DG_STEP_STATS_HISTORY - 1)];
+	}
+	return count;
+}
+
+// bodies whose matrix changed in the last update, in no particular order.
+// the list is valid until the next update, destroyed bodies are only deleted by the update or by DestroyAllBodies.
+dgInt32 dgWorld::GetActiveTransformsCount() const
+{
+	return m_activeTransformsCount;
+}
+
+dgBody* const* dgWorld::GetActiveTransforms() const
+{
+	return &m_activeTransforms[0];
+}
+
+// contact events of the last update sorted by body pair, and in the order they happened for each pair.
+// the list is valid until the next update, bodies in end events can be already destroyed.
+dgInt32 dgWorld::GetContactEventsCount() const
+{
+	return m_contactEventsCount;
+}
+
+const dgContactEvent* dgWorld::GetContactEvents() const
+{
+	return &m_contactEvents[0];
+}
+
+bool dgWorld::GetContactEventBuffering() const
+{
+	return m_bufferContactEvents ? true : false;
+}
+
+void dgWorld::SetContactEventBuffering(bool state)
+{
+	m_bufferContactEvents = state ? 1 : 0;
+	m_contactEventsCount = 0;
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_threadContactEventsCount[i] = 0;
+	}
+}
+
+void dgWorld::AddContactEvent(const dgContact* const contact, dgContactEvent::dgType type, dgInt32 threadIndex)
+{
+	// each thread appends to its own buffer, so the contact kernels never wait on each other
+	dgBody* const body0 = contact->GetBody0();
+	dgBody* const body1 = contact->GetBody1();
+	const bool swap = body0->m_uniqueID > body1->m_uniqueID;
+
+	dgContactEvent& event = m_threadContactEvents[threadIndex][m_threadContactEventsCount[threadIndex]];
+	event.m_point = dgVector::m_zero;
+	event.m_normal = dgVector::m_zero;
+	event.m_body0 = swap ? body1 : body0;
+	event.m_body1 = swap ? body0 : body1;
+	event.m_contact = contact;
+	event.m_impulse = dgFloat32 (0.0f);
+	event.m_body0Id = event.m_body0->m_uniqueID;
+	event.m_body1Id = event.m_body1->m_uniqueID;
+	event.m_sequence = m_contactEventsSequence;
+	event.m_type = type;
+	m_threadContactEventsCount[threadIndex] ++;
+}
+
+void dgWorld::CalculateContactImpacts()
+{
+	D_TRACKTIME();
+	// contacts that began this step are still alive, read the impulses the solver applied to them
+	const dgInt32 beginSequence = m_contactEventsSequence;
+	m_contactEventsSequence ++;
+	const dgInt32 threadCount = GetThreadCount();
+	for (dgInt32 thread = 0; thread < threadCount; thread ++) {
+		const dgInt32 count = m_threadContactEventsCount[thread];
+		for (dgInt32 i = 0; i < count; i ++) {
+			const dgContactEvent& event = m_threadContactEvents[thread][i];
+			if ((event.m_type == dgContactEvent::m_begin) && (event.m_sequence == beginSequence)) {
+				const dgContact* const contact = event.m_contact;
+				const dgContactMaterial* maxMaterial = NULL;
+				dgFloat32 maxImpulse = dgFloat32 (0.0f);
+				for (dgList<dgContactMaterial>::dgListNode* node = contact->GetFirst(); node; node = node->GetNext()) {
+					const dgContactMaterial& material = node->GetInfo();
+					if (material.m_normal_Force.m_impact > maxImpulse) {
+						maxImpulse = material.m_normal_Force.m_impact;
+						maxMaterial = &material;
+					}
+				}
+				if (maxMaterial) {
+					// impacts go to the first buffer, which can grow while this loop reads it
+					const dgVector point (maxMaterial->m_point);
+					const dgVector normal (maxMaterial->m_normal);
+					const dgBody* const normalBody = maxMaterial->m_body0;
+					AddContactEvent(contact, dgContactEvent::m_impact, 0);
+					dgContactEvent& impact = m_threadContactEvents[0][m_threadContactEventsCount[0] - 1];
+					impact.m_point = point;
+					impact.m_normal = (impact.m_body0 == normalBody) ? normal : normal.Scale(dgFloat32 (-1.0f));
+					impact.m_impulse = maxImpulse;
+				}
+			}
+		}
+	}
+	m_contactEventsSequence ++;
+}
+
+void dgWorld::MergeContactEvents()
+{
+	D_TRACKTIME();
+	m_contactEventsCount = 0;
+	if (m_bufferContactEvents) {
+		for (dgInt32 thread = 0; thread < DG_MAX_THREADS_HIVE_COUNT; thread ++) {
+			const dgInt32 count = m_threadContactEventsCount[thread];
+			if (count) {
+				m_contactEvents.ResizeIfNecessary(m_contactEventsCount + count);
+				dgContactEvent* const dst = &m_contactEvents[m_contactEventsCount];
+				const dgContactEvent* const src = &m_threadContactEvents[thread][0];
+				for (dgInt32 i = 0; i < count; i ++) {
+					dst[i] = src[i];
+				}
+				m_contactEventsCount += count;
+				m_threadContactEventsCount[thread] = 0;
+			}
+		}
+		if (m_contactEventsCount > 1) {
+			dgSort (&m_contactEvents[0], m_contactEventsCount, CompareContactEvents);
+		}
+	}
+}
+
+dgInt32 dgWorld::CompareContactEvents(const dgContactEvent* const eventA, const dgContactEvent* const eventB, void* notUsed)
+{
+	if (eventA->m_body0Id < eventB->m_body0Id) {
+		return -1;
+	}
+	if (eventA->m_body0Id > eventB->m_body0Id) {
+		return 1;
+	}
+	if (eventA->m_body1Id < eventB->m_body1Id) {
+		return -1;
+	}
+	if (eventA->m_body1Id > eventB->m_body1Id) {
+		return 1;
+	}
+	return eventA->m_sequence - eventB->m_sequence;
+}
+
 void dgWorld::TickCallback(dgInt32 threadID)
 {
 	RunStep();
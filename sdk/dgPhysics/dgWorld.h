@@ -39,6 +39,7 @@
 
 #define DG_SLEEP_ENTRIES					8
 #define DG_MAX_DESTROYED_BODIES_BY_FORCE	8
+#define DG_STEP_STATS_HISTORY				64
 
 class dgBody;
 class dgDynamicBody;
@@ -114,6 +115,52 @@ class dgSolverProgressiveSleepEntry
 	dgInt32 m_steps;
 };
 
+// timings in microseconds of one world update accumulated over all sub steps,
+// the counters are the values of the last sub step.
+class dgWorldStepStats
+{
+	public:
+	dgUnsigned64 m_stepIndex;
+	dgUnsigned32 m_broadphaseTime;		// force callbacks, sleep states and broadphase tree update
+	dgUnsigned32 m_pairsTime;			// new colliding pairs
+	dgUnsigned32 m_contactsTime;		// contact generation
+	dgUnsigned32 m_clustersTime;		// skeleton update and island build
+	dgUnsigned32 m_solverTime;			// joint solver, small islands and soft bodies integrate here too
+	dgUnsigned32 m_integrationTime;		// large islands integration and transform callbacks
+	dgUnsigned32 m_totalTime;
+	dgInt32 m_pairCount;
+	dgInt32 m_contactCount;
+	dgInt32 m_clusterCount;
+	dgInt32 m_rowCount;
+	dgInt32 m_sleepingBodyCount;
+	dgInt32 m_allocationCount;
+};
+
+// contact changes recorded during the update when contact event buffering is enabled,
+// body0 is always the body with the lower unique id
+DG_MSC_VECTOR_ALIGMENT
+class dgContactEvent
+{
+	public:
+	enum dgType
+	{
+		m_begin,
+		m_end,
+		m_impact,
+	};
+
+	dgVector m_point;					// point of largest impulse, impact events only
+	dgVector m_normal;					// contact normal at that point, impact events only
+	dgBody* m_body0;
+	dgBody* m_body1;
+	const dgContact* m_contact;			// only valid during the step the contact begins
+	dgFloat32 m_impulse;				// largest normal impulse, impact events only
+	dgInt32 m_body0Id;
+	dgInt32 m_body1Id;
+	dgInt32 m_sequence;
+	dgInt32 m_type;
+} DG_GCC_VECTOR_ALIGMENT;
+
 class dgWorldThreadPool: public dgThreadHive
 {
 	public:
@@ -179,6 +226,8 @@ class dgWorld
 	typedef void (dgApi *OnCollisionInstanceDestroy) (const dgWorld* const world, const dgCollisionInstance* const collision);
 	typedef void (dgApi *OnCollisionInstanceDuplicate) (const dgWorld* const world, dgCollisionInstance* const collision, const dgCollisionInstance* const sourceCollision);
 
+	typedef void (dgApi *OnUserParallelFor) (dgWorld* const world, void* const userData, dgInt32 start, dgInt32 count, dgInt32 threadID);
+
 	typedef void (dgApi *OnJointSerializationCallback) (const dgUserConstraint* const joint, dgSerialize funt, void* const serilalizeObject);
 	typedef void (dgApi *OnJointDeserializationCallback) (const dgBody* const body0, const dgBody* const body1, dgDeserialize funt, void* const serilalizeObject);
 
@@ -196,6 +245,7 @@ class dgWorld
 			,m_userData(NULL)
 			,m_onPreUpdate(NULL)
 			,m_onPostUpdate(NULL)
+			,m_onPostTransform(NULL)
 			,m_onDebugCallback(NULL)
 			,m_onListenerDestroy(NULL)
 			,m_onBodyDestroy(NULL)
@@ -214,6 +264,7 @@ class dgWorld
 		void* m_userData;
 		OnListenerUpdateCallback m_onPreUpdate;
 		OnListenerUpdateCallback m_onPostUpdate;
+		OnListenerUpdateCallback m_onPostTransform;
 		OnListenerDebugCallback m_onDebugCallback;
 		OnListenerDestroyCallback m_onListenerDestroy;
 		OnListenerBodyDestroyCallback m_onBodyDestroy;
@@ -238,6 +289,13 @@ class dgWorld
 	~dgWorld();
 
 	dgFloat32 GetUpdateTime() const;
+	dgInt32 GetStepStats(dgWorldStepStats* const stats, dgInt32 maxCount) const;
+	dgInt32 GetActiveTransformsCount() const;
+	dgBody* const* GetActiveTransforms() const;
+	dgInt32 GetContactEventsCount() const;
+	const dgContactEvent* GetContactEvents() const;
+	bool GetContactEventBuffering() const;
+	void SetContactEventBuffering(bool state);
 	dgBroadPhase* GetBroadPhase() const;
 
 	dgInt32 GetSolverIterations() const;
@@ -249,6 +307,10 @@ class dgWorld
 	void EnableParallelSolverOnLargeIsland(dgInt32 mode);
 	dgInt32 GetParallelSolverOnLargeIsland() const;
 
+	void SetDeterministicMode(dgInt32 mode);
+	dgInt32 GetDeterministicMode() const;
+	dgUnsigned32 CalculateStateHash() const;
+
 	void FlushCache();
 
 	virtual dgUnsigned64 GetTimeInMicrosenconds() const;
@@ -289,6 +351,7 @@ class dgWorld
 	void ListenerSetDestroyCallback (void* const listener, OnListenerDestroyCallback destroyCallback);
 	void ListenerSetPreUpdate (void* const listener, OnListenerUpdateCallback updateCallback);
 	void ListenerSetPostUpdate (void* const listener, OnListenerUpdateCallback updateCallback);
+	void ListenerSetPostTransform (void* const listener, OnListenerUpdateCallback updateCallback);
 	
 	void SetListenerBodyDebugCallback (void* const listener, OnListenerDebugCallback callback);
 	void SetListenerBodyDestroyCallback (void* const listener, OnListenerBodyDestroyCallback callback);
@@ -399,6 +462,7 @@ class dgWorld
 	
 	//Parallel Job dispatcher for user related stuff
 	void ExecuteUserJob (dgWorkerThreadTaskCallback userJobKernel, void* const userJobKernelContext, const char* const functionName);
+	void ExecuteUserParallelFor (dgInt32 count, dgInt32 grainSize, OnUserParallelFor callback, void* const userData, const char* const functionName);
 
 	void BodyEnableSimulation (dgBody* const body);
 	void BodyDisableSimulation (dgBody* const body);
@@ -418,6 +482,12 @@ class dgWorld
 
 	void SetSubsteps (dgInt32 subSteps);
 	dgInt32 GetSubsteps () const;
+
+	void SetStiffClusterSubsteps (dgFloat32 massRatio, dgInt32 subSteps);
+	dgFloat32 GetStiffClusterMassRatio () const;
+	dgInt32 GetStiffClusterSubsteps () const;
+
+	bool IsInUpdate () const;
 	
 	private:
 	class dgAdressDistPair
@@ -431,6 +501,7 @@ class dgWorld
 	void CalculateContacts (dgBroadPhase::dgPair* const pair, dgInt32 threadIndex, bool ccdMode, bool intersectionTestOnly);
 
 	dgInt32 PruneContacts (dgInt32 count, dgContactPoint* const contact, dgFloat32 distTolerenace, dgInt32 maxCount = (DG_CONSTRAINT_MAX_ROWS / 3)) const;
+	dgInt32 ReduceContactManifolds (dgInt32 count, dgContactPoint* const contact, dgInt32 pointsPerManifold) const;
 	dgInt32 CalculateConvexPolygonToHullContactsDescrete (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculatePolySoupToHullContactsDescrete (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateConvexToNonConvexContactsContinue (dgCollisionParamProxy& proxy) const;
@@ -465,6 +536,7 @@ class dgWorld
 	dgInt32 Prune3dContacts(const dgMatrix& matrix, dgInt32 count, dgContactPoint* const contact, int maxCount, dgFloat32 distTol) const;
 	dgInt32 Prune2dContacts(const dgMatrix& matrix, dgInt32 count, dgContactPoint* const contact, int maxCount, dgFloat32 distTol) const;
 	DG_INLINE dgInt32 PruneSupport(int count, const dgVector& dir, const dgVector* points) const;
+	dgInt32 ReduceManifold(dgInt32 count, const dgContactPoint* const contact, const dgInt32* const indices, dgInt32 pointsPerManifold, dgInt8* const keep) const;
 
 	DG_INLINE dgBody* FindRoot(dgBody* const body) const;
 	DG_INLINE dgBody* FindRootAndSplit(dgBody* const body) const;
@@ -476,10 +548,17 @@ class dgWorld
 
 	static dgUnsigned32 dgApi GetPerformanceCount ();
 	static void UpdateTransforms(void* const context, void* const node, dgInt32 threadID);
+	static void UserParallelForKernel(void* const context, void* const worldContext, dgInt32 threadID);
 	static dgInt32 SortFaces (const dgAdressDistPair* const A, const dgAdressDistPair* const B, void* const context);
 	static dgInt32 CompareJointByInvMass (const dgBilateralConstraint* const jointA, const dgBilateralConstraint* const jointB, void* notUsed);
+	static dgInt32 CompareContactEvents (const dgContactEvent* const eventA, const dgContactEvent* const eventB, void* notUsed);
+
+	void AddContactEvent (const dgContact* const contact, dgContactEvent::dgType type, dgInt32 threadIndex);
+	void CalculateContactImpacts ();
+	void MergeContactEvents ();
 
 	dgUnsigned32 m_numberOfSubsteps;
+	dgUnsigned32 m_stiffClusterSubsteps;
 	dgUnsigned32 m_dynamicsLru;
 	dgUnsigned32 m_inUpdate;
 	dgUnsigned32 m_solverIterations;
@@ -487,9 +566,12 @@ class dgWorld
 	dgUnsigned32 m_defualtBodyGroupID;
 	dgUnsigned32 m_bodiesUniqueID;
 	dgUnsigned32 m_useParallelSolver;
+	dgUnsigned32 m_deterministicMode;
+	dgUnsigned32 m_bufferContactEvents;
 	dgUnsigned32 m_genericLRUMark;
 	dgInt32 m_clusterLRU;
 
+	dgFloat32 m_stiffClusterMassRatio;
 	dgFloat32 m_freezeAccel2;
 	dgFloat32 m_freezeAlpha2;
 	dgFloat32 m_freezeSpeed2;
@@ -500,6 +582,9 @@ class dgWorld
 	dgFloat32 m_lastExecutionTime;
 
 	dgSolverProgressiveSleepEntry m_sleepTable[DG_SLEEP_ENTRIES];
+	dgWorldStepStats m_currentStepStats;
+	dgWorldStepStats m_stepStatsHistory[DG_STEP_STATS_HISTORY];
+	dgUnsigned64 m_stepStatsCount;
 	
 	dgBroadPhase* m_broadPhase; 
 	dgDynamicBody* m_sentinelBody;
@@ -526,6 +611,13 @@ class dgWorld
 	dgArray<dgUnsigned8> m_solverJacobiansMemory;  
 	dgArray<dgUnsigned8> m_solverRightHandSideMemory;
 	dgArray<dgUnsigned8> m_solverForceAccumulatorMemory;
+	dgArray<dgBody*> m_activeTransforms;
+	dgInt32 m_activeTransformsCount;
+	dgArray<dgContactEvent> m_contactEvents;
+	dgInt32 m_contactEventsCount;
+	dgInt32 m_contactEventsSequence;
+	dgArray<dgContactEvent> m_threadContactEvents[DG_MAX_THREADS_HIVE_COUNT];
+	dgInt32 m_threadContactEventsCount[DG_MAX_THREADS_HIVE_COUNT];
 	
 	friend class dgBody;
 	friend class dgSolver;
@@ -591,6 +683,32 @@ inline dgInt32 dgWorld::GetSubsteps () const
 	return m_numberOfSubsteps;
 }
 
+inline void dgWorld::SetStiffClusterSubsteps (dgFloat32 massRatio, dgInt32 subSteps)
+{
+	m_stiffClusterMassRatio = dgMax (massRatio, dgFloat32 (0.0f));
+	m_stiffClusterSubsteps = dgClamp(subSteps, 1, 8);
+}
+
+inline dgFloat32 dgWorld::GetStiffClusterMassRatio () const
+{
+	return m_stiffClusterMassRatio;
+}
+
+inline dgInt32 dgWorld::GetStiffClusterSubsteps () const
+{
+	return m_stiffClusterSubsteps;
+}
+
+inline bool dgWorld::IsInUpdate () const
+{
+	return m_inUpdate ? true : false;
+}
+
+inline dgInt32 dgWorld::GetDeterministicMode() const
+{
+	return m_deterministicMode ? 1 : 0;
+}
+
 inline dgFloat32 dgWorld::GetUpdateTime() const
 {
 	return m_lastExecutionTime;
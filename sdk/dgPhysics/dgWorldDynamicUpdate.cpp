@@ -48,6 +48,8 @@ class dgWorldDynamicUpdateSyncDescriptor
 	
 	dgInt32 m_clusterCount;
 	dgInt32 m_firstCluster;
+	dgInt32 m_atomicSoftBodiesCounter;
+	dgInt32 m_softBodiesCount;
 };
 
 
@@ -106,9 +108,24 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	sentinelBody->m_equilibrium = 1;
 	sentinelBody->m_dynamicsLru = m_markLru;
 
+	dgWorldStepStats& stepStats = world->m_currentStepStats;
+	const dgUnsigned64 clustersTime = dgGetTimeInMicrosenconds();
+
 	BuildClusters(timestep);
 	const dgInt32 threadCount = world->GetThreadCount();	
 
+	dgInt32 rowCount = 0;
+	for (dgInt32 i = 0; i < m_clusters; i ++) {
+		rowCount += m_clusterData[i].m_rowCount;
+	}
+	stepStats.m_rowCount = rowCount;
+	stepStats.m_clusterCount = m_clusters;
+
+	// the large island solver adds its integration pass to the integration time
+	const dgUnsigned32 integrationTime = stepStats.m_integrationTime;
+	const dgUnsigned64 solverTime = dgGetTimeInMicrosenconds();
+	stepStats.m_clustersTime += dgUnsigned32 (solverTime - clustersTime);
+
 	dgWorldDynamicUpdateSyncDescriptor descriptor;
 	descriptor.m_timestep = timestep;
 
@@ -121,7 +138,7 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 //useParallelSolver = 0;
 	if (useParallelSolver) {
 		dgInt32 count = 0;
-		for (dgInt32 i = 0; (i < m_clusters) && (m_clusterData[index + i].m_jointCount >= DG_PARALLEL_JOINT_COUNT_CUT_OFF); i++) {
+		for (dgInt32 i = 0; ((index + i) < m_clusters) && (m_clusterData[index + i].m_jointCount >= DG_PARALLEL_JOINT_COUNT_CUT_OFF); i++) {
 			count++;
 		}
 		if (count) {
@@ -130,27 +147,28 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 		}
 	}
 
-	if (index < m_clusters) {
+	// large soft bodies split each phase of their integration across all the threads,
+	// so they run here, where they can queue their own jobs
+	for (dgInt32 i = 0; i < m_softBodiesCount; i++) {
+		if (IsSplitSoftBody(&m_clusterData[i])) {
+			IntegrateSoftBody(&m_clusterData[i], 0, timestep);
+		}
+	}
+
+	// the other soft bodies are queued as ordinary jobs together with the small clusters,
+	// so their integration overlaps the rigid body solver instead of running after it on one thread
+	if ((index < m_clusters) || m_softBodiesCount) {
 		descriptor.m_atomicCounter = 0;
 		descriptor.m_firstCluster = index;
 		descriptor.m_clusterCount = m_clusters - index;
+		descriptor.m_atomicSoftBodiesCounter = 0;
+		descriptor.m_softBodiesCount = m_softBodiesCount;
 		for (dgInt32 i = 0; i < threadCount; i ++) {
 			world->QueueJob (CalculateClusterReactionForcesKernel, &descriptor, world, "dgWorldDynamicUpdate::CalculateClusterReactionForces");
 		}
 		world->SynchronizationBarrier();
 	}
-
-	dgBodyInfo* const bodyArrayPtr = &world->m_bodiesMemory[0];
-	for (dgInt32 i = 0; i < m_softBodiesCount; i++) {
-		dgBodyCluster* const cluster = &m_clusterData[i];
-//		IntegrateExternalForce(cluster, timestep, 0);
-		dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
-		dgAssert (cluster->m_bodyCount == 2);
-		dgDynamicBody* const body = (dgDynamicBody*)bodyArray[1].m_body;
-		dgAssert (body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI));
-		body->IntegrateOpenLoopExternalForce(timestep);
-		IntegrateVelocity(cluster, DG_SOLVER_MAX_ERROR, timestep, 0);
-	}
+	stepStats.m_solverTime += dgUnsigned32 (dgGetTimeInMicrosenconds() - solverTime) - (stepStats.m_integrationTime - integrationTime);
 
 	m_clusterData = NULL;
 }
@@ -170,13 +188,73 @@ dgInt32 dgWorldDynamicUpdate::CompareKey(dgInt32 highA, dgInt32 lowA, dgInt32 hi
 	return 0;
 }
 
-dgInt32 dgWorldDynamicUpdate::CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void*)
+dgInt32 dgWorldDynamicUpdate::CompareJointBodies(const dgConstraint* const jointA, const dgConstraint* const jointB)
+{
+	const dgInt32 idA0 = jointA->GetBody0()->GetUniqueID();
+	const dgInt32 idA1 = jointA->GetBody1()->GetUniqueID();
+	const dgInt32 idB0 = jointB->GetBody0()->GetUniqueID();
+	const dgInt32 idB1 = jointB->GetBody1()->GetUniqueID();
+
+	const dgInt32 lowA = dgMin(idA0, idA1);
+	const dgInt32 lowB = dgMin(idB0, idB1);
+	if (lowA < lowB) {
+		return -1;
+	} else if (lowA > lowB) {
+		return 1;
+	}
+
+	const dgInt32 highA = dgMax(idA0, idA1);
+	const dgInt32 highB = dgMax(idB0, idB1);
+	if (highA < highB) {
+		return -1;
+	} else if (highA > highB) {
+		return 1;
+	}
+
+	const dgInt32 typeA = jointA->GetId();
+	const dgInt32 typeB = jointB->GetId();
+	if (typeA < typeB) {
+		return -1;
+	} else if (typeA > typeB) {
+		return 1;
+	}
+
+	// only bilateral joints can share a body pair and a type,
+	// order them by creation so the result does not depend on the input order
+	if (jointA->IsBilateral() && jointB->IsBilateral()) {
+		const dgUnsigned32 serialA = ((const dgBilateralConstraint*)jointA)->m_serialNumber;
+		const dgUnsigned32 serialB = ((const dgBilateralConstraint*)jointB)->m_serialNumber;
+		if (serialA < serialB) {
+			return -1;
+		} else if (serialA > serialB) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+dgInt32 dgWorldDynamicUpdate::CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* context)
 {
-	return CompareKey(infoA->m_jointCount, infoA->m_setId, infoB->m_jointCount, infoB->m_setId);
+	// the place holders of the soft bodies go first, in the same order as their clusters
+	const dgInt32 softA = infoA->m_jointCount ? 0 : infoA->m_body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI);
+	const dgInt32 softB = infoB->m_jointCount ? 0 : infoB->m_body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI);
+	if (softA != softB) {
+		return softA ? -1 : 1;
+	}
+	dgInt32 test = CompareKey(infoA->m_jointCount, infoA->m_setId, infoB->m_jointCount, infoB->m_setId);
+	if (!test && context && infoA->m_jointCount) {
+		// deterministic mode, joints of the same cluster are ordered by body ids
+		test = CompareJointBodies(infoA->m_joint, infoB->m_joint);
+	}
+	return test;
 }
 
 dgInt32 dgWorldDynamicUpdate::CompareClusterInfos(const dgBodyCluster* const clusterA, const dgBodyCluster* const clusterB, void* notUsed)
 {
+	// soft bodies go first, the solver integrates them as a separate range
+	if (clusterA->m_hasSoftBodies != clusterB->m_hasSoftBodies) {
+		return clusterA->m_hasSoftBodies ? -1 : 1;
+	}
 	return CompareKey(clusterA->m_jointCount, clusterA->m_bodyStart, clusterB->m_jointCount, clusterB->m_bodyStart);
 }
 
@@ -278,8 +356,9 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 				cluster.m_bodyCount = 2;
 				cluster.m_jointCount = 0;
 				cluster.m_rowCount = 0;
-				cluster.m_hasSoftBodies = 0;
+				cluster.m_hasSoftBodies = body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI) ? 1 : 0;
 				cluster.m_isContinueCollision = 0;
+				cluster.m_substeps = 1;
 				cluster.m_bodyStart = root->m_index;
 
 				clustersCount ++;
@@ -311,6 +390,7 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 				cluster.m_hasSoftBodies = 0;
 				cluster.m_bodyStart = root->m_index;
 				cluster.m_isContinueCollision = 0;
+				cluster.m_substeps = 1;
 
 				clustersCount++;
 				bodyInfoCount += root->m_disjointInfo.m_bodyCount + 1;
@@ -325,8 +405,13 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	m_clusterData = &world->m_clusterMemory[0];
 //	dgSort(augmentedJointArray, augmentedJointCount, CompareJointInfos);
 //	dgSort(m_clusterData, clustersCount, CompareClusterInfos);
-	dgParallelSort(*world, augmentedJointArray, augmentedJointCount, CompareJointInfos);
-	dgParallelSort(*world, m_clusterData, clustersCount, CompareClusterInfos);
+	if (world->m_deterministicMode) {
+		dgSort(augmentedJointArray, augmentedJointCount, CompareJointInfos, world);
+		dgSort(m_clusterData, clustersCount, CompareClusterInfos);
+	} else {
+		dgParallelSort(*world, augmentedJointArray, augmentedJointCount, CompareJointInfos);
+		dgParallelSort(*world, m_clusterData, clustersCount, CompareClusterInfos);
+	}
 
 	dgInt32 rowStart = 0;
 	dgInt32 bodyStart = 0;
@@ -347,14 +432,19 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	world->m_bodiesMemory.ResizeIfNecessary(bodyStart);
 
 	rowStart = 0;
+	const dgFloat32 stiffMassRatio = world->m_stiffClusterMassRatio;
+	const dgInt32 stiffSubsteps = world->m_stiffClusterSubsteps;
 	for (dgInt32 i = 0; i < clustersCount; i++) {
-		const dgBodyCluster& cluster = m_clusterData[i];
+		dgBodyCluster& cluster = m_clusterData[i];
 		dgBodyInfo* const bodyArray = &world->m_bodiesMemory[cluster.m_bodyStart];
 		dgJointInfo* const jointSetArray = &augmentedJointArray[cluster.m_jointStart];
 		bodyArray[0].m_body = world->GetSentinelBody();
 
 		if (cluster.m_jointCount) {
 			dgInt32 bodyIndex = 1;
+			dgInt32 substeps = 1;
+			dgFloat32 minInvMass = dgFloat32 (1.0e10f);
+			dgFloat32 maxInvMass = dgFloat32 (0.0f);
 			for (dgInt32 j = 0; j < cluster.m_jointCount; j++) {
 				dgJointInfo* const jointInfo = &jointSetArray[j];
 				dgConstraint* const joint = jointInfo->m_joint;
@@ -369,6 +459,9 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 						bodyArray[bodyIndex].m_body = body0;
 						bodyIndex++;
 						dgAssert(bodyIndex <= cluster.m_bodyCount);
+						substeps = dgMax (substeps, body0->GetSolverSubsteps());
+						minInvMass = dgMin (minInvMass, body0->m_invMass.m_w);
+						maxInvMass = dgMax (maxInvMass, body0->m_invMass.m_w);
 					}
 					m0 = body0->m_index;
 				}
@@ -381,6 +474,9 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 						bodyArray[bodyIndex].m_body = body1;
 						bodyIndex++;
 						dgAssert(bodyIndex <= cluster.m_bodyCount);
+						substeps = dgMax (substeps, body1->GetSolverSubsteps());
+						minInvMass = dgMin (minInvMass, body1->m_invMass.m_w);
+						maxInvMass = dgMax (maxInvMass, body1->m_invMass.m_w);
 					}
 					m1 = body1->m_index;
 				}
@@ -390,6 +486,12 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 				jointInfo->m_pairStart = rowStart;
 				rowStart += jointInfo->m_pairCount; 
 			}
+
+			// clusters with a large mass ratio are stiff, they get extra solver sub steps, everything else runs one step
+			if ((stiffMassRatio > dgFloat32 (0.0f)) && (maxInvMass > minInvMass * stiffMassRatio)) {
+				substeps = dgMax (substeps, stiffSubsteps);
+			}
+			cluster.m_substeps = substeps;
 		} else {
 			dgAssert(cluster.m_bodyCount == 2);
 			bodyArray[1].m_body = jointSetArray[0].m_body;
@@ -429,6 +531,16 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForcesKernel (void* const con
 
 	dgFloat32 timestep = descriptor->m_timestep;
 	dgWorld* const world = (dgWorld*) worldContext;
+
+	// soft bodies go first, they are usually the most expensive items in the queue
+	const dgInt32 softBodiesCount = descriptor->m_softBodiesCount;
+	const dgBodyCluster* const softBodies = world->m_clusterData;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicSoftBodiesCounter, 1); i < softBodiesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicSoftBodiesCounter, 1)) {
+		if (!world->IsSplitSoftBody(&softBodies[i])) {
+			world->IntegrateSoftBody (&softBodies[i], threadID, timestep);
+		}
+	}
+
 	dgInt32 count = descriptor->m_clusterCount;
 	dgBodyCluster* const clusters = &world->m_clusterData[descriptor->m_firstCluster];
 
@@ -438,6 +550,24 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForcesKernel (void* const con
 	}
 }
 
+bool dgWorldDynamicUpdate::IsSplitSoftBody(const dgBodyCluster* const cluster) const
+{
+	dgWorld* const world = (dgWorld*) this;
+	const dgBodyInfo* const bodyArray = &world->m_bodiesMemory[cluster->m_bodyStart];
+	const dgDynamicBody* const body = (dgDynamicBody*)bodyArray[1].m_body;
+	const dgCollisionLumpedMassParticles* const lumpedMassShape = (dgCollisionLumpedMassParticles*)body->m_collision->GetChildShape();
+	return lumpedMassShape->SplitAcrossThreads();
+}
+
+void dgWorldDynamicUpdate::IntegrateSoftBody(const dgBodyCluster* const cluster, dgInt32 threadID, dgFloat32 timestep) const
+{
+	D_TRACKTIME();
+	dgAssert (cluster->m_bodyCount == 2);
+	dgAssert (((dgWorld*)this)->m_bodiesMemory[cluster->m_bodyStart + 1].m_body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI));
+	IntegrateExternalForce(cluster, timestep, threadID);
+	IntegrateVelocity(cluster, DG_SOLVER_MAX_ERROR, timestep, threadID);
+}
+
 dgInt32 dgWorldDynamicUpdate::GetJacobianDerivatives(dgContraintDescritor& constraintParam, dgJointInfo* const jointInfo, dgConstraint* const constraint, dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide, dgInt32 rowCount) const
 {
 	dgInt32 dof = dgInt32(constraint->m_maxDOF);
@@ -118,6 +118,7 @@ class dgBodyCluster
 	dgInt32 m_rowStart;
 	dgInt16 m_hasSoftBodies;
 	dgInt16 m_isContinueCollision;
+	dgInt32 m_substeps;
 };
 
 class dgJointImpulseInfo
@@ -242,9 +243,11 @@ class dgWorldDynamicUpdate
 	virtual dgInt32 GetJacobianDerivatives (dgContraintDescritor& constraintParamOut, dgJointInfo* const jointInfo, dgConstraint* const constraint, dgLeftHandSide* const matrixRow, dgRightHandSide* const rightHandSide, dgInt32 rowCount) const;
 	virtual void CalculateNetAcceleration (dgBody* const body, const dgVector& invTimeStep, const dgVector& accNorm) const;
 
+	static dgInt32 CompareJointBodies(const dgConstraint* const jointA, const dgConstraint* const jointB);
+
 	private:
 	static DG_INLINE dgInt32 CompareKey(dgInt32 highA, dgInt32 lowA, dgInt32 highB, dgInt32 lowB);
-	static dgInt32 CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* notUsed);
+	static dgInt32 CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* context);
 	static dgInt32 CompareClusterInfos (const dgBodyCluster* const clusterA, const dgBodyCluster* const clusterB, void* notUsed);
 
 	void BuildClusters(dgFloat32 timestep);
@@ -261,6 +264,8 @@ class dgWorldDynamicUpdate
 	void IntegrateReactionsForces(const dgBodyCluster* const cluster, dgInt32 threadID, dgFloat32 timestep) const;
 	void BuildJacobianMatrix (const dgBodyInfo* const bodyInfo, dgJointInfo* const jointInfo, dgJacobian* const internalForces, dgLeftHandSide* const matrixRow, dgRightHandSide* const rightHandSide, dgFloat32 forceImpulseScale) const;
 	void CalculateClusterReactionForces(const dgBodyCluster* const cluster, dgInt32 threadID, dgFloat32 timestep) const;
+	void IntegrateSoftBody(const dgBodyCluster* const cluster, dgInt32 threadID, dgFloat32 timestep) const;
+	bool IsSplitSoftBody(const dgBodyCluster* const cluster) const;
 
 	void IntegrateInslandParallel(dgParallelClusterArray* const clusters, dgInt32 threadID);
 	void CalculateReactionForcesParallel(const dgBodyCluster* const clusters, dgInt32 clustersCount, dgFloat32 timestep);
@@ -58,19 +58,22 @@ void dgWorldDynamicUpdate::CalculateReactionForcesParallel(const dgBodyCluster*
 	dgBodyInfo* const bodyArray = &world->m_bodiesMemory[m_bodies];
 	dgJointInfo* const jointArray = &world->m_jointsMemory[m_joints];
 
-	if (world->GetCurrentPlugin()) {
+	// plugin solvers accumulate joint forces in thread order, deterministic mode always uses the built in solver
+	if (world->GetCurrentPlugin() && !world->m_deterministicMode) {
 		dgWorldPlugin* const plugin = world->GetCurrentPlugin()->GetInfo().m_plugin;
 		plugin->CalculateJointForces(cluster, bodyArray, jointArray, timestep);
 	} else {
 		m_parallelSolver.CalculateJointForces(cluster, bodyArray, jointArray, timestep);
 	}
 
+	const dgUnsigned64 integrationTime = dgGetTimeInMicrosenconds();
 	dgParallelClusterArray integrateCluster(clusterArray, clustersCount, timestep);
 	const dgInt32 threadCounts = world->GetThreadCount();
 	for (dgInt32 i = 0; i < threadCounts; i++) {
 		world->QueueJob(IntegrateClustersParallelKernel, &integrateCluster, world, "dgWorldDynamicUpdate::IntegrateClustersParallelKernel");
 	}
 	world->SynchronizationBarrier();
+	world->m_currentStepStats.m_integrationTime += dgUnsigned32 (dgGetTimeInMicrosenconds() - integrationTime);
 }
 
 void dgWorldDynamicUpdate::IntegrateClustersParallelKernel(void* const context, void* const worldPtr, dgInt32 threadID)
@@ -98,11 +101,13 @@ dgBodyCluster dgWorldDynamicUpdate::MergeClusters(const dgBodyCluster* const clu
 	dgInt32 bodyCount = 0;
 	dgInt32 jointsCount = 0;
 	dgInt32 rowCount = 0;
+	dgInt32 substeps = 1;
 	for (dgInt32 i = 0; i < clustersCount; i++) {
 		const dgBodyCluster* const srcCluster = &clusterArray[i];
 		bodyCount += srcCluster->m_bodyCount - 1;
 		jointsCount += srcCluster->m_jointCount;
 		rowCount += srcCluster->m_rowCount;
+		substeps = dgMax (substeps, srcCluster->m_substeps);
 	}
 
 	world->m_solverMemory.Init(world, rowCount, 2 * bodyCount);
@@ -162,6 +167,7 @@ dgBodyCluster dgWorldDynamicUpdate::MergeClusters(const dgBodyCluster* const clu
 	cluster.m_rowStart = 0;
 	cluster.m_isContinueCollision = 0;
 	cluster.m_hasSoftBodies = 0;
+	cluster.m_substeps = substeps;
 
 	return cluster;
 }
@@ -389,7 +395,7 @@ void dgParallelBodySolver::TransposeMassMatrix(dgInt32 threadID)
 	}
 }
 
-DG_INLINE void dgParallelBodySolver::BuildJacobianMatrix(dgJointInfo* const jointInfo, dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide, dgJacobian* const internalForces)
+DG_INLINE void dgParallelBodySolver::BuildJacobianMatrix(dgJointInfo* const jointInfo, dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide, dgJacobian* const internalForces, dgJacobian* const jointForces)
 {
 	const dgInt32 m0 = jointInfo->m_m0;
 	const dgInt32 m1 = jointInfo->m_m1;
@@ -473,6 +479,12 @@ DG_INLINE void dgParallelBodySolver::BuildJacobianMatrix(dgJointInfo* const join
 		forceAcc1 = forceAcc1.MulAdd(JtM1, f1);
 	}
 
+	if (jointForces) {
+		(dgWorkGroupFloat&)jointForces[0] = forceAcc0;
+		(dgWorkGroupFloat&)jointForces[1] = forceAcc1;
+		return;
+	}
+
 	if (m0) {
 		dgWorkGroupFloat& out = (dgWorkGroupFloat&)internalForces[m0];
 		dgScopeSpinPause lock(&m_bodyProxyArray[m0].m_lock);
@@ -527,6 +539,7 @@ void dgParallelBodySolver::InitJacobianMatrix(dgInt32 threadID)
 	dgLeftHandSide* const leftHandSide = &m_world->m_solverMemory.m_leftHandSizeBuffer[0];
 	dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
 	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
+	dgJacobian* const jointForces = m_deterministicMode ? &m_jointForceBuffer[0] : NULL;
 
 	dgContraintDescritor constraintParams;
 	constraintParams.m_world = m_world;
@@ -544,11 +557,11 @@ void dgParallelBodySolver::InitJacobianMatrix(dgInt32 threadID)
 		dgAssert(jointInfo->m_m0 != jointInfo->m_m1);
 		const dgInt32 rowBase = dgAtomicExchangeAndAdd(&m_jacobianMatrixRowAtomicIndex, jointInfo->m_pairCount);
 		m_world->GetJacobianDerivatives(constraintParams, jointInfo, constraint, leftHandSide, rightHandSide, rowBase);
-		BuildJacobianMatrix(jointInfo, leftHandSide, rightHandSide, internalForces);
+		BuildJacobianMatrix(jointInfo, leftHandSide, rightHandSide, internalForces, jointForces ? &jointForces[i * 2] : NULL);
 	}
 }
 
-dgInt32 dgParallelBodySolver::CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* notUsed)
+dgInt32 dgParallelBodySolver::CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* context)
 {
 	const dgInt32 restingA = (infoA->m_joint->m_body0->m_resting & infoA->m_joint->m_body1->m_resting) ? 1 : 0;
 	const dgInt32 restingB = (infoB->m_joint->m_body0->m_resting & infoB->m_joint->m_body1->m_resting) ? 1 : 0;
@@ -562,7 +575,32 @@ dgInt32 dgParallelBodySolver::CompareJointInfos(const dgJointInfo* const infoA,
 	if (countA > countB) {
 		return -1;
 	}
-	return 0;
+	return context ? dgWorldDynamicUpdate::CompareJointBodies(infoA->m_joint, infoB->m_joint) : 0;
+}
+
+void dgParallelBodySolver::AccumulateJointForces(dgJacobian* const internalForces, dgInt32 jointCount) const
+{
+	// reduce the joint forces in joint order, so that the sum does not depend on which thread solved each joint
+	const dgJacobian* const jointForces = &m_jointForceBuffer[0];
+	for (dgInt32 i = 0; i < m_cluster->m_bodyCount; i++) {
+		internalForces[i].m_linear = dgVector::m_zero;
+		internalForces[i].m_angular = dgVector::m_zero;
+	}
+	for (dgInt32 i = 0; i < jointCount; i++) {
+		const dgJointInfo* const jointInfo = &m_jointArray[i];
+		if (jointInfo->m_joint) {
+			const dgInt32 m0 = jointInfo->m_m0;
+			const dgInt32 m1 = jointInfo->m_m1;
+			if (m0) {
+				internalForces[m0].m_linear += jointForces[i * 2].m_linear;
+				internalForces[m0].m_angular += jointForces[i * 2].m_angular;
+			}
+			if (m1) {
+				internalForces[m1].m_linear += jointForces[i * 2 + 1].m_linear;
+				internalForces[m1].m_angular += jointForces[i * 2 + 1].m_angular;
+			}
+		}
+	}
 }
 
 void dgParallelBodySolver::InitJacobianMatrix()
@@ -571,15 +609,27 @@ void dgParallelBodySolver::InitJacobianMatrix()
 	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
 	memset(internalForces, 0, m_cluster->m_bodyCount * sizeof (dgJacobian));
 
+	if (m_deterministicMode) {
+		m_jointForceBuffer.ResizeIfNecessary(m_jointCount * DG_WORK_GROUP_SIZE * 2);
+		m_jointAccelNorm.ResizeIfNecessary(m_jointCount * DG_WORK_GROUP_SIZE);
+	}
+
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(InitJacobianMatrixKernel, this, NULL, "dgParallelBodySolver::InitJacobianMatrix");
 	}
 	m_world->SynchronizationBarrier();
 
+	if (m_deterministicMode) {
+		AccumulateJointForces(internalForces, m_cluster->m_jointCount);
+	}
+
 #ifdef D_USE_SOA_SOLVER
 	dgJointInfo* const jointArray = m_jointArray;
-//	dgSort(jointArray, m_cluster->m_jointCount, CompareJointInfos);
-	dgParallelSort(*m_world, jointArray, m_cluster->m_jointCount, CompareJointInfos);
+	if (m_deterministicMode) {
+		dgSort(jointArray, m_cluster->m_jointCount, CompareJointInfos, m_world);
+	} else {
+		dgParallelSort(*m_world, jointArray, m_cluster->m_jointCount, CompareJointInfos);
+	}
 
 	const dgInt32 jointCount = m_jointCount * DG_WORK_GROUP_SIZE;
 	for (dgInt32 i = m_cluster->m_jointCount; i < jointCount; i++) {
@@ -806,7 +856,16 @@ void dgParallelBodySolver::CalculateJointsForce()
 		m_world->QueueJob(CalculateJointsForceKernel, this, NULL, "dgParallelBodySolver::CalculateJointsForce");
 	}
 	m_world->SynchronizationBarrier();
-	memcpy(internalForces, tempInternalForces, bodyCount * sizeof(dgJacobian));
+
+	if (m_deterministicMode) {
+#ifdef D_USE_SOA_SOLVER
+		AccumulateJointForces(internalForces, m_jointCount * DG_WORK_GROUP_SIZE);
+#else
+		AccumulateJointForces(internalForces, m_cluster->m_jointCount);
+#endif
+	} else {
+		memcpy(internalForces, tempInternalForces, bodyCount * sizeof(dgJacobian));
+	}
 }
 
 void dgParallelBodySolver::CalculateJointsAcceleration()
@@ -843,7 +902,7 @@ void dgParallelBodySolver::InitSkeletons(dgInt32 threadID)
 void dgParallelBodySolver::UpdateSkeletons(dgInt32 threadID)
 {
 	const dgInt32 count = m_skeletonCount;
-	const dgInt32 threadCounts = m_world->GetThreadCount();
+	const dgInt32 threadCounts = m_deterministicMode ? 1 : m_world->GetThreadCount();
 	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
 	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
 
@@ -876,6 +935,12 @@ void dgParallelBodySolver::InitSkeletons()
 
 void dgParallelBodySolver::UpdateSkeletons()
 {
+	if (m_deterministicMode) {
+		// skeletons with loop joints to the same body add forces to that body, 
+		// solve them in skeleton order so the sum does not depend on thread timing
+		UpdateSkeletons(0);
+		return;
+	}
 	const dgInt32 threadCounts = m_world->GetThreadCount();
 	for (dgInt32 i = 0; i < threadCounts; i++) {
 		m_world->QueueJob(UpdateSkeletonsKernel, this, NULL, "dgParallelBodySolver::UpdateSkeletons");
@@ -1136,6 +1201,7 @@ void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 		}
 
 		dgBodyProxy* const bodyProxyArray = m_bodyProxyArray;
+		dgJacobian* const jointForces = m_deterministicMode ? &m_jointForceBuffer[i * DG_WORK_GROUP_SIZE * 2] : NULL;
 		dgJacobian* const tempInternalForces = &m_world->m_solverMemory.m_internalForcesBuffer[m_cluster->m_bodyCount];
 		for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j++) {
 			const dgJointInfo* const joint = &jointInfo[j];
@@ -1152,6 +1218,12 @@ void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 				const dgInt32 m0 = jointInfo[j].m_m0;
 				const dgInt32 m1 = jointInfo[j].m_m1;
 
+				if (jointForces) {
+					jointForces[j * 2] = m_body0Force;
+					jointForces[j * 2 + 1] = m_body1Force;
+					continue;
+				}
+
 				if (m0) {
 					dgScopeSpinPause lock(&bodyProxyArray[m0].m_lock);
 					tempInternalForces[m0].m_linear += m_body0Force.m_linear;
@@ -1164,6 +1236,9 @@ void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 				}
 			}
 		}
+		if (m_deterministicMode) {
+			m_jointAccelNorm[i] = accel2;
+		}
 		accNorm += accel2;
 	}
 	m_accelNorm[threadID] = accNorm;
@@ -1313,15 +1388,24 @@ void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 			torqueM1 = torqueM1.MulAdd(lhs->m_Jt.m_jacobianM1.m_angular, f);
 		}
 
-		if (m0) {
-			dgScopeSpinPause lock(&bodyProxyArray[m0].m_lock);
-			tempInternalForces[m0].m_linear += forceM0;
-			tempInternalForces[m0].m_angular += torqueM0;
-		}
-		if (m1) {
-			dgScopeSpinPause lock(&bodyProxyArray[m1].m_lock);
-			tempInternalForces[m1].m_linear += forceM1;
-			tempInternalForces[m1].m_angular += torqueM1;
+		if (m_deterministicMode) {
+			dgJacobian* const jointForces = &m_jointForceBuffer[i * 2];
+			jointForces[0].m_linear = forceM0;
+			jointForces[0].m_angular = torqueM0;
+			jointForces[1].m_linear = forceM1;
+			jointForces[1].m_angular = torqueM1;
+			m_jointAccelNorm[i] = accel2.GetScalar();
+		} else {
+			if (m0) {
+				dgScopeSpinPause lock(&bodyProxyArray[m0].m_lock);
+				tempInternalForces[m0].m_linear += forceM0;
+				tempInternalForces[m0].m_angular += torqueM0;
+			}
+			if (m1) {
+				dgScopeSpinPause lock(&bodyProxyArray[m1].m_lock);
+				tempInternalForces[m1].m_linear += forceM1;
+				tempInternalForces[m1].m_angular += torqueM1;
+			}
 		}
 
 		accNorm += accel2;
@@ -1338,14 +1422,27 @@ void dgParallelBodySolver::CalculateForces()
 	const dgInt32 threadCounts = m_world->GetThreadCount();
 
 	InitSkeletons();
-	for (dgInt32 step = 0; step < 4; step++) {
+	const dgInt32 derivativesEvaluationsRK4 = 4 * m_cluster->m_substeps;
+	for (dgInt32 step = 0; step < derivativesEvaluationsRK4; step++) {
 		CalculateJointsAcceleration();
 		dgFloat32 accNorm = DG_SOLVER_MAX_ERROR * dgFloat32(2.0f);
 		for (dgInt32 k = 0; (k < passes) && (accNorm > DG_SOLVER_MAX_ERROR); k++) {
 			CalculateJointsForce();
 			accNorm = dgFloat32(0.0f);
-			for (dgInt32 i = 0; i < threadCounts; i++) {
-				accNorm = dgMax(accNorm, m_accelNorm[i]);
+			if (m_deterministicMode) {
+				// same as the single thread norm, regardless of how the work was split
+#ifdef D_USE_SOA_SOLVER
+				const dgInt32 count = m_jointCount;
+#else
+				const dgInt32 count = m_cluster->m_jointCount;
+#endif
+				for (dgInt32 i = 0; i < count; i++) {
+					accNorm += m_jointAccelNorm[i];
+				}
+			} else {
+				for (dgInt32 i = 0; i < threadCounts; i++) {
+					accNorm = dgMax(accNorm, m_accelNorm[i]);
+				}
 			}
 		}
 		UpdateSkeletons();
@@ -1373,12 +1470,13 @@ void dgParallelBodySolver::CalculateJointForces(const dgBodyCluster& cluster, dg
 	m_timestep = timestep;
 	m_invTimestep = (timestep > dgFloat32(0.0f)) ? dgFloat32(1.0f) / timestep : dgFloat32(0.0f);
 
-	m_invStepRK = dgFloat32(0.25f);
+	m_invStepRK = dgFloat32(0.25f) / dgFloat32(cluster.m_substeps);
 	m_timestepRK = m_timestep * m_invStepRK;
-	m_invTimestepRK = m_invTimestep * dgFloat32(4.0f);
+	m_invTimestepRK = m_invTimestep * dgFloat32(4 * cluster.m_substeps);
 
 	m_solverPasses = m_world->GetSolverIterations();
 	m_threadCounts = m_world->GetThreadCount();
+	m_deterministicMode = m_world->m_deterministicMode;
 	m_jointCount = ((m_cluster->m_jointCount + DG_WORK_GROUP_SIZE - 1) & -dgInt32(DG_WORK_GROUP_SIZE - 1)) / DG_WORK_GROUP_SIZE;
 
 	m_soaRowStart = dgAlloca(dgInt32, m_jointCount);
@@ -223,6 +223,7 @@ class dgParallelBodySolver
 	void UpdateKinematicFeedback();
 	void CalculateJointsAcceleration();
 	void CalculateBodiesAcceleration();
+	void AccumulateJointForces(dgJacobian* const internalForces, dgInt32 jointCount) const;
 	
 	void InitBodyArray(dgInt32 threadID);
 	void InitSkeletons(dgInt32 threadID);
@@ -250,12 +251,12 @@ class dgParallelBodySolver
 	static void CalculateBodiesAccelerationKernel(void* const context, void* const, dgInt32 threadID);
 	static void CalculateJointsAccelerationKernel(void* const context, void* const, dgInt32 threadID);
 
-	static dgInt32 CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* notUsed);
+	static dgInt32 CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* context);
 
 	dgFloat32 CalculateJointForce(const dgJointInfo* const jointInfo, dgSolverSoaElement* const massMatrix, const dgJacobian* const internalForces) const;
 	DG_INLINE void SortWorkGroup (dgInt32 base) const; 
 	DG_INLINE void TransposeRow (dgSolverSoaElement* const row, const dgJointInfo* const jointInfoArray, dgInt32 index);
-	DG_INLINE void BuildJacobianMatrix(dgJointInfo* const jointInfo, dgLeftHandSide* const leftHandSide, dgRightHandSide* const righHandSide, dgJacobian* const internalForces);
+	DG_INLINE void BuildJacobianMatrix(dgJointInfo* const jointInfo, dgLeftHandSide* const leftHandSide, dgRightHandSide* const righHandSide, dgJacobian* const internalForces, dgJacobian* const jointForces);
 
 	protected:
 	dgWorld* m_world;
@@ -272,6 +273,8 @@ class dgParallelBodySolver
 	dgFloat32 m_accelNorm[DG_MAX_THREADS_HIVE_COUNT];
 	dgInt32 m_hasJointFeeback[DG_MAX_THREADS_HIVE_COUNT];
 	dgArray<dgSkeletonContainer*> m_skeletonArray; 
+	dgArray<dgJacobian> m_jointForceBuffer;
+	dgArray<dgFloat32> m_jointAccelNorm;
 
 	dgInt32 m_jointCount;
 	dgInt32 m_solverPasses;
@@ -279,6 +282,7 @@ class dgParallelBodySolver
 	dgInt32 m_soaRowsCount;
 	dgInt32 m_skeletonCount;
 	dgInt32 m_jacobianMatrixRowAtomicIndex;
+	dgInt32 m_deterministicMode;
 	dgInt32* m_soaRowStart;
 	dgInt32* m_bodyRowStart;
 
@@ -303,17 +307,20 @@ DG_INLINE dgParallelBodySolver::dgParallelBodySolver(dgMemoryAllocator* const al
 	,m_invTimestepRK(dgFloat32(0.0f))
 	,m_firstPassCoef(dgFloat32(0.0f))
 	,m_skeletonArray(allocator)
+	,m_jointForceBuffer(allocator)
+	,m_jointAccelNorm(allocator)
 	,m_jointCount(0)
 	,m_solverPasses(0)
 	,m_threadCounts(0)
 	,m_soaRowsCount(0)
 	,m_skeletonCount(0)
 	,m_jacobianMatrixRowAtomicIndex(0)
+	,m_deterministicMode(0)
 	,m_soaRowStart(NULL)
 	,m_bodyRowStart(NULL)
-	,m_massMatrix(allocator)
 	,m_one(dgFloat32 (1.0f))
 	,m_zero(dgFloat32 (0.0f))
+	,m_massMatrix(allocator)
 {
 	m_skeletonArray[32] = NULL;
 }
@@ -1261,7 +1261,8 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 	dgRightHandSide* const rightHandSide = &m_solverMemory.m_righHandSizeBuffer[cluster->m_rowStart];
 	const dgLeftHandSide* const leftHandSide = &m_solverMemory.m_leftHandSizeBuffer[cluster->m_rowStart];
 
-	const dgInt32 derivativesEvaluationsRK4 = 4;
+	// stiff clusters run the inner loop at a higher rate, contacts and jacobians are shared by all sub steps
+	const dgInt32 derivativesEvaluationsRK4 = 4 * cluster->m_substeps;
 	dgFloat32 invTimestep = (timestep > dgFloat32(0.0f)) ? dgFloat32(1.0f) / timestep : dgFloat32(0.0f);
 	dgFloat32 invStepRK = (dgFloat32(1.0f) / dgFloat32(derivativesEvaluationsRK4));
 	dgFloat32 timestepRK = timestep * invStepRK;